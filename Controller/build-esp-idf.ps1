@@ -1,5 +1,7 @@
 #!/usr/bin/env pwsh
 # ESP-IDF Build Script for Mini-6DOF Controller
+#   -NimBLE   build with the NimBLE host instead of Bluedroid (sdkconfig.nimble)
+param([switch]$NimBLE)
 
 Write-Host "Setting up ESP-IDF environment..." -ForegroundColor Cyan
 
@@ -36,8 +38,15 @@ Write-Host "Setting target to ESP32..." -ForegroundColor Cyan
 idf.py set-target esp32
 
 # Build the project
-Write-Host "Building project..." -ForegroundColor Cyan
-idf.py build
+if ($NimBLE) {
+    # The host stack is a Kconfig choice: regenerate sdkconfig from the overlay.
+    Write-Host "Building project (NimBLE host)..." -ForegroundColor Cyan
+    Remove-Item -ErrorAction SilentlyContinue sdkconfig
+    idf.py -D SDKCONFIG_DEFAULTS="sdkconfig.defaults;sdkconfig.nimble" build
+} else {
+    Write-Host "Building project..." -ForegroundColor Cyan
+    idf.py build
+}
 
 if ($LASTEXITCODE -eq 0) {
     Write-Host "`nBuild completed successfully!" -ForegroundColor Green
@@ -0,0 +1,132 @@
+// bench_biquad6.cpp — SoA biquad6 kernel vs a per-filter (AoS) reference
+//
+// Runs the same 6-axis cascade two ways over a synthetic 250 Hz motion trace:
+//   ref : one {b0..a2,z1,z2} struct per axis per section, walked axis by axis
+//         (the layout the cue chain uses today)
+//   soa : biquad6_tick(), all six axes per section in one pass
+// Reports ns and cycles per tick for both, and the max output deviation.
+// Exits non-zero if the deviation exceeds the stated tolerance.
+//
+//   biquad6_bench [ticks] [rate_hz]
+
+#include "biquad6.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline unsigned long long cycles() { return __rdtsc(); }
+#define HAVE_CYCLES 1
+#else
+static inline unsigned long long cycles() { return 0; }
+#define HAVE_CYCLES 0
+#endif
+
+// Relative to the trace's full scale (±100 %). float32 TDF-II in a different
+// evaluation order (SIMD lanes, FMA contraction) stays well inside this.
+static const double kTolerance = 1e-5;
+
+struct RefBiquad { float b0, b1, b2, a1, a2, z1, z2; };
+
+static inline float refRun(RefBiquad& b, float x) {
+    float y = b.b0 * x + b.z1;
+    b.z1 = b.b1 * x - b.a1 * y + b.z2;
+    b.z2 = b.b2 * x - b.a2 * y;
+    return y;
+}
+
+// Cue-chain-shaped cascade: input LP, 4th-order washout HP (2 sections),
+// tilt-channel LP. Different corner per axis so no two lanes are identical.
+static void designChain(Biquad6* bq, float fs) {
+    biquad6_init(bq, 4);
+    for (int a = 0; a < BIQUAD6_AXES; a++) {
+        biquad6_set_lowpass (bq, 0, a, 8.0f + a,          fs, 0.7071f);
+        biquad6_set_highpass(bq, 1, a, 0.4f + 0.05f * a,  fs, 0.5412f);
+        biquad6_set_highpass(bq, 2, a, 0.4f + 0.05f * a,  fs, 1.3066f);
+        biquad6_set_lowpass (bq, 3, a, 3.0f + 0.25f * a,  fs, 0.7071f);
+    }
+}
+
+static void copyToRef(const Biquad6& bq, std::vector<RefBiquad>& ref) {
+    ref.assign(BIQUAD6_AXES * bq.stages, RefBiquad{});
+    for (int a = 0; a < BIQUAD6_AXES; a++)
+        for (int s = 0; s < bq.stages; s++)
+            ref[a * bq.stages + s] = { bq.b0[s][a], bq.b1[s][a], bq.b2[s][a],
+                                       bq.a1[s][a], bq.a2[s][a], 0.0f, 0.0f };
+}
+
+// Lap-like percent trace: a few sines per axis plus braking steps.
+static void synth(std::vector<float>& trace, int ticks, float fs) {
+    trace.resize((size_t)ticks * 6);
+    for (int n = 0; n < ticks; n++) {
+        float t = n / fs;
+        for (int a = 0; a < 6; a++) {
+            float v = 40.0f * sinf(0.31f * t * (a + 1)) + 15.0f * sinf(2.7f * t + a)
+                    + 5.0f * sinf(11.0f * t * (a + 1));
+            if (((n / (int)(fs * 3)) & 1) && a < 2) v += 30.0f;
+            trace[(size_t)n * 6 + a] = v;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    int   ticks = argc > 1 ? atoi(argv[1]) : 300000;     // 20 min @ 250 Hz
+    float fs    = argc > 2 ? (float)atof(argv[2]) : 250.0f;
+    if (ticks <= 0 || fs <= 0.0f) { fprintf(stderr, "usage: biquad6_bench [ticks] [rate_hz]\n"); return 2; }
+
+    std::vector<float> trace;
+    synth(trace, ticks, fs);
+
+    Biquad6 soa;
+    designChain(&soa, fs);
+    std::vector<RefBiquad> ref;
+    copyToRef(soa, ref);
+    const int stages = soa.stages;
+
+    std::vector<float> outRef((size_t)ticks * 6), outSoa((size_t)ticks * 6);
+
+    using clk = std::chrono::steady_clock;
+
+    auto t0 = clk::now(); unsigned long long c0 = cycles();
+    for (int n = 0; n < ticks; n++) {
+        const float* in = &trace[(size_t)n * 6];
+        float* out = &outRef[(size_t)n * 6];
+        for (int a = 0; a < 6; a++) {
+            float x = in[a];
+            for (int s = 0; s < stages; s++) x = refRun(ref[a * stages + s], x);
+            out[a] = x;
+        }
+    }
+    unsigned long long c1 = cycles(); auto t1 = clk::now();
+    for (int n = 0; n < ticks; n++)
+        biquad6_tick(&soa, &trace[(size_t)n * 6], &outSoa[(size_t)n * 6]);
+    unsigned long long c2 = cycles(); auto t2 = clk::now();
+
+    double maxErr = 0.0;
+    for (size_t i = 0; i < outRef.size(); i++)
+        maxErr = std::fmax(maxErr, std::fabs((double)outRef[i] - (double)outSoa[i]));
+    const double rel = maxErr / 100.0;   // trace full scale is ±100 %
+
+    double nsRef = std::chrono::duration<double, std::nano>(t1 - t0).count() / ticks;
+    double nsSoa = std::chrono::duration<double, std::nano>(t2 - t1).count() / ticks;
+    printf("biquad6: %d ticks @ %.0f Hz, %d sections x 6 axes, simd=%d\n",
+           ticks, fs, stages,
+#ifdef BIQUAD6_SIMD
+           1
+#else
+           0
+#endif
+    );
+    printf("  ref (AoS): %8.1f ns/tick", nsRef);
+    if (HAVE_CYCLES) printf("  %8.1f cycles/tick", (double)(c1 - c0) / ticks);
+    printf("\n  soa      : %8.1f ns/tick", nsSoa);
+    if (HAVE_CYCLES) printf("  %8.1f cycles/tick", (double)(c2 - c1) / ticks);
+    printf("\n  speedup  : %.2fx\n", nsSoa > 0 ? nsRef / nsSoa : 0.0);
+    printf("  max |soa-ref| = %.3g (%.3g of full scale, tolerance %.0e) %s\n",
+           maxErr, rel, kTolerance, rel <= kTolerance ? "PASS" : "FAIL");
+    return rel <= kTolerance ? 0 : 1;
+}
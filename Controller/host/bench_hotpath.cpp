@@ -0,0 +1,362 @@
+// bench_hotpath.cpp — micro-benchmarks of the per-frame and per-tick firmware code
+//
+// Links the firmware's own main/ sources through fw_harness.h plus
+// stewart-core, compiled with the device's dialect and float model, so every
+// case times the code CueTask and the serial monitor actually run:
+//   cobs      cobs_encode / cobs_decode at 16 .. 2048-byte frames
+//   dispatch  cobs_dispatch_frame per channel (CMD, DATA, DATA_RAW)
+//   cmd       process_data per command class, and a CSV motion line
+//   pos       mapRawToPosition, slewRateLimit, calculateAllServoAngles
+//   mca       processInputFilter, processMotionCueing, mcaApplyOutputStage
+//   tick      one full CueTask tick (DEMO on the embedded lap, LIVE raw)
+//
+// Method: each case sizes a batch to --batch-ms, runs one warm-up batch, then
+// times --reps batches. The per-op statistics are over those batches; median
+// and MAD (median absolute deviation) are what --baseline compares, because
+// they ignore the odd batch the scheduler interrupted. A case regresses when
+// its median is more than --threshold % slower than the baseline AND the gap
+// is larger than 3 MADs of either run.
+//
+//   mini6dof_bench [--filter SUBSTR] [--reps N] [--batch-ms MS] [--cpu N]
+//                  [--csv FILE|-] [--json FILE|-] [--baseline FILE.csv]
+//                  [--threshold PCT]
+//
+// Absolute numbers are the host's; compare runs on the same machine (pin with
+// --cpu, keep the governor fixed). The on-device figures are *:BENCH.
+
+#include "fw_harness.h"
+#include "sim_hooks.h"
+#include "cobs.h"
+#include "CobsTransport.h"
+#include "MiniPlatform.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sched.h>
+
+void process_data(char* data);
+void process_raw_packet(const uint8_t* payload);
+
+namespace {
+
+// Keep a value alive without a store the optimizer can see through.
+template <class T> inline void keep(const T& v) { asm volatile("" : : "r,m"(v) : "memory"); }
+
+struct Stats {
+    std::string name;
+    uint64_t iters = 0;          // ops per batch
+    int      reps  = 0;
+    double   median = 0, mad = 0, mean = 0, stddev = 0, min = 0, p95 = 0;   // ns/op
+};
+
+struct Options {
+    std::string filter;
+    int         reps     = 30;
+    double      batchMs  = 20.0;
+    int         cpu      = -1;
+    std::string csv, json, baseline;
+    double      threshold = 10.0;   // %
+};
+
+double quantile(std::vector<double> v, double q) {
+    std::sort(v.begin(), v.end());
+    const double pos = q * (v.size() - 1);
+    const size_t lo = (size_t)pos;
+    const size_t hi = std::min(lo + 1, v.size() - 1);
+    return v[lo] + (v[hi] - v[lo]) * (pos - lo);
+}
+
+// `op(i)` is one operation; i counts up across the whole run so cases can
+// walk an input table instead of repeating one value.
+Stats measure(const std::string& name, const Options& opt, const std::function<void(uint64_t)>& op) {
+    using clk = std::chrono::steady_clock;
+    uint64_t i = 0;
+    auto batch = [&](uint64_t n) {
+        const auto t0 = clk::now();
+        for (uint64_t k = 0; k < n; k++) op(i++);
+        return std::chrono::duration<double, std::nano>(clk::now() - t0).count();
+    };
+
+    // Size the batch: double until one batch takes a tenth of the target.
+    uint64_t n = 1;
+    double ns = batch(n);
+    while (ns < opt.batchMs * 1e5 && n < (1ull << 32)) { n *= 2; ns = batch(n); }
+    n = std::max<uint64_t>(1, (uint64_t)(n * (opt.batchMs * 1e6 / std::max(ns, 1.0))));
+    batch(n);                                   // warm-up at the final size
+
+    std::vector<double> per(opt.reps);
+    for (int r = 0; r < opt.reps; r++) per[r] = batch(n) / (double)n;
+
+    Stats s;
+    s.name   = name;
+    s.iters  = n;
+    s.reps   = opt.reps;
+    s.median = quantile(per, 0.5);
+    s.p95    = quantile(per, 0.95);
+    s.min    = *std::min_element(per.begin(), per.end());
+    double sum = 0, sq = 0;
+    for (double v : per) sum += v;
+    s.mean = sum / per.size();
+    for (double v : per) sq += (v - s.mean) * (v - s.mean);
+    s.stddev = per.size() > 1 ? std::sqrt(sq / (per.size() - 1)) : 0.0;
+    std::vector<double> dev(per.size());
+    for (size_t k = 0; k < per.size(); k++) dev[k] = std::fabs(per[k] - s.median);
+    s.mad = quantile(dev, 0.5);
+    return s;
+}
+
+// ── Inputs ───────────────────────────────────────────────────────────
+
+const int kTrace = 4096;   // frames; power of two
+
+// Lap-like signed percent trace (the RAW domain), six axes.
+std::vector<float> percentTrace() {
+    std::vector<float> t((size_t)kTrace * 6);
+    for (int n = 0; n < kTrace; n++) {
+        const float s = n / 50.0f;
+        for (int a = 0; a < 6; a++)
+            t[(size_t)n * 6 + a] = 45.0f * sinf(0.37f * s * (a + 1)) + 20.0f * sinf(2.3f * s + a)
+                                 + 6.0f * sinf(9.0f * s * (a + 1));
+    }
+    return t;
+}
+
+// The same trace in the 12-bit count domain (baked / mapRawToPosition input).
+std::vector<float> countTrace(const std::vector<float>& pct) {
+    std::vector<float> c(pct.size());
+    for (size_t k = 0; k < pct.size(); k++) c[k] = 2048.0f + pct[k] * 20.47f;
+    return c;
+}
+
+// Frame bytes with a realistic share of zeros (COBS cost depends on them).
+std::vector<uint8_t> frameBytes(int len, uint32_t seed) {
+    std::vector<uint8_t> b(len);
+    for (int k = 0; k < len; k++) {
+        seed = seed * 1664525u + 1013904223u;
+        b[k] = (seed >> 24) % 7 == 0 ? 0 : (uint8_t)(seed >> 16);
+    }
+    return b;
+}
+
+// ── Output ───────────────────────────────────────────────────────────
+
+void writeCsv(FILE* f, const std::vector<Stats>& all) {
+    fprintf(f, "name,iters,reps,median_ns,mad_ns,mean_ns,stddev_ns,min_ns,p95_ns\n");
+    for (const Stats& s : all)
+        fprintf(f, "%s,%llu,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n", s.name.c_str(),
+                (unsigned long long)s.iters, s.reps, s.median, s.mad, s.mean, s.stddev, s.min, s.p95);
+}
+
+void writeJson(FILE* f, const std::vector<Stats>& all) {
+    fprintf(f, "{\n  \"unit\": \"ns/op\",\n  \"benchmarks\": [\n");
+    for (size_t k = 0; k < all.size(); k++) {
+        const Stats& s = all[k];
+        fprintf(f, "    {\"name\": \"%s\", \"iters\": %llu, \"reps\": %d, \"median\": %.3f, \"mad\": %.3f, "
+                   "\"mean\": %.3f, \"stddev\": %.3f, \"min\": %.3f, \"p95\": %.3f}%s\n",
+                s.name.c_str(), (unsigned long long)s.iters, s.reps, s.median, s.mad, s.mean, s.stddev,
+                s.min, s.p95, k + 1 < all.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+bool emit(const std::string& path, const std::vector<Stats>& all, void (*fn)(FILE*, const std::vector<Stats>&)) {
+    if (path.empty()) return true;
+    FILE* f = path == "-" ? stdout : fopen(path.c_str(), "w");
+    if (!f) { perror(path.c_str()); return false; }
+    fn(f, all);
+    if (f != stdout) fclose(f);
+    return true;
+}
+
+// Baseline CSV (our own --csv output): name -> {median, mad}.
+bool readBaseline(const std::string& path, std::map<std::string, std::pair<double, double>>& out) {
+    std::ifstream f(path);
+    if (!f) { perror(path.c_str()); return false; }
+    std::string line;
+    std::getline(f, line);   // header
+    while (std::getline(f, line)) {
+        std::stringstream ss(line);
+        std::string name, iters, reps, median, mad;
+        if (std::getline(ss, name, ',') && std::getline(ss, iters, ',') && std::getline(ss, reps, ',') &&
+            std::getline(ss, median, ',') && std::getline(ss, mad, ','))
+            out[name] = std::make_pair(atof(median.c_str()), atof(mad.c_str()));
+    }
+    return true;
+}
+
+void usage() {
+    fprintf(stderr,
+        "usage: mini6dof_bench [--filter SUBSTR] [--reps N] [--batch-ms MS] [--cpu N]\n"
+        "                      [--csv FILE|-] [--json FILE|-] [--baseline FILE.csv] [--threshold PCT]\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        const std::string a = argv[i];
+        auto val = [&]() -> const char* {
+            if (i + 1 >= argc) { usage(); exit(2); }
+            return argv[++i];
+        };
+        if      (a == "--filter")    opt.filter = val();
+        else if (a == "--reps")      opt.reps = atoi(val());
+        else if (a == "--batch-ms")  opt.batchMs = atof(val());
+        else if (a == "--cpu")       opt.cpu = atoi(val());
+        else if (a == "--csv")       opt.csv = val();
+        else if (a == "--json")      opt.json = val();
+        else if (a == "--baseline")  opt.baseline = val();
+        else if (a == "--threshold") opt.threshold = atof(val());
+        else { usage(); return 2; }
+    }
+    if (opt.reps < 3 || opt.batchMs <= 0) { usage(); return 2; }
+    if (opt.cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(opt.cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) perror("sched_setaffinity");
+    }
+
+    // Firmware up without a port: responses are encoded, counted and dropped.
+    shim_uart_open_null();
+    fw_harness_boot();
+
+    const std::vector<float> pct = percentTrace();
+    const std::vector<float> cnt = countTrace(pct);
+    auto pctFrame = [&](uint64_t i) { return &pct[(i & (kTrace - 1)) * 6]; };
+    auto cntFrame = [&](uint64_t i) { return &cnt[(i & (kTrace - 1)) * 6]; };
+
+    std::vector<Stats> all;
+    const bool table = opt.csv != "-" && opt.json != "-";
+    if (table) printf("%-30s %12s %10s %10s %10s\n", "case", "median ns", "mad", "p95", "iters");
+    auto run = [&](const std::string& name, const std::function<void(uint64_t)>& op) {
+        if (!opt.filter.empty() && name.find(opt.filter) == std::string::npos) return;
+        all.push_back(measure(name, opt, op));
+        const Stats& s = all.back();
+        if (table) printf("%-30s %12.1f %10.2f %10.1f %10llu\n", name.c_str(), s.median, s.mad, s.p95,
+                          (unsigned long long)s.iters);
+        fflush(stdout);
+    };
+
+    // ── tick: first, while the boot source (DEMO) is still selected ──────
+    run("tick/demo", [](uint64_t) { fw_harness_tick(); });
+    fw_harness_command("SOURCE:LIVE");
+    run("tick/live_raw", [&](uint64_t i) {
+        process_raw_packet((const uint8_t*)pctFrame(i));
+        fw_harness_tick();
+    });
+
+    // ── cobs ─────────────────────────────────────────────────────────
+    for (int len : {16, 64, 256, 2048}) {
+        const std::vector<uint8_t> raw = frameBytes(len, (uint32_t)len);
+        std::vector<uint8_t> enc(COBS_MAX_ENC_SIZE(len)), dec(COBS_MAX_ENC_SIZE(len));
+        const int encLen = cobs_encode(raw.data(), len, enc.data());
+        std::vector<uint8_t> encIn(enc.begin(), enc.begin() + encLen);
+        char n[32];
+        snprintf(n, sizeof(n), "cobs/encode/%d", len);
+        run(n, [&](uint64_t) { keep(cobs_encode(raw.data(), len, enc.data())); keep(enc[0]); });
+        snprintf(n, sizeof(n), "cobs/decode/%d", len);
+        run(n, [&](uint64_t) { keep(cobs_decode(encIn.data(), encLen, dec.data())); keep(dec[0]); });
+    }
+
+    // ── dispatch: decoded frame -> handler (source already LIVE) ─────
+    {
+        const char cmd[] = "VERSION?";
+        std::vector<uint8_t> fCmd(1 + sizeof(cmd) - 1), fData(1 + 12), fRaw(1 + 24);
+        fCmd[0] = COBS_CH_CMD;
+        memcpy(&fCmd[1], cmd, sizeof(cmd) - 1);
+        fData[0] = COBS_CH_DATA;
+        for (int a = 0; a < 6; a++) { fData[1 + a * 2] = 0x00; fData[2 + a * 2] = 0x08; }   // 2048
+        fRaw[0] = COBS_CH_DATA_RAW;
+        memcpy(&fRaw[1], pct.data(), 24);
+        run("dispatch/cmd", [&](uint64_t) { cobs_dispatch_frame(fCmd.data(), (int)fCmd.size()); });
+        run("dispatch/data", [&](uint64_t) { cobs_dispatch_frame(fData.data(), (int)fData.size()); });
+        run("dispatch/data_raw", [&](uint64_t) { cobs_dispatch_frame(fRaw.data(), (int)fRaw.size()); });
+    }
+
+    // ── cmd: process_data per command class (it tokenizes in place) ──
+    {
+        struct { const char* name; const char* line; } cmds[] = {
+            { "cmd/query",   "VERSION?" },                       // short fixed response
+            { "cmd/dump",    "CONFIG?" },                        // multi-field formatted dump
+            { "cmd/mca",     "MCA?" },                           // cue engine state
+            { "cmd/setter",  "BITS:12" },                        // parse + publish + NVS stage
+            { "cmd/csv",     "2048,2048,2048,2048,2048,2048" },  // legacy CSV motion
+        };
+        for (const auto& c : cmds) {
+            const std::string line = c.line;
+            run(c.name, [&](uint64_t) {
+                char buf[256];
+                memcpy(buf, line.c_str(), line.size() + 1);
+                process_data(buf);
+            });
+        }
+    }
+
+    // ── pos: count domain -> pose -> slew -> servo angles ────────────
+    {
+        StewartConfig geom;
+        initMiniDefaults(&geom);
+        AxisScaleConfig scales;
+        computeAxisScalesFromGeometry(&scales, &geom, AXIS_SCALE_MARGIN);
+        const float maxRaw = 4095.0f;
+        std::vector<float> poses((size_t)kTrace * 6);
+        for (int n = 0; n < kTrace; n++) mapRawToPosition(&cnt[(size_t)n * 6], &scales, maxRaw, &poses[(size_t)n * 6]);
+        float out[6];
+        run("pos/mapRawToPosition", [&](uint64_t i) { mapRawToPosition(cntFrame(i), &scales, maxRaw, out); keep(out[0]); });
+        run("pos/slewRateLimit", [&](uint64_t i) {
+            fw_harness_slew(&poses[(i & (kTrace - 1)) * 6], out, 1.0f / 50.0f);
+            keep(out[0]);
+        });
+        run("pos/calculateAllServoAngles", [&](uint64_t i) {
+            calculateAllServoAngles(&poses[(i & (kTrace - 1)) * 6], &geom, out);
+            keep(out[0]);
+        });
+    }
+
+    // ── mca: the cue chain stages, moderate preset at the 50 Hz default ─
+    {
+        const float rate = 50.0f;
+        MotionCueingConfig mca;
+        InputFilterConfig  inf;
+        initMotionCueing(&mca, rate);
+        initInputFilter(&inf, rate);
+        setMotionCueingPreset(&mca, MCA_MODERATE);
+        float f[6], m[6], o[6];
+        run("mca/processInputFilter", [&](uint64_t i) { processInputFilter(&inf, pctFrame(i), f); keep(f[0]); });
+        run("mca/processMotionCueing", [&](uint64_t i) { processMotionCueing(&mca, pctFrame(i), m); keep(m[0]); });
+        run("mca/mcaApplyOutputStage", [&](uint64_t i) { mcaApplyOutputStage(&mca, pctFrame(i), o); keep(o[0]); });
+    }
+
+    if (all.empty()) { fprintf(stderr, "no case matches '%s'\n", opt.filter.c_str()); return 2; }
+    if (!emit(opt.csv, all, writeCsv) || !emit(opt.json, all, writeJson)) return 1;
+
+    if (opt.baseline.empty()) return 0;
+    std::map<std::string, std::pair<double, double>> base;
+    if (!readBaseline(opt.baseline, base)) return 1;
+    int regressions = 0;
+    for (const Stats& s : all) {
+        auto it = base.find(s.name);
+        if (it == base.end()) continue;
+        const double b = it->second.first, noise = 3.0 * std::max(s.mad, it->second.second);
+        const double pctChange = b > 0 ? (s.median - b) / b * 100.0 : 0.0;
+        const bool slower = pctChange > opt.threshold && s.median - b > noise;
+        if (slower) regressions++;
+        fprintf(stderr, "%-30s %10.1f -> %10.1f ns  %+6.1f%%%s\n", s.name.c_str(), b, s.median, pctChange,
+                slower ? "  REGRESSION" : "");
+    }
+    fprintf(stderr, "%d regression(s) beyond %.0f%% (vs %s)\n", regressions, opt.threshold, opt.baseline.c_str());
+    return regressions ? 1 : 0;
+}
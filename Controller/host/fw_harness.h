@@ -0,0 +1,34 @@
+// fw_harness.h — the firmware's main.cpp driven from a host program
+// Compiled into main.cpp when MINI6DOF_HARNESS is defined (host/CMakeLists
+// does this for every target built from main/). Nothing here exists on the
+// device. Call fw_harness_boot() once, then fw_harness_tick() as CueTask
+// would — no sleep, so the caller owns the tick rate (and, with the shim's
+// virtual clock, time itself).
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+// app_main's boot stages (NVS, transport, config, LEDC, cue engine, sequence
+// library, boot source) with servo power on and no settle wait. Starts the
+// firmware's helper tasks but neither CueTask nor the serial monitor.
+// Returns whether a sequence is selected.
+bool fw_harness_boot(void);
+
+// One CueTask iteration: target -> cue chain -> slew -> IK -> LEDC.
+void fw_harness_tick(void);
+
+// Rescan the library with `m6p` (a whole .m6p image, kept by the caller) as
+// its embedded entry #0, select it and start DEMO playback from frame 0.
+bool fw_harness_play(const uint8_t* m6p, size_t len);
+
+// A command line as the COBS CMD channel delivers it (process_data on a copy).
+void fw_harness_command(const char* cmd);
+
+// main.cpp's slewRateLimit() (file-static) for the bench.
+void fw_harness_slew(const float target[6], float out[6], float dt);
+#ifdef __cplusplus
+}
+#endif
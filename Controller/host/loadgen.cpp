@@ -0,0 +1,263 @@
+// loadgen.cpp — mini6dof_loadgen: stream motion at a fixed rate, measure the link
+//
+// Drives a device (or mini6dof_sim's pty) through M6Client the way a game
+// bridge would: handshake, TEL2 on, then one motion frame per timerfd tick
+// for --seconds, with VERSION? probes in between. Reports:
+//
+//   send    scheduled / sent / dropped (TX backlog full) / missed timer ticks,
+//           lateness of each write vs its schedule and the send interval spread
+//   device  TEL2 samples, samples lost in transit (tick gaps), TelStream drops
+//           (TEL2?), input age
+//   rtt     command round trip (VERSION? -> VERSION:) and motion echo: frame
+//           write -> first TEL2 sample whose IN group carries it
+//
+// Motion echo works by marking each frame: the last axis carries a sawtooth
+// whose value is the frame's sequence number modulo the marker period, a
+// step the TEL2 IN group reproduces exactly (0.01 % raw, 1 count baked). The
+// other axes run a slow sine. A latency beyond the marker period (at most
+// 2000 frames) would alias; the report prints the period.
+//
+//   mini6dof_loadgen [--baud N] [--format raw|baked] [--rate HZ] [--seconds S]
+//                    [--tel2-div N] [--ping HZ] [--txlimit BYTES] [--csv FILE] <port>
+//
+// Try it against the simulator:
+//   ./build-host/mini6dof_sim --link /tmp/mini6dof &
+//   ./build-host/mini6dof_loadgen --rate 500 --seconds 10 /tmp/mini6dof
+
+#include "m6client.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct Dist {
+    std::vector<double> v;
+    void add(double x) { v.push_back(x); }
+    double pct(double p) {
+        if (v.empty()) return 0.0;
+        std::sort(v.begin(), v.end());
+        return v[std::min(v.size() - 1, (size_t)(p / 100.0 * (v.size() - 1) + 0.5))];
+    }
+    double mean() const {
+        double s = 0;
+        for (double x : v) s += x;
+        return v.empty() ? 0.0 : s / v.size();
+    }
+    double stddev() const {
+        const double m = mean();
+        double s = 0;
+        for (double x : v) s += (x - m) * (x - m);
+        return v.size() > 1 ? std::sqrt(s / (v.size() - 1)) : 0.0;
+    }
+    void print(const char* what, const char* unit) {
+        if (v.empty()) { printf("  %-22s -\n", what); return; }
+        printf("  %-22s n=%-7zu mean %8.1f  p50 %8.1f  p99 %8.1f  max %8.1f %s\n", what, v.size(), mean(),
+               pct(50), pct(99), pct(100), unit);
+    }
+};
+
+const int kSrcLive = 2;     // TEL2 src: SRC_LIVE (main.cpp)
+
+struct Sent {
+    int64_t schedUs, sentUs, echoUs;
+};
+
+void usage() {
+    fprintf(stderr,
+        "usage: mini6dof_loadgen [--baud N] [--format raw|baked] [--rate HZ] [--seconds S]\n"
+        "                        [--tel2-div N] [--ping HZ] [--txlimit BYTES] [--csv FILE] <port>\n");
+}
+
+// "KEY:...name=<n>..." -> n, or `def`.
+long field(const std::string& line, const char* name, long def) {
+    size_t k = line.find(name);
+    return k == std::string::npos ? def : strtol(line.c_str() + k + strlen(name), nullptr, 0);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int baud = 921600, rate = 250, tel2Div = 1, pingHz = 5;
+    double seconds = 10.0;
+    bool raw = true;
+    size_t txLimit = 4096;
+    std::string port, csv;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string a = argv[i];
+        auto val = [&]() -> const char* {
+            if (i + 1 >= argc) { usage(); exit(2); }
+            return argv[++i];
+        };
+        if      (a == "--baud")     baud = atoi(val());
+        else if (a == "--format")   { std::string f = val(); raw = f != "baked"; if (f != "raw" && raw) { usage(); return 2; } }
+        else if (a == "--rate")     rate = atoi(val());
+        else if (a == "--seconds")  seconds = atof(val());
+        else if (a == "--tel2-div") tel2Div = atoi(val());
+        else if (a == "--ping")     pingHz = atoi(val());
+        else if (a == "--txlimit")  txLimit = (size_t)atol(val());
+        else if (a == "--csv")      csv = val();
+        else if (!a.empty() && a[0] == '-') { usage(); return 2; }
+        else if (port.empty())      port = a;
+        else { usage(); return 2; }
+    }
+    if (port.empty() || rate < 1 || rate > 10000 || seconds <= 0 || tel2Div < 1 || pingHz < 0) { usage(); return 2; }
+
+    M6Client c;
+    c.txLimit = txLimit;
+    if (!c.open(port, baud)) return 1;
+    M6DeviceInfo dev;
+    if (!c.handshake(&dev)) { fprintf(stderr, "%s: no FINGERPRINT reply\n", port.c_str()); return 1; }
+    printf("%s: %s fw=%s proto=%d platform=%s caps=%s\n", port.c_str(), dev.mac.c_str(), dev.fw.c_str(),
+           dev.proto, dev.platform.c_str(), dev.caps.c_str());
+    if (raw && !dev.hasCap("raw")) { fprintf(stderr, "device has no raw cap; use --format baked\n"); return 1; }
+
+    // Value domain: raw percent, or counts around the middle of BITS.
+    double centre = 0.0, amp = 20.0, step = 0.01;
+    if (!raw) {
+        const long maxRaw = field(c.request("BITS?"), "max_raw=", 4095);
+        centre = (double)((maxRaw + 1) / 2);
+        amp = std::floor(maxRaw * 0.1);   // whole counts: markers round-trip exactly
+        step = 1.0;
+    }
+    const int markerPeriod = (int)std::min(2000.0, 2.0 * amp / step);
+
+    std::string r = c.request("TEL2:0x41," + std::to_string(tel2Div));
+    if (r.compare(0, 10, "TEL2:mask=") != 0) { fprintf(stderr, "TEL2 setup failed: %s\n", r.c_str()); return 1; }
+
+    // ── Streaming ───────────────────────────────────────────────────────
+    const uint64_t total = (uint64_t)std::llround(seconds * rate);
+    const int64_t periodNs = 1000000000LL / rate;
+    std::vector<Sent> sent;
+    sent.reserve(total);
+    std::vector<int64_t> lastOfCode(markerPeriod, -1);   // code -> newest frame index with it
+    Dist late, interval, cmdRtt, echo, age;
+    uint64_t missed = 0, dropped = 0, tel2 = 0, lostTel2 = 0;
+    uint32_t lastTick = 0;
+    bool haveTick = false, pingOut = false;
+    const int pingEvery = pingHz ? std::max(1, rate / pingHz) : 0;
+
+    c.onTel2 = [&](const Tel2Sample& s) {
+        const int64_t now = M6Client::nowUs();
+        tel2++;
+        if (haveTick && s.tick - lastTick > (uint32_t)tel2Div) lostTel2 += (s.tick - lastTick) / tel2Div - 1;
+        lastTick = s.tick;
+        haveTick = true;
+        if (s.mask & TEL2_F_AGE) age.add(s.age_ms);
+        // Only streamed input carries markers (not DEMO before the first frame).
+        if (s.src != kSrcLive || s.fmt != (raw ? TEL2_FMT_RAW : TEL2_FMT_BAKED)) return;
+        const long code = std::lround((s.in[5] - (centre - amp)) / step);
+        if (code < 0 || code >= markerPeriod || lastOfCode[code] < 0) return;
+        Sent& f = sent[(size_t)lastOfCode[code]];
+        if (f.echoUs >= 0) return;
+        f.echoUs = now;
+        echo.add((now - f.sentUs) / 1000.0);
+    };
+    c.onResponse = [](const std::string& line) {
+        if (line.compare(0, 4, "WDT:") == 0 || line.compare(0, 4, "ERR:") == 0) printf("  device: %s\n", line.c_str());
+    };
+
+    int tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    const int64_t t0Ns = (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec + 20000000LL;
+    itimerspec its{};
+    its.it_value.tv_sec = t0Ns / 1000000000LL;
+    its.it_value.tv_nsec = t0Ns % 1000000000LL;
+    its.it_interval.tv_sec = periodNs / 1000000000LL;
+    its.it_interval.tv_nsec = periodNs % 1000000000LL;
+    timerfd_settime(tfd, TFD_TIMER_ABSTIME, &its, nullptr);
+
+    uint64_t k = 0;             // timer ticks elapsed
+    int64_t lastSentUs = -1;
+    c.watch(tfd, [&]() {
+        uint64_t exp = 0;
+        if (read(tfd, &exp, sizeof(exp)) != (ssize_t)sizeof(exp) || exp == 0) return;
+        missed += exp - 1;      // a late wakeup sends only the newest frame
+        k += exp;
+        if (k > total) return;
+        const uint64_t n = k - 1;
+        const double t = (double)n / rate;
+        const int code = (int)(n % (uint64_t)markerPeriod);
+        float v[6];
+        for (int a = 0; a < 5; a++) v[a] = (float)(centre + 0.5 * amp * std::sin(2 * M_PI * 0.2 * t + a));
+        v[5] = (float)(centre - amp + code * step);
+        const int64_t sched = (t0Ns + (int64_t)n * periodNs) / 1000;
+        bool ok;
+        if (raw) {
+            ok = c.sendRaw(v);
+        } else {
+            uint16_t counts[6];
+            for (int a = 0; a < 6; a++) counts[a] = (uint16_t)std::lround(v[a]);
+            ok = c.sendBaked(counts);
+        }
+        const int64_t at = M6Client::nowUs();
+        if (!ok) { dropped++; return; }
+        lastOfCode[code] = (int64_t)sent.size();
+        sent.push_back(Sent{sched, at, -1});
+        late.add((double)(at - sched));
+        if (lastSentUs >= 0) interval.add((double)(at - lastSentUs));
+        lastSentUs = at;
+        if (pingEvery && n % pingEvery == 0 && !pingOut) {
+            pingOut = true;
+            c.requestAsync("VERSION?", [&](bool okR, const std::string&, int64_t rtt) {
+                pingOut = false;
+                if (okR) cmdRtt.add(rtt / 1000.0);
+            });
+        }
+    });
+
+    const int64_t endUs = t0Ns / 1000 + (int64_t)(seconds * 1e6) + 300000;   // + echo / reply tail
+    while (M6Client::nowUs() < endUs)
+        if (!c.run(10)) { fprintf(stderr, "%s: link lost\n", port.c_str()); return 1; }
+    close(tfd);
+
+    const std::string tel2Stats = c.request("TEL2?");
+    c.request("TEL2:0");
+
+    // ── Report ──────────────────────────────────────────────────────────
+    const M6ClientStats& st = c.stats();
+    uint64_t echoed = 0;
+    for (const Sent& f : sent) echoed += f.echoUs >= 0;
+    printf("stream: %s @ %d Hz for %.1f s, TEL2 IN+AGE every %d tick(s), marker period %.2f s\n",
+           raw ? "CH_DATA_RAW" : "CH_DATA", rate, seconds, tel2Div, (double)markerPeriod / rate);
+    printf("send:   %llu scheduled, %zu sent, %llu dropped (backlog > %zu B, peak %zu B), %llu timer ticks missed\n",
+           (unsigned long long)total, sent.size(), (unsigned long long)dropped, txLimit, st.txPeak,
+           (unsigned long long)missed);
+    late.print("write lateness", "us");
+    const double nominal = 1e6 / rate;
+    printf("  %-22s nominal %.1f us, stddev %.1f us, min %.1f, max %.1f\n", "send interval", nominal,
+           interval.stddev(), interval.pct(0), interval.pct(100));
+    printf("device: %llu TEL2 samples, %llu lost in transit, %s\n", (unsigned long long)tel2,
+           (unsigned long long)lostTel2, tel2Stats.empty() ? "TEL2? no reply" : tel2Stats.c_str());
+    age.print("input age (device)", "ms");
+    printf("rtt:\n");
+    cmdRtt.print("VERSION? round trip", "ms");
+    echo.print("motion -> TEL2 echo", "ms");
+    printf("  %-22s %llu of %zu frames seen by a CueTask tick (the rest were superseded)\n", "echoed",
+           (unsigned long long)echoed, sent.size());
+    printf("link:   tx %llu B / %llu frames, rx %llu B / %llu frames, %llu bad, %llu overflow, %llu timeouts\n",
+           (unsigned long long)st.txBytes, (unsigned long long)st.txFrames, (unsigned long long)st.rxBytes,
+           (unsigned long long)st.rxFrames, (unsigned long long)st.badFrames, (unsigned long long)st.rxOverflow,
+           (unsigned long long)st.timeouts);
+
+    if (!csv.empty()) {
+        FILE* f = fopen(csv.c_str(), "w");
+        if (!f) { perror(csv.c_str()); return 1; }
+        fprintf(f, "seq,sched_us,late_us,echo_us\n");
+        for (size_t n = 0; n < sent.size(); n++)
+            fprintf(f, "%zu,%lld,%lld,%lld\n", n, (long long)(sent[n].schedUs - sent[0].schedUs),
+                    (long long)(sent[n].sentUs - sent[n].schedUs),
+                    (long long)(sent[n].echoUs < 0 ? -1 : sent[n].echoUs - sent[n].sentUs));
+        fclose(f);
+    }
+    return 0;
+}
@@ -0,0 +1,377 @@
+// m6client.cpp — M6Client: epoll loop, in-place COBS framing, request matching
+#include "m6client.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+const size_t RX_BUF = 16384;        // > COBS_MAX_ENC_SIZE of any device frame (scope dump ≈ 2 KB)
+
+// cobs_encode() over the two-part input {ch, payload} plus the delimiter:
+// the channel byte never has to be copied in front of the payload.
+int encodeFrame(uint8_t ch, const uint8_t* p, int n, uint8_t* out) {
+    int wi = 1, ci = 0;
+    uint8_t code = 1;
+    for (int ri = -1; ri < n; ri++) {
+        const uint8_t b = ri < 0 ? ch : p[ri];
+        if (b == 0) {
+            out[ci] = code;
+            ci = wi++;
+            code = 1;
+        } else {
+            out[wi++] = b;
+            if (++code == 0xFF) {
+                out[ci] = code;
+                ci = wi++;
+                code = 1;
+            }
+        }
+    }
+    out[ci] = code;
+    out[wi++] = 0x00;
+    return wi;
+}
+
+// "FINGERPRINT?" -> "FINGERPRINT:", "SERVO:RATE=250" -> "SERVO:".
+std::string defaultExpect(const std::string& cmd) {
+    size_t k = cmd.find_first_of(":?=");
+    return (k == std::string::npos ? cmd : cmd.substr(0, k)) + ":";
+}
+
+bool startsWith(const std::string& s, const std::string& p) {
+    return s.size() >= p.size() && s.compare(0, p.size(), p) == 0;
+}
+
+std::string textOf(const uint8_t* p, int len) {
+    std::string s((const char*)p, (size_t)len);
+    while (!s.empty() && (s.back() == '\n' || s.back() == '\r' || s.back() == '\0')) s.pop_back();
+    return s;
+}
+
+}  // namespace
+
+bool M6DeviceInfo::hasCap(const char* cap) const {
+    const size_t n = strlen(cap);
+    for (size_t k = 0; k <= caps.size();) {
+        size_t e = caps.find_first_of("+|", k);
+        if (e == std::string::npos) e = caps.size();
+        if (e - k == n && caps.compare(k, n, cap) == 0) return true;
+        k = e + 1;
+    }
+    return false;
+}
+
+int64_t M6Client::nowUs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+M6Client::M6Client() : rx_(RX_BUF) {}
+
+M6Client::~M6Client() { close(); }
+
+bool M6Client::open(const std::string& path, int baud) {
+    close();
+    speed_t sp;
+    switch (baud) {
+        case 115200: sp = B115200; break;
+        case 230400: sp = B230400; break;
+#ifdef B460800
+        case 460800: sp = B460800; break;
+#endif
+#ifdef B921600
+        case 921600: sp = B921600; break;
+#endif
+        default: fprintf(stderr, "unsupported baud %d\n", baud); return false;
+    }
+    fd_ = ::open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd_ < 0) { perror(path.c_str()); return false; }
+    termios t{};
+    if (tcgetattr(fd_, &t) == 0) {
+        cfmakeraw(&t);
+        cfsetispeed(&t, sp);
+        cfsetospeed(&t, sp);
+        t.c_cflag |= CLOCAL | CREAD;
+        if (tcsetattr(fd_, TCSANOW, &t) != 0) { perror("tcsetattr"); close(); return false; }
+        tcflush(fd_, TCIOFLUSH);
+    }
+    ep_ = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd_;
+    if (ep_ < 0 || epoll_ctl(ep_, EPOLL_CTL_ADD, fd_, &ev) != 0) { perror("epoll"); close(); return false; }
+    wantOut_ = false;
+    rxLen_ = txHead_ = 0;
+    rxSkip_ = false;
+    tx_.clear();
+    tx_.push_back(0x00);
+    return flush();
+}
+
+void M6Client::close() {
+    if (ep_ >= 0) ::close(ep_);
+    if (fd_ >= 0) ::close(fd_);
+    ep_ = fd_ = -1;
+    watches_.clear();
+    pending_.clear();
+}
+
+bool M6Client::watch(int fd, std::function<void()> ready) {
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (ep_ < 0 || epoll_ctl(ep_, EPOLL_CTL_ADD, fd, &ev) != 0) return false;
+    watches_.push_back(Watch{fd, std::move(ready)});
+    return true;
+}
+
+void M6Client::armOut(bool on) {
+    if (on == wantOut_) return;
+    epoll_event ev{};
+    ev.events = on ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+    ev.data.fd = fd_;
+    epoll_ctl(ep_, EPOLL_CTL_MOD, fd_, &ev);
+    wantOut_ = on;
+}
+
+// Write what the port takes now; keep the rest for EPOLLOUT.
+bool M6Client::flush() {
+    while (txHead_ < tx_.size()) {
+        ssize_t w = write(fd_, tx_.data() + txHead_, tx_.size() - txHead_);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN) break;
+            perror("write");
+            return false;
+        }
+        txHead_ += (size_t)w;
+        stats_.txBytes += (uint64_t)w;
+    }
+    if (txHead_ == tx_.size()) {
+        tx_.clear();
+        txHead_ = 0;
+    } else if (txHead_ > 65536) {   // reclaim the sent prefix now and then
+        tx_.erase(tx_.begin(), tx_.begin() + (std::ptrdiff_t)txHead_);
+        txHead_ = 0;
+    }
+    armOut(txHead_ < tx_.size());
+    return true;
+}
+
+bool M6Client::sendFrame(uint8_t ch, const void* payload, int len, bool motion) {
+    if (fd_ < 0) return false;
+    if (motion && txBacklog() > txLimit) {
+        stats_.txDropped++;
+        return false;
+    }
+    const size_t at = tx_.size();
+    tx_.resize(at + COBS_MAX_ENC_SIZE(1 + len) + 1);
+    const int n = encodeFrame(ch, (const uint8_t*)payload, len, tx_.data() + at);
+    tx_.resize(at + (size_t)n);
+    stats_.txFrames++;
+    if (txBacklog() > stats_.txPeak) stats_.txPeak = txBacklog();
+    return flush();
+}
+
+bool M6Client::sendBaked(const uint16_t counts[6]) {
+    uint8_t p[12];
+    for (int i = 0; i < 6; i++) {
+        p[2 * i]     = (uint8_t)counts[i];
+        p[2 * i + 1] = (uint8_t)(counts[i] >> 8);
+    }
+    return sendFrame(COBS_CH_DATA, p, sizeof(p), true);
+}
+
+bool M6Client::sendRaw(const float v[6]) {
+    return sendFrame(COBS_CH_DATA_RAW, v, 6 * sizeof(float), true);   // host is LE, as the wire
+}
+
+bool M6Client::sendCommand(const std::string& cmd) {
+    return sendFrame(COBS_CH_CMD, cmd.data(), (int)cmd.size());
+}
+
+// ── Receive ──────────────────────────────────────────────────────────
+
+// Drain the port. Each delimiter-terminated run is decoded in place (COBS
+// output never overtakes its input) and dispatched from the buffer; only a
+// trailing partial frame is moved, to the front.
+bool M6Client::readPort() {
+    for (;;) {
+        ssize_t n = read(fd_, rx_.data() + rxLen_, rx_.size() - rxLen_);
+        if (n == 0) return false;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN;
+        }
+        stats_.rxBytes += (uint64_t)n;
+        size_t start = 0, scan = rxLen_;
+        rxLen_ += (size_t)n;
+        for (;;) {
+            uint8_t* z = (uint8_t*)memchr(rx_.data() + scan, 0x00, rxLen_ - scan);
+            if (!z) break;
+            const size_t end = (size_t)(z - rx_.data());
+            if (rxSkip_) {
+                rxSkip_ = false;
+            } else if (end > start) {
+                uint8_t* f = rx_.data() + start;
+                int d = cobs_decode(f, (int)(end - start), f);
+                if (d > 0) {
+                    stats_.rxFrames++;
+                    dispatch(f, d);
+                } else {
+                    stats_.badFrames++;
+                }
+            }
+            start = scan = end + 1;
+        }
+        if (start > 0) {
+            memmove(rx_.data(), rx_.data() + start, rxLen_ - start);
+            rxLen_ -= start;
+        }
+        if (rxLen_ == rx_.size()) {   // no delimiter in a full buffer
+            stats_.rxOverflow++;
+            rxSkip_ = true;
+            rxLen_ = 0;
+        }
+        if (fd_ < 0) return false;     // a callback closed the client
+    }
+}
+
+void M6Client::dispatch(const uint8_t* f, int len) {
+    const uint8_t ch = f[0];
+    const uint8_t* p = f + 1;
+    const int n = len - 1;
+    switch (ch) {
+        case COBS_CH_TEL2: {
+            Tel2Sample s;
+            if (!tel2_decode(p, n, &s)) { stats_.badFrames++; return; }
+            if (onTel2) onTel2(s);
+            return;
+        }
+        case COBS_CH_TEL: {
+            if (n != (int)sizeof(M6Telemetry)) { stats_.badFrames++; return; }
+            M6Telemetry t;
+            memcpy(&t, p, sizeof(t));
+            if (onTel) onTel(t);
+            return;
+        }
+        case COBS_CH_RESP:
+            onLine(textOf(p, n));
+            return;
+        case COBS_CH_LOG:
+            if (onLog) onLog(textOf(p, n));
+            return;
+        default:
+            if (onFrame) onFrame(ch, p, n);
+    }
+}
+
+void M6Client::onLine(const std::string& line) {
+    const int64_t now = nowUs();
+    for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+        const bool err = it == pending_.begin() && startsWith(line, "ERR:");
+        if (!err && !startsWith(line, it->expect)) continue;
+        Pending p = std::move(*it);
+        pending_.erase(it);
+        if (p.done) p.done(true, line, now - p.sentUs);
+        return;
+    }
+    if (onResponse) onResponse(line);
+}
+
+void M6Client::expire(int64_t now) {
+    while (!pending_.empty()) {
+        auto it = pending_.begin();
+        for (auto j = pending_.begin(); j != pending_.end(); ++j)
+            if (j->deadlineUs < it->deadlineUs) it = j;
+        if (it->deadlineUs > now) return;
+        Pending p = std::move(*it);
+        pending_.erase(it);
+        stats_.timeouts++;
+        if (p.done) p.done(false, std::string(), now - p.sentUs);
+    }
+}
+
+bool M6Client::run(int timeoutMs) {
+    if (fd_ < 0) return false;
+    // Never sleep past the earliest request deadline.
+    if (!pending_.empty()) {
+        int64_t first = pending_.front().deadlineUs;
+        for (const Pending& p : pending_) if (p.deadlineUs < first) first = p.deadlineUs;
+        int64_t left = (first - nowUs() + 999) / 1000;
+        if (left < 0) left = 0;
+        if (timeoutMs < 0 || left < timeoutMs) timeoutMs = (int)left;
+    }
+    epoll_event ev[8];
+    int n = epoll_wait(ep_, ev, 8, timeoutMs);
+    if (n < 0 && errno != EINTR) { perror("epoll_wait"); return false; }
+    for (int i = 0; i < n && fd_ >= 0; i++) {
+        if (ev[i].data.fd == fd_) {
+            if ((ev[i].events & EPOLLOUT) && !flush()) return false;
+            if ((ev[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) && !readPort()) return false;
+            continue;
+        }
+        for (size_t w = 0; w < watches_.size(); w++)
+            if (watches_[w].fd == ev[i].data.fd) { watches_[w].ready(); break; }
+    }
+    expire(nowUs());
+    return fd_ >= 0;
+}
+
+// ── Requests ─────────────────────────────────────────────────────────
+
+void M6Client::requestAsync(const std::string& cmd, ReplyFn done, int timeoutMs, const std::string& expect) {
+    const int64_t now = nowUs();
+    pending_.push_back(Pending{expect.empty() ? defaultExpect(cmd) : expect, now,
+                               now + (int64_t)timeoutMs * 1000, std::move(done)});
+    if (!sendCommand(cmd)) {
+        Pending p = std::move(pending_.back());
+        pending_.pop_back();
+        if (p.done) p.done(false, std::string(), 0);
+    }
+}
+
+std::string M6Client::request(const std::string& cmd, int timeoutMs, const std::string& expect) {
+    bool done = false;
+    std::string reply;
+    requestAsync(cmd, [&](bool ok, const std::string& line, int64_t) {
+        done = true;
+        if (ok) reply = line;
+    }, timeoutMs, expect);
+    while (!done && run(timeoutMs)) {}
+    return reply;
+}
+
+// FINGERPRINT:<mac>,fw=<v>,proto=<n>,platform=<id>,caps=<a+b>
+bool M6Client::handshake(M6DeviceInfo* info, int telHz, int timeoutMs) {
+    const std::string r = request("FINGERPRINT?", timeoutMs);
+    if (!startsWith(r, "FINGERPRINT:")) return false;
+    M6DeviceInfo d;
+    size_t k = strlen("FINGERPRINT:");
+    bool first = true;
+    while (k <= r.size()) {
+        size_t e = r.find(',', k);
+        if (e == std::string::npos) e = r.size();
+        const std::string f = r.substr(k, e - k);
+        if (first)                          d.mac = f;
+        else if (startsWith(f, "fw="))       d.fw = f.substr(3);
+        else if (startsWith(f, "proto="))    d.proto = atoi(f.c_str() + 6);
+        else if (startsWith(f, "platform=")) d.platform = f.substr(9);
+        else if (startsWith(f, "caps="))     d.caps = f.substr(5);
+        first = false;
+        k = e + 1;
+    }
+    if (info) *info = d;
+    if (telHz > 0 && !startsWith(request("TELRATE:" + std::to_string(telHz), timeoutMs), "TELRATE:"))
+        return false;
+    return true;
+}
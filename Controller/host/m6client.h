@@ -0,0 +1,152 @@
+// m6client.h — Host client for the controller's COBS serial protocol (Linux)
+//
+// One class for everything a host integration needs to talk to the device
+// (or mini6dof_sim's pty): non-blocking serial I/O on an epoll set, COBS
+// framing without intermediate copies, typed motion senders for CH_DATA /
+// CH_DATA_RAW, decoded TEL / TEL2 telemetry, and command requests matched
+// to their CH_RESP line. Wire formats are the firmware's own headers
+// (cobs.h, tel2.h); the command strings are process_data() in main.cpp.
+//
+//   M6Client c;
+//   c.open("/dev/ttyUSB0");                 // or the sim's --link path
+//   M6DeviceInfo dev;
+//   c.handshake(&dev);                      // FINGERPRINT?
+//   c.onTel2 = [](const Tel2Sample& s) { ... };
+//   c.request("TEL2:0x41,1");               // reply line, or "" on timeout
+//   for (;;) { c.sendRaw(v); c.run(4); }
+//
+// Single-threaded: every callback runs inside run() and may send or
+// requestAsync(), but not call run() / request() again. Received frames are
+// decoded in place in the RX buffer; the pointers handed to onFrame are valid
+// until the callback returns. Motion frames are latest-wins: when the TX
+// backlog is above txLimit (the port can't keep up) a new motion frame is
+// dropped and counted rather than queued behind stale ones. Commands always
+// queue.
+#pragma once
+
+#include "cobs.h"
+#include "tel2.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct M6DeviceInfo {
+    std::string mac, fw, platform, caps;
+    int         proto = 0;
+    bool hasCap(const char* cap) const;    // `cap` is one of caps= (raw, or a+b / a|b lists)
+};
+
+// COBS_CH_TEL: 12 × float32 LE, servo angles then positions.
+struct M6Telemetry {
+    float angles[6];
+    float positions[6];
+};
+
+struct M6ClientStats {
+    uint64_t rxBytes = 0, txBytes = 0;
+    uint64_t rxFrames = 0, txFrames = 0;
+    uint64_t badFrames = 0;        // COBS decode error or empty frame
+    uint64_t rxOverflow = 0;       // frame longer than the RX buffer, skipped
+    uint64_t txDropped = 0;        // motion frames dropped on a full backlog
+    uint64_t timeouts = 0;         // requests without a reply
+    size_t   txPeak = 0;           // TX backlog high-water mark, bytes
+};
+
+class M6Client {
+public:
+    // Handlers; any left empty just drops its frames.
+    std::function<void(const Tel2Sample&)>                  onTel2;
+    std::function<void(const M6Telemetry&)>                 onTel;
+    std::function<void(const std::string&)>                 onResponse;   // unsolicited CH_RESP lines
+    std::function<void(const std::string&)>                 onLog;        // CH_LOG lines
+    std::function<void(uint8_t ch, const uint8_t*, int)>    onFrame;      // any other channel
+
+    // Reply to requestAsync(): ok = false on timeout (line empty).
+    typedef std::function<void(bool ok, const std::string& line, int64_t rttUs)> ReplyFn;
+
+    size_t txLimit = 4096;         // backlog above which motion frames are dropped
+
+    M6Client();
+    ~M6Client();
+    M6Client(const M6Client&) = delete;
+    M6Client& operator=(const M6Client&) = delete;
+
+    // Raw 8N1 at `baud` (ignored by a pty), O_NONBLOCK. Sends one delimiter
+    // first to terminate any half frame left in the device's decoder.
+    bool open(const std::string& path, int baud = 921600);
+    void close();
+    bool isOpen() const { return fd_ >= 0; }
+    int  fd() const { return fd_; }
+    // The epoll set itself: readable whenever run(0) has work, so a program
+    // driving several devices can nest every client's set in its own.
+    int  pollFd() const { return ep_; }
+
+    // Add another fd (timerfd, eventfd, socket) to the same epoll set;
+    // `ready` runs from run() when it becomes readable.
+    bool watch(int fd, std::function<void()> ready);
+
+    // One epoll_wait (timeoutMs: 0 = poll, -1 = block): read and dispatch
+    // frames, flush queued TX, expire requests, run watched fds. Returns
+    // false when the port is gone (EOF / error).
+    bool run(int timeoutMs);
+
+    // ── Senders ─────────────────────────────────────────────────────────
+    // Encode straight into the TX queue and write as much as the port takes.
+    bool sendFrame(uint8_t ch, const void* payload, int len, bool motion = false);
+    bool sendBaked(const uint16_t counts[6]);    // COBS_CH_DATA, 6 × u16 LE
+    bool sendRaw(const float v[6]);              // COBS_CH_DATA_RAW, 6 × f32 LE
+    bool sendCommand(const std::string& cmd);    // COBS_CH_CMD, no reply tracking
+
+    // ── Requests ────────────────────────────────────────────────────────
+    // The reply is the first CH_RESP line that starts with `expect`, or an
+    // "ERR:" line while this is the oldest request outstanding. Default
+    // `expect`: the command up to its first ':', '?' or '=', plus ':' —
+    // "FINGERPRINT?" -> "FINGERPRINT:", "TEL2:0x41" -> "TEL2:". Commands the
+    // firmware does not know are silent and time out.
+    void requestAsync(const std::string& cmd, ReplyFn done, int timeoutMs = 1000,
+                      const std::string& expect = std::string());
+    // Runs the loop until the reply arrives; returns it, "" on timeout.
+    std::string request(const std::string& cmd, int timeoutMs = 1000,
+                        const std::string& expect = std::string());
+    size_t pending() const { return pending_.size(); }
+
+    // FINGERPRINT?, parsed. TELRATE:N too when telHz > 0.
+    bool handshake(M6DeviceInfo* info, int telHz = 0, int timeoutMs = 1000);
+
+    const M6ClientStats& stats() const { return stats_; }
+    size_t txBacklog() const { return tx_.size() - txHead_; }
+
+    static int64_t nowUs();        // CLOCK_MONOTONIC, the clock of every *Us here
+
+private:
+    struct Pending {
+        std::string expect;
+        int64_t     sentUs, deadlineUs;
+        ReplyFn     done;
+    };
+    struct Watch {
+        int                   fd;
+        std::function<void()> ready;
+    };
+
+    int fd_ = -1, ep_ = -1;
+    bool wantOut_ = false;
+    std::vector<uint8_t> rx_;      // COBS bytes; frames decoded in place
+    size_t rxLen_ = 0;
+    bool   rxSkip_ = false;        // discarding an oversize frame up to its delimiter
+    std::vector<uint8_t> tx_;      // encoded frames, [txHead_, size) unsent
+    size_t txHead_ = 0;
+    std::deque<Pending> pending_;
+    std::vector<Watch> watches_;
+    M6ClientStats stats_;
+
+    bool readPort();
+    bool flush();
+    void armOut(bool on);
+    void dispatch(const uint8_t* f, int len);
+    void onLine(const std::string& line);
+    void expire(int64_t now);
+};
@@ -0,0 +1,99 @@
+// m6p3enc.h — M6P3 block encoder (host only; format + decoder: include/m6p3.h)
+//
+// Integer samples in, packed file out: per block and channel, the residual
+// of the 2-tap prediction is zigzag-mapped and Rice-coded with the k that
+// minimizes that channel's bits. Used by `m6ptool compress` (sequences) and
+// mini6dof_replay (golden duty streams).
+//
+// Samples are integers, so M6P2 (float32) input is lossy: the caller
+// quantizes each channel to int16 with scale = channel peak / 32767, i.e.
+// a step of peak/32767 and an error of at most half a step per sample.
+// Baked counts go through unchanged (lossless). `m6ptool compress` refuses
+// raw input unless --lossy is given and prints the step and max error.
+//
+//   std::vector<uint8_t> img = m6p3_encode(info, q, scale, log2);
+#pragma once
+
+#include "m6p3.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+struct M6p3BitWriter {
+    std::vector<uint8_t>& out;
+    uint64_t acc = 0;
+    int      n   = 0;
+
+    explicit M6p3BitWriter(std::vector<uint8_t>& o) : out(o) {}
+    void put(uint32_t v, int bits) {          // bits <= 32, MSB first
+        if (!bits) return;
+        acc = (acc << bits) | (v & (uint32_t)((1ull << bits) - 1));
+        n += bits;
+        while (n >= 8) { out.push_back((uint8_t)(acc >> (n - 8))); n -= 8; }
+    }
+    void rice(uint32_t zz, int k) {
+        uint32_t q = zz >> k;
+        if (q < M6P3_RICE_ESC) {
+            put((1u << (q + 1)) - 2, (int)q + 1);   // q ones, then a zero
+            put(zz, k);
+        } else {
+            put((1u << M6P3_RICE_ESC) - 1, M6P3_RICE_ESC);
+            put(zz, M6P3_RAW_BITS);
+        }
+    }
+    void align() { if (n) put(0, 8 - n); }
+};
+
+// `q` is [info.count][6]: baked counts as-is, or raw values already divided
+// by `scale` (1.0 for baked). Returns header + payload with crc32@52 set.
+inline std::vector<uint8_t> m6p3_encode(M6pInfo info, const std::vector<int32_t>& q,
+                                        const float scale[6], int log2) {
+    const uint32_t B = 1u << log2;
+    const uint32_t nblocks = (info.count + B - 1) / B;
+
+    std::vector<uint8_t> pay(M6P3_SCALES_SIZE + 4 * (size_t)nblocks);
+    memcpy(pay.data(), scale, M6P3_SCALES_SIZE);
+    for (uint32_t b = 0; b < nblocks; b++) {
+        const uint32_t f0 = b * B, f1 = std::min(info.count, f0 + B);
+        m6p_wr32(pay.data() + M6P3_SCALES_SIZE + 4 * b, (uint32_t)pay.size());
+
+        // Residuals per channel, then the k that minimizes each channel's bits.
+        std::vector<uint32_t> zz[6];
+        uint8_t k[6];
+        for (int c = 0; c < 6; c++) {
+            int32_t x1 = q[(size_t)f0 * 6 + c], x2 = x1;
+            for (uint32_t n = f0 + 1; n < f1; n++) {
+                int32_t x = q[(size_t)n * 6 + c];
+                zz[c].push_back(m6p3_zigzag(x - (2 * x1 - x2)));
+                x2 = x1; x1 = x;
+            }
+            uint64_t best = UINT64_MAX;
+            for (int kk = 0; kk <= M6P3_K_MAX; kk++) {
+                uint64_t bits = 0;
+                for (uint32_t z : zz[c]) bits += m6p3_rice_bits(z, kk);
+                if (bits < best) { best = bits; k[c] = (uint8_t)kk; }
+            }
+        }
+        for (int c = 0; c < 6; c++) {
+            pay.push_back((uint8_t)q[(size_t)f0 * 6 + c]);
+            pay.push_back((uint8_t)(q[(size_t)f0 * 6 + c] >> 8));
+        }
+        for (int c = 0; c < 6; c++) pay.push_back(k[c]);
+        M6p3BitWriter bw(pay);
+        for (size_t i = 0; i + f0 + 1 < f1; i++)
+            for (int c = 0; c < 6; c++) bw.rice(zz[c][i], k[c]);
+        bw.align();
+    }
+
+    info.packed     = 1;
+    info.block_log2 = (uint8_t)log2;
+    info.payload    = (uint32_t)pay.size();
+    if (info.kind == M6P_KIND_RAW) info.bits = 16;
+    info.crc32 = m6p_crc32_update(0, pay.data(), pay.size());
+    std::vector<uint8_t> out(M6P_HEADER_SIZE + pay.size());
+    m6p_write_header(&info, out.data());
+    memcpy(out.data() + M6P_HEADER_SIZE, pay.data(), pay.size());
+    return out;
+}
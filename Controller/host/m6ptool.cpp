@@ -0,0 +1,1185 @@
+// m6ptool.cpp — host-side .m6p toolkit: inspect, verify, bake, convert, compress, pack, upload, scope
+//
+// Built from the same stewart-core + MiniPlatform.h sources the firmware
+// runs, so a bake here is the exact on-device cue chain:
+//   M6P2 raw frame -> processInputFilter -> processMotionCueing ->
+//   mcaApplyOutputStage -> surge/sway swap -> counts  (cueRawFrame)
+// evaluated at the servo (cue loop) rate with the file frames interpolated
+// by the same phase accumulator CueTask plays DEMO with.
+//
+//   m6ptool inspect <file.m6p>...
+//   m6ptool verify  [--ik] [--servo-rate HZ] <file.m6p>...
+//   m6ptool bake    [--preset NAME] [--servo-rate HZ] [--out-rate HZ] [--bits N]
+//                   [--jobs N] [--clip-report DIR] -o <out.m6p|outdir> <in.m6p>...
+//   m6ptool convert [--rate HZ] [--format baked|raw] [--bits N] [--name S] <in> -o <out>
+//   m6ptool compress [--block N] [--lossy] <in.m6p> -o <out.m6p>   (-> M6P3, m6p3.h)
+//   m6ptool pack    [--capacity BYTES] -o <seq.bin> <file.m6p>...
+//   m6ptool list    <seq.bin>
+//   m6ptool upload  [--port DEV] [--baud N] [--chunk BYTES] <file.m6p>
+//   m6ptool scope   [--port DEV] [--baud N] [-o trace.csv]      (SCOPE:DUMP, scope.h)
+//   m6ptool servosim [--servo-rate HZ] [--tau MS] [--vmax DPS] [--lead G]
+//                   [--plant-tau MS] [--plant-vmax DPS] [-o track.csv] <file.m6p>
+//                                                               (servodyn.h)
+//
+// `pack` builds an M6PL image for the `seq` partition (m6p.h); flash it with
+//   esptool.py write_flash 0x210000 seq.bin
+// or append single files to a running device with `upload` (COBS, no reflash).
+// Batch bakes are spread over a thread pool (--jobs, default = hardware
+// threads); every job owns its own filter/IK state.
+
+#include "m6p.h"
+#include "m6p3.h"
+#include "m6p3enc.h"
+#include "cobs.h"
+#include "scope.h"
+#include "servodyn.h"
+#include "MiniPlatform.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+
+// ── File I/O ─────────────────────────────────────────────────────────
+
+struct SeqFile {
+    std::string          path;
+    std::vector<uint8_t> bytes;
+    M6pInfo              info{};
+    int                  status = M6P_ERR_SHORT;
+
+    std::vector<uint8_t> plain;       // M6P3: payload decoded to M6P1/M6P2 frames
+
+    const uint8_t* payload() const { return bytes.data() + M6P_HEADER_SIZE; }   // what crc32@52 covers
+    const uint8_t* frames() const { return info.packed ? plain.data() : payload(); }
+};
+
+bool readFile(const std::string& path, std::vector<uint8_t>& out) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) return false;
+    out.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool writeFile(const std::string& path, const std::vector<uint8_t>& data) {
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f) return false;
+    f.write(reinterpret_cast<const char*>(data.data()), (std::streamsize)data.size());
+    return (bool)f;
+}
+
+bool loadSeq(const std::string& path, SeqFile& seq) {
+    seq.path = path;
+    if (!readFile(path, seq.bytes)) {
+        fprintf(stderr, "%s: cannot read\n", path.c_str());
+        return false;
+    }
+    seq.status = seq.bytes.size() < M6P_HEADER_SIZE
+        ? M6P_ERR_SHORT
+        : m6p_parse_header(seq.bytes.data(), seq.bytes.size(), &seq.info);
+    if (seq.status == M6P_OK && seq.info.packed) {
+        // Expand M6P3 once so every command sees plain frames (CRC first: the
+        // decoder stays in bounds on garbage, but its output would be noise).
+        seq.status = m6p_check_crc(&seq.info, seq.payload());
+        M6p3Decoder d;
+        if (seq.status == M6P_OK) seq.status = m6p3_init(&d, seq.bytes.data(), &seq.info);
+        if (seq.status == M6P_OK) {
+            seq.plain.resize((size_t)seq.info.count * seq.info.stride);
+            for (uint32_t n = 0; n < seq.info.count; n++) {
+                float v[6];
+                m6p3_next(&d, v);
+                uint8_t* p = seq.plain.data() + (size_t)n * seq.info.stride;
+                if (seq.info.kind == M6P_KIND_RAW) memcpy(p, v, sizeof(v));
+                else for (int c = 0; c < 6; c++) m6p_wr16(p + 2 * c, (uint16_t)v[c]);
+            }
+        }
+    }
+    return true;
+}
+
+// Decode one frame to floats (M6P1 counts or M6P2 percent).
+void decodeFrame(const M6pInfo& info, const uint8_t* p, float out[6]) {
+    if (info.kind == M6P_KIND_RAW) {
+        memcpy(out, p, 6 * sizeof(float));
+    } else {
+        for (int i = 0; i < 6; i++) out[i] = (float)m6p_rd16(p + i * 2);
+    }
+}
+
+const char* kindName(const M6pInfo& info) {
+    return info.packed ? "M6P3" : info.kind == M6P_KIND_RAW ? "M6P2" : "M6P1";
+}
+
+std::vector<uint8_t> buildFile(M6pInfo info, const std::vector<uint8_t>& frames) {
+    info.crc32 = m6p_crc32_update(0, frames.data(), frames.size());
+    std::vector<uint8_t> out(M6P_HEADER_SIZE + frames.size());
+    m6p_write_header(&info, out.data());
+    if (!frames.empty()) memcpy(out.data() + M6P_HEADER_SIZE, frames.data(), frames.size());
+    return out;
+}
+
+std::string stem(const std::string& path) {
+    size_t s = path.find_last_of('/');
+    std::string base = (s == std::string::npos) ? path : path.substr(s + 1);
+    size_t d = base.find_last_of('.');
+    return d == std::string::npos ? base : base.substr(0, d);
+}
+
+bool endsWith(const std::string& s, const char* suffix) {
+    size_t n = strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+int presetByName(const char* name) {
+    for (int i = 0; i < MCA_PRESET_COUNT; i++)
+        if (strcmp(name, mcaPresetName(i)) == 0) return i;
+    return -1;
+}
+
+// ── Device replay: the CueTask chain at the servo rate ───────────────
+// Frames are interpolated at servoRate like CueTask's playback sampler (at
+// 1×: tick k sits k·rate/servoRate frames in, exactly). RAW
+// frames go through cueRawFrame(); baked frames straight to mapRawToPosition.
+// Every tick then runs the per-time slew + IK and flags servos whose angle
+// is NaN or beyond SERVO_MAX_ANGLE_RAD (what driveServos() would clamp).
+
+struct ReplayOptions {
+    int      preset    = MCA_MODERATE;
+    uint16_t servoRate = 50;     // cueLoopHz (SERVO:RATE)
+    uint16_t outRate   = 0;      // 0 = keep the input frame rate
+    uint16_t bits      = 12;     // M6P1 output depth / count domain for RAW
+    bool     keepAngles = false; // record per-tick servo angles (servosim)
+};
+
+struct ReplayResult {
+    std::vector<uint8_t> bakedFrames;    // M6P1 frames (RAW input only)
+    uint32_t             outCount = 0;
+    std::vector<uint8_t> clipMask;       // per INPUT frame, bit i = servo i clipped
+    std::vector<float>   clipPeakDeg;    // per input frame, worst |angle| in degrees
+    uint32_t             clippedFrames = 0;
+    uint32_t             clipPerServo[6] = {0};
+    std::vector<float>   angles;         // 6 per tick, clamped as driveServos (keepAngles)
+    uint64_t             ticks = 0;
+    double               seconds = 0.0;
+};
+
+void replay(const SeqFile& seq, const ReplayOptions& opt, bool bake, ReplayResult& res) {
+    const M6pInfo& info = seq.info;
+    const bool raw = (info.kind == M6P_KIND_RAW);
+
+    StewartConfig geom;
+    initMiniDefaults(&geom);
+    AxisScaleConfig scales;
+    computeAxisScalesFromGeometry(&scales, &geom, AXIS_SCALE_MARGIN);
+
+    // Same bring-up as app_main + applyServoRate + setSource on device.
+    MotionCueingConfig mca;
+    InputFilterConfig  inputFilter;
+    initMotionCueing(&mca, (float)opt.servoRate);
+    initInputFilter(&inputFilter, (float)opt.servoRate);
+    setMotionCueingPreset(&mca, opt.preset);
+    mcaUpdateSampleRate(&mca, (float)opt.servoRate);
+    inputFilterUpdateSampleRate(&inputFilter, (float)opt.servoRate);
+    resetMotionCueing(&mca);
+    resetInputFilter(&inputFilter);
+
+    const uint16_t bits   = raw ? opt.bits : info.bits;
+    const float    maxRaw = (float)((1 << bits) - 1);
+    const uint16_t outRate = opt.outRate ? opt.outRate : info.rate;
+    const uint64_t ticks  = ((uint64_t)info.count * opt.servoRate + info.rate - 1) / info.rate;
+    uint64_t outCount = (uint64_t)info.count * outRate / info.rate;
+    if (outCount == 0) outCount = 1;
+
+    res.clipMask.assign(info.count, 0);
+    res.clipPeakDeg.assign(info.count, 0.0f);
+    if (bake && raw) res.bakedFrames.reserve(outCount * M6P_STRIDE_BAKED);
+
+    float smoothed[6] = {0};
+    bool  smoothInit  = false;
+    const float dt = 1.0f / (float)opt.servoRate;
+    uint64_t outIdx = 0;
+
+    for (uint64_t k = 0; k < ticks; k++) {
+        uint64_t ph = k * info.rate;
+        uint32_t fi = (uint32_t)(ph / opt.servoRate);
+        if (fi >= info.count) fi = info.count - 1;
+        uint32_t fn = fi + 1 < info.count ? fi + 1 : fi;
+        float u = (float)(ph % opt.servoRate) / (float)opt.servoRate;
+
+        float ch[6], nx[6], counts[6], pos[6];
+        decodeFrame(info, seq.frames() + (size_t)fi * info.stride, ch);
+        decodeFrame(info, seq.frames() + (size_t)fn * info.stride, nx);
+        for (int i = 0; i < 6; i++) ch[i] += (nx[i] - ch[i]) * u;
+        if (raw) cueRawFrame(&inputFilter, &mca, ch, maxRaw, counts);
+        else     memcpy(counts, ch, sizeof(counts));
+        mapRawToPosition(counts, &scales, maxRaw, pos);
+
+        // slewRateLimit()
+        if (!smoothInit) { memcpy(smoothed, pos, sizeof(smoothed)); smoothInit = true; }
+        const float maxStep = SLEW_RATE_MAX_PER_S * dt;
+        for (int i = 0; i < 6; i++) {
+            float d = pos[i] - smoothed[i];
+            if (d > maxStep) d = maxStep; else if (d < -maxStep) d = -maxStep;
+            smoothed[i] += d;
+        }
+
+        float angles[6];
+        calculateAllServoAngles(smoothed, &geom, angles);
+        for (int i = 0; i < 6; i++) {
+            bool bad = std::isnan(angles[i]) || std::isinf(angles[i]);
+            float mag = bad ? INFINITY : std::fabs(angles[i]);
+            if (bad || mag > SERVO_MAX_ANGLE_RAD) res.clipMask[fi] |= (uint8_t)(1u << i);
+            float deg = bad ? 999.0f : mag * (float)(180.0 / M_PI);
+            if (deg > res.clipPeakDeg[fi]) res.clipPeakDeg[fi] = deg;
+            if (opt.keepAngles) {
+                float a = bad ? 0.0f : angles[i];
+                if (a > SERVO_MAX_ANGLE_RAD) a = SERVO_MAX_ANGLE_RAD;
+                if (a < -SERVO_MAX_ANGLE_RAD) a = -SERVO_MAX_ANGLE_RAD;
+                res.angles.push_back(a);
+            }
+        }
+
+        // Output frames sampled from this tick (duplicates if outRate > servoRate).
+        while (bake && raw && outIdx < outCount &&
+               outIdx * opt.servoRate / outRate == k) {
+            for (int i = 0; i < 6; i++) {
+                float c = std::round(counts[i]);
+                if (c < 0.0f) c = 0.0f;
+                if (c > maxRaw) c = maxRaw;
+                uint16_t v = (uint16_t)c;
+                res.bakedFrames.push_back((uint8_t)v);
+                res.bakedFrames.push_back((uint8_t)(v >> 8));
+            }
+            outIdx++;
+        }
+    }
+    res.ticks    = ticks;
+    res.outCount = (uint32_t)outIdx;
+    for (uint32_t f = 0; f < info.count; f++) {
+        if (!res.clipMask[f]) continue;
+        res.clippedFrames++;
+        for (int i = 0; i < 6; i++)
+            if (res.clipMask[f] & (1u << i)) res.clipPerServo[i]++;
+    }
+}
+
+void printClipSummary(const SeqFile& seq, const ReplayResult& r) {
+    printf("  ik: %u/%u frames clipped (%.2f%%)  per servo: %u %u %u %u %u %u\n",
+           r.clippedFrames, seq.info.count, 100.0 * r.clippedFrames / seq.info.count,
+           r.clipPerServo[0], r.clipPerServo[1], r.clipPerServo[2],
+           r.clipPerServo[3], r.clipPerServo[4], r.clipPerServo[5]);
+}
+
+bool writeClipReport(const std::string& path, const SeqFile& seq, const ReplayResult& r) {
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) return false;
+    fprintf(f, "frame,time_s,servo_mask,peak_deg\n");
+    for (uint32_t i = 0; i < seq.info.count; i++) {
+        if (!r.clipMask[i]) continue;
+        fprintf(f, "%u,%.3f,0x%02X,%.2f\n", i, (double)i / seq.info.rate,
+                r.clipMask[i], r.clipPeakDeg[i]);
+    }
+    fclose(f);
+    return true;
+}
+
+// ── Commands ─────────────────────────────────────────────────────────
+
+int cmdInspect(const std::vector<std::string>& files) {
+    int rc = 0;
+    for (const auto& path : files) {
+        SeqFile seq;
+        if (!loadSeq(path, seq)) { rc = 1; continue; }
+        const M6pInfo& in = seq.info;
+        printf("%s: %zu bytes\n", path.c_str(), seq.bytes.size());
+        if (seq.status != M6P_OK && seq.status != M6P_ERR_TRUNCATED) {
+            printf("  invalid: %s\n", m6p_strerror(seq.status));
+            rc = 1;
+            continue;
+        }
+        printf("  %s v%u  \"%s\"\n",
+               in.packed ? (in.kind == M6P_KIND_RAW ? "M6P3 (packed raw -> M6P2 frames)"
+                                                     : "M6P3 (packed baked -> M6P1 frames)")
+                         : (in.kind == M6P_KIND_RAW ? "M6P2 (raw float32, pre-cue)"
+                                                     : "M6P1 (baked uint16)"),
+               in.version, in.name);
+        if (in.packed)
+            printf("  block=%u frames  payload=%u B  %.2f bits/sample (%.1fx vs plain)\n",
+                   1u << in.block_log2, in.payload, 8.0 * in.payload / (6.0 * in.count),
+                   (double)in.count * in.stride / in.payload);
+        printf("  rate=%u Hz  frames=%u (%.1f s)  loop@%u  stride=%u",
+               in.rate, in.count, (double)in.count / in.rate, in.loop_point, in.stride);
+        if (in.kind == M6P_KIND_BAKED) printf("  bits=%u", in.bits);
+        printf("\n");
+        if (seq.status == M6P_ERR_TRUNCATED) {
+            printf("  TRUNCATED: need %zu frame bytes, have %zu\n",
+                   m6p_data_size(&in), seq.bytes.size() - M6P_HEADER_SIZE);
+            rc = 1;
+            continue;
+        }
+        uint32_t crc = m6p_crc32_update(0, seq.payload(), m6p_data_size(&in));
+        printf("  crc32@52=%08X computed=%08X %s\n", in.crc32, crc, crc == in.crc32 ? "OK" : "MISMATCH");
+        if (crc != in.crc32) rc = 1;
+
+        float lo[6], hi[6]; double sum[6] = {0};
+        for (int i = 0; i < 6; i++) { lo[i] = INFINITY; hi[i] = -INFINITY; }
+        for (uint32_t f = 0; f < in.count; f++) {
+            float v[6];
+            decodeFrame(in, seq.frames() + (size_t)f * in.stride, v);
+            for (int i = 0; i < 6; i++) {
+                lo[i] = std::min(lo[i], v[i]); hi[i] = std::max(hi[i], v[i]); sum[i] += v[i];
+            }
+        }
+        static const char* axis[6] = {"ch0", "ch1", "ch2", "ch3", "ch4", "ch5"};
+        for (int i = 0; i < 6; i++)
+            printf("  %s  min=%10.3f  max=%10.3f  mean=%10.3f\n", axis[i], lo[i], hi[i], sum[i] / in.count);
+    }
+    return rc;
+}
+
+int cmdVerify(const std::vector<std::string>& files, bool ik, const ReplayOptions& opt) {
+    int bad = 0;
+    for (const auto& path : files) {
+        SeqFile seq;
+        if (!loadSeq(path, seq)) { bad++; continue; }
+        int st = seq.status;
+        if (st == M6P_OK) st = m6p_check_crc(&seq.info, seq.payload());
+        printf("%s: %s\n", path.c_str(), st == M6P_OK ? "OK" : m6p_strerror(st));
+        if (st != M6P_OK) { bad++; continue; }
+        if (ik) {
+            ReplayResult r;
+            replay(seq, opt, false, r);
+            printClipSummary(seq, r);
+        }
+    }
+    return bad ? 1 : 0;
+}
+
+struct BakeJob {
+    std::string  in, out, clipReport;
+    SeqFile      seq;
+    ReplayResult res;
+    bool         ok = false;
+    std::string  err;
+    double       seconds = 0.0;
+};
+
+void runBake(BakeJob& job, const ReplayOptions& opt) {
+    if (!loadSeq(job.in, job.seq)) { job.err = "cannot read"; return; }
+    int st = job.seq.status;
+    if (st == M6P_OK) st = m6p_check_crc(&job.seq.info, job.seq.payload());
+    if (st != M6P_OK) { job.err = m6p_strerror(st); return; }
+    if (job.seq.info.kind != M6P_KIND_RAW) { job.err = "bake needs M6P2 (raw) input"; return; }
+
+    auto t0 = std::chrono::steady_clock::now();
+    replay(job.seq, opt, true, job.res);
+    job.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    M6pInfo out{};
+    out.kind    = M6P_KIND_BAKED;
+    out.version = 1;
+    out.rate    = opt.outRate ? opt.outRate : job.seq.info.rate;
+    out.count   = job.res.outCount;
+    out.loop_point = (uint32_t)((uint64_t)job.seq.info.loop_point * out.rate / job.seq.info.rate);
+    if (out.loop_point >= out.count) out.loop_point = 0;
+    out.bits    = opt.bits;
+    memcpy(out.name, job.seq.info.name, sizeof(out.name));
+    if (!writeFile(job.out, buildFile(out, job.res.bakedFrames))) { job.err = "cannot write " + job.out; return; }
+    if (!job.clipReport.empty() && !writeClipReport(job.clipReport, job.seq, job.res)) {
+        job.err = "cannot write " + job.clipReport;
+        return;
+    }
+    job.ok = true;
+}
+
+int cmdBake(const std::vector<std::string>& files, const std::string& out,
+            const std::string& clipDir, unsigned jobs, const ReplayOptions& opt) {
+    if (files.empty() || out.empty()) {
+        fprintf(stderr, "bake: need -o and at least one input\n");
+        return 2;
+    }
+    const bool single = files.size() == 1 && endsWith(out, ".m6p");
+    std::vector<BakeJob> work(files.size());
+    for (size_t i = 0; i < files.size(); i++) {
+        work[i].in  = files[i];
+        work[i].out = single ? out
+                             : out + "/" + stem(files[i]) + "_" + mcaPresetName(opt.preset) + "_" +
+                                   std::to_string(opt.servoRate) + "hz.m6p";
+        if (!clipDir.empty())
+            work[i].clipReport = clipDir + "/" + stem(files[i]) + "_clip.csv";
+    }
+
+    if (jobs == 0) jobs = std::max(1u, std::thread::hardware_concurrency());
+    jobs = std::min<unsigned>(jobs, (unsigned)work.size());
+
+    std::atomic<size_t> next{0};
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < jobs; t++)
+        pool.emplace_back([&] {
+            for (size_t i; (i = next.fetch_add(1)) < work.size();) runBake(work[i], opt);
+        });
+    for (auto& th : pool) th.join();
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    uint64_t frames = 0, ticks = 0;
+    int failed = 0;
+    for (auto& j : work) {
+        if (!j.ok) {
+            printf("%s: FAILED (%s)\n", j.in.c_str(), j.err.c_str());
+            failed++;
+            continue;
+        }
+        frames += j.seq.info.count;
+        ticks  += j.res.ticks;
+        printf("%s -> %s: %u -> %u frames @ %u Hz, preset=%s servo=%u Hz, %.0f frames/s\n",
+               j.in.c_str(), j.out.c_str(), j.seq.info.count, j.res.outCount,
+               opt.outRate ? opt.outRate : j.seq.info.rate, mcaPresetName(opt.preset),
+               opt.servoRate, j.seconds > 0 ? j.seq.info.count / j.seconds : 0.0);
+        printClipSummary(j.seq, j.res);
+    }
+    printf("bake: %zu file(s), %u thread(s), %llu frames / %llu ticks in %.3f s -> %.0f frames/s, %.0f ticks/s\n",
+           work.size(), jobs, (unsigned long long)frames, (unsigned long long)ticks, wall,
+           wall > 0 ? frames / wall : 0.0, wall > 0 ? ticks / wall : 0.0);
+    return failed ? 1 : 0;
+}
+
+int cmdConvert(const std::string& in, const std::string& out, uint16_t rate,
+               const std::string& format, uint16_t bits, const std::string& name) {
+    if (endsWith(in, ".m6p") && endsWith(out, ".csv")) {
+        SeqFile seq;
+        if (!loadSeq(in, seq)) return 1;
+        if (seq.status != M6P_OK) { fprintf(stderr, "%s: %s\n", in.c_str(), m6p_strerror(seq.status)); return 1; }
+        FILE* f = fopen(out.c_str(), "w");
+        if (!f) { fprintf(stderr, "%s: cannot write\n", out.c_str()); return 1; }
+        const M6pInfo& i = seq.info;
+        fprintf(f, "# %s rate=%u bits=%u loop=%u name=%s\n",
+                i.kind == M6P_KIND_RAW ? "M6P2" : "M6P1", i.rate, i.bits, i.loop_point, i.name);
+        for (uint32_t n = 0; n < i.count; n++) {
+            float v[6];
+            decodeFrame(i, seq.frames() + (size_t)n * i.stride, v);
+            if (i.kind == M6P_KIND_RAW)
+                fprintf(f, "%.6g,%.6g,%.6g,%.6g,%.6g,%.6g\n", v[0], v[1], v[2], v[3], v[4], v[5]);
+            else
+                fprintf(f, "%.0f,%.0f,%.0f,%.0f,%.0f,%.0f\n", v[0], v[1], v[2], v[3], v[4], v[5]);
+        }
+        fclose(f);
+        printf("%s -> %s: %u frames\n", in.c_str(), out.c_str(), i.count);
+        return 0;
+    }
+    if (endsWith(in, ".csv") && endsWith(out, ".m6p")) {
+        std::ifstream f(in);
+        if (!f) { fprintf(stderr, "%s: cannot read\n", in.c_str()); return 1; }
+        const bool raw = (format == "raw");
+        std::vector<uint8_t> frames;
+        std::string line;
+        uint32_t count = 0;
+        while (std::getline(f, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            float v[6];
+            if (sscanf(line.c_str(), "%f,%f,%f,%f,%f,%f", &v[0], &v[1], &v[2], &v[3], &v[4], &v[5]) != 6) continue;
+            if (raw) {
+                const uint8_t* p = reinterpret_cast<const uint8_t*>(v);
+                frames.insert(frames.end(), p, p + sizeof(v));
+            } else {
+                const float maxRaw = (float)((1 << bits) - 1);
+                for (int i = 0; i < 6; i++) {
+                    float c = std::min(std::max(std::round(v[i]), 0.0f), maxRaw);
+                    uint16_t u = (uint16_t)c;
+                    frames.push_back((uint8_t)u);
+                    frames.push_back((uint8_t)(u >> 8));
+                }
+            }
+            count++;
+        }
+        if (!count) { fprintf(stderr, "%s: no frames\n", in.c_str()); return 1; }
+        M6pInfo info{};
+        info.kind    = raw ? M6P_KIND_RAW : M6P_KIND_BAKED;
+        info.version = 1;
+        info.rate    = rate;
+        info.count   = count;
+        info.bits    = bits;
+        snprintf(info.name, sizeof(info.name), "%s", name.empty() ? stem(in).c_str() : name.c_str());
+        if (!writeFile(out, buildFile(info, frames))) { fprintf(stderr, "%s: cannot write\n", out.c_str()); return 1; }
+        printf("%s -> %s: %u frames @ %u Hz (%s)\n", in.c_str(), out.c_str(), count, rate, raw ? "M6P2" : "M6P1");
+        return 0;
+    }
+    fprintf(stderr, "convert: supported directions are .m6p -> .csv and .csv -> .m6p\n");
+    return 2;
+}
+
+// ── M6P3 compress (encoder: m6p3enc.h, format + decoder: m6p3.h) ─────
+
+// Integer samples [count][6]: baked counts as-is; raw floats quantized to
+// int16 with a per-channel scale (full range = channel peak). `maxErr` gets
+// the worst raw quantization error.
+std::vector<int32_t> quantize(const SeqFile& seq, float scale[6], float& maxErr) {
+    const M6pInfo& info = seq.info;
+    std::vector<int32_t> q((size_t)info.count * 6);
+    maxErr = 0.0f;
+    float peak[6] = {0};
+    for (uint32_t n = 0; n < info.count; n++) {
+        float v[6];
+        decodeFrame(info, seq.frames() + (size_t)n * info.stride, v);
+        for (int c = 0; c < 6; c++) peak[c] = std::max(peak[c], std::fabs(v[c]));
+    }
+    for (int c = 0; c < 6; c++)
+        scale[c] = (info.kind == M6P_KIND_RAW && peak[c] > 0.0f) ? peak[c] / 32767.0f : 1.0f;
+    for (uint32_t n = 0; n < info.count; n++) {
+        float v[6];
+        decodeFrame(info, seq.frames() + (size_t)n * info.stride, v);
+        for (int c = 0; c < 6; c++) {
+            int32_t x = (int32_t)std::lrint(v[c] / scale[c]);
+            if (info.kind == M6P_KIND_RAW) x = std::min(std::max(x, -32767), 32767);
+            q[(size_t)n * 6 + c] = x;
+            maxErr = std::max(maxErr, std::fabs(x * scale[c] - v[c]));
+        }
+    }
+    return q;
+}
+
+std::vector<uint8_t> encodeM6p3(const SeqFile& seq, int log2, float& maxErr) {
+    float scale[6];
+    std::vector<int32_t> q = quantize(seq, scale, maxErr);
+    return m6p3_encode(seq.info, q, scale, log2);
+}
+
+int cmdCompress(const std::string& in, const std::string& out, int log2, bool lossy) {
+    if (log2 < M6P3_LOG2_MIN || log2 > M6P3_LOG2_MAX) {
+        fprintf(stderr, "--block must be a power of two, %d-%d\n", 1 << M6P3_LOG2_MIN, 1 << M6P3_LOG2_MAX);
+        return 2;
+    }
+    SeqFile seq;
+    if (!loadSeq(in, seq)) return 1;
+    int st = seq.status;
+    if (st == M6P_OK) st = m6p_check_crc(&seq.info, seq.payload());
+    if (st != M6P_OK) { fprintf(stderr, "%s: %s\n", in.c_str(), m6p_strerror(st)); return 1; }
+    if (seq.info.kind == M6P_KIND_RAW && !lossy) {
+        fprintf(stderr, "%s: M6P2 float32 frames are quantized to int16 (step = channel peak / 32767);"
+                        " pass --lossy to accept\n", in.c_str());
+        return 2;
+    }
+
+    float maxErr = 0.0f;
+    std::vector<uint8_t> img = encodeM6p3(seq, log2, maxErr);
+
+    // Round trip through the device decoder: exact for baked, within the
+    // quantization step for raw. Also times it (streaming, one pass).
+    SeqFile back;
+    back.bytes = img;
+    m6p_parse_header(img.data(), img.size(), &back.info);
+    M6p3Decoder d;
+    if (m6p3_init(&d, img.data(), &back.info) != M6P_OK) { fprintf(stderr, "compress: self-check failed\n"); return 1; }
+    double worst = 0.0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < seq.info.count; n++) {
+        float v[6], ref[6];
+        m6p3_next(&d, v);
+        decodeFrame(seq.info, seq.frames() + (size_t)n * seq.info.stride, ref);
+        for (int c = 0; c < 6; c++) worst = std::max(worst, (double)std::fabs(v[c] - ref[c]));
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count()
+              / seq.info.count;
+    if (worst > maxErr * 1.001 + 1e-6) { fprintf(stderr, "compress: round trip error %g\n", worst); return 1; }
+    if (!writeFile(out, img)) { fprintf(stderr, "%s: cannot write\n", out.c_str()); return 1; }
+
+    size_t plainBytes = M6P_HEADER_SIZE + m6p_data_size(&seq.info);
+    printf("%s -> %s: %s %u frames, %zu -> %zu B (%.1fx, %.2f bits/sample), block %u\n",
+           in.c_str(), out.c_str(), kindName(seq.info), seq.info.count, plainBytes, img.size(),
+           (double)plainBytes / img.size(), 8.0 * (img.size() - M6P_HEADER_SIZE) / (6.0 * seq.info.count),
+           1u << log2);
+    if (seq.info.kind == M6P_KIND_RAW) {
+        float scale[6];
+        memcpy(scale, img.data() + M6P_HEADER_SIZE, sizeof(scale));
+        printf("  raw quantization (lossy, int16): step");
+        for (int c = 0; c < 6; c++) printf(" %.3g", scale[c]);
+        printf(", max error %.3g\n", maxErr);
+    }
+    printf("  host decode: %.0f ns/frame (incl. verify)\n", ns);
+    return 0;
+}
+
+// Default = `seq` size in partitions.csv.
+#define SEQ_PARTITION_SIZE  0x1F0000u
+
+int cmdPack(const std::vector<std::string>& files, const std::string& out, uint32_t capacity) {
+    if (files.empty() || out.empty()) { fprintf(stderr, "pack: need -o and at least one input\n"); return 2; }
+    if (files.size() > M6PL_MAX_ENTRIES) { fprintf(stderr, "pack: at most %d files\n", M6PL_MAX_ENTRIES); return 2; }
+    std::vector<uint8_t> img(M6PL_DATA_OFFSET, 0xFF);
+    m6pl_write_dir(img.data());
+    for (size_t i = 0; i < files.size(); i++) {
+        SeqFile seq;
+        if (!loadSeq(files[i], seq)) return 1;
+        int st = seq.status;
+        if (st == M6P_OK) st = m6p_check_crc(&seq.info, seq.payload());
+        if (st != M6P_OK) { fprintf(stderr, "%s: %s\n", files[i].c_str(), m6p_strerror(st)); return 1; }
+        M6plEntry e;
+        e.state  = M6PL_STATE_VALID;
+        e.offset = (uint32_t)img.size();
+        e.length = (uint32_t)(M6P_HEADER_SIZE + m6p_data_size(&seq.info));   // drop trailing bytes
+        memcpy(e.header, seq.bytes.data(), M6P_HEADER_SIZE);
+        if ((uint64_t)e.offset + e.length > capacity) {
+            fprintf(stderr, "pack: %s does not fit (%u + %u > %u)\n", files[i].c_str(), e.offset, e.length, capacity);
+            return 1;
+        }
+        img.insert(img.end(), seq.bytes.begin(), seq.bytes.begin() + e.length);
+        img.resize(m6pl_align((uint32_t)img.size()), 0xFF);
+        m6pl_write_entry(&e, img.data() + M6PL_DIR_HDR_SIZE + i * M6PL_ENTRY_SIZE);
+        printf("  [%zu] @0x%06X %8u B  \"%s\"\n", i + 1, e.offset, e.length, seq.info.name);
+    }
+    if (!writeFile(out, img)) { fprintf(stderr, "%s: cannot write\n", out.c_str()); return 1; }
+    printf("%s: %zu file(s), %zu / %u bytes (entry 0 on device = embedded file, if built in)\n",
+           out.c_str(), files.size(), img.size(), capacity);
+    return 0;
+}
+
+int cmdList(const std::string& path) {
+    std::vector<uint8_t> img;
+    if (!readFile(path, img) || img.size() < M6PL_DATA_OFFSET) { fprintf(stderr, "%s: cannot read\n", path.c_str()); return 1; }
+    int slots = m6pl_parse_dir(img.data());
+    if (!slots) { printf("%s: no M6PL directory (blank)\n", path.c_str()); return 1; }
+    int bad = 0, n = 0;
+    for (int i = 0; i < slots; i++) {
+        M6plEntry e;
+        const uint8_t* raw = img.data() + M6PL_DIR_HDR_SIZE + i * M6PL_ENTRY_SIZE;
+        m6pl_read_entry(raw, &e);
+        if (e.state == M6PL_STATE_EMPTY) {
+            if (std::all_of(raw, raw + M6PL_ENTRY_SIZE, [](uint8_t b) { return b == 0xFF; })) break;
+            printf("  slot %d: torn commit (no state word)\n", i);
+            continue;
+        }
+        if (e.state != M6PL_STATE_VALID) { printf("  slot %d: deleted\n", i); continue; }
+        n++;
+        M6pInfo info;
+        int st = ((uint64_t)e.offset + e.length > img.size()) ? M6P_ERR_TRUNCATED
+               : memcmp(img.data() + e.offset, e.header, M6P_HEADER_SIZE) ? M6P_ERR_MAGIC
+               : m6p_parse_header(img.data() + e.offset, e.length, &info);
+        if (st == M6P_OK) st = m6p_check_crc(&info, img.data() + e.offset + M6P_HEADER_SIZE);
+        m6p_parse_header(e.header, 0, &info);
+        printf("  [%d] @0x%06X %8u B  %s %u Hz %u frames  \"%s\"  %s\n", n, e.offset, e.length,
+               kindName(info), info.rate, info.count, info.name, m6p_strerror(st));
+        if (st != M6P_OK) bad++;
+    }
+    return bad ? 1 : 0;
+}
+
+// ── Serial upload (COBS_CH_UPLOAD, M6PU protocol in m6p.h) ───────────
+// Streams a file into the device's `seq` partition at line rate: chunks are
+// pipelined up to the device's advertised credit (its free buffer space)
+// instead of stop-and-wait, NAKs rewind to the offset the device expects
+// (go-back-N), and rerunning the same command after an interruption resumes
+// from the device's last 64 KB checkpoint.
+
+struct SerialLink {
+    int                              fd = -1;
+    std::vector<uint8_t>             acc;      // COBS bytes since the last delimiter
+    std::deque<std::vector<uint8_t>> frames;   // decoded, not yet consumed
+
+    ~SerialLink() { if (fd >= 0) close(fd); }
+
+    bool open(const std::string& path, int baud) {
+        speed_t sp;
+        switch (baud) {
+            case 115200: sp = B115200; break;
+            case 230400: sp = B230400; break;
+#ifdef B460800
+            case 460800: sp = B460800; break;
+#endif
+#ifdef B921600
+            case 921600: sp = B921600; break;
+#endif
+            default: fprintf(stderr, "unsupported baud %d\n", baud); return false;
+        }
+        fd = ::open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (fd < 0) { perror(path.c_str()); return false; }
+        termios t{};
+        tcgetattr(fd, &t);
+        cfmakeraw(&t);
+        cfsetispeed(&t, sp);
+        cfsetospeed(&t, sp);
+        t.c_cflag |= CLOCAL | CREAD;
+        if (tcsetattr(fd, TCSANOW, &t) != 0) { perror("tcsetattr"); return false; }
+        tcflush(fd, TCIOFLUSH);
+        // Delimiter first: terminates whatever half frame an interrupted
+        // session left in the device's decoder.
+        const uint8_t sync = 0x00;
+        return write(fd, &sync, 1) == 1;
+    }
+
+    bool send(uint8_t ch, const uint8_t* payload, size_t len) {
+        std::vector<uint8_t> raw(1 + len), enc(COBS_MAX_ENC_SIZE(1 + len) + 1);
+        raw[0] = ch;
+        if (len) memcpy(raw.data() + 1, payload, len);
+        int n = cobs_encode(raw.data(), (int)raw.size(), enc.data());
+        enc[n++] = 0x00;
+        for (int off = 0; off < n;) {
+            ssize_t w = write(fd, enc.data() + off, n - off);
+            if (w < 0) {
+                if (errno == EAGAIN) { pollfd p{fd, POLLOUT, 0}; poll(&p, 1, 100); continue; }
+                if (errno == EINTR) continue;
+                perror("write");
+                return false;
+            }
+            off += (int)w;
+        }
+        return true;
+    }
+
+    // Read whatever arrives within `timeoutMs` and split it into frames.
+    void pump(int timeoutMs) {
+        pollfd p{fd, POLLIN, 0};
+        if (poll(&p, 1, timeoutMs) <= 0) return;
+        uint8_t buf[1024];
+        ssize_t n;
+        while ((n = read(fd, buf, sizeof(buf))) > 0) {
+            for (ssize_t i = 0; i < n; i++) {
+                if (buf[i] != 0x00) { acc.push_back(buf[i]); continue; }
+                std::vector<uint8_t> f(acc.size());
+                int d = acc.empty() ? 0 : cobs_decode(acc.data(), (int)acc.size(), f.data());
+                acc.clear();
+                if (d > 0) { f.resize(d); frames.push_back(std::move(f)); }
+            }
+        }
+    }
+
+    // Next payload on `ch`; RESP/LOG text is echoed, anything else dropped.
+    bool recv(std::vector<uint8_t>& payload, int timeoutMs, uint8_t ch = COBS_CH_UPLOAD) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        for (;;) {
+            while (!frames.empty()) {
+                std::vector<uint8_t> f = std::move(frames.front());
+                frames.pop_front();
+                if (f[0] == ch) { payload.assign(f.begin() + 1, f.end()); return true; }
+                if (f[0] == COBS_CH_RESP || f[0] == COBS_CH_LOG) {
+                    std::string s(f.begin() + 1, f.end());
+                    while (!s.empty() && (s.back() == '\n' || s.back() == '\r')) s.pop_back();
+                    printf("  device: %s\n", s.c_str());
+                }
+            }
+            int left = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+                           deadline - std::chrono::steady_clock::now()).count();
+            if (left < 0) return false;
+            pump(left);
+            if (frames.empty() && left == 0) return false;
+        }
+    }
+};
+
+struct UploadAck {
+    uint8_t  op = 0, status = 0;
+    uint32_t value = 0, credit = 0;
+};
+
+bool parseAck(const std::vector<uint8_t>& p, UploadAck& a) {
+    if (p.size() < M6PU_ACK_SIZE || !(p[0] & M6PU_ACK)) return false;
+    a.op     = p[0] & ~M6PU_ACK;
+    a.status = p[1];
+    a.value  = m6p_rd32(p.data() + 2);
+    a.credit = m6p_rd32(p.data() + 6);
+    return true;
+}
+
+// Send `op` (payload `p`) and wait for its ack, skipping stray chunk acks.
+bool transact(SerialLink& link, const std::vector<uint8_t>& p, UploadAck& a, int timeoutMs) {
+    if (!link.send(COBS_CH_UPLOAD, p.data(), p.size())) return false;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    std::vector<uint8_t> r;
+    for (;;) {
+        int left = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+                       deadline - std::chrono::steady_clock::now()).count();
+        if (left <= 0 || !link.recv(r, left)) return false;
+        if (parseAck(r, a) && a.op == p[0]) return true;
+    }
+}
+
+int cmdUpload(const std::string& path, const std::string& port, int baud, unsigned chunk) {
+    SeqFile seq;
+    if (!loadSeq(path, seq)) return 1;
+    int st = seq.status;
+    if (st == M6P_OK) st = m6p_check_crc(&seq.info, seq.payload());
+    if (st != M6P_OK) { fprintf(stderr, "%s: %s\n", path.c_str(), m6p_strerror(st)); return 1; }
+    if (chunk < 64 || chunk > M6PU_CHUNK_MAX) { fprintf(stderr, "--chunk range 64-%d\n", M6PU_CHUNK_MAX); return 2; }
+    const uint32_t len = (uint32_t)(M6P_HEADER_SIZE + m6p_data_size(&seq.info));   // drop trailing bytes
+    const uint8_t* file = seq.bytes.data();
+
+    SerialLink link;
+    if (!link.open(port, baud)) return 1;
+
+    std::vector<uint8_t> begin(M6PU_BEGIN_SIZE);
+    begin[0] = M6PU_OP_BEGIN;
+    m6p_wr32(begin.data() + 1, len);
+    memcpy(begin.data() + 5, file, M6P_HEADER_SIZE);
+    UploadAck a;
+    bool ok = transact(link, begin, a, 2000);
+    if (ok && a.status == M6PU_ERR_STATE) {
+        // A previous upload was cut off mid-session: close it (keeps its checkpoint).
+        std::vector<uint8_t> abort(1, M6PU_OP_ABORT);
+        UploadAck b;
+        transact(link, abort, b, 5000);
+        ok = transact(link, begin, a, 2000);
+    }
+    if (!ok) { fprintf(stderr, "upload: no response from %s (firmware with upload support?)\n", port.c_str()); return 1; }
+    if (a.status != M6PU_OK) { fprintf(stderr, "upload: BEGIN rejected: %s\n", m6pu_strerror(a.status)); return 1; }
+    if (a.value) printf("%s: resuming at %u / %u bytes\n", path.c_str(), a.value, len);
+
+    const uint32_t start = a.value;
+    uint32_t acked = a.value, sent = a.value, limit = a.value + a.credit;
+    uint32_t rewoundTo = UINT32_MAX;
+    unsigned retrans = 0, timeouts = 0, lastPct = 101;
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<uint8_t> pkt(M6PU_CHUNK_HDR + chunk), r;
+    while (acked < len) {
+        // Fill the window.
+        while (sent < len && sent < limit) {
+            uint32_t n = std::min<uint32_t>({chunk, len - sent, limit - sent});
+            pkt.resize(M6PU_CHUNK_HDR + n);
+            pkt[0] = M6PU_OP_CHUNK;
+            m6p_wr32(pkt.data() + 1, sent);
+            m6p_wr32(pkt.data() + 5, m6p_crc32_update(0, file + sent, n));
+            memcpy(pkt.data() + M6PU_CHUNK_HDR, file + sent, n);
+            if (!link.send(COBS_CH_UPLOAD, pkt.data(), pkt.size())) return 1;
+            sent += n;
+        }
+        if (!link.recv(r, 2000)) {
+            if (++timeouts > 5) { fprintf(stderr, "\nupload: device stopped acking at %u\n", acked); return 1; }
+            sent = acked;   // lost frames: resend everything unacked
+            retrans++;
+            continue;
+        }
+        if (!parseAck(r, a) || a.op != M6PU_OP_CHUNK) continue;
+        timeouts = 0;
+        if (a.status == M6PU_OK) {
+            if (a.value > acked) acked = a.value;
+            if (a.value > rewoundTo) rewoundTo = UINT32_MAX;   // past the rewind point
+            limit = a.value + a.credit;
+        } else if (a.status == M6PU_ERR_FLASH || a.status == M6PU_ERR_STATE) {
+            fprintf(stderr, "\nupload: device error at %u: %s\n", a.value, m6pu_strerror(a.status));
+            return 1;
+        } else {
+            // CRC / OFFSET / BUSY: go back to what the device expects. Chunks
+            // already in flight past it NAK with the same offset — ignore those.
+            limit = a.value + a.credit;
+            if (a.value != rewoundTo) {
+                rewoundTo = a.value;
+                acked = a.value;
+                sent  = a.value;
+                retrans++;
+            }
+        }
+        unsigned pct = (unsigned)((uint64_t)acked * 100 / len);
+        if (pct != lastPct) {
+            double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            printf("\r  %3u%%  %u / %u bytes  %.1f KB/s", pct, acked, len,
+                   s > 0 ? (acked - start) / 1024.0 / s : 0.0);
+            fflush(stdout);
+            lastPct = pct;
+        }
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    printf("\n");
+
+    std::vector<uint8_t> end(1, M6PU_OP_END);
+    if (!transact(link, end, a, 15000)) { fprintf(stderr, "upload: no END ack\n"); return 1; }
+    if (a.status != M6PU_OK) { fprintf(stderr, "upload: not committed: %s\n", m6pu_strerror(a.status)); return 1; }
+    double bits = 10.0 * (len - start) / (secs > 0 ? secs : 1);   // 8N1 = 10 bits/byte
+    printf("%s -> library #%u: %u bytes in %.1fs (%.1f KB/s, %.0f%% of %d baud, %u rewinds)\n",
+           path.c_str(), a.value, len - start, secs, (len - start) / 1024.0 / (secs > 0 ? secs : 1),
+           100.0 * bits / baud, baud, retrans);
+    printf("  PLAY:SELECT=%u to play it\n", a.value);
+    return 0;
+}
+
+// ── Scope readout (SCOPE:DUMP on COBS_CH_SCOPE, layout in scope.h) ──
+// Pulls a finished device capture and writes one CSV row per cue-loop tick,
+// time relative to the trigger sample.
+int cmdScope(const std::string& port, int baud, const std::string& out) {
+    SerialLink link;
+    if (!link.open(port, baud)) return 1;
+    const char* dump = "SCOPE:DUMP";
+    if (!link.send(COBS_CH_CMD, (const uint8_t*)dump, strlen(dump))) return 1;
+
+    std::vector<uint8_t> p;
+    if (!link.recv(p, 2000, COBS_CH_SCOPE) || p.size() < SCOPE_HDR_SIZE || p[0] != SCOPE_OP_HDR) {
+        fprintf(stderr, "scope: no capture from %s (SCOPE:STATUS must say done)\n", port.c_str());
+        return 1;
+    }
+    if (p[1] != 1 || m6p_rd16(&p[2]) != sizeof(ScopeSample)) {
+        fprintf(stderr, "scope: sample layout v%u/%uB, this tool reads v1/%uB\n",
+                p[1], m6p_rd16(&p[2]), (unsigned)sizeof(ScopeSample));
+        return 1;
+    }
+    const unsigned count = m6p_rd16(&p[4]), trigIdx = m6p_rd16(&p[6]), rate = m6p_rd16(&p[8]);
+    ScopeTrigger trig;
+    trig.type = p[10]; trig.field = p[11]; trig.axis = p[12]; trig.edge = p[13];
+    memcpy(&trig.level, &p[14], 4);
+
+    std::vector<ScopeSample> samples(count);
+    std::vector<bool> have(count, false);
+    uint32_t crc = 0, endCrc = 0;
+    for (bool done = false; !done;) {
+        if (!link.recv(p, 2000, COBS_CH_SCOPE)) { fprintf(stderr, "scope: dump stalled\n"); return 1; }
+        if (p[0] == SCOPE_OP_DATA && p.size() >= 3) {
+            unsigned first = m6p_rd16(&p[1]), k = (unsigned)((p.size() - 3) / sizeof(ScopeSample));
+            for (unsigned j = 0; j < k && first + j < count; j++) {
+                memcpy(&samples[first + j], &p[3 + j * sizeof(ScopeSample)], sizeof(ScopeSample));
+                have[first + j] = true;
+            }
+            crc = m6p_crc32_update(crc, &p[3], k * sizeof(ScopeSample));
+        } else if (p[0] == SCOPE_OP_END && p.size() >= 7) {
+            endCrc = m6p_rd32(&p[3]);
+            done = true;
+        }
+    }
+    if (std::count(have.begin(), have.end(), true) != (long)count || crc != endCrc) {
+        fprintf(stderr, "scope: dump corrupt (frames lost or CRC mismatch) — rerun SCOPE:DUMP\n");
+        return 1;
+    }
+
+    FILE* f = out.empty() ? stdout : fopen(out.c_str(), "w");
+    if (!f) { perror(out.c_str()); return 1; }
+    fprintf(f, "# trigger %s", scope_trig_name(trig.type));
+    if (trig.type == SCOPE_TRIG_THR)
+        fprintf(f, " %s[%u] %s %g", scope_field_name(trig.field), trig.axis,
+                trig.edge == SCOPE_EDGE_RISE ? "rise" : trig.edge == SCOPE_EDGE_FALL ? "fall" : "both",
+                (double)trig.level);
+    fprintf(f, ", %u samples @ %u Hz, trigger at %u\n", count, rate, trigIdx);
+    fprintf(f, "t_ms,tick,flags,fmt,src");
+    for (int fld = 0; fld < SCOPE_FIELD_COUNT; fld++)
+        for (int a = 0; a < 6; a++) fprintf(f, ",%s%d", scope_field_name(fld), a);
+    fprintf(f, "\n");
+    for (unsigned i = 0; i < count; i++) {
+        const ScopeSample& x = samples[i];
+        fprintf(f, "%.3f,%u,0x%04x,%u,%u", rate ? ((double)i - trigIdx) * 1000.0 / rate : 0.0,
+                x.tick, x.flags, x.fmt, x.src);
+        for (int fld = 0; fld < SCOPE_FIELD_COUNT; fld++)
+            for (int a = 0; a < 6; a++) fprintf(f, ",%.6g", (double)scope_value(&x, fld, a));
+        fprintf(f, "\n");
+    }
+    if (f != stdout) {
+        fclose(f);
+        printf("%s: %u samples (%.0f ms pre / %.0f ms post trigger)\n", out.c_str(), count,
+               rate ? trigIdx * 1000.0 / rate : 0.0, rate ? (count - 1 - trigIdx) * 1000.0 / rate : 0.0);
+    }
+    return 0;
+}
+
+// ── servosim: servo lag with / without feed-forward compensation ─────
+// Replays the sequence through the device chain to get the intended servo
+// angles per CueTask tick, then drives a simulated servo ("plant": first-order
+// lag + speed cap, integrated in PLANT_SUBSTEPS steps per tick under a held
+// pulse) twice: with the plain angles and with servo_dyn_compensate(). The
+// plant defaults to the compensator's own model; --plant-* tests a mismatch.
+// Error = plant angle at the end of a tick minus that tick's intended angle.
+
+const int PLANT_SUBSTEPS = 20;
+
+struct TrackStats {
+    double sumSq[6] = {0}, maxAbs[6] = {0};
+    double rms(int i, uint64_t n) const { return n ? std::sqrt(sumSq[i] / n) : 0.0; }
+    void add(int i, double e) {
+        sumSq[i] += e * e;
+        if (std::fabs(e) > maxAbs[i]) maxAbs[i] = std::fabs(e);
+    }
+};
+
+int cmdServoSim(const std::string& path, ReplayOptions opt, const ServoDynParams& model,
+                const ServoDynParams& plant, const std::string& csvPath) {
+    SeqFile seq;
+    if (!loadSeq(path, seq)) return 1;
+    int st = seq.status;
+    if (st == M6P_OK) st = m6p_check_crc(&seq.info, seq.payload());
+    if (st != M6P_OK) { fprintf(stderr, "%s: %s\n", path.c_str(), m6p_strerror(st)); return 1; }
+
+    opt.keepAngles = true;
+    ReplayResult r;
+    replay(seq, opt, false, r);
+    const uint64_t ticks = r.angles.size() / 6;
+    const float dt = 1.0f / (float)opt.servoRate;
+    const float R2D = (float)(180.0 / M_PI);
+
+    FILE* csv = nullptr;
+    if (!csvPath.empty()) {
+        csv = fopen(csvPath.c_str(), "w");
+        if (!csv) { fprintf(stderr, "cannot write %s\n", csvPath.c_str()); return 1; }
+        fprintf(csv, "t");
+        for (const char* g : {"want", "plain", "comp", "cmd"})
+            for (int i = 0; i < 6; i++) fprintf(csv, ",%s%d", g, i);
+        fprintf(csv, "\n");
+    }
+
+    ServoDynState comp[6] = {};
+    float armPlain[6], armComp[6];
+    for (int i = 0; i < 6; i++) armPlain[i] = armComp[i] = r.angles[i];
+    TrackStats plain, withComp;
+    for (uint64_t k = 0; k < ticks; k++) {
+        const float* want = &r.angles[k * 6];
+        float cmd[6];
+        for (int i = 0; i < 6; i++) {
+            cmd[i] = servo_dyn_compensate(&model, &comp[i], want[i], dt);
+            if (cmd[i] > SERVO_MAX_ANGLE_RAD) cmd[i] = SERVO_MAX_ANGLE_RAD;
+            if (cmd[i] < -SERVO_MAX_ANGLE_RAD) cmd[i] = -SERVO_MAX_ANGLE_RAD;
+            for (int s = 0; s < PLANT_SUBSTEPS; s++) {
+                servo_dyn_step(&plant, &armPlain[i], want[i], dt / PLANT_SUBSTEPS);
+                servo_dyn_step(&plant, &armComp[i], cmd[i], dt / PLANT_SUBSTEPS);
+            }
+            plain.add(i, (armPlain[i] - want[i]) * R2D);
+            withComp.add(i, (armComp[i] - want[i]) * R2D);
+        }
+        if (csv) {
+            fprintf(csv, "%.4f", k * dt);
+            for (int i = 0; i < 6; i++) fprintf(csv, ",%.3f", want[i] * R2D);
+            for (int i = 0; i < 6; i++) fprintf(csv, ",%.3f", armPlain[i] * R2D);
+            for (int i = 0; i < 6; i++) fprintf(csv, ",%.3f", armComp[i] * R2D);
+            for (int i = 0; i < 6; i++) fprintf(csv, ",%.3f", cmd[i] * R2D);
+            fprintf(csv, "\n");
+        }
+    }
+    if (csv) fclose(csv);
+
+    printf("%s: %llu ticks @ %u Hz (%.1f s)\n", path.c_str(), (unsigned long long)ticks,
+           opt.servoRate, ticks * dt);
+    printf("  model tau=%.1fms vmax=%.0fdeg/s lead=%.2f   plant tau=%.1fms vmax=%.0fdeg/s\n",
+           model.tau_s * 1000.0f, model.vmax * R2D, model.lead, plant.tau_s * 1000.0f, plant.vmax * R2D);
+    printf("  servo   rms plain   rms comp   max plain   max comp   (deg)\n");
+    double allPlain = 0, allComp = 0;
+    for (int i = 0; i < 6; i++) {
+        printf("  %5d   %9.3f  %9.3f   %9.3f  %9.3f\n", i, plain.rms(i, ticks), withComp.rms(i, ticks),
+               plain.maxAbs[i], withComp.maxAbs[i]);
+        allPlain += plain.sumSq[i];
+        allComp  += withComp.sumSq[i];
+    }
+    allPlain = ticks ? std::sqrt(allPlain / (6.0 * ticks)) : 0.0;
+    allComp  = ticks ? std::sqrt(allComp / (6.0 * ticks)) : 0.0;
+    printf("  all     %9.3f  %9.3f   rms error %+.1f%%\n", allPlain, allComp,
+           allPlain > 0 ? 100.0 * (allComp - allPlain) / allPlain : 0.0);
+    return 0;
+}
+
+void usage() {
+    fprintf(stderr,
+        "usage:\n"
+        "  m6ptool inspect <file.m6p>...\n"
+        "  m6ptool verify  [--ik] [--servo-rate HZ] [--preset NAME] <file.m6p>...\n"
+        "  m6ptool bake    [--preset NAME] [--servo-rate HZ] [--out-rate HZ] [--bits N]\n"
+        "                  [--jobs N] [--clip-report DIR] -o <out.m6p|outdir> <in.m6p>...\n"
+        "  m6ptool convert [--rate HZ] [--format baked|raw] [--bits N] [--name S] <in> -o <out>\n"
+        "  m6ptool compress [--block N] [--lossy] <in.m6p> -o <out.m6p>\n"
+        "  m6ptool pack    [--capacity BYTES] -o <seq.bin> <file.m6p>...\n"
+        "  m6ptool list    <seq.bin>\n"
+        "  m6ptool upload  [--port DEV] [--baud N] [--chunk BYTES] <file.m6p>\n"
+        "  m6ptool scope   [--port DEV] [--baud N] [-o trace.csv]\n"
+        "  m6ptool servosim [--servo-rate HZ] [--tau MS] [--vmax DPS] [--lead G]\n"
+        "                  [--plant-tau MS] [--plant-vmax DPS] [-o track.csv] <file.m6p>\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) { usage(); return 2; }
+    const std::string cmd = argv[1];
+
+    ReplayOptions opt;
+    std::vector<std::string> files;
+    std::string out, clipDir, format = "raw", name;
+    unsigned jobs = 0;
+    uint16_t rate = 50;
+    bool ik = false, lossy = false;
+    uint32_t capacity = SEQ_PARTITION_SIZE;
+    std::string port = "/dev/ttyUSB0";
+    int baud = 921600;
+    unsigned chunk = M6PU_CHUNK_MAX;
+    unsigned block = 256;
+    ServoDynParams model;
+    servo_dyn_defaults(&model);
+    model.lead = 1.0f;
+    float plantTau = -1.0f, plantVmax = -1.0f;   // < 0 = same as the model
+
+    for (int i = 2; i < argc; i++) {
+        std::string a = argv[i];
+        auto val = [&](const char* what) -> const char* {
+            if (i + 1 >= argc) { fprintf(stderr, "%s needs a value\n", what); exit(2); }
+            return argv[++i];
+        };
+        if      (a == "-o")             out = val("-o");
+        else if (a == "--preset") {
+            const char* p = val("--preset");
+            opt.preset = presetByName(p);
+            if (opt.preset < 0) { fprintf(stderr, "unknown preset '%s'\n", p); return 2; }
+        }
+        else if (a == "--servo-rate")   opt.servoRate = (uint16_t)atoi(val("--servo-rate"));
+        else if (a == "--out-rate")     opt.outRate = (uint16_t)atoi(val("--out-rate"));
+        else if (a == "--bits")         opt.bits = (uint16_t)atoi(val("--bits"));
+        else if (a == "--jobs" || a == "-j") jobs = (unsigned)atoi(val("--jobs"));
+        else if (a == "--clip-report")  clipDir = val("--clip-report");
+        else if (a == "--ik")           ik = true;
+        else if (a == "--lossy")        lossy = true;
+        else if (a == "--rate")         rate = (uint16_t)atoi(val("--rate"));
+        else if (a == "--format")       format = val("--format");
+        else if (a == "--name")         name = val("--name");
+        else if (a == "--capacity")     capacity = (uint32_t)strtoul(val("--capacity"), nullptr, 0);
+        else if (a == "--port")         port = val("--port");
+        else if (a == "--baud")         baud = atoi(val("--baud"));
+        else if (a == "--chunk")        chunk = (unsigned)atoi(val("--chunk"));
+        else if (a == "--block")        block = (unsigned)atoi(val("--block"));
+        else if (a == "--tau")          model.tau_s = (float)atof(val("--tau")) / 1000.0f;
+        else if (a == "--vmax")         model.vmax = (float)(atof(val("--vmax")) * M_PI / 180.0);
+        else if (a == "--lead")         model.lead = (float)atof(val("--lead"));
+        else if (a == "--plant-tau")    plantTau = (float)atof(val("--plant-tau")) / 1000.0f;
+        else if (a == "--plant-vmax")   plantVmax = (float)(atof(val("--plant-vmax")) * M_PI / 180.0);
+        else if (!a.empty() && a[0] == '-') { usage(); return 2; }
+        else files.push_back(a);
+    }
+    if (opt.servoRate < 20 || opt.servoRate > 333) { fprintf(stderr, "--servo-rate range 20-333\n"); return 2; }
+    if (opt.bits < 8 || opt.bits > 16) { fprintf(stderr, "--bits range 8-16\n"); return 2; }
+
+    if (cmd == "inspect") return cmdInspect(files);
+    if (cmd == "verify")  return cmdVerify(files, ik, opt);
+    if (cmd == "bake")    return cmdBake(files, out, clipDir, jobs, opt);
+    if (cmd == "pack")    return cmdPack(files, out, capacity);
+    if (cmd == "compress") {
+        if (files.size() != 1 || out.empty()) { usage(); return 2; }
+        int log2 = 0;
+        while ((1u << log2) < block) log2++;
+        if ((1u << log2) != block) log2 = -1;
+        return cmdCompress(files[0], out, log2, lossy);
+    }
+    if (cmd == "list")    { if (files.size() != 1) { usage(); return 2; } return cmdList(files[0]); }
+    if (cmd == "upload")  { if (files.size() != 1) { usage(); return 2; } return cmdUpload(files[0], port, baud, chunk); }
+    if (cmd == "scope")   { if (!files.empty()) { usage(); return 2; } return cmdScope(port, baud, out); }
+    if (cmd == "servosim") {
+        if (files.size() != 1) { usage(); return 2; }
+        if (model.tau_s < 0.0f || model.vmax <= 0.0f || model.lead < 0.0f || model.lead > SERVO_DYN_LEAD_MAX) {
+            fprintf(stderr, "--tau >= 0, --vmax > 0, --lead 0-%.1f\n", SERVO_DYN_LEAD_MAX);
+            return 2;
+        }
+        ServoDynParams plant = model;
+        if (plantTau >= 0.0f) plant.tau_s = plantTau;
+        if (plantVmax > 0.0f) plant.vmax = plantVmax;
+        return cmdServoSim(files[0], opt, model, plant, out);
+    }
+    if (cmd == "convert") {
+        if (files.size() != 1 || out.empty()) { usage(); return 2; }
+        if (format != "raw" && format != "baked") { fprintf(stderr, "--format raw|baked\n"); return 2; }
+        if (!rate) { fprintf(stderr, "--rate must be > 0\n"); return 2; }
+        return cmdConvert(files[0], out, rate, format, opt.bits, name);
+    }
+    usage();
+    return 2;
+}
@@ -0,0 +1,121 @@
+// mini6dof_sim.cpp — the controller firmware as a Linux process
+//
+// Builds the firmware's own main/ sources (COBS transport, command parser,
+// CueTask, playback, MCA, IK, sequence library, NVS write-behind) against
+// host/shim: FreeRTOS on std::thread, esp_timer on the steady clock, NVS in
+// a file, LEDC duties recorded, the `seq` partition in a file and UART0 on
+// a pseudo-terminal. BLE is not built. Anything that talks to the device
+// over serial (m6ptool upload/scope, the desktop app, scripts) can open the
+// pty instead — unthrottled by default, or paced with --baud.
+//
+//   mini6dof_sim [--link PATH] [--baud N] [--nvs FILE] [--seq FILE]
+//                [--pwm-log FILE] [--stats SEC] [--clock-ppm P] [--clock-offset-ms MS]
+//
+//   --link     symlink to the pty slave (e.g. /tmp/mini6dof), stable across runs
+//   --baud     pace UART TX at N baud (10 bits/byte); default unthrottled
+//   --nvs      settings file (loaded at start, rewritten on each commit)
+//   --seq      `seq` partition image (m6ptool pack output works as is)
+//   --pwm-log  CSV of every LEDC duty change: t_us,channel,duty
+//   --stats    every SEC seconds on stderr: UART bytes, duty updates, servo power
+//   --clock-ppm / --clock-offset-ms
+//              skew esp_timer and the tick against the host clock (a crystal
+//              P ppm fast, booted MS earlier) — several sims for SYNC:* tests
+//
+// Timing is the host's: CueTask keeps its period with absolute sleeps, but
+// *:BENCH cycle figures measure the host CPU (esp_cpu.h shim).
+
+#include "sim_hooks.h"
+#include "driver/gpio.h"
+#include "helpers.h"
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <chrono>
+
+extern "C" void app_main(void);
+
+namespace {
+
+FILE* g_pwmLog = nullptr;
+
+void usage() {
+    fprintf(stderr,
+        "usage: mini6dof_sim [--link PATH] [--baud N] [--nvs FILE] [--seq FILE]\n"
+        "                    [--pwm-log FILE] [--stats SEC] [--clock-ppm P] [--clock-offset-ms MS]\n");
+}
+
+// Ctrl-C: flush the PWM log and leave (NVS is already on disk per commit).
+void onSignal(int sig) {
+    (void)sig;
+    if (g_pwmLog) fflush(g_pwmLog);
+    _exit(0);
+}
+
+void statsLoop(int sec) {
+    uint64_t lastRx = 0, lastTx = 0, lastUpd = 0;
+    for (;;) {
+        std::this_thread::sleep_for(std::chrono::seconds(sec));
+        uint64_t rx, tx, drop;
+        shim_uart_stats(&rx, &tx, &drop);
+        const uint64_t upd = shim_ledc_updates();
+        fprintf(stderr, "sim: rx %.1f KB/s  tx %.1f KB/s (dropped %llu B)  duty updates %.0f/s  "
+                        "carrier %u Hz  servo power %s\n",
+                (rx - lastRx) / 1024.0 / sec, (tx - lastTx) / 1024.0 / sec, (unsigned long long)drop,
+                (double)(upd - lastUpd) / sec, (unsigned)shim_ledc_freq(),
+                gpio_get_level((gpio_num_t)SERVO_ENABLE_PIN) ? "on" : "off");
+        lastRx = rx; lastTx = tx; lastUpd = upd;
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const char* link = nullptr;
+    const char* nvsFile = nullptr;
+    const char* seqFile = nullptr;
+    const char* pwmFile = nullptr;
+    int baud = 0, statsSec = 0;
+    double clockPpm = 0.0, clockOffsetMs = 0.0;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string a = argv[i];
+        auto val = [&](const char* what) -> const char* {
+            if (i + 1 >= argc) { fprintf(stderr, "%s needs a value\n", what); exit(2); }
+            return argv[++i];
+        };
+        if      (a == "--link")    link = val("--link");
+        else if (a == "--baud")    baud = atoi(val("--baud"));
+        else if (a == "--nvs")     nvsFile = val("--nvs");
+        else if (a == "--seq")     seqFile = val("--seq");
+        else if (a == "--pwm-log") pwmFile = val("--pwm-log");
+        else if (a == "--stats")   statsSec = atoi(val("--stats"));
+        else if (a == "--clock-ppm")       clockPpm = atof(val("--clock-ppm"));
+        else if (a == "--clock-offset-ms") clockOffsetMs = atof(val("--clock-offset-ms"));
+        else { usage(); return 2; }
+    }
+
+    if (clockOffsetMs < 0.0) { usage(); return 2; }
+    if (clockPpm != 0.0 || clockOffsetMs > 0.0) shim_clock_skew((int64_t)(clockOffsetMs * 1000.0), clockPpm);
+    if (nvsFile && !shim_nvs_set_file(nvsFile)) return 1;
+    if (seqFile && !shim_partition_set_file(seqFile)) return 1;
+    if (pwmFile) {
+        g_pwmLog = fopen(pwmFile, "w");
+        if (!g_pwmLog) { perror(pwmFile); return 1; }
+        fprintf(g_pwmLog, "t_us,ch,duty\n");
+        shim_ledc_set_log(g_pwmLog);
+    }
+    const char* pty = shim_uart_open_pty(link, baud);
+    if (!pty) return 1;
+    fprintf(stderr, "mini6dof_sim: UART0 on %s%s%s\n", pty, link ? " <- " : "", link ? link : "");
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    if (statsSec > 0) std::thread(statsLoop, statsSec).detach();
+
+    app_main();                              // never returns (watchdog loop)
+    return 0;
+}
@@ -0,0 +1,237 @@
+// replay_golden.cpp — headless CueTask replay against golden LEDC duty streams
+//
+// Boots the firmware's own main/ sources (fw_harness.h) on the shim's virtual
+// clock, plays a .m6p through DEMO playback — the exact CueTask chain: sampler
+// / lookahead, input filter, MCA, output stage, slew, IK, servo lag
+// compensation, LEDC — and records the six servo duties after every tick. No
+// sleeping: time advances one servo period per tick, so a whole lap replays
+// in well under a second and every run is bit-for-bit repeatable.
+//
+//   mini6dof_replay [--rate HZ] [--seconds S] [--cmd LINE]... [--tol-us US]
+//                   [--golden FILE [--update]] [--csv FILE] <seq.m6p>
+//
+//   --rate     SERVO:RATE for the run (default: the boot rate, 50 Hz)
+//   --seconds  length of the run; default one pass of the sequence
+//   --cmd      serial command applied before playback (repeatable), e.g.
+//              --cmd MCA:AGGRESSIVE --cmd SERVO:DYN=30,570,1
+//   --golden   compare against this duty stream (max / RMS per servo, exit 1
+//              beyond --tol-us, default 1 µs of pulse width)
+//   --update   write the stream to --golden instead of comparing
+//   --csv      per-tick duties: tick,t_us,d0..d5
+//
+// Goldens are .m6p files (M6P3-packed M6P1, 16-bit, rate = servo rate, one
+// frame per tick), so `m6ptool inspect` reads them too. They depend on the
+// stewart-core commit they were made with, so none are checked in: make one
+// from your own checkout with --update. `cmake --build ... --target
+// replay_check` runs each host/replay/ fixture twice, run against run.
+
+#include "fw_harness.h"
+#include "sim_hooks.h"
+#include "m6p.h"
+#include "m6p3.h"
+#include "m6p3enc.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const double kDutyMax = 65535.0;   // LEDC_TIMER_MAX (16-bit timer, main.cpp)
+
+bool readFile(const std::string& path, std::vector<uint8_t>& out) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) return false;
+    out.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool writeFile(const std::string& path, const std::vector<uint8_t>& data) {
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f) return false;
+    f.write(reinterpret_cast<const char*>(data.data()), (std::streamsize)data.size());
+    return (bool)f;
+}
+
+std::string stem(const std::string& path) {
+    size_t s = path.find_last_of('/');
+    std::string base = (s == std::string::npos) ? path : path.substr(s + 1);
+    size_t d = base.find_last_of('.');
+    return d == std::string::npos ? base : base.substr(0, d);
+}
+
+// Duty stream -> golden .m6p (M6P3, one 16-bit frame per tick).
+std::vector<uint8_t> packGolden(const std::vector<uint16_t>& duty, uint32_t ticks, uint16_t rate,
+                                const std::string& name) {
+    M6pInfo info;
+    memset(&info, 0, sizeof(info));
+    info.kind   = M6P_KIND_BAKED;
+    info.rate   = rate;
+    info.count  = ticks;
+    info.bits   = 16;
+    info.stride = M6P_STRIDE_BAKED;
+    snprintf(info.name, sizeof(info.name), "%s", name.c_str());
+    std::vector<int32_t> q(duty.begin(), duty.end());
+    const float unit[6] = {1, 1, 1, 1, 1, 1};
+    return m6p3_encode(info, q, unit, M6P3_LOG2_MAX);
+}
+
+// Golden .m6p (M6P1 or M6P3, baked) -> duty stream.
+bool unpackGolden(const std::vector<uint8_t>& img, M6pInfo& info, std::vector<uint16_t>& duty) {
+    int st = img.size() < M6P_HEADER_SIZE ? M6P_ERR_SHORT : m6p_parse_header(img.data(), img.size(), &info);
+    if (st == M6P_OK) st = m6p_check_crc(&info, img.data() + M6P_HEADER_SIZE);
+    if (st == M6P_OK && info.kind != M6P_KIND_BAKED) st = M6P_ERR_FORMAT;
+    if (st != M6P_OK) { fprintf(stderr, "golden: %s\n", m6p_strerror(st)); return false; }
+    duty.resize((size_t)info.count * 6);
+    if (info.packed) {
+        M6p3Decoder d;
+        if (m6p3_init(&d, img.data(), &info) != M6P_OK) { fprintf(stderr, "golden: bad M6P3 payload\n"); return false; }
+        for (uint32_t n = 0; n < info.count; n++) {
+            float v[6];
+            m6p3_next(&d, v);
+            for (int c = 0; c < 6; c++) duty[(size_t)n * 6 + c] = (uint16_t)v[c];
+        }
+    } else {
+        const uint8_t* p = img.data() + M6P_HEADER_SIZE;
+        for (size_t k = 0; k < duty.size(); k++) duty[k] = m6p_rd16(p + 2 * k);
+    }
+    return true;
+}
+
+void usage() {
+    fprintf(stderr,
+        "usage: mini6dof_replay [--rate HZ] [--seconds S] [--cmd LINE]... [--tol-us US]\n"
+        "                       [--golden FILE [--update]] [--csv FILE] <seq.m6p>\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int rate = 0;
+    double seconds = 0.0, tolUs = 1.0;
+    bool update = false;
+    std::string golden, csv, seqPath;
+    std::vector<std::string> cmds;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string a = argv[i];
+        auto val = [&]() -> const char* {
+            if (i + 1 >= argc) { usage(); exit(2); }
+            return argv[++i];
+        };
+        if      (a == "--rate")    rate = atoi(val());
+        else if (a == "--seconds") seconds = atof(val());
+        else if (a == "--cmd")     cmds.push_back(val());
+        else if (a == "--tol-us")  tolUs = atof(val());
+        else if (a == "--golden")  golden = val();
+        else if (a == "--update")  update = true;
+        else if (a == "--csv")     csv = val();
+        else if (!a.empty() && a[0] == '-') { usage(); return 2; }
+        else if (seqPath.empty())  seqPath = a;
+        else { usage(); return 2; }
+    }
+    if (seqPath.empty() || (update && golden.empty()) || seconds < 0.0 || tolUs < 0.0) { usage(); return 2; }
+
+    std::vector<uint8_t> seq;
+    if (!readFile(seqPath, seq)) { fprintf(stderr, "%s: cannot read\n", seqPath.c_str()); return 1; }
+    M6pInfo seqInfo;
+    int st = seq.size() < M6P_HEADER_SIZE ? M6P_ERR_SHORT : m6p_parse_header(seq.data(), seq.size(), &seqInfo);
+    if (st != M6P_OK) { fprintf(stderr, "%s: %s\n", seqPath.c_str(), m6p_strerror(st)); return 1; }
+
+    // Firmware up on virtual time, no port; then rate, commands, playback.
+    shim_uart_open_null();
+    shim_clock_set_virtual(0);
+    fw_harness_boot();
+    if (rate) {
+        char line[32];
+        snprintf(line, sizeof(line), "SERVO:RATE=%d", rate);
+        fw_harness_command(line);
+        if ((int)shim_ledc_freq() != rate) { fprintf(stderr, "SERVO:RATE=%d rejected\n", rate); return 2; }
+    }
+    for (const std::string& c : cmds) fw_harness_command(c.c_str());
+    rate = (int)shim_ledc_freq();
+    if (!fw_harness_play(seq.data(), seq.size())) {
+        fprintf(stderr, "%s: not playable (CRC / format)\n", seqPath.c_str());
+        return 1;
+    }
+
+    const uint32_t ticks = seconds > 0.0
+        ? (uint32_t)std::lround(seconds * rate)
+        : (uint32_t)(((uint64_t)seqInfo.count * rate + seqInfo.rate - 1) / seqInfo.rate);
+    std::vector<uint16_t> duty((size_t)ticks * 6);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < ticks; n++) {
+        fw_harness_tick();
+        for (int c = 0; c < 6; c++) duty[(size_t)n * 6 + c] = (uint16_t)shim_ledc_duty(c);
+        // Next tick one servo period later (exact over the run, no drift).
+        shim_clock_advance((int64_t)(n + 1) * 1000000 / rate - (int64_t)n * 1000000 / rate);
+    }
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    printf("%s: \"%s\" %s @ %u Hz -> %u ticks @ %d Hz (%.1f s) in %.3f s: %.0f ticks/s, %.0fx real time\n",
+           seqPath.c_str(), seqInfo.name, seqInfo.packed ? "M6P3" : seqInfo.kind == M6P_KIND_RAW ? "M6P2" : "M6P1",
+           (unsigned)seqInfo.rate, (unsigned)ticks, rate, (double)ticks / rate, wall,
+           wall > 0 ? ticks / wall : 0.0, wall > 0 ? ticks / (double)rate / wall : 0.0);
+
+    if (!csv.empty()) {
+        FILE* f = fopen(csv.c_str(), "w");
+        if (!f) { perror(csv.c_str()); return 1; }
+        fprintf(f, "tick,t_us,d0,d1,d2,d3,d4,d5\n");
+        for (uint32_t n = 0; n < ticks; n++) {
+            const uint16_t* d = &duty[(size_t)n * 6];
+            fprintf(f, "%u,%lld,%u,%u,%u,%u,%u,%u\n", (unsigned)n, (long long)n * 1000000 / rate,
+                    d[0], d[1], d[2], d[3], d[4], d[5]);
+        }
+        fclose(f);
+    }
+    if (golden.empty()) return 0;
+
+    if (update) {
+        char name[M6P_NAME_LEN + 1];
+        snprintf(name, sizeof(name), "%s@%dHz", stem(seqPath).c_str(), rate);
+        const std::vector<uint8_t> img = packGolden(duty, ticks, (uint16_t)rate, name);
+        if (!writeFile(golden, img)) { fprintf(stderr, "%s: cannot write\n", golden.c_str()); return 1; }
+        printf("golden: wrote %s (%zu B, %.2f bits/sample)\n", golden.c_str(), img.size(),
+               8.0 * (img.size() - M6P_HEADER_SIZE) / (6.0 * ticks));
+        return 0;
+    }
+
+    std::vector<uint8_t> img;
+    if (!readFile(golden, img)) { fprintf(stderr, "%s: cannot read\n", golden.c_str()); return 1; }
+    M6pInfo gInfo;
+    std::vector<uint16_t> ref;
+    if (!unpackGolden(img, gInfo, ref)) return 1;
+    if (gInfo.rate != rate || gInfo.count != ticks) {
+        fprintf(stderr, "golden %s is %u ticks @ %u Hz, this run is %u @ %d Hz\n", golden.c_str(),
+                (unsigned)gInfo.count, (unsigned)gInfo.rate, (unsigned)ticks, rate);
+        return 1;
+    }
+
+    // Per servo: max / RMS deviation in duty counts and in µs of pulse.
+    const double usPerCount = 1e6 / rate / kDutyMax;
+    bool pass = true;
+    printf("golden %s: tolerance %.2f us (%.1f counts)\n", golden.c_str(), tolUs, tolUs / usPerCount);
+    printf("  servo   max cnt   max us   rms us   over  first\n");
+    for (int c = 0; c < 6; c++) {
+        int maxD = 0;
+        double sq = 0.0;
+        uint32_t over = 0, first = 0;
+        for (uint32_t n = 0; n < ticks; n++) {
+            const int d = std::abs((int)duty[(size_t)n * 6 + c] - (int)ref[(size_t)n * 6 + c]);
+            if (d > maxD) maxD = d;
+            sq += (double)d * d;
+            if (d * usPerCount > tolUs && over++ == 0) first = n;
+        }
+        const double rmsUs = std::sqrt(sq / ticks) * usPerCount;
+        printf("  %5d %9d %8.2f %8.3f %6u  %s\n", c, maxD, maxD * usPerCount, rmsUs, (unsigned)over,
+               over ? std::to_string(first).c_str() : "-");
+        if (over) pass = false;
+    }
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
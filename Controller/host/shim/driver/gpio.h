@@ -0,0 +1,17 @@
+// gpio.h — host shim: output levels are recorded (shim_esp.cpp)
+#pragma once
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef int gpio_num_t;
+typedef enum { GPIO_MODE_DISABLE = 0, GPIO_MODE_INPUT = 1, GPIO_MODE_OUTPUT = 2 } gpio_mode_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+esp_err_t gpio_set_direction(gpio_num_t gpio, gpio_mode_t mode);
+esp_err_t gpio_set_level(gpio_num_t gpio, uint32_t level);
+int       gpio_get_level(gpio_num_t gpio);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,35 @@
+// uart.h — host shim: UART0 is a pseudo-terminal (shim_uart.cpp)
+// uart_read_bytes keeps the driver's contract — it returns when `len` bytes
+// arrived or the timeout ran out — so RX latency matches the device.
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+typedef enum { UART_NUM_0 = 0 } uart_port_t;
+typedef enum { UART_DATA_8_BITS = 3 } uart_word_length_t;
+typedef enum { UART_PARITY_DISABLE = 0 } uart_parity_t;
+typedef enum { UART_STOP_BITS_1 = 1 } uart_stop_bits_t;
+typedef enum { UART_HW_FLOWCTRL_DISABLE = 0 } uart_hw_flowcontrol_t;
+typedef enum { UART_SCLK_DEFAULT = 0 } uart_sclk_t;
+
+typedef struct {
+    int                   baud_rate;
+    uart_word_length_t    data_bits;
+    uart_parity_t         parity;
+    uart_stop_bits_t      stop_bits;
+    uart_hw_flowcontrol_t flow_ctrl;
+    uart_sclk_t           source_clk;
+} uart_config_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+esp_err_t uart_param_config(uart_port_t port, const uart_config_t* cfg);
+esp_err_t uart_driver_install(uart_port_t port, int rx_size, int tx_size, int queue_size, void* queue, int flags);
+int       uart_write_bytes(uart_port_t port, const void* src, size_t len);
+int       uart_read_bytes(uart_port_t port, void* dst, uint32_t len, TickType_t ticks);
+#ifdef __cplusplus
+}
+#endif
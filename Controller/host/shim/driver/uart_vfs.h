@@ -0,0 +1,8 @@
+// uart_vfs.h — host shim: line-ending control is a no-op (stdio is the terminal)
+#pragma once
+
+typedef enum { ESP_LINE_ENDINGS_CRLF, ESP_LINE_ENDINGS_CR, ESP_LINE_ENDINGS_LF } esp_line_endings_t;
+
+static inline void uart_vfs_dev_use_driver(int port) { (void)port; }
+static inline void uart_vfs_dev_port_set_tx_line_endings(int port, esp_line_endings_t m) { (void)port; (void)m; }
+static inline void uart_vfs_dev_port_set_rx_line_endings(int port, esp_line_endings_t m) { (void)port; (void)m; }
@@ -0,0 +1,13 @@
+// esp_cpu.h — host shim: cycle counter scaled to a 240 MHz core
+// Host time × 240 MHz, so *:BENCH figures read in device units — they
+// measure the host CPU, not the ESP32.
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+uint32_t esp_cpu_get_cycle_count(void);
+#ifdef __cplusplus
+}
+#endif
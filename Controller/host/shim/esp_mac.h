@@ -0,0 +1,12 @@
+// esp_mac.h — host shim: fixed locally-administered MAC (sim fingerprint)
+#pragma once
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+esp_err_t esp_efuse_mac_get_default(uint8_t* mac);
+#ifdef __cplusplus
+}
+#endif
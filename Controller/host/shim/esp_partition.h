@@ -0,0 +1,39 @@
+// esp_partition.h — host shim: the `seq` data partition only
+// Backed by a file (mini6dof_sim --seq FILE, mmap'd shared so uploads and
+// recordings persist) or by blank 0xFF memory. Reads, writes and mmap hit
+// the same bytes, so erase/program ordering bugs show up as on flash.
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef enum { ESP_PARTITION_TYPE_APP = 0x00, ESP_PARTITION_TYPE_DATA = 0x01 } esp_partition_type_t;
+typedef int esp_partition_subtype_t;
+typedef enum { ESP_PARTITION_MMAP_DATA, ESP_PARTITION_MMAP_INST } esp_partition_mmap_memory_t;
+typedef uint32_t esp_partition_mmap_handle_t;
+
+typedef struct {
+    esp_partition_type_t    type;
+    esp_partition_subtype_t subtype;
+    uint32_t                address;
+    uint32_t                size;
+    uint32_t                erase_size;
+    char                    label[17];
+    bool                    encrypted;
+} esp_partition_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label);
+esp_err_t esp_partition_read(const esp_partition_t* p, size_t off, void* dst, size_t len);
+esp_err_t esp_partition_write(const esp_partition_t* p, size_t off, const void* src, size_t len);
+esp_err_t esp_partition_erase_range(const esp_partition_t* p, size_t off, size_t len);
+esp_err_t esp_partition_mmap(const esp_partition_t* p, size_t off, size_t len, esp_partition_mmap_memory_t mem,
+                             const void** out, esp_partition_mmap_handle_t* handle);
+void      esp_partition_munmap(esp_partition_mmap_handle_t handle);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,14 @@
+// esp_system.h — host shim
+#pragma once
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+uint32_t esp_get_free_heap_size(void);
+uint32_t esp_get_minimum_free_heap_size(void);
+void     esp_restart(void);      // exits the simulator
+#ifdef __cplusplus
+}
+#endif
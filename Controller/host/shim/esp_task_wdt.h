@@ -0,0 +1,3 @@
+// esp_task_wdt.h — host shim: no task watchdog on the host
+#pragma once
+#include "esp_err.h"
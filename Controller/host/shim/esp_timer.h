@@ -0,0 +1,11 @@
+// esp_timer.h — host shim: microseconds since process start (steady clock)
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+int64_t esp_timer_get_time(void);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,2 @@
+// esp_vfs.h — host shim: stdio stays on the host terminal
+#pragma once
@@ -0,0 +1,39 @@
+// FreeRTOS.h — host shim: FreeRTOS types + tick on std::thread (shim_freertos.cpp)
+// One tick = 1 ms, as CONFIG_FREERTOS_HZ=1000 on the device. Cores and
+// priorities are accepted and ignored; the host scheduler runs every task.
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int      BaseType_t;
+typedef unsigned UBaseType_t;
+
+#define configTICK_RATE_HZ   1000
+#define portTICK_PERIOD_MS   1
+#define portMAX_DELAY        ((TickType_t)0xffffffffu)
+#define pdMS_TO_TICKS(ms)    ((TickType_t)(ms))
+#define pdTICKS_TO_MS(t)     ((uint32_t)(t))
+#define pdTRUE               1
+#define pdFALSE              0
+#define pdPASS               pdTRUE
+#define pdFAIL               pdFALSE
+
+// Critical sections: one process-wide recursive lock (they are short).
+typedef struct { int unused; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED  { 0 }
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void vPortEnterCritical(portMUX_TYPE* mux);
+void vPortExitCritical(portMUX_TYPE* mux);
+#ifdef __cplusplus
+}
+#endif
+
+#define taskENTER_CRITICAL(m)   vPortEnterCritical(m)
+#define taskEXIT_CRITICAL(m)    vPortExitCritical(m)
+#define portENTER_CRITICAL(m)   vPortEnterCritical(m)
+#define portEXIT_CRITICAL(m)    vPortExitCritical(m)
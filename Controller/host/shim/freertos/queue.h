@@ -0,0 +1,20 @@
+// queue.h — host shim: fixed-item-size FIFO queues (shim_freertos.cpp)
+#pragma once
+#include "FreeRTOS.h"
+
+typedef void* QueueHandle_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+QueueHandle_t xQueueCreate(UBaseType_t depth, UBaseType_t itemSize);
+BaseType_t    xQueueSend(QueueHandle_t q, const void* item, TickType_t ticks);
+BaseType_t    xQueueReceive(QueueHandle_t q, void* item, TickType_t ticks);
+BaseType_t    xQueueOverwrite(QueueHandle_t q, const void* item);
+BaseType_t    xQueueReset(QueueHandle_t q);
+UBaseType_t   uxQueueMessagesWaiting(QueueHandle_t q);
+#ifdef __cplusplus
+}
+#endif
+
+#define xQueueSendToBack(q, item, ticks)  xQueueSend((q), (item), (ticks))
@@ -0,0 +1,26 @@
+// task.h — host shim: FreeRTOS tasks as detached std::threads
+#pragma once
+#include "FreeRTOS.h"
+
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stack, void* arg,
+                                   UBaseType_t prio, TaskHandle_t* out, BaseType_t core);
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack, void* arg,
+                       UBaseType_t prio, TaskHandle_t* out);
+void       vTaskDelete(TaskHandle_t task);     // NULL = the calling task
+void       vTaskDelay(TickType_t ticks);
+void       vTaskDelayUntil(TickType_t* prev, TickType_t period);
+TickType_t xTaskGetTickCount(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+// Direct-to-task notifications (counting semantics).
+uint32_t   ulTaskNotifyTake(BaseType_t clear, TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+#ifdef __cplusplus
+}
+#endif
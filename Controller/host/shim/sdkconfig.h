@@ -0,0 +1,3 @@
+// sdkconfig.h — host shim: no Bluetooth host stack in the simulator
+#pragma once
+#define CONFIG_FREERTOS_HZ  1000
@@ -0,0 +1,194 @@
+// shim_esp.cpp — ESP-IDF system, GPIO, LEDC and `seq` partition on the host.
+
+#include "esp_system.h"
+#include "esp_mac.h"
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#include "esp_partition.h"
+#include "driver/gpio.h"
+#include "driver/ledc.h"
+#include "sim_hooks.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace {
+
+// ── LEDC / GPIO state ────────────────────────────────────────────────
+const int LEDC_CHANNELS = 8;
+std::mutex            g_ledcMu;
+uint32_t              g_pending[LEDC_CHANNELS];
+std::atomic<uint32_t> g_duty[LEDC_CHANNELS];
+std::atomic<uint32_t> g_freq{0};
+std::atomic<uint64_t> g_updates{0};
+FILE*                 g_pwmLog = nullptr;
+std::atomic<int>      g_gpio[40];
+
+// ── seq partition (partitions.csv: data, 0x40, 0x210000, 0x1F0000) ─
+const uint32_t  SEQ_ADDR = 0x210000;
+const uint32_t  SEQ_SIZE = 0x1F0000;
+const uint32_t  SECTOR   = 4096;
+esp_partition_t g_seq    = { ESP_PARTITION_TYPE_DATA, 0x40, SEQ_ADDR, SEQ_SIZE, SECTOR, "seq", false };
+uint8_t*        g_flash  = nullptr;
+
+uint8_t* flash() {
+    if (!g_flash) {                                    // no --seq: blank part
+        g_flash = static_cast<uint8_t*>(malloc(SEQ_SIZE));
+        memset(g_flash, 0xFF, SEQ_SIZE);
+    }
+    return g_flash;
+}
+
+bool inRange(const esp_partition_t* p, size_t off, size_t len) {
+    return p == &g_seq && off <= SEQ_SIZE && len <= SEQ_SIZE - off;
+}
+
+}  // namespace
+
+extern "C" {
+
+// ── System ───────────────────────────────────────────────────────────
+
+uint32_t esp_get_free_heap_size(void)         { return 200 * 1024; }
+uint32_t esp_get_minimum_free_heap_size(void) { return 200 * 1024; }
+
+void esp_restart(void) {
+    fprintf(stderr, "sim: esp_restart()\n");
+    fflush(nullptr);
+    exit(0);
+}
+
+esp_err_t esp_efuse_mac_get_default(uint8_t* mac) {
+    static const uint8_t SIM_MAC[6] = { 0x02, 0x4D, 0x36, 0x53, 0x49, 0x4D };   // 02:'M6SIM'
+    memcpy(mac, SIM_MAC, 6);
+    return ESP_OK;
+}
+
+uint32_t esp_cpu_get_cycle_count(void) {
+    using namespace std::chrono;
+    const int64_t ns = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    return (uint32_t)(ns * 240 / 1000);
+}
+
+// ── GPIO ─────────────────────────────────────────────────────────────
+
+esp_err_t gpio_set_direction(gpio_num_t gpio, gpio_mode_t mode) {
+    (void)mode;
+    return gpio >= 0 && gpio < 40 ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio, uint32_t level) {
+    if (gpio < 0 || gpio >= 40) return ESP_ERR_INVALID_ARG;
+    g_gpio[gpio] = level ? 1 : 0;
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio) {
+    return gpio >= 0 && gpio < 40 ? g_gpio[gpio].load() : 0;
+}
+
+// ── LEDC ─────────────────────────────────────────────────────────────
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t* cfg) {
+    g_freq = cfg->freq_hz;
+    return ESP_OK;
+}
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t* cfg) {
+    if (cfg->channel < 0 || cfg->channel >= LEDC_CHANNELS) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> lk(g_ledcMu);
+    g_pending[cfg->channel] = cfg->duty;
+    g_duty[cfg->channel]    = cfg->duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_duty(ledc_mode_t mode, ledc_channel_t ch, uint32_t duty) {
+    (void)mode;
+    if (ch < 0 || ch >= LEDC_CHANNELS) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> lk(g_ledcMu);
+    g_pending[ch] = duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_update_duty(ledc_mode_t mode, ledc_channel_t ch) {
+    (void)mode;
+    if (ch < 0 || ch >= LEDC_CHANNELS) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> lk(g_ledcMu);
+    const uint32_t d = g_pending[ch];
+    g_updates++;
+    if (g_duty[ch].exchange(d) != d && g_pwmLog)
+        fprintf(g_pwmLog, "%lld,%d,%u\n", (long long)esp_timer_get_time(), ch, (unsigned)d);
+    return ESP_OK;
+}
+
+void     shim_ledc_set_log(FILE* f) { std::lock_guard<std::mutex> lk(g_ledcMu); g_pwmLog = f; }
+uint32_t shim_ledc_duty(int ch)     { return ch >= 0 && ch < LEDC_CHANNELS ? g_duty[ch].load() : 0; }
+uint32_t shim_ledc_freq(void)       { return g_freq; }
+uint64_t shim_ledc_updates(void)    { return g_updates; }
+
+// ── `seq` partition ──────────────────────────────────────────────────
+
+bool shim_partition_set_file(const char* path) {
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) { perror(path); return false; }
+    struct stat st;
+    fstat(fd, &st);
+    const off_t had = st.st_size;
+    if (had < (off_t)SEQ_SIZE && ftruncate(fd, SEQ_SIZE) != 0) { perror(path); close(fd); return false; }
+    void* m = mmap(nullptr, SEQ_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (m == MAP_FAILED) { perror(path); return false; }
+    g_flash = static_cast<uint8_t*>(m);
+    if (had < (off_t)SEQ_SIZE) memset(g_flash + had, 0xFF, SEQ_SIZE - had);   // grown = erased
+    return true;
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label) {
+    if (type != ESP_PARTITION_TYPE_DATA || subtype != g_seq.subtype) return nullptr;
+    if (label && strcmp(label, g_seq.label) != 0) return nullptr;
+    return &g_seq;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* p, size_t off, void* dst, size_t len) {
+    if (!inRange(p, off, len)) return ESP_ERR_INVALID_ARG;
+    memcpy(dst, flash() + off, len);
+    return ESP_OK;
+}
+
+// NOR semantics: programming can only clear bits.
+esp_err_t esp_partition_write(const esp_partition_t* p, size_t off, const void* src, size_t len) {
+    if (!inRange(p, off, len)) return ESP_ERR_INVALID_ARG;
+    const uint8_t* s = static_cast<const uint8_t*>(src);
+    uint8_t* d = flash() + off;
+    for (size_t i = 0; i < len; i++) d[i] &= s[i];
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* p, size_t off, size_t len) {
+    if (!inRange(p, off, len) || off % SECTOR || len % SECTOR) return ESP_ERR_INVALID_ARG;
+    memset(flash() + off, 0xFF, len);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t* p, size_t off, size_t len, esp_partition_mmap_memory_t mem,
+                             const void** out, esp_partition_mmap_handle_t* handle) {
+    (void)mem;
+    if (!inRange(p, off, len)) return ESP_ERR_INVALID_ARG;
+    *out = flash() + off;
+    *handle = 1;
+    return ESP_OK;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t handle) { (void)handle; }
+
+}  // extern "C"
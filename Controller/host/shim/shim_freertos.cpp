@@ -0,0 +1,262 @@
+// shim_freertos.cpp — FreeRTOS tasks, delays, semaphores, queues and task
+// notifications on std::thread / std::condition_variable. The tick is the
+// steady clock in ms since start; vTaskDelayUntil sleeps to an absolute
+// tick, so CueTask keeps its period instead of drifting by its run time.
+// With the virtual clock on (replay), esp_timer / the tick only move when the
+// caller advances them; blocking waits still time out in real time. A clock
+// skew (offset + ppm, shim_clock_skew) makes the sim's crystal disagree with
+// the host's, for SYNC:* runs with several sims.
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+#include "sim_hooks.h"
+
+#include <pthread.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+const Clock::time_point g_start = Clock::now();
+
+struct Task {
+    std::string             name;
+    std::mutex              mu;
+    std::condition_variable cv;
+    uint32_t                notify = 0;
+};
+
+thread_local Task* t_self = nullptr;
+
+Task* self() {
+    if (!t_self) t_self = new Task();          // app_main / foreign threads
+    return t_self;
+}
+
+// portMAX_DELAY = forever; otherwise a deadline `ticks` ms from now.
+template <class Pred>
+bool waitFor(std::unique_lock<std::mutex>& lk, std::condition_variable& cv, TickType_t ticks, Pred pred) {
+    if (ticks == portMAX_DELAY) { cv.wait(lk, pred); return true; }
+    return cv.wait_for(lk, std::chrono::milliseconds(ticks), pred);
+}
+
+struct Sem {
+    std::mutex              mu;
+    std::condition_variable cv;
+    int                     count;
+};
+
+struct Queue {
+    std::mutex                        mu;
+    std::condition_variable           cv;
+    std::deque<std::vector<uint8_t>>  items;
+    size_t                            depth, size;
+};
+
+std::recursive_mutex g_critical;
+
+std::atomic<bool>    g_virtual{false};
+std::atomic<int64_t> g_virtualUs{0};
+int64_t              g_skewUs   = 0;      // device = real × g_skewRate + g_skewUs
+double               g_skewRate = 1.0;
+
+// Device µs -> real µs since start (inverse of the skew).
+int64_t realUs(int64_t devUs) {
+    return (int64_t)((double)(devUs - g_skewUs) / g_skewRate);
+}
+
+}  // namespace
+
+extern "C" {
+
+void shim_clock_set_virtual(int64_t start_us) {
+    g_virtualUs = start_us;
+    g_virtual   = true;
+}
+
+void shim_clock_advance(int64_t us) {
+    g_virtualUs += us;
+}
+
+void shim_clock_skew(int64_t offset_us, double ppm) {
+    g_skewUs   = offset_us;
+    g_skewRate = 1.0 + ppm * 1e-6;
+}
+
+int64_t esp_timer_get_time(void) {
+    if (g_virtual) return g_virtualUs;
+    const int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - g_start).count();
+    return g_skewRate == 1.0 ? us + g_skewUs : (int64_t)((double)us * g_skewRate) + g_skewUs;
+}
+
+void vPortEnterCritical(portMUX_TYPE* mux) { (void)mux; g_critical.lock(); }
+void vPortExitCritical(portMUX_TYPE* mux)  { (void)mux; g_critical.unlock(); }
+
+// ── Tasks ────────────────────────────────────────────────────────────
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stack, void* arg,
+                                   UBaseType_t prio, TaskHandle_t* out, BaseType_t core) {
+    (void)stack; (void)prio; (void)core;
+    Task* t = new Task();
+    t->name = name ? name : "";
+    if (out) *out = t;
+    std::thread([t, fn, arg]() {
+        t_self = t;
+        pthread_setname_np(pthread_self(), t->name.substr(0, 15).c_str());
+        fn(arg);
+    }).detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack, void* arg,
+                       UBaseType_t prio, TaskHandle_t* out) {
+    return xTaskCreatePinnedToCore(fn, name, stack, arg, prio, out, 0);
+}
+
+// Only self-deletion is used (one-shot tasks); the Task record is kept so a
+// stale handle stays safe to notify.
+void vTaskDelete(TaskHandle_t task) {
+    if (task == nullptr || task == t_self) pthread_exit(nullptr);
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)(esp_timer_get_time() / 1000);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) { return self(); }
+
+void vTaskDelay(TickType_t ticks) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+void vTaskDelayUntil(TickType_t* prev, TickType_t period) {
+    *prev += period;
+    std::this_thread::sleep_until(g_start + std::chrono::microseconds(realUs((int64_t)*prev * 1000)));
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks) {
+    Task* t = self();
+    std::unique_lock<std::mutex> lk(t->mu);
+    waitFor(lk, t->cv, ticks, [t] { return t->notify > 0; });
+    const uint32_t v = t->notify;
+    if (v) t->notify = clear ? 0 : v - 1;
+    return v;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    Task* t = static_cast<Task*>(task);
+    {
+        std::lock_guard<std::mutex> lk(t->mu);
+        t->notify++;
+    }
+    t->cv.notify_one();
+    return pdPASS;
+}
+
+// ── Semaphores (mutex = binary semaphore created given) ──────────────
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    Sem* s = new Sem();
+    s->count = 1;
+    return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    Sem* s = new Sem();
+    s->count = 0;
+    return s;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+    Sem* s = static_cast<Sem*>(sem);
+    std::unique_lock<std::mutex> lk(s->mu);
+    if (!waitFor(lk, s->cv, ticks, [s] { return s->count > 0; })) return pdFALSE;
+    s->count--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    Sem* s = static_cast<Sem*>(sem);
+    {
+        std::lock_guard<std::mutex> lk(s->mu);
+        if (s->count > 0) return pdFALSE;
+        s->count = 1;
+    }
+    s->cv.notify_one();
+    return pdTRUE;
+}
+
+// ── Queues ───────────────────────────────────────────────────────────
+
+QueueHandle_t xQueueCreate(UBaseType_t depth, UBaseType_t itemSize) {
+    Queue* q = new Queue();
+    q->depth = depth;
+    q->size  = itemSize;
+    return q;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks) {
+    Queue* q = static_cast<Queue*>(queue);
+    {
+        std::unique_lock<std::mutex> lk(q->mu);
+        if (!waitFor(lk, q->cv, ticks, [q] { return q->items.size() < q->depth; })) return pdFALSE;
+        const uint8_t* p = static_cast<const uint8_t*>(item);
+        q->items.emplace_back(p, p + q->size);
+    }
+    q->cv.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks) {
+    Queue* q = static_cast<Queue*>(queue);
+    {
+        std::unique_lock<std::mutex> lk(q->mu);
+        if (!waitFor(lk, q->cv, ticks, [q] { return !q->items.empty(); })) return pdFALSE;
+        memcpy(item, q->items.front().data(), q->size);
+        q->items.pop_front();
+    }
+    q->cv.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void* item) {
+    Queue* q = static_cast<Queue*>(queue);
+    {
+        std::lock_guard<std::mutex> lk(q->mu);
+        const uint8_t* p = static_cast<const uint8_t*>(item);
+        q->items.clear();
+        q->items.emplace_back(p, p + q->size);
+    }
+    q->cv.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+    Queue* q = static_cast<Queue*>(queue);
+    {
+        std::lock_guard<std::mutex> lk(q->mu);
+        q->items.clear();
+    }
+    q->cv.notify_all();
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    Queue* q = static_cast<Queue*>(queue);
+    std::lock_guard<std::mutex> lk(q->mu);
+    return (UBaseType_t)q->items.size();
+}
+
+}  // extern "C"
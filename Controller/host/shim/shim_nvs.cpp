@@ -0,0 +1,159 @@
+// shim_nvs.cpp — host NVS: namespaced blobs in an in-process map.
+// Integers are stored as little-endian blobs, like the sizes NVS enforces.
+// With shim_nvs_set_file() (mini6dof_sim --nvs) the map is loaded from a file
+// and every nvs_commit() rewrites it, so settings survive a restart.
+
+#include "nvs_flash.h"
+#include "sim_hooks.h"
+
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstring>
+
+namespace {
+std::mutex                                      g_mu;
+std::map<std::string, std::vector<uint8_t>>     g_store;    // "ns/key" -> bytes
+std::vector<std::string>                        g_handles;  // handle-1 -> namespace
+std::string                                     g_file;     // backing file, "" = RAM only
+
+// File: "M6NV" then per entry u16 name length, name, u32 value length, value.
+const char NVS_FILE_MAGIC[4] = { 'M', '6', 'N', 'V' };
+
+// Caller holds g_mu. Written to a temp file and renamed: a crash mid-save
+// leaves the previous contents, like an interrupted NVS commit.
+bool saveFile() {
+    if (g_file.empty()) return true;
+    const std::string tmp = g_file + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "wb");
+    if (!f) return false;
+    fwrite(NVS_FILE_MAGIC, 1, 4, f);
+    for (const auto& kv : g_store) {
+        const uint16_t kl = (uint16_t)kv.first.size();
+        const uint32_t vl = (uint32_t)kv.second.size();
+        fwrite(&kl, sizeof(kl), 1, f);
+        fwrite(kv.first.data(), 1, kl, f);
+        fwrite(&vl, sizeof(vl), 1, f);
+        fwrite(kv.second.data(), 1, vl, f);
+    }
+    const bool ok = fclose(f) == 0;
+    return ok && rename(tmp.c_str(), g_file.c_str()) == 0;
+}
+
+std::string keyFor(nvs_handle_t h, const char* key) {
+    return g_handles[h - 1] + "/" + key;
+}
+
+bool validHandle(nvs_handle_t h) { return h >= 1 && h <= g_handles.size(); }
+
+esp_err_t setBytes(nvs_handle_t h, const char* key, const void* v, size_t len) {
+    std::lock_guard<std::mutex> lk(g_mu);
+    if (!validHandle(h) || !key) return ESP_ERR_INVALID_ARG;
+    const uint8_t* p = static_cast<const uint8_t*>(v);
+    g_store[keyFor(h, key)].assign(p, p + len);
+    return ESP_OK;
+}
+
+esp_err_t getExact(nvs_handle_t h, const char* key, void* out, size_t len) {
+    std::lock_guard<std::mutex> lk(g_mu);
+    if (!validHandle(h) || !key) return ESP_ERR_INVALID_ARG;
+    auto it = g_store.find(keyFor(h, key));
+    if (it == g_store.end()) return ESP_ERR_NVS_NOT_FOUND;
+    if (it->second.size() != len) return ESP_ERR_NVS_INVALID_LENGTH;
+    memcpy(out, it->second.data(), len);
+    return ESP_OK;
+}
+}  // namespace
+
+extern "C" {
+
+bool shim_nvs_set_file(const char* path) {
+    std::lock_guard<std::mutex> lk(g_mu);
+    g_file = path;
+    g_store.clear();
+    FILE* f = fopen(path, "rb");
+    if (!f) return true;                     // first run: starts empty
+    char magic[4];
+    bool ok = fread(magic, 1, 4, f) == 4 && memcmp(magic, NVS_FILE_MAGIC, 4) == 0;
+    uint16_t kl;
+    while (ok && fread(&kl, sizeof(kl), 1, f) == 1) {
+        std::string key(kl, '\0');
+        uint32_t vl = 0;
+        ok = fread(&key[0], 1, kl, f) == kl && fread(&vl, sizeof(vl), 1, f) == 1 && vl <= (1u << 20);
+        if (!ok) break;
+        std::vector<uint8_t> v(vl);
+        ok = fread(v.data(), 1, vl, f) == vl;
+        if (ok) g_store[key] = std::move(v);
+    }
+    fclose(f);
+    if (!ok) fprintf(stderr, "nvs: %s is corrupt, ignoring the rest\n", path);
+    return ok;
+}
+
+const char* esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        case ESP_OK:                     return "ESP_OK";
+        case ESP_FAIL:                   return "ESP_FAIL";
+        case ESP_ERR_NO_MEM:             return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:        return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_NVS_NOT_FOUND:      return "ESP_ERR_NVS_NOT_FOUND";
+        case ESP_ERR_NVS_INVALID_LENGTH: return "ESP_ERR_NVS_INVALID_LENGTH";
+        default:                         return "ESP_ERR_UNKNOWN";
+    }
+}
+
+esp_err_t nvs_flash_init(void)  { return ESP_OK; }
+esp_err_t nvs_flash_erase(void) {
+    std::lock_guard<std::mutex> lk(g_mu);
+    g_store.clear();
+    return saveFile() ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t nvs_open(const char* ns, nvs_open_mode_t mode, nvs_handle_t* out) {
+    (void)mode;
+    if (!ns || !out) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> lk(g_mu);
+    g_handles.push_back(ns);
+    *out = (nvs_handle_t)g_handles.size();
+    return ESP_OK;
+}
+
+void      nvs_close(nvs_handle_t h)  { (void)h; }
+esp_err_t nvs_commit(nvs_handle_t h) {
+    std::lock_guard<std::mutex> lk(g_mu);
+    if (!validHandle(h)) return ESP_ERR_INVALID_ARG;
+    return saveFile() ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t h, const char* key) {
+    std::lock_guard<std::mutex> lk(g_mu);
+    if (!validHandle(h) || !key) return ESP_ERR_INVALID_ARG;
+    return g_store.erase(keyFor(h, key)) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t h, const char* key, const void* v, size_t len) {
+    return setBytes(h, key, v, len);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t h, const char* key, void* out, size_t* len) {
+    std::lock_guard<std::mutex> lk(g_mu);
+    if (!validHandle(h) || !key || !len) return ESP_ERR_INVALID_ARG;
+    auto it = g_store.find(keyFor(h, key));
+    if (it == g_store.end()) return ESP_ERR_NVS_NOT_FOUND;
+    if (out == nullptr) { *len = it->second.size(); return ESP_OK; }
+    if (*len < it->second.size()) return ESP_ERR_NVS_INVALID_LENGTH;
+    memcpy(out, it->second.data(), it->second.size());
+    *len = it->second.size();
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_u8 (nvs_handle_t h, const char* k, uint8_t v)   { return setBytes(h, k, &v, sizeof(v)); }
+esp_err_t nvs_get_u8 (nvs_handle_t h, const char* k, uint8_t* v)  { return getExact(h, k, v, sizeof(*v)); }
+esp_err_t nvs_set_u16(nvs_handle_t h, const char* k, uint16_t v)  { return setBytes(h, k, &v, sizeof(v)); }
+esp_err_t nvs_get_u16(nvs_handle_t h, const char* k, uint16_t* v) { return getExact(h, k, v, sizeof(*v)); }
+esp_err_t nvs_set_u32(nvs_handle_t h, const char* k, uint32_t v)  { return setBytes(h, k, &v, sizeof(v)); }
+esp_err_t nvs_get_u32(nvs_handle_t h, const char* k, uint32_t* v) { return getExact(h, k, v, sizeof(*v)); }
+
+}  // extern "C"
@@ -0,0 +1,130 @@
+// shim_uart.cpp — UART0 on a pseudo-terminal.
+// The simulator keeps the slave side open itself (raw mode), so a client can
+// connect, leave and reconnect without the master seeing EIO/HUP. The master
+// is non-blocking: with no reader the pty buffer fills and further TX is
+// dropped and counted, as bytes on an unconnected UART are lost.
+
+#include "driver/uart.h"
+#include "esp_timer.h"
+#include "sim_hooks.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace {
+int                   g_master = -1;
+int                   g_slave  = -1;
+int                   g_baud   = 0;          // TX pacing, 0 = off
+bool                  g_null   = false;      // no port: TX counted and discarded
+std::string           g_path;
+std::mutex            g_txMu;
+int64_t               g_txFreeUs = 0;        // wire idle from (pacing)
+std::atomic<uint64_t> g_rx{0}, g_tx{0}, g_txDrop{0};
+}  // namespace
+
+extern "C" {
+
+const char* shim_uart_open_pty(const char* link, int baud) {
+    g_master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (g_master < 0 || grantpt(g_master) != 0 || unlockpt(g_master) != 0) {
+        perror("posix_openpt");
+        return nullptr;
+    }
+    g_path  = ptsname(g_master);
+    g_slave = open(g_path.c_str(), O_RDWR | O_NOCTTY);
+    if (g_slave >= 0) {
+        struct termios tio;
+        tcgetattr(g_slave, &tio);
+        cfmakeraw(&tio);
+        tcsetattr(g_slave, TCSANOW, &tio);
+    }
+    fcntl(g_master, F_SETFL, fcntl(g_master, F_GETFL) | O_NONBLOCK);
+    g_baud = baud;
+    if (link) {
+        unlink(link);
+        if (symlink(g_path.c_str(), link) != 0) perror(link);
+    }
+    return g_path.c_str();
+}
+
+void shim_uart_open_null(void) {
+    g_null = true;
+}
+
+void shim_uart_stats(uint64_t* rx_bytes, uint64_t* tx_bytes, uint64_t* tx_dropped) {
+    *rx_bytes   = g_rx;
+    *tx_bytes   = g_tx;
+    *tx_dropped = g_txDrop;
+}
+
+esp_err_t uart_param_config(uart_port_t port, const uart_config_t* cfg) {
+    (void)port; (void)cfg;
+    return ESP_OK;
+}
+
+esp_err_t uart_driver_install(uart_port_t port, int rx_size, int tx_size, int queue_size, void* queue, int flags) {
+    (void)port; (void)rx_size; (void)tx_size; (void)queue_size; (void)queue; (void)flags;
+    if (g_master < 0 && !g_null && !shim_uart_open_pty(nullptr, 0)) return ESP_FAIL;
+    return ESP_OK;
+}
+
+int uart_write_bytes(uart_port_t port, const void* src, size_t len) {
+    (void)port;
+    if (g_null) {
+        g_tx += len;
+        return (int)len;
+    }
+    std::lock_guard<std::mutex> lk(g_txMu);
+    if (g_baud > 0) {                        // 10 bits per byte on the wire
+        const int64_t now = esp_timer_get_time();
+        if (g_txFreeUs < now) g_txFreeUs = now;
+        g_txFreeUs += (int64_t)len * 10 * 1000000 / g_baud;
+        std::this_thread::sleep_for(std::chrono::microseconds(g_txFreeUs - now));
+    }
+    const uint8_t* p = static_cast<const uint8_t*>(src);
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = write(g_master, p + done, len - done);
+        if (n > 0) { done += (size_t)n; continue; }
+        if (n < 0 && errno == EINTR) continue;
+        break;                               // EAGAIN: nobody is reading
+    }
+    g_tx += done;
+    g_txDrop += len - done;
+    return (int)len;
+}
+
+// Driver contract: return once `len` bytes arrived or `ticks` ms passed.
+int uart_read_bytes(uart_port_t port, void* dst, uint32_t len, TickType_t ticks) {
+    (void)port;
+    if (g_null) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+        return 0;
+    }
+    uint8_t* p = static_cast<uint8_t*>(dst);
+    uint32_t got = 0;
+    const int64_t deadline = esp_timer_get_time() + (int64_t)ticks * 1000;
+    while (got < len) {
+        ssize_t n = read(g_master, p + got, len - got);
+        if (n > 0) { got += (uint32_t)n; continue; }
+        const int64_t left = deadline - esp_timer_get_time();
+        if (left <= 0) break;
+        struct pollfd pfd = { g_master, POLLIN, 0 };
+        poll(&pfd, 1, (int)((left + 999) / 1000));
+    }
+    g_rx += got;
+    return (int)got;
+}
+
+}  // extern "C"
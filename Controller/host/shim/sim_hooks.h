@@ -0,0 +1,41 @@
+// sim_hooks.h — host shim: controls for the host programs built from main/
+// Set up before app_main() / fw_harness_boot() runs; none of this exists on
+// the device.
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+// Virtual clock: esp_timer_get_time() / the tick read `start_us` and move
+// only by shim_clock_advance() — deterministic time for replays.
+void        shim_clock_set_virtual(int64_t start_us);
+void        shim_clock_advance(int64_t us);
+// Real clock, skewed: esp_timer / the tick read real × (1 + ppm·1e-6) +
+// offset_us (offset_us ≥ 0), so one sim's crystal can disagree with the host.
+void        shim_clock_skew(int64_t offset_us, double ppm);
+
+// NVS: load `path` now (missing = empty), rewrite it on every nvs_commit().
+bool        shim_nvs_set_file(const char* path);
+
+// UART0 on a new pty. `link` (may be NULL) becomes a symlink to the slave;
+// baud > 0 paces TX like the wire, 0 = unthrottled. Returns the slave path.
+const char* shim_uart_open_pty(const char* link, int baud);
+// UART0 with no port at all (bench / replay): TX is counted and discarded,
+// reads time out. Call instead of shim_uart_open_pty().
+void        shim_uart_open_null(void);
+void        shim_uart_stats(uint64_t* rx_bytes, uint64_t* tx_bytes, uint64_t* tx_dropped);
+
+// `seq` partition image (created at partition size, 0xFF-filled, if new).
+bool        shim_partition_set_file(const char* path);
+
+// LEDC: every latched duty as "t_us,ch,duty\n" (NULL = off).
+void        shim_ledc_set_log(FILE* f);
+uint32_t    shim_ledc_duty(int ch);
+uint32_t    shim_ledc_freq(void);
+uint64_t    shim_ledc_updates(void);
+#ifdef __cplusplus
+}
+#endif
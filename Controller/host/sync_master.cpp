@@ -0,0 +1,245 @@
+// sync_master.cpp — mini6dof_sync: lock several rigs to this host's clock and
+// start them together
+//
+// Each port gets its own M6Client; their epoll sets nest in one loop. Every
+// rig runs SYNC:T timestamp exchanges at --hz, so its firmware tracks offset
+// and drift against CLOCK_MONOTONIC here (clocksync.h). Once every rig
+// reports lock, one host time `now + --lead` goes to all of them as
+// SOURCE:DEMO@<host µs>: each starts frame 0 of its sequence at that instant
+// on its own clock, aligns its CueTask ticks to the host's period grid and
+// keeps the playhead on host time from then on. --seek sends a stamped
+// PLAY:SEEK halfway through, for every rig to jump at the same instant.
+// Exchanges continue for the whole run; every --stats seconds each rig's
+// SYNC? is printed:
+//
+//   offset / drift   device − host and the crystal difference
+//   delay / resid    best round trip in the window, fit residual
+//   tick             CueTask tick start vs the host grid, last / RMS µs
+//   play             DEMO playhead vs host time, last / RMS µs (slews, steps)
+//
+// The run passes when every rig ends within the firmware's stated tolerance
+// (SYNC_TOL_US, one FreeRTOS tick). Rigs keep playing afterwards, on their
+// last clock model.
+//
+//   mini6dof_sync [--baud N] [--hz HZ] [--settle S] [--lead S] [--seek POS]
+//                 [--seconds S] [--stats SEC] <port>...
+//
+// Two simulated rigs with crystals 60 ppm apart:
+//   ./build-host/mini6dof_sim --link /tmp/rig0 --clock-ppm 40 --clock-offset-ms 1500 &
+//   ./build-host/mini6dof_sim --link /tmp/rig1 --clock-ppm -20 &
+//   ./build-host/mini6dof_sync --seconds 20 --seek 30 /tmp/rig0 /tmp/rig1
+
+#include "m6client.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct Rig {
+    std::string port;
+    M6Client    c;
+    int64_t     lastT1 = -1, lastT4 = 0;   // completed exchange, handed back with the next
+    bool        inFlight = false, statusOut = false;
+    uint64_t    exchanges = 0, lost = 0;
+    std::vector<double> rttUs;
+    std::string status;                    // last SYNC? reply
+};
+
+void usage() {
+    fprintf(stderr,
+        "usage: mini6dof_sync [--baud N] [--hz HZ] [--settle S] [--lead S] [--seek POS]\n"
+        "                     [--seconds S] [--stats SEC] <port>...\n");
+}
+
+// "KEY:...name=<value> ..." -> value, or "".
+std::string field(const std::string& line, const char* name) {
+    size_t k = line.find(name);
+    if (k == std::string::npos) return std::string();
+    k += strlen(name);
+    return line.substr(k, line.find(' ', k) - k);
+}
+
+// One SYNC:T exchange: t1 now, the reply carries t2 / t3, t4 on arrival.
+void exchange(Rig& r) {
+    if (r.inFlight) return;
+    const int64_t t1 = M6Client::nowUs();
+    std::string cmd = "SYNC:T=" + std::to_string(t1);
+    if (r.lastT1 >= 0) cmd += "," + std::to_string(r.lastT1) + "," + std::to_string(r.lastT4);
+    r.inFlight = true;
+    r.c.requestAsync(cmd, [&r, t1](bool ok, const std::string& line, int64_t) {
+        const int64_t t4 = M6Client::nowUs();
+        r.inFlight = false;
+        if (!ok || strtoll(line.c_str() + 7, nullptr, 10) != t1) {   // lost, or a stale reply
+            r.lost++;
+            r.lastT1 = -1;
+            return;
+        }
+        r.lastT1 = t1;
+        r.lastT4 = t4;
+        r.exchanges++;
+        r.rttUs.push_back((double)(t4 - t1));
+    }, 500, "SYNC:T=");
+}
+
+void pollStatus(Rig& r) {
+    if (r.statusOut) return;
+    r.statusOut = true;
+    r.c.requestAsync("SYNC?", [&r](bool ok, const std::string& line, int64_t) {
+        r.statusOut = false;
+        if (ok) r.status = line;
+    }, 500, "SYNC:on=");
+}
+
+void printStatus(size_t i, const Rig& r) {
+    const std::string& s = r.status;
+    if (s.empty()) { printf("  rig%zu %-12s no SYNC? reply\n", i, r.port.c_str()); return; }
+    printf("  rig%zu %-12s lock=%s offset=%sus drift=%s delay=%sus resid=%sus tick=%sus play=%sus "
+           "slews=%s steps=%s anchor=%s %s\n", i, r.port.c_str(), field(s, "lock=").c_str(),
+           field(s, "offset=").c_str(), field(s, "drift=").c_str(), field(s, "delay=").c_str(),
+           field(s, "resid=").c_str(), field(s, "tick=").c_str(), field(s, "play=").c_str(),
+           field(s, "slews=").c_str(), field(s, "steps=").c_str(), field(s, "anchor=").c_str(),
+           s.substr(s.rfind(' ') + 1).c_str());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int baud = 921600;
+    double hz = 4.0, settle = 3.0, lead = 1.0, seek = -1.0, seconds = 10.0, statsSec = 2.0;
+    std::vector<std::string> ports;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string a = argv[i];
+        auto val = [&]() -> const char* {
+            if (i + 1 >= argc) { usage(); exit(2); }
+            return argv[++i];
+        };
+        if      (a == "--baud")    baud = atoi(val());
+        else if (a == "--hz")      hz = atof(val());
+        else if (a == "--settle")  settle = atof(val());
+        else if (a == "--lead")    lead = atof(val());
+        else if (a == "--seek")    seek = atof(val());
+        else if (a == "--seconds") seconds = atof(val());
+        else if (a == "--stats")   statsSec = atof(val());
+        else if (!a.empty() && a[0] == '-') { usage(); return 2; }
+        else ports.push_back(a);
+    }
+    if (ports.empty() || hz <= 0.0 || hz > 50.0 || settle < 0.0 || lead < 0.1 || seconds <= 0.0 || statsSec <= 0.0) {
+        usage();
+        return 2;
+    }
+
+    // ── Rigs: handshake, clean model, SYNC:ON ───────────────────────────
+    std::vector<std::unique_ptr<Rig>> rigs;
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    for (const std::string& p : ports) {
+        rigs.emplace_back(new Rig);
+        Rig& r = *rigs.back();
+        r.port = p;
+        if (!r.c.open(p, baud)) return 1;
+        M6DeviceInfo dev;
+        if (!r.c.handshake(&dev)) { fprintf(stderr, "%s: no FINGERPRINT reply\n", p.c_str()); return 1; }
+        if (r.c.request("SYNC:RESET") != "SYNC:RESET" || r.c.request("SYNC:ON") != "SYNC:ON") {
+            fprintf(stderr, "%s: no SYNC:* support (fw=%s)\n", p.c_str(), dev.fw.c_str());
+            return 1;
+        }
+        printf("rig%zu %s: %s fw=%s platform=%s\n", rigs.size() - 1, p.c_str(), dev.mac.c_str(),
+               dev.fw.c_str(), dev.platform.c_str());
+        r.c.onResponse = [&r](const std::string& line) {
+            if (line.compare(0, 4, "ERR:") == 0 || line.find(":ERR") != std::string::npos)
+                printf("  %s: %s\n", r.port.c_str(), line.c_str());
+        };
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = r.c.pollFd();
+        epoll_ctl(ep, EPOLL_CTL_ADD, r.c.pollFd(), &ev);
+    }
+
+    // ── Loop: exchanges throughout; lock -> start -> (seek) -> end ───────
+    enum { LOCKING, PLAYING } phase = LOCKING;
+    const int64_t t0 = M6Client::nowUs();
+    const int64_t exchangeUs = (int64_t)(1e6 / hz), statsUs = (int64_t)(statsSec * 1e6);
+    int64_t nextExchange = t0, nextStats = t0 + statsUs, startUs = 0, seekUs = 0, endUs = 0;
+    bool seekSent = seek < 0.0;
+    for (;;) {
+        const int64_t now = M6Client::nowUs();
+        if (now >= nextExchange) {
+            for (auto& r : rigs) exchange(*r);
+            nextExchange += exchangeUs;
+        }
+        if (phase == LOCKING && now - t0 >= (int64_t)(settle * 1e6)) {
+            bool all = true;
+            for (auto& r : rigs) {
+                if (field(r->status, "lock=") != "1") all = false;
+                pollStatus(*r);
+            }
+            if (all) {
+                startUs = now + (int64_t)(lead * 1e6);
+                seekUs  = startUs + (int64_t)(seconds * 5e5);
+                endUs   = startUs + (int64_t)(seconds * 1e6);
+                for (auto& r : rigs) {
+                    const std::string rep = r->c.request("SOURCE:DEMO@" + std::to_string(startUs));
+                    if (rep.compare(0, 12, "SOURCE:DEMO@") != 0) {
+                        fprintf(stderr, "%s: start refused: %s\n", r->port.c_str(), rep.c_str());
+                        return 1;
+                    }
+                }
+                printf("start: SOURCE:DEMO at host %lld us (+%.2f s), %zu rig(s)\n", (long long)startUs,
+                       lead, rigs.size());
+                phase = PLAYING;
+            } else if (now - t0 > (int64_t)(settle * 1e6) + 30000000) {
+                fprintf(stderr, "no lock on every rig after %.0f s\n", settle + 30.0);
+                for (size_t i = 0; i < rigs.size(); i++) printStatus(i, *rigs[i]);
+                return 1;
+            }
+        }
+        if (phase == PLAYING && !seekSent && now >= seekUs - (int64_t)(lead * 1e6)) {
+            seekSent = true;
+            char cmd[64];
+            snprintf(cmd, sizeof(cmd), "PLAY:SEEK=%.2f@%lld", seek, (long long)seekUs);
+            for (auto& r : rigs) r->c.sendCommand(cmd);
+            printf("seek: %.2f s at host %lld us\n", seek, (long long)seekUs);
+        }
+        if (now >= nextStats) {
+            nextStats += statsUs;
+            printf("t=%.1fs%s\n", (now - t0) / 1e6, phase == LOCKING ? " (locking)" : "");
+            for (size_t i = 0; i < rigs.size(); i++) {
+                printStatus(i, *rigs[i]);
+                pollStatus(*rigs[i]);
+            }
+        }
+        if (phase == PLAYING && now >= endUs) break;
+
+        epoll_event ev[8];
+        epoll_wait(ep, ev, 8, 5);
+        for (auto& r : rigs)
+            if (!r->c.run(0)) { fprintf(stderr, "%s: link lost\n", r->port.c_str()); return 1; }
+    }
+
+    // ── Report ──────────────────────────────────────────────────────────
+    bool pass = true;
+    printf("final:\n");
+    for (size_t i = 0; i < rigs.size(); i++) {
+        Rig& r = *rigs[i];
+        r.status = r.c.request("SYNC?", 500, "SYNC:on=");
+        printStatus(i, r);
+        std::vector<double>& v = r.rttUs;
+        std::sort(v.begin(), v.end());
+        printf("         %llu exchanges, %llu lost, rtt min %.0f / p50 %.0f / max %.0f us\n",
+               (unsigned long long)r.exchanges, (unsigned long long)r.lost, v.empty() ? 0.0 : v.front(),
+               v.empty() ? 0.0 : v[v.size() / 2], v.empty() ? 0.0 : v.back());
+        if (r.status.empty() || r.status.substr(r.status.rfind(' ') + 1) != "OK") pass = false;
+    }
+    printf("%s\n", pass ? "PASS: every rig within its sync tolerance" : "FAIL");
+    close(ep);
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+// BleHost.h — Seam between BleTransport and the BLE host stack
+// BleTransport.cpp holds everything stack-independent: the connection table,
+// write parsing (single + batched), the TEL2 fan-out (BleTelTask) and the
+// public BleTransport.h API. Exactly one backend implements ble_host_* and
+// feeds stack events back through ble_core_*:
+//   BleBluedroid.cpp  CONFIG_BT_BLUEDROID_ENABLED (sdkconfig.defaults)
+//   BleNimble.cpp     CONFIG_BT_NIMBLE_ENABLED    (sdkconfig.nimble overlay)
+// Both expose the same service and characteristics (0xFF01/0xFF02/0xFF03),
+// so clients cannot tell them apart. Internal to the BLE transport.
+#ifndef BLE_HOST_H
+#define BLE_HOST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BLE_DEVICE_NAME   "Mini6DOF"
+#define BLE_LOCAL_MTU     247      // 244-byte notifications: 6 pose+angle samples
+#define BLE_DLE_OCTETS    251      // max LE data length (4.2 DLE)
+#define BLE_DLE_TIME_US   2120     // air time of a 251-octet PDU on 1M
+
+#if defined(CONFIG_BT_NIMBLE_MAX_CONNECTIONS)
+#define BLE_MAX_CONN  CONFIG_BT_NIMBLE_MAX_CONNECTIONS
+#elif defined(CONFIG_BT_ACL_CONNECTIONS)
+#define BLE_MAX_CONN  CONFIG_BT_ACL_CONNECTIONS
+#else
+#define BLE_MAX_CONN  3
+#endif
+
+// Service UUID 42100001-0001-1000-8000-00805f9b34fb, little-endian
+extern const uint8_t BLE_SERVICE_UUID128[16];
+
+typedef enum {
+    BLE_CHR_MOTION = 0,   // 0xFF01 write: 12/15-byte motion or batch
+    BLE_CHR_STATUS,       // 0xFF02 notify + write [mask, rate_hz u16]
+    BLE_CHR_ACCEL,        // 0xFF03 write: 24-byte accel or batch
+} BleChr;
+
+// ── Backend (one of BleBluedroid.cpp / BleNimble.cpp) ───────────────
+// Bring up controller + host, register the GATT table, start advertising.
+bool        ble_host_start(void);
+// One notification on 0xFF02 to one client; false = not sent (not ready,
+// out of buffers, congested).
+bool        ble_host_notify(uint16_t conn_id, const uint8_t *data, uint16_t len);
+const char *ble_host_name(void);
+
+// ── Core (BleTransport.cpp), called from the stack's callback context ──
+void ble_core_adv_started(void);
+// Returns the clients now connected, -1 if the table is full.
+int  ble_core_connect(uint16_t conn_id, const uint8_t addr[6]);
+// Returns the clients still connected.
+int  ble_core_disconnect(uint16_t conn_id);
+bool ble_core_find_addr(const uint8_t addr[6], uint16_t *conn_id);
+void ble_core_set_mtu(uint16_t conn_id, uint16_t mtu);
+void ble_core_set_congested(uint16_t conn_id, bool congested);
+void ble_core_set_notify(uint16_t conn_id, bool on);
+void ble_core_set_phy(uint16_t conn_id, uint8_t tx_phy, uint8_t rx_phy);
+void ble_core_set_data_len(uint16_t conn_id, uint16_t tx_octets, uint16_t rx_octets);
+void ble_core_set_interval(uint16_t conn_id, uint16_t itvl_x125);
+// A write to one of the characteristics (the backend answers the ATT write).
+void ble_core_rx(uint16_t conn_id, BleChr chr, const uint8_t *data, uint16_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLE_HOST_H
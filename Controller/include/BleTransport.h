@@ -15,24 +15,71 @@ extern "C" {
  *
  * Service UUID:  4210xxxx-0001-1000-8000-00805f9b34fb
  * Motion RX characteristic (0xFF01): writable, receives 12-byte binary payloads
- * Status TX characteristic (0xFF02): notify, sends status/telemetry
+ * Status TX characteristic (0xFF02): notify, batched TEL2 telemetry (write = subscribe)
  * Accel  RX characteristic (0xFF03): writable, receives 24-byte accel packets
  *
+ * The host stack is picked at build time: Bluedroid (sdkconfig.defaults) or
+ * NimBLE (sdkconfig.nimble overlay) — same service, same API (BleHost.h).
+ *
  * @param process_packet  Callback for each valid 12-byte binary payload
  * @return true on success
  */
 bool ble_transport_init(void (*process_packet)(const uint8_t *payload));
 
+typedef struct {
+    const char *host;          // "Bluedroid" / "NimBLE"
+    uint32_t    heap_used;     // free-heap drop across controller + host bring-up
+    uint32_t    adv_ready_us;  // boot -> first advertising start (0 = not yet)
+} BleHostInfo;
+
+/** Which host stack is built in and what bringing it up cost. */
+void ble_transport_host_info(BleHostInfo *out);
+
 /**
  * Register callback for accelerometer/gyro data packets.
  * Called when 24 bytes (6 x float32 LE) arrive on the accel characteristic.
- * Data order: [accel_x, accel_y, accel_z, gyro_x, gyro_y, gyro_z]
- * Units: m/s² for accel, rad/s for gyro (Android TYPE_ACCELEROMETER + TYPE_GYROSCOPE)
+ * The firmware reads them per ACCEL:MODE (main.cpp):
+ *   FUSED: [roll°, pitch°, yaw°, surge, sway, heave] (phone-side fusion)
+ *   RAW:   [accel_x, accel_y, accel_z, gyro_x, gyro_y, gyro_z], m/s² and rad/s
+ *          (Android TYPE_ACCELEROMETER + TYPE_GYROSCOPE), fused on the device
  *
  * @param process_accel  Callback receiving pointer to 6 floats
  */
 void ble_transport_set_accel_callback(void (*process_accel)(const float *data));
 
+/*
+ * Batched writes on 0xFF01 (motion) and 0xFF03 (accel): N samples per write,
+ *   u8 BLE_BATCH_MAGIC, u8 n, u16 seq (sender's batch counter, informational),
+ *   n × { u16 offset (BLE_BATCH_TICK_US units, sender clock), payload }
+ * payload = 12 bytes (6 × uint16) on 0xFF01, 24 bytes (6 × float32) on 0xFF03.
+ * Sample k is due at arrival + (offset_k − offset_0). With DLE and MTU 247:
+ * up to 17 motion or 9 accel samples per write.
+ */
+#define BLE_BATCH_MAGIC    0xB7
+#define BLE_BATCH_HDR      4
+#define BLE_BATCH_TICK_US  100
+
+typedef void (*ble_motion_at_cb_t)(const uint8_t *payload, int64_t due_us);
+typedef void (*ble_accel_at_cb_t)(const float *data, int64_t due_us);
+
+/**
+ * Register the consumers of batched samples (due_us = esp_timer time).
+ * Without them a batch delivers only its newest sample, immediately.
+ */
+void ble_transport_set_timed_callbacks(ble_motion_at_cb_t motion, ble_accel_at_cb_t accel);
+
+typedef struct {
+    uint16_t conn_id, mtu;
+    uint8_t  tx_phy, rx_phy;          // 1 = 1M, 2 = 2M, 3 = coded
+    uint16_t tx_octets, rx_octets;    // LE data length
+    uint32_t interval_us;             // connection interval (0 = not reported yet)
+    uint32_t writes, samples, bytes, bad;   // received since the previous query
+    uint32_t window_us;               // ... over this window
+} BleLinkStatus;
+
+/** Per-client link state + receive counters (reset by each call). */
+int ble_transport_link_status(BleLinkStatus *out, int max);
+
 /**
  * Returns true when a BLE client is connected.
  */
@@ -44,13 +91,46 @@ bool ble_transport_connected(void);
 const char* ble_transport_state_str(void);
 
 /**
- * Send notification data to connected BLE client (for telemetry).
+ * Send one notification on the status characteristic to every subscribed
+ * client (up to CONFIG_BT_ACL_CONNECTIONS).
  * @param data  Pointer to data bytes
- * @param len   Length of data
- * @return 0 on success
+ * @param len   Length of data (≤ each client's MTU − 3, else it is skipped)
+ * @return 0 if at least one client got it
  */
 int ble_transport_notify(const uint8_t *data, uint16_t len);
 
+/*
+ * Batched TEL2 telemetry on the status characteristic (0xFF02).
+ * Every client that enables notifications gets its own subscription —
+ * default pose + angles at 50 Hz — changed by writing 3 bytes
+ * [mask, rate_hz u16 LE] to 0xFF02 (or BLE:TEL from the serial side).
+ * Samples are packed back to back up to the client's negotiated MTU.
+ */
+#define BLE_TEL_MAX_HZ  250
+
+typedef struct {
+    uint16_t conn_id, mtu;
+    bool     notify, congested;
+    uint8_t  mask;
+    uint16_t rate_hz;
+    uint32_t samples, notifies, dropped;
+} BleTelStatus;
+
+/** Union of the subscribed clients' TEL2 groups; 0 = nobody listening. */
+uint8_t ble_transport_tel_mask(void);
+
+/**
+ * CueTask: queue one TEL2 sample encoded with ble_transport_tel_mask().
+ * Never blocks; false when the queue is full.
+ */
+bool ble_transport_tel_push(const uint8_t *sample, int len);
+
+/** Set a client's TEL2 groups and rate (conn_id < 0: every client). */
+bool ble_transport_tel_config(int conn_id, uint8_t mask, uint16_t rate_hz);
+
+/** Per-client telemetry state; returns the number of entries filled. */
+int ble_transport_tel_status(BleTelStatus *out, int max);
+
 #ifdef __cplusplus
 }
 #endif
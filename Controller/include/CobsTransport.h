@@ -1,5 +1,5 @@
 // CobsTransport.h — COBS-framed multiplexed serial transport for ESP32
-// Provides clean channel separation: DATA, CMD, TEL, LOG, RESP
+// Provides clean channel separation: DATA, CMD, TEL, LOG, RESP, UPLOAD
 // Self-recovering framing — boot garbage and corruption auto-discard
 #ifndef COBS_TRANSPORT_H
 #define COBS_TRANSPORT_H
@@ -11,6 +11,10 @@
 extern "C" {
 #endif
 
+// Largest decoded inbound frame (channel byte + payload). Sized for 2 KB
+// upload chunks; outbound frames stay small (responses, telemetry).
+#define COBS_MAX_RX_FRAME  2112
+
 // Initialize COBS transport on UART0.
 // Installs UART driver, redirects ESP-IDF logs, sends sync delimiters.
 // Must be called from app_main() before any other transport I/O.
@@ -33,6 +37,11 @@ void cobs_send_telemetry(const float angles[6], const float positions[6]);
 // Blocks up to timeout_ms. Call from a FreeRTOS task loop.
 int  cobs_read_process(int timeout_ms);
 
+// Route one decoded frame (channel byte + payload) to its registered
+// handler. cobs_read_process() calls this per frame; exposed for the host
+// bench (host/bench_hotpath.cpp).
+void cobs_dispatch_frame(const uint8_t *data, int len);
+
 // Callback types
 typedef void (*cobs_data_cb_t)(const uint8_t *payload, int len);
 typedef void (*cobs_cmd_cb_t)(const char *cmd);
@@ -45,6 +54,10 @@ void cobs_set_cmd_handler(cobs_cmd_cb_t handler);
 // 6x float32 pre-cue telemetry). Dispatched separately from baked CH_DATA.
 void cobs_set_data_raw_handler(cobs_data_cb_t handler);
 
+// Register handler for sequence-upload frames (COBS_CH_UPLOAD, SeqUpload.h).
+// Called on the RX task — must not touch flash.
+void cobs_set_upload_handler(cobs_data_cb_t handler);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,74 @@
+// MiniPlatform.h — Mini-6DOF platform constants + the RAW cue step
+// Shared by the firmware (CueTask) and the host tools so both run the exact
+// same geometry defaults, limits and cue-output conversion.
+#ifndef MINI_PLATFORM_H
+#define MINI_PLATFORM_H
+
+#include "InverseKinematics.h"
+#include "AxisScaling.h"
+#include "MotionCueing.h"
+
+// Workspace probe margin for computeAxisScalesFromGeometry()
+#define AXIS_SCALE_MARGIN     0.90f
+
+// ── Slew-Rate Limiter (per-TIME, rate-independent) ───────────────────
+// FIX TRAP B (MCU_HIFI_CUEING.md §2): the old limit was per-CALL (5 units/
+// cycle) which silently assumed 50 Hz. At 250 Hz that would be ~5x harsher.
+// Express it as units/SECOND and multiply by dt so it's identical in feel at
+// any cueLoopHz. 250 units/s == the old 5 units × 50 Hz.
+#define SLEW_RATE_MAX_PER_S   250.0f                     // mm (or rad) per SECOND
+
+// ── IK Angle Limits ──────────────────────────────────────────────────
+// Max servo arm deflection in radians (±45° is typical hobby servo range)
+#define SERVO_MAX_ANGLE_RAD  (IK_PI / 4.0f)
+
+// Mini-6DOF specific defaults (geometry in mm, converted from inches)
+static inline void initMiniDefaults(StewartConfig* cfg) {
+    cfg->theta_r = 10.0f;
+    cfg->theta_s[0] = 150.0f; cfg->theta_s[1] = -90.0f; cfg->theta_s[2] = 30.0f;
+    cfg->theta_s[3] = 150.0f; cfg->theta_s[4] = -90.0f; cfg->theta_s[5] = 30.0f;
+    cfg->theta_p = 30.0f;
+    cfg->RD = 15.75f;               // base radius (mm — original Mini uses mm directly)
+    cfg->PD = 16.0f;                // platform radius (mm)
+    cfg->ServoArmLengthL1 = 7.25f;  // servo horn length (mm)
+    cfg->ConnectingArmLengthL2 = 28.5f; // connecting rod length (mm)
+    cfg->platformHeight = 25.517f;   // neutral height (mm)
+
+    // Drive train not used for PWM servos — kept for API compat
+    cfg->virtual_gear = 1.0f;
+    cfg->planetary_ratio = 1.0f;
+    cfg->encoder_ppr = 1;
+    cfg->steps_per_degree = 1.0f;
+}
+
+// One RAW (pre-cue, M6P2 / CH_DATA_RAW) frame through the cue chain, out to
+// the COUNT domain mapRawToPosition() expects.
+// RAW = pre-cue telemetry in APP axis order (surge=0, sway=1), no wire swap.
+// Run the cue chain in app order (the washout/tilt engine is defined in app
+// order), THEN swap surge<->sway into device order before scaling/IK — the
+// swap the baked wire already carried.
+// RAW = signed PERCENT. mapRawToPosition expects the COUNT domain [0..max_raw]
+// centered at home, so convert per the pinned contract:
+// counts = home*(1 + pct/100)  =>  ±100% spans 0..max_raw and the mapping
+// yields position = scale*(pct/100). Feeding raw percent straight in sits ~0
+// counts << home and rails the output — decoupled from input.
+// cueFilteredFrame() is the same step for frames that were already input-
+// filtered upstream (the zero-phase lookahead path in DEMO).
+static inline void cueFilteredFrame(MotionCueingConfig* mca, const float f[6],
+                                    float maxRaw, float counts[6]) {
+    float m[6], o[6];
+    processMotionCueing(mca, f, m);
+    mcaApplyOutputStage(mca, m, o);
+    float tmp = o[0]; o[0] = o[1]; o[1] = tmp;   // surge<->sway (app->device)
+    float home = (float)((int)maxRaw / 2);
+    for (int i = 0; i < 6; i++) counts[i] = home * (1.0f + o[i] * 0.01f);
+}
+
+static inline void cueRawFrame(InputFilterConfig* inputFilter, MotionCueingConfig* mca,
+                               const float ch[6], float maxRaw, float counts[6]) {
+    float f[6];
+    processInputFilter(inputFilter, ch, f);
+    cueFilteredFrame(mca, f, maxRaw, counts);
+}
+
+#endif // MINI_PLATFORM_H
@@ -0,0 +1,67 @@
+// NvsPersist.h — Coalescing NVS writes off the command path
+// The command handler stages a key's new value (a memcpy under a mutex, no
+// flash access) and returns. NvsSave (core 0, low priority) waits until no
+// key has changed for NVS_PERSIST_DEBOUNCE_MS, then writes only the dirty
+// keys and does a single nvs_commit(). A value identical to the last staged
+// one is not re-marked, so "save everything" callers cost nothing for the
+// keys they did not change. nvs_persist_flush() skips the debounce. A failed
+// set / commit leaves its keys dirty and retries after NVS_PERSIST_RETRY_MS.
+#ifndef NVS_PERSIST_H
+#define NVS_PERSIST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NVS_PERSIST_SLOTS         12      // distinct keys
+#define NVS_PERSIST_MAX_BLOB      256     // largest value (geometry blob)
+#define NVS_PERSIST_DEBOUNCE_MS   500     // quiet time before a commit
+#define NVS_PERSIST_MAX_DEFER_MS  3000    // a continuous burst still commits this often
+#define NVS_PERSIST_RETRY_MS      2000    // after a failed write-out (keys stay dirty)
+
+typedef struct {
+    uint32_t commits;      // nvs_commit() calls
+    uint32_t writes;       // keys written (nvs_set_*)
+    uint32_t staged;       // stage calls that changed a value
+    uint32_t coalesced;    // ... of which hit an already-dirty key
+    uint32_t errors;       // failed open / set / commit
+    uint32_t pending;      // keys dirty right now
+    uint32_t lastUs;       // duration of the last write-out (sets + commit)
+    uint32_t lastKeys;     // keys in the last write-out
+} NvsPersistStats;
+
+// Called from NvsSave after a flush request completes: keys written, ok.
+typedef void (*nvs_persist_done_cb_t)(int keys, bool ok);
+
+// Writer for a value kept in another module's NVS format; runs in NvsSave,
+// returns 0 on success.
+typedef int (*nvs_persist_write_fn)(void);
+
+// Create the staging lock and NvsSave. Call after nvs_flash_init().
+void nvs_persist_init(const char *ns);
+
+// Stage a value for `key` (≤ 15 chars). Never touches flash. Returns false
+// when the slot table is full or the value is too large.
+bool nvs_persist_blob(const char *key, const void *data, size_t len);
+bool nvs_persist_u8(const char *key, uint8_t v);
+bool nvs_persist_u16(const char *key, uint16_t v);
+
+// Stage a call instead of a value (e.g. stewart-core's mcaSaveToNVS, which
+// owns its key and blob layout): `fn` runs once in the next write-out, with
+// the other keys. Always marks `key` dirty; the caller snapshots the data.
+bool nvs_persist_call(const char *key, nvs_persist_write_fn fn);
+
+// Write the dirty keys now; `done` (may be NULL) runs in NvsSave afterwards.
+void nvs_persist_flush(nvs_persist_done_cb_t done);
+
+void nvs_persist_stats(NvsPersistStats *st);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NVS_PERSIST_H
@@ -0,0 +1,72 @@
+// SeqLibrary.h — .m6p sequence library on the raw `seq` flash partition
+// Directory format: M6PL (m6p.h). Frames are read in place through
+// esp_partition_mmap — no copy into RAM. Entry 0 is the sequence embedded in
+// the app image (when built with MINI6DOF_EMBED_SEQ) and is the fallback when
+// the partition is blank or an entry fails its boot CRC check.
+#ifndef SEQ_LIBRARY_H
+#define SEQ_LIBRARY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "m6p.h"
+#include "esp_partition.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SEQ_LIBRARY_MAX  (1 + M6PL_MAX_ENTRIES)   // embedded + partition slots
+
+typedef struct {
+    M6pInfo  info;
+    uint32_t offset;     // partition offset of the file (0 for embedded)
+    uint32_t length;     // file bytes (header + frames)
+    int      status;     // M6pStatus from the boot check (header + CRC)
+    bool     embedded;
+} SeqEntry;
+
+// Scan the directory and CRC-check every entry (boot; ~30 ms per MB).
+// `embedded` / `embedded_len` describe the app-image file, or NULL / 0.
+// Returns the number of entries (embedded included, failed ones included).
+int seq_library_init(const uint8_t *embedded, size_t embedded_len);
+
+// Re-read the directory after it changed on flash (e.g. an upload).
+// Must not be called while an entry is mapped for playback.
+int seq_library_rescan(void);
+
+int             seq_library_count(void);
+const SeqEntry *seq_library_entry(int n);      // NULL when out of range
+
+// Map entry `n` (releasing the previous mapping) and return its 64-byte
+// header; frames follow contiguously. NULL if `n` is invalid or not OK.
+const uint8_t  *seq_library_map(int n);
+
+// Partition geometry: total bytes and first free 4 KB-aligned offset.
+uint32_t seq_library_capacity(void);
+uint32_t seq_library_free_offset(void);
+
+// First EMPTY directory slot, or -1 when the directory is full / no partition.
+int      seq_library_free_slot(void);
+
+// The raw `seq` partition (NULL when the table has none) — for the uploader,
+// which writes file data into [free_offset, capacity) itself.
+const esp_partition_t *seq_library_partition(void);
+
+// One writer at a time past free_offset (upload or recording). Claim before
+// choosing the offset, release after the commit (or the failure).
+bool     seq_library_claim_writer(void);
+void     seq_library_release_writer(void);
+
+// Append a directory entry for a file already written and verified at
+// `offset` (writes the directory header first on a blank partition). The
+// state word is programmed last, so the entry appears atomically. Returns the
+// directory slot or -1; call seq_library_rescan() (not while mapped) to see it.
+int      seq_library_commit(uint32_t offset, uint32_t length,
+                            const uint8_t header[M6P_HEADER_SIZE]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEQ_LIBRARY_H
@@ -0,0 +1,95 @@
+// SeqRecord.h — Record live motion into the `seq` partition as a new .m6p
+// CueTask samples the live target (CH_DATA -> M6P1 counts, CH_DATA_RAW ->
+// M6P2 pre-cue floats) at the recording rate and pushes frames into a RAM
+// ring — never blocks; a full ring counts a drop. RecordTask drains the ring
+// in flash-page programs issued right after a CueTask tick, so the cache-off
+// window lands in CueTask's idle time. An erase turns the flash cache off on
+// both cores for tens to hundreds of ms, so the reservation is erased at
+// REC:START with the rig parked (SOURCE:OFF), before capture begins: the
+// erase only advances while `parked` says so, never mid-session. REC:STOP
+// programs the 64-byte header (left erased until then) and commits the
+// directory entry.
+#ifndef SEQ_RECORD_H
+#define SEQ_RECORD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SEQ_REC_RATE_MIN     10
+#define SEQ_REC_RATE_MAX     250
+#define SEQ_REC_SECONDS_MAX  1800
+
+typedef enum {
+    SEQ_REC_IDLE      = 0,
+    SEQ_REC_ARMING    = 1,   // erasing the reservation (only while parked)
+    SEQ_REC_CAPTURE   = 2,   // accepting samples
+    SEQ_REC_FINISHING = 3,   // draining, header, directory commit
+} SeqRecState;
+
+typedef enum {
+    SEQ_REC_OK        =  0,
+    SEQ_REC_ERR_BUSY  = -1,   // recording already running / upload owns the partition
+    SEQ_REC_ERR_SPACE = -2,   // no partition, directory full or not enough free space
+    SEQ_REC_ERR_EMPTY = -3,   // stopped before any sample arrived; nothing committed
+    SEQ_REC_ERR_FLASH = -4,   // erase/write/commit failed
+    SEQ_REC_ERR_ARG   = -5,   // rate / duration out of range
+    SEQ_REC_ERR_IDLE  = -6,   // REC:STOP with nothing recording
+} SeqRecStatus;
+
+typedef struct {
+    int      state;        // SeqRecState
+    uint8_t  kind;         // M6pKind of the take, 0 until the first sample
+    uint16_t rate;
+    uint32_t frames;       // captured (ring + flash)
+    uint32_t maxFrames;    // reservation; capture stops there
+    uint32_t written;      // file bytes programmed
+    uint32_t dropped;      // ring full (RecordTask behind)
+    uint32_t rejected;     // other format than the take's first sample
+    uint32_t ringPeak;     // ring high-water mark, frames
+    uint32_t ringSize;
+    int      lastStatus;   // SeqRecStatus of the last finished take
+    int      lastIndex;    // its library index, -1 = none
+} SeqRecordStatus;
+
+// on_done: RecordTask, after the take was committed to directory slot `slot`;
+// rescan the library and return the new entry's index.
+typedef int (*seq_record_done_cb_t)(int slot);
+
+// parked: RecordTask, before each erase unit; true while the rig is parked
+// (no motion output to stall). ARMING waits while it returns false.
+typedef bool (*seq_record_parked_cb_t)(void);
+
+// Create RecordTask (core 0). Call after seq_library_init().
+void seq_record_init(seq_record_done_cb_t on_done, seq_record_parked_cb_t parked);
+
+// Claim the free space, reserve `max_seconds` at `rate` and arm (erase in the
+// background while parked; capture starts when REC:STATUS says so). `bits` =
+// M6P1 depth.
+int  seq_record_start(uint16_t rate, uint32_t max_seconds, uint16_t bits, const char *name);
+
+// Finish the take: RecordTask drains, programs the header and commits.
+// Stopping while arming discards the take (SEQ_REC_ERR_EMPTY).
+int  seq_record_stop(void);
+
+// CueTask: one sample of the live target, `kind` M6P_KIND_BAKED / _RAW.
+// Lock-free, never blocks; false when not capturing or dropped.
+bool seq_record_push(const float ch[6], uint8_t kind);
+
+// CueTask, every tick after the servo write: wakes RecordTask when a page
+// is ready (or the take is finishing) so its flash program runs while
+// CueTask sleeps. One load when idle.
+void seq_record_tick(void);
+
+bool seq_record_capturing(void);
+void seq_record_status(SeqRecordStatus *st);
+const char *seq_record_strerror(int st);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEQ_RECORD_H
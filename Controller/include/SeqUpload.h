@@ -0,0 +1,50 @@
+// SeqUpload.h — Pipelined .m6p upload into the `seq` partition over COBS
+// Wire protocol: M6PU (m6p.h), channel COBS_CH_UPLOAD. The RX task only checks
+// each chunk's CRC and copies it into one of two sector buffers; UploadTask
+// programs full buffers and erases the sectors ahead of the write point while
+// the link is busy, so reception never waits on flash. Progress is
+// checkpointed in NVS every 64 KB — a BEGIN with the same header after an
+// interruption (or a reboot) resumes from the checkpoint. The file becomes
+// selectable only after END re-reads it from flash and the CRC-32 matches
+// crc32@52 of its header.
+#ifndef SEQ_UPLOAD_H
+#define SEQ_UPLOAD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    bool     active;        // session open (BEGIN .. END/ABORT)
+    bool     busy;          // UploadTask still draining / verifying
+    uint32_t length;        // file bytes
+    uint32_t received;      // next offset the RX side expects
+    uint32_t written;       // bytes programmed
+    uint32_t resumed;       // offset the session resumed from
+    uint32_t bytesPerSec;   // last finished session (received / wall time)
+    int      lastStatus;    // M6puStatus of the last finished session
+} SeqUploadStatus;
+
+// on_begin: RX task, after BEGIN was accepted (e.g. park the rig — erases
+//           stall the other core while the flash cache is off).
+// on_done:  UploadTask, after the entry was committed to the directory in
+//           `slot`; rescan the library and return the new entry's index.
+typedef void (*seq_upload_begin_cb_t)(void);
+typedef int  (*seq_upload_done_cb_t)(int slot);
+
+// Create UploadTask (core 0). Call after seq_library_init().
+void seq_upload_init(seq_upload_begin_cb_t on_begin, seq_upload_done_cb_t on_done);
+
+// COBS_CH_UPLOAD frame handler (cobs_set_upload_handler). Never touches flash.
+void seq_upload_handle_frame(const uint8_t *payload, int len);
+
+void seq_upload_status(SeqUploadStatus *st);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEQ_UPLOAD_H
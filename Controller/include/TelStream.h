@@ -0,0 +1,37 @@
+// TelStream.h — TEL2 telemetry out of CueTask without blocking it
+// CueTask encodes a sample (tel2.h) and hands it over with a zero-wait
+// queue send — a full queue counts a drop, never a stall. TelTask (core 0,
+// low priority) drains the queue onto COBS_CH_TEL2, so UART back-pressure
+// and the TX mutex never reach the cue loop.
+#ifndef TEL_STREAM_H
+#define TEL_STREAM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TEL_STREAM_DEPTH  32      // samples queued (128 ms at 250 Hz)
+
+typedef struct {
+    uint32_t sent;        // frames handed to the transport
+    uint32_t dropped;     // queue full at push
+    uint32_t peak;        // queue high-water mark
+} TelStreamStats;
+
+// Create the queue and TelTask. Call before CueTask starts.
+void tel_stream_init(void);
+
+// CueTask: queue one encoded TEL2 sample (≤ TEL2_MAX_SIZE). Never blocks.
+bool tel_stream_push(const uint8_t *buf, int len);
+
+void tel_stream_stats(TelStreamStats *st);
+void tel_stream_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEL_STREAM_H
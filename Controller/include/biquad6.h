@@ -0,0 +1,151 @@
+// biquad6.h — Structure-of-arrays biquad cascade for the six platform axes
+// Header-only, zero-dependency, works on ESP32 and desktop
+//
+// Coefficients and state are stored stage-major, axis-minor ([stage][lane]),
+// so one tick of all six axes is a straight pass over contiguous rows. On the
+// host each stage maps onto two 4-wide SIMD ops (GCC vector extensions, SSE2
+// or NEON); on the ESP32 the six independent chains interleave so the FPU's
+// madd.s latency is hidden instead of stalling one axis at a time. Lanes 6..7
+// are padding (zero coefficients, zero state) so every row is 32 bytes.
+//
+// Each section is transposed direct form II, normalized so a0 == 1:
+//   y  = b0*x + z1
+//   z1 = b1*x - a1*y + z2
+//   z2 = b2*x - a2*y
+//
+// Not in the live cue chain, by scope: the washout / input filters are
+// stewart-core's own (MotionCueing), and this kernel has only been checked
+// against the per-filter reference in host/bench_biquad6.cpp, not against
+// that chain. MCA:BENCH and biquad6_bench use it to size what a port would
+// save; porting processInputFilter / processMotionCueing onto it needs a
+// tolerance check against the existing chain first.
+#ifndef BIQUAD6_H
+#define BIQUAD6_H
+
+#include <math.h>
+#include <string.h>
+
+#define BIQUAD6_AXES        6
+#define BIQUAD6_LANES       8   // 6 axes padded to two 4-wide vectors
+#define BIQUAD6_MAX_STAGES  6
+
+#if !defined(ESP_PLATFORM) && defined(__GNUC__) && (defined(__SSE2__) || defined(__ARM_NEON))
+#  define BIQUAD6_SIMD 1
+typedef float biquad6_v4 __attribute__((vector_size(16)));
+#endif
+
+typedef struct {
+    float b0[BIQUAD6_MAX_STAGES][BIQUAD6_LANES];
+    float b1[BIQUAD6_MAX_STAGES][BIQUAD6_LANES];
+    float b2[BIQUAD6_MAX_STAGES][BIQUAD6_LANES];
+    float a1[BIQUAD6_MAX_STAGES][BIQUAD6_LANES];
+    float a2[BIQUAD6_MAX_STAGES][BIQUAD6_LANES];
+    float z1[BIQUAD6_MAX_STAGES][BIQUAD6_LANES];
+    float z2[BIQUAD6_MAX_STAGES][BIQUAD6_LANES];
+    int   stages;
+} __attribute__((aligned(16))) Biquad6;
+
+// ── Setup ────────────────────────────────────────────────────────────
+
+// Zero everything and make `stages` pass-through sections (b0 = 1) on the
+// six real lanes. Padding lanes stay all-zero.
+static inline void biquad6_init(Biquad6 *bq, int stages) {
+    memset(bq, 0, sizeof(*bq));
+    if (stages < 0) stages = 0;
+    if (stages > BIQUAD6_MAX_STAGES) stages = BIQUAD6_MAX_STAGES;
+    bq->stages = stages;
+    for (int s = 0; s < stages; s++)
+        for (int a = 0; a < BIQUAD6_AXES; a++)
+            bq->b0[s][a] = 1.0f;
+}
+
+// Set one section's normalized coefficients (a0 already divided out).
+// Does not touch the section state.
+static inline void biquad6_set(Biquad6 *bq, int stage, int axis,
+                               float b0, float b1, float b2, float a1, float a2) {
+    if (stage < 0 || stage >= bq->stages || axis < 0 || axis >= BIQUAD6_AXES) return;
+    bq->b0[stage][axis] = b0;
+    bq->b1[stage][axis] = b1;
+    bq->b2[stage][axis] = b2;
+    bq->a1[stage][axis] = a1;
+    bq->a2[stage][axis] = a2;
+}
+
+// RBJ cookbook 2nd-order low/high-pass (q = 0.7071 -> Butterworth).
+// fc is clamped just under Nyquist so a retune to a low loop rate stays stable.
+static inline void biquad6_design(Biquad6 *bq, int stage, int axis,
+                                  int highpass, float fc, float fs, float q) {
+    if (fs <= 0.0f || fc <= 0.0f || q <= 0.0f) return;
+    if (fc > 0.49f * fs) fc = 0.49f * fs;
+    float w  = 2.0f * 3.14159265358979f * fc / fs;
+    float cw = cosf(w);
+    float al = sinf(w) / (2.0f * q);
+    float a0 = 1.0f + al;
+    float b0, b1, b2;
+    if (highpass) { b0 = (1.0f + cw) * 0.5f; b1 = -(1.0f + cw); b2 = b0; }
+    else          { b0 = (1.0f - cw) * 0.5f; b1 =  (1.0f - cw); b2 = b0; }
+    biquad6_set(bq, stage, axis, b0 / a0, b1 / a0, b2 / a0,
+                (-2.0f * cw) / a0, (1.0f - al) / a0);
+}
+
+static inline void biquad6_set_lowpass(Biquad6 *bq, int stage, int axis, float fc, float fs, float q) {
+    biquad6_design(bq, stage, axis, 0, fc, fs, q);
+}
+
+static inline void biquad6_set_highpass(Biquad6 *bq, int stage, int axis, float fc, float fs, float q) {
+    biquad6_design(bq, stage, axis, 1, fc, fs, q);
+}
+
+static inline void biquad6_reset(Biquad6 *bq) {
+    memset(bq->z1, 0, sizeof(bq->z1));
+    memset(bq->z2, 0, sizeof(bq->z2));
+}
+
+// ── Per-tick kernel: one sample on all six axes through every stage ──
+
+#ifdef BIQUAD6_SIMD
+static inline biquad6_v4 biquad6_ld(const float *p) { biquad6_v4 v; memcpy(&v, p, sizeof(v)); return v; }
+static inline void       biquad6_st(float *p, biquad6_v4 v) { memcpy(p, &v, sizeof(v)); }
+#endif
+
+static inline void biquad6_tick(Biquad6 *bq, const float in[BIQUAD6_AXES], float out[BIQUAD6_AXES]) {
+#ifdef BIQUAD6_SIMD
+    float xin[BIQUAD6_LANES] = { in[0], in[1], in[2], in[3], in[4], in[5], 0.0f, 0.0f };
+    biquad6_v4 xl = biquad6_ld(xin), xh = biquad6_ld(xin + 4);
+    for (int s = 0; s < bq->stages; s++) {
+        for (int h = 0; h < 2; h++) {
+            const int o = h * 4;
+            biquad6_v4 x  = h ? xh : xl;
+            biquad6_v4 z1 = biquad6_ld(&bq->z1[s][o]);
+            biquad6_v4 z2 = biquad6_ld(&bq->z2[s][o]);
+            biquad6_v4 y  = biquad6_ld(&bq->b0[s][o]) * x + z1;
+            z1 = biquad6_ld(&bq->b1[s][o]) * x - biquad6_ld(&bq->a1[s][o]) * y + z2;
+            z2 = biquad6_ld(&bq->b2[s][o]) * x - biquad6_ld(&bq->a2[s][o]) * y;
+            biquad6_st(&bq->z1[s][o], z1);
+            biquad6_st(&bq->z2[s][o], z2);
+            if (h) xh = y; else xl = y;
+        }
+    }
+    float yout[BIQUAD6_LANES];
+    biquad6_st(yout, xl);
+    biquad6_st(yout + 4, xh);
+    memcpy(out, yout, BIQUAD6_AXES * sizeof(float));
+#else
+    float x[BIQUAD6_AXES];
+    memcpy(x, in, sizeof(x));
+    for (int s = 0; s < bq->stages; s++) {
+        float *z1 = bq->z1[s], *z2 = bq->z2[s];
+        const float *b0 = bq->b0[s], *b1 = bq->b1[s], *b2 = bq->b2[s];
+        const float *a1 = bq->a1[s], *a2 = bq->a2[s];
+        for (int a = 0; a < BIQUAD6_AXES; a++) {
+            float y = b0[a] * x[a] + z1[a];
+            z1[a] = b1[a] * x[a] - a1[a] * y + z2[a];
+            z2[a] = b2[a] * x[a] - a2[a] * y;
+            x[a] = y;
+        }
+    }
+    memcpy(out, x, sizeof(x));
+#endif
+}
+
+#endif // BIQUAD6_H
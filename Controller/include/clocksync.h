@@ -0,0 +1,140 @@
+// clocksync.h — Device-vs-host clock offset and drift from timestamp exchanges
+// Header-only, zero-dependency, works on ESP32 and desktop
+//
+// The host stamps a request with its clock (t1), the device notes receipt
+// (t2) and reply (t3) on esp_timer, the host notes the reply's arrival (t4)
+// and hands t4 back with its next request. Per exchange (NTP):
+//   θ = ((t2 − t1) + (t3 − t4)) / 2     device − host
+//   δ = (t4 − t1) − (t3 − t2)           round trip on the wire
+// θ is off by at most half the path asymmetry, which grows with δ, so only
+// exchanges within CLOCKSYNC_DELAY_SLACK_US of the smallest δ in the window
+// count. A least-squares line through their θ against device time gives the
+// offset at the newest sample and the drift (crystal ppm difference).
+//
+//   ClockSync cs;  clocksync_init(&cs);
+//   clocksync_add(&cs, t1, t2, t3, t4);
+//   int64_t due = clocksync_to_device(&cs.m, host_us);
+#ifndef CLOCKSYNC_H
+#define CLOCKSYNC_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define CLOCKSYNC_WINDOW          32      // exchanges kept (16 s at the host's 2 Hz)
+#define CLOCKSYNC_MIN_SAMPLES     4       // before the model is valid
+#define CLOCKSYNC_DELAY_SLACK_US  300     // δ above the window minimum still used
+#define CLOCKSYNC_MIN_SPAN_US     2000000 // fit drift only over ≥ 2 s of samples
+#define CLOCKSYNC_DRIFT_MAX       200e-6  // |drift| beyond this is a bad fit, not a crystal
+
+// device = host + offset + drift · (device − ref)
+typedef struct {
+    int64_t ref;        // device µs the line is anchored at (newest sample used)
+    int64_t offset;     // device − host at ref, µs
+    double  drift;      // s/s (× 1e6 = ppm); > 0: device clock runs fast
+    bool    valid;
+} ClockSyncModel;
+
+typedef struct {
+    int64_t t2;         // device receipt
+    int64_t theta;      // device − host
+    int32_t delay;      // round trip minus device turnaround
+} ClockSyncSample;
+
+typedef struct {
+    ClockSyncSample s[CLOCKSYNC_WINDOW];
+    uint32_t n;          // exchanges accepted (ring index = n % WINDOW)
+    uint32_t rejected;   // negative / absurd round trip
+    int32_t  minDelay;   // smallest δ in the window
+    int32_t  lastDelay;
+    int32_t  resid;      // RMS of the used samples about the line, µs
+    uint8_t  used;       // samples in the last fit
+    ClockSyncModel m;
+} ClockSync;
+
+static inline void clocksync_init(ClockSync *cs) {
+    memset(cs, 0, sizeof(*cs));
+}
+
+static inline int64_t clocksync_to_device(const ClockSyncModel *m, int64_t host) {
+    const int64_t d = host + m->offset;   // first order: drift² is < 1e-7
+    return d + (int64_t)(m->drift * (double)(d - m->ref));
+}
+
+static inline int64_t clocksync_to_host(const ClockSyncModel *m, int64_t dev) {
+    return dev - m->offset - (int64_t)(m->drift * (double)(dev - m->ref));
+}
+
+// Refit from the window. Returns the model's validity.
+static inline bool clocksync_fit(ClockSync *cs) {
+    const uint32_t have = cs->n < CLOCKSYNC_WINDOW ? cs->n : CLOCKSYNC_WINDOW;
+    if (!have) return false;
+    int32_t minD = INT32_MAX;
+    int64_t newest = INT64_MIN, oldest = INT64_MAX;
+    for (uint32_t i = 0; i < have; i++)
+        if (cs->s[i].delay < minD) minD = cs->s[i].delay;
+    const int32_t lim = minD + CLOCKSYNC_DELAY_SLACK_US;
+    for (uint32_t i = 0; i < have; i++) {
+        if (cs->s[i].delay > lim) continue;
+        if (cs->s[i].t2 > newest) newest = cs->s[i].t2;
+        if (cs->s[i].t2 < oldest) oldest = cs->s[i].t2;
+    }
+    cs->minDelay = minD;
+
+    // θ = a + b·x, x = t2 − newest (s), sums relative to the first used θ.
+    int64_t th0 = 0;
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < have; i++) {
+        const ClockSyncSample *p = &cs->s[i];
+        if (p->delay > lim) continue;
+        if (!k) th0 = p->theta;
+        const double x = (double)(p->t2 - newest) * 1e-6, y = (double)(p->theta - th0);
+        sx += x; sy += y; sxx += x * x; sxy += x * y;
+        k++;
+    }
+    double b = 0.0;
+    const double den = k * sxx - sx * sx;
+    if (k >= 3 && newest - oldest >= CLOCKSYNC_MIN_SPAN_US && den > 0.0) {
+        b = (k * sxy - sx * sy) / den;                 // µs per s = ppm
+        if (fabs(b) > CLOCKSYNC_DRIFT_MAX * 1e6) b = cs->m.drift * 1e6;
+    } else {
+        b = cs->m.drift * 1e6;                         // keep the last drift until the span allows a fit
+    }
+    const double a = (sy - b * sx) / k;
+
+    double r2 = 0;
+    for (uint32_t i = 0; i < have; i++) {
+        const ClockSyncSample *p = &cs->s[i];
+        if (p->delay > lim) continue;
+        const double e = (double)(p->theta - th0) - (a + b * (double)(p->t2 - newest) * 1e-6);
+        r2 += e * e;
+    }
+    cs->used    = (uint8_t)k;
+    cs->resid   = (int32_t)sqrt(r2 / k);
+    cs->m.ref    = newest;
+    cs->m.offset = th0 + (int64_t)llround(a);
+    cs->m.drift  = b * 1e-6;
+    cs->m.valid  = cs->n >= CLOCKSYNC_MIN_SAMPLES;
+    return cs->m.valid;
+}
+
+// One completed exchange. Returns false if it was rejected.
+static inline bool clocksync_add(ClockSync *cs, int64_t t1, int64_t t2, int64_t t3, int64_t t4) {
+    const int64_t delay = (t4 - t1) - (t3 - t2);
+    cs->lastDelay = (int32_t)(delay > INT32_MAX ? INT32_MAX : delay);
+    if (delay < 0 || delay > 1000000 || t3 < t2) {
+        cs->rejected++;
+        return false;
+    }
+    ClockSyncSample *p = &cs->s[cs->n % CLOCKSYNC_WINDOW];
+    p->t2    = t2;
+    p->theta = ((t2 - t1) + (t3 - t4)) / 2;
+    p->delay = (int32_t)delay;
+    cs->n++;
+    clocksync_fit(cs);
+    return true;
+}
+
+#endif // CLOCKSYNC_H
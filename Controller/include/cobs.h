@@ -14,6 +14,11 @@
 #define COBS_CH_RESP      0x05  // ESP->App: command response text
 #define COBS_CH_DATA_RAW  0x07  // App->ESP: RAW pre-cue telemetry (24 bytes: 6x float32 LE)
                                 //   cued on-device by CueTask (DECISIONS round 3/4)
+#define COBS_CH_UPLOAD    0x08  // App<->ESP: .m6p upload to the seq partition
+                                //   (binary ops + acks, SeqUpload.h)
+#define COBS_CH_SCOPE     0x09  // ESP->App: SCOPE:DUMP capture (scope.h)
+#define COBS_CH_TEL2      0x0A  // ESP->App: TEL2 compact telemetry, one sample
+                                //   per frame from CueTask (tel2.h)
 
 // Max COBS overhead: 1 byte per 254 input bytes + 1
 #define COBS_MAX_ENC_SIZE(n) ((n) + ((n) / 254) + 1)
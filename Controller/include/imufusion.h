@@ -0,0 +1,158 @@
+// imufusion.h — 6-axis IMU fusion (Madgwick gradient descent) + gravity removal
+// Header-only, zero-dependency, works on ESP32 and desktop
+//
+// ACCEL:MODE=RAW: the phone forwards raw sensor samples on 0xFF03 and CueTask
+// runs this filter once per tick on the freshest one (zero-order hold), so
+// orientation latency is one device tick instead of the phone's fusion
+// pipeline. Inputs are the Android conventions:
+//   acc  m/s², specific force (reads +g on the up axis at rest)
+//   gyr  rad/s, right-handed about the same axes
+// Outputs: roll/pitch/yaw (ZYX Euler, degrees; yaw is relative to the start —
+// there is no magnetometer) and linear acceleration (acc minus the gravity
+// the current attitude predicts), both in the sensor frame.
+//
+//   ImuFusion f;  imu_fusion_init(&f);
+//   imu_fusion_update(&f, &cfg, acc, gyr, dt);    // every CueTask tick
+//   imu_fusion_euler_deg(&f, rpy);  imu_fusion_linear(&f, acc, lin);
+//
+// Gyro bias: while the sensor is still (|ω − b| < rest_gyro and
+// ||a| − g| < rest_acc for rest_s), b follows ω with time constant bias_tau.
+// Motion freezes the estimate, so a slow turn is never learned as bias.
+#ifndef IMUFUSION_H
+#define IMUFUSION_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define IMU_GRAVITY  9.80665f
+
+typedef struct {
+    float beta;        // Madgwick gain (rad/s): accel correction vs gyro trust
+    float rest_gyro;   // rad/s: |ω − bias| below this counts as still
+    float rest_acc;    // m/s²: ||a| − g| below this counts as still
+    float rest_s;      // stillness needed before the bias adapts
+    float bias_tau;    // s: bias tracking time constant while still
+} ImuFusionConfig;
+
+typedef struct {
+    float q[4];        // attitude quaternion w, x, y, z (sensor -> world)
+    float bias[3];     // gyro bias estimate, rad/s
+    float still_s;     // time the sensor has been still
+    bool  init;        // q seeded from the first accel sample
+} ImuFusion;
+
+static inline void imu_fusion_defaults(ImuFusionConfig *c) {
+    c->beta      = 0.1f;
+    c->rest_gyro = 0.05f;
+    c->rest_acc  = 0.4f;
+    c->rest_s    = 0.5f;
+    c->bias_tau  = 2.0f;
+}
+
+// Attitude restarts from the next accel sample; the bias is kept.
+static inline void imu_fusion_reset(ImuFusion *f) {
+    f->q[0] = 1.0f; f->q[1] = f->q[2] = f->q[3] = 0.0f;
+    f->still_s = 0.0f;
+    f->init = false;
+}
+
+static inline void imu_fusion_init(ImuFusion *f) {
+    memset(f, 0, sizeof(*f));
+    imu_fusion_reset(f);
+}
+
+// Roll/pitch straight from gravity, yaw 0 — no slow convergence at start.
+static inline void imu_fusion_seed(ImuFusion *f, const float a[3]) {
+    const float roll  = atan2f(a[1], a[2]);
+    const float pitch = atan2f(-a[0], sqrtf(a[1] * a[1] + a[2] * a[2]));
+    const float cr = cosf(roll * 0.5f),  sr = sinf(roll * 0.5f);
+    const float cp = cosf(pitch * 0.5f), sp = sinf(pitch * 0.5f);
+    f->q[0] = cr * cp;
+    f->q[1] = sr * cp;
+    f->q[2] = cr * sp;
+    f->q[3] = -sr * sp;
+    f->init = true;
+}
+
+static inline void imu_fusion_update(ImuFusion *f, const ImuFusionConfig *c,
+                                     const float acc[3], const float gyr[3], float dt) {
+    const float an = sqrtf(acc[0] * acc[0] + acc[1] * acc[1] + acc[2] * acc[2]);
+    if (!f->init) {
+        if (an > 0.5f * IMU_GRAVITY) imu_fusion_seed(f, acc);
+        return;
+    }
+
+    // Bias: adapt only while still.
+    float g[3] = { gyr[0] - f->bias[0], gyr[1] - f->bias[1], gyr[2] - f->bias[2] };
+    const float gn = sqrtf(g[0] * g[0] + g[1] * g[1] + g[2] * g[2]);
+    const bool still = gn < c->rest_gyro && fabsf(an - IMU_GRAVITY) < c->rest_acc;
+    f->still_s = still ? f->still_s + dt : 0.0f;
+    if (f->still_s >= c->rest_s && c->bias_tau > 0.0f) {
+        const float k = dt / (c->bias_tau + dt);
+        for (int i = 0; i < 3; i++) {
+            f->bias[i] += k * (gyr[i] - f->bias[i]);
+            g[i] = gyr[i] - f->bias[i];
+        }
+    }
+
+    float q0 = f->q[0], q1 = f->q[1], q2 = f->q[2], q3 = f->q[3];
+    // Rate of change from the gyro: q̇ = ½ q ⊗ (0, ω)
+    float qd0 = 0.5f * (-q1 * g[0] - q2 * g[1] - q3 * g[2]);
+    float qd1 = 0.5f * ( q0 * g[0] + q2 * g[2] - q3 * g[1]);
+    float qd2 = 0.5f * ( q0 * g[1] - q1 * g[2] + q3 * g[0]);
+    float qd3 = 0.5f * ( q0 * g[2] + q1 * g[1] - q2 * g[0]);
+
+    // Gradient-descent correction toward the measured gravity direction.
+    if (an > 0.0f) {
+        const float ax = acc[0] / an, ay = acc[1] / an, az = acc[2] / an;
+        const float _2q0 = 2.0f * q0, _2q1 = 2.0f * q1, _2q2 = 2.0f * q2, _2q3 = 2.0f * q3;
+        const float _4q0 = 4.0f * q0, _4q1 = 4.0f * q1, _4q2 = 4.0f * q2;
+        const float _8q1 = 8.0f * q1, _8q2 = 8.0f * q2;
+        const float q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+        float s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+        float s1 = _4q1 * q3q3 - _2q3 * ax + 4.0f * q0q0 * q1 - _2q0 * ay - _4q1 + _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az;
+        float s2 = 4.0f * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 + _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az;
+        float s3 = 4.0f * q1q1 * q3 - _2q1 * ax + 4.0f * q2q2 * q3 - _2q2 * ay;
+        const float sn = sqrtf(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+        if (sn > 0.0f) {
+            const float k = c->beta / sn;
+            qd0 -= k * s0; qd1 -= k * s1; qd2 -= k * s2; qd3 -= k * s3;
+        }
+    }
+
+    q0 += qd0 * dt; q1 += qd1 * dt; q2 += qd2 * dt; q3 += qd3 * dt;
+    const float qn = sqrtf(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    if (qn > 0.0f) {
+        f->q[0] = q0 / qn; f->q[1] = q1 / qn; f->q[2] = q2 / qn; f->q[3] = q3 / qn;
+    } else {
+        imu_fusion_reset(f);
+    }
+}
+
+// ZYX Euler angles, degrees: rpy[0] roll, rpy[1] pitch, rpy[2] yaw.
+static inline void imu_fusion_euler_deg(const ImuFusion *f, float rpy[3]) {
+    const float q0 = f->q[0], q1 = f->q[1], q2 = f->q[2], q3 = f->q[3];
+    const float R2D = 57.2957795f;
+    float sp = 2.0f * (q0 * q2 - q3 * q1);
+    if (sp > 1.0f) sp = 1.0f;
+    if (sp < -1.0f) sp = -1.0f;
+    rpy[0] = atan2f(2.0f * (q0 * q1 + q2 * q3), 1.0f - 2.0f * (q1 * q1 + q2 * q2)) * R2D;
+    rpy[1] = asinf(sp) * R2D;
+    rpy[2] = atan2f(2.0f * (q0 * q3 + q1 * q2), 1.0f - 2.0f * (q2 * q2 + q3 * q3)) * R2D;
+}
+
+// Linear acceleration (sensor frame, m/s²): acc minus the gravity reaction
+// the current attitude predicts.
+static inline void imu_fusion_linear(const ImuFusion *f, const float acc[3], float lin[3]) {
+    const float q0 = f->q[0], q1 = f->q[1], q2 = f->q[2], q3 = f->q[3];
+    const float gx = 2.0f * (q1 * q3 - q0 * q2);
+    const float gy = 2.0f * (q0 * q1 + q2 * q3);
+    const float gz = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+    lin[0] = acc[0] - gx * IMU_GRAVITY;
+    lin[1] = acc[1] - gy * IMU_GRAVITY;
+    lin[2] = acc[2] - gz * IMU_GRAVITY;
+}
+
+#endif // IMUFUSION_H
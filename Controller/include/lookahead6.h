@@ -0,0 +1,102 @@
+// lookahead6.h — Zero-phase lookahead FIR for six-axis frames over a fixed window
+// Header-only, zero-dependency, works on ESP32 and desktop
+//
+// For streams whose future is known (a stored sequence): a symmetric
+// (linear-phase) windowed-sinc low-pass over the last 2H+1 pushed frames.
+// The output is aligned with the frame pushed H pushes ago, so when the
+// producer reads H frames AHEAD of the playhead the filtered signal has zero
+// phase lag — unlike a causal biquad, which delays motion by its group delay.
+//
+//   lookahead6_design(&la, fc, fs);      // H chosen from fc/fs, ≤ LOOKAHEAD6_MAX_HALF
+//   ... push H+1 frames starting at the playhead (lookahead6_fill the past) ...
+//   lookahead6_output(&la, y);           // y = filtered frame at the playhead
+//
+// RAM is fixed: (2·LOOKAHEAD6_MAX_HALF+1) frames × 6 floats + taps.
+#ifndef LOOKAHEAD6_H
+#define LOOKAHEAD6_H
+
+#include <math.h>
+#include <string.h>
+
+#define LOOKAHEAD6_AXES      6
+#define LOOKAHEAD6_MAX_HALF  16                          // ±16 frames (±320 ms @ 50 Hz)
+#define LOOKAHEAD6_WINDOW    (2 * LOOKAHEAD6_MAX_HALF + 1)
+#define LOOKAHEAD6_PI        3.14159265358979f
+
+typedef struct {
+    float ring[LOOKAHEAD6_WINDOW][LOOKAHEAD6_AXES];
+    float taps[LOOKAHEAD6_MAX_HALF + 1];   // symmetric: taps[k] weights frames ±k from center
+    int   half;                            // H; 0 = pass-through (output = newest frame)
+    int   head;                            // ring slot of the newest frame
+} Lookahead6;
+
+// Hamming-windowed sinc, DC gain normalized to 1. The half-width is sized so
+// the transition band is ~fc wide (H ≈ 1.6·fs/fc), clamped to the window.
+// fc <= 0 or fc >= fs/2 selects pass-through.
+static inline void lookahead6_design(Lookahead6 *la, float fc, float fs) {
+    memset(la, 0, sizeof(*la));
+    la->taps[0] = 1.0f;
+    if (fs <= 0.0f || fc <= 0.0f || fc >= 0.5f * fs) return;
+    int h = (int)ceilf(1.6f * fs / fc);
+    if (h < 1) h = 1;
+    if (h > LOOKAHEAD6_MAX_HALF) h = LOOKAHEAD6_MAX_HALF;
+    const float wc = 2.0f * LOOKAHEAD6_PI * fc / fs;
+    float sum = 0.0f;
+    for (int k = 0; k <= h; k++) {
+        float s = (k == 0) ? wc / LOOKAHEAD6_PI : sinf(wc * (float)k) / (LOOKAHEAD6_PI * (float)k);
+        float w = 0.54f + 0.46f * cosf(LOOKAHEAD6_PI * (float)k / (float)(h + 1));
+        la->taps[k] = s * w;
+        sum += (k == 0) ? la->taps[k] : 2.0f * la->taps[k];
+    }
+    for (int k = 0; k <= h; k++) la->taps[k] /= sum;
+    la->half = h;
+}
+
+// Frames the filter reads ahead of its output (== group delay of the FIR).
+static inline int lookahead6_delay(const Lookahead6 *la) { return la->half; }
+
+// Cutoff the designed taps actually achieve: the -6 dB (|H| = 0.5) point of
+// H(f) = taps[0] + 2·Σ taps[k]·cos(2πfk/fs), which sits at the design fc
+// while H is unclamped. Once the clamp to LOOKAHEAD6_MAX_HALF bites (low fc
+// at high fs) the transition widens and this lands above the request.
+// Pass-through returns fs/2. Command-path cost (a few hundred cosf).
+static inline float lookahead6_cutoff(const Lookahead6 *la, float fs) {
+    if (la->half == 0 || fs <= 0.0f) return 0.5f * fs;
+    float lo = 0.0f, hi = 0.5f * fs;
+    for (int i = 0; i < 16; i++) {                       // response falls through 0.5 once
+        const float f = 0.5f * (lo + hi), w = 2.0f * LOOKAHEAD6_PI * f / fs;
+        float g = la->taps[0];
+        for (int k = 1; k <= la->half; k++) g += 2.0f * la->taps[k] * cosf(w * (float)k);
+        if (g > 0.5f) lo = f; else hi = f;
+    }
+    return 0.5f * (lo + hi);
+}
+
+static inline void lookahead6_push(Lookahead6 *la, const float frame[LOOKAHEAD6_AXES]) {
+    la->head = (la->head + 1) % LOOKAHEAD6_WINDOW;
+    memcpy(la->ring[la->head], frame, sizeof(la->ring[0]));
+}
+
+// Seed the whole window with one frame (hold-before-start). Follow with H
+// pushes of the frames after it so the output is centered on `frame`.
+static inline void lookahead6_fill(Lookahead6 *la, const float frame[LOOKAHEAD6_AXES]) {
+    for (int i = 0; i < LOOKAHEAD6_WINDOW; i++) memcpy(la->ring[i], frame, sizeof(la->ring[0]));
+}
+
+// Filtered frame centered H pushes behind the newest one.
+static inline void lookahead6_output(const Lookahead6 *la, float out[LOOKAHEAD6_AXES]) {
+    const int h = la->half;
+    int c = la->head - h;
+    if (c < 0) c += LOOKAHEAD6_WINDOW;
+    float acc[LOOKAHEAD6_AXES];
+    for (int a = 0; a < LOOKAHEAD6_AXES; a++) acc[a] = la->taps[0] * la->ring[c][a];
+    for (int k = 1; k <= h; k++) {
+        int p = c + k; if (p >= LOOKAHEAD6_WINDOW) p -= LOOKAHEAD6_WINDOW;
+        int m = c - k; if (m < 0) m += LOOKAHEAD6_WINDOW;
+        const float t = la->taps[k];
+        for (int a = 0; a < LOOKAHEAD6_AXES; a++) acc[a] += t * (la->ring[p][a] + la->ring[m][a]);
+    }
+    memcpy(out, acc, sizeof(acc));
+}
+
+#endif // LOOKAHEAD6_H
@@ -0,0 +1,316 @@
+// m6p.h — .m6p motion-sequence container: header layout, parse/write, CRC-32,
+//         the M6PL sequence-library directory on the `seq` partition, and
+//         the M6PU upload protocol that writes into it
+// Header-only, zero-dependency, works on ESP32 and desktop
+//
+// 64-byte header, branch on magic (app Phase-2 contract, PR #29):
+//   common: magic[4]@0, u16 ver@4, u16 rate@6, u32 count@8, u32 loop@12,
+//           name[32]@16..47, u32 crc32@52 (IEEE CRC-32 of the frame data).
+//   M6P1 (baked): u16 bits@48; frames = 6×uint16 LE (12B, post-cue, wire order
+//                 = device order, surge/sway already swapped).
+//   M6P2 (raw):   u8 format@48 (1=float32), u8 channels@49 (=6), [50..51] rsvd,
+//                 [56..63] rsvd; frames = 6×float32 LE (24B), PRE-cueing, app
+//                 axis order (surge=0, sway=1), NO surge/sway swap.
+//   M6P3 (packed, m6p3.h): u8 kind@48 (1 = baked counts, 2 = raw), u8
+//                 block_log2@49, u16 bits@50, u32 payload@56 (bytes after the
+//                 header; crc32@52 covers them). Decodes to M6P1 / M6P2 frames.
+// All fields little-endian (matches both the ESP32 and x86/ARM hosts).
+#ifndef M6P_H
+#define M6P_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_rom_crc.h"
+#endif
+
+#define M6P_HEADER_SIZE   64
+#define M6P_NAME_LEN      32
+#define M6P_CRC_OFFSET    52
+
+#define M6P_STRIDE_BAKED  12   // 6 × uint16
+#define M6P_STRIDE_RAW    24   // 6 × float32
+
+typedef enum {
+    M6P_KIND_BAKED = 1,   // M6P1
+    M6P_KIND_RAW   = 2,   // M6P2
+} M6pKind;
+
+#define M6P3_LOG2_MIN  4      // 16 frames per block
+#define M6P3_LOG2_MAX  8      // 256 frames: a seek decodes ≤ 255 inside one CueTask tick
+
+typedef enum {
+    M6P_OK            =  0,
+    M6P_ERR_SHORT     = -1,   // fewer than 64 bytes
+    M6P_ERR_MAGIC     = -2,   // not M6P1/M6P2
+    M6P_ERR_FORMAT    = -3,   // M6P2 format/channels unsupported
+    M6P_ERR_EMPTY     = -4,   // rate or count is zero
+    M6P_ERR_TRUNCATED = -5,   // fewer frame bytes than count × stride
+    M6P_ERR_CRC       = -6,   // crc32@52 does not match the frame data
+} M6pStatus;
+
+typedef struct {
+    uint8_t  kind;                    // M6pKind
+    uint16_t version;
+    uint16_t rate;                    // frames per second
+    uint32_t count;                   // frames
+    uint32_t loop_point;              // clamped to 0 when >= count
+    uint16_t bits;                    // M6P1 bit depth (M6P2: 16 placeholder)
+    uint8_t  format;                  // M6P2 sample format (1 = float32)
+    uint8_t  channels;                // M6P2 channel count (6)
+    uint16_t stride;                  // bytes per (decoded) frame
+    uint32_t crc32;                   // stored crc32@52
+    uint8_t  packed;                  // 1 = M6P3 (kind = what it decodes to)
+    uint8_t  block_log2;              // M6P3 frames per block = 1 << block_log2
+    uint32_t payload;                 // M6P3 bytes after the header
+    char     name[M6P_NAME_LEN + 1];  // NUL-terminated copy
+} M6pInfo;
+
+static inline const char* m6p_strerror(int st) {
+    switch (st) {
+        case M6P_OK:            return "ok";
+        case M6P_ERR_SHORT:     return "short header";
+        case M6P_ERR_MAGIC:     return "bad magic";
+        case M6P_ERR_FORMAT:    return "unsupported format";
+        case M6P_ERR_EMPTY:     return "zero rate/count";
+        case M6P_ERR_TRUNCATED: return "truncated";
+        case M6P_ERR_CRC:       return "crc mismatch";
+        default:                return "?";
+    }
+}
+
+static inline uint16_t m6p_rd16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static inline uint32_t m6p_rd32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+static inline void m6p_wr16(uint8_t *p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static inline void m6p_wr32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+
+// IEEE 802.3 CRC-32 (zlib crc32 / esp_rom_crc32_le). Chainable: start with 0.
+static inline uint32_t m6p_crc32_update(uint32_t crc, const uint8_t *buf, size_t len) {
+#ifdef ESP_PLATFORM
+    return esp_rom_crc32_le(crc, buf, (uint32_t)len);
+#else
+    static const uint32_t tbl[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc = tbl[(crc ^ buf[i]) & 0x0F] ^ (crc >> 4);
+        crc = tbl[(crc ^ (buf[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+    return ~crc;
+#endif
+}
+
+// Parse the 64-byte header at `h`. `total` is the number of bytes available
+// from `h` (header + frames); pass 0 to skip the truncation check (e.g. when
+// only the header has been read so far).
+static inline int m6p_parse_header(const uint8_t *h, size_t total, M6pInfo *info) {
+    memset(info, 0, sizeof(*info));
+    if (total != 0 && total < M6P_HEADER_SIZE) return M6P_ERR_SHORT;
+
+    bool isM6P1 = (memcmp(h, "M6P1", 4) == 0);
+    bool isM6P2 = (memcmp(h, "M6P2", 4) == 0);
+    bool isM6P3 = (memcmp(h, "M6P3", 4) == 0);
+    if (!isM6P1 && !isM6P2 && !isM6P3) return M6P_ERR_MAGIC;
+
+    info->version    = m6p_rd16(h + 4);
+    info->rate       = m6p_rd16(h + 6);
+    info->count      = m6p_rd32(h + 8);
+    info->loop_point = m6p_rd32(h + 12);
+    memcpy(info->name, h + 16, M6P_NAME_LEN);
+    info->name[M6P_NAME_LEN] = '\0';
+    info->crc32      = m6p_rd32(h + M6P_CRC_OFFSET);
+
+    if (isM6P3) {
+        info->packed     = 1;
+        info->kind       = h[48];
+        info->block_log2 = h[49];
+        info->bits       = m6p_rd16(h + 50);
+        info->payload    = m6p_rd32(h + 56);
+        info->format     = 1;
+        info->channels   = 6;
+        if ((info->kind != M6P_KIND_BAKED && info->kind != M6P_KIND_RAW) ||
+            info->block_log2 < M6P3_LOG2_MIN || info->block_log2 > M6P3_LOG2_MAX)
+            return M6P_ERR_FORMAT;
+        info->stride     = info->kind == M6P_KIND_RAW ? M6P_STRIDE_RAW : M6P_STRIDE_BAKED;
+    } else if (isM6P2) {
+        info->kind     = M6P_KIND_RAW;
+        info->format   = h[48];
+        info->channels = h[49];
+        if (info->format != 1 || info->channels != 6) return M6P_ERR_FORMAT;
+        info->stride   = M6P_STRIDE_RAW;
+        info->bits     = 16;          // raw float32 has no bit depth (placeholder)
+    } else {
+        info->kind     = M6P_KIND_BAKED;
+        info->bits     = m6p_rd16(h + 48);
+        info->stride   = M6P_STRIDE_BAKED;
+    }
+
+    if (info->rate == 0 || info->count == 0) return M6P_ERR_EMPTY;
+    size_t data = isM6P3 ? (size_t)info->payload : (size_t)info->count * info->stride;
+    if (total != 0 && (size_t)M6P_HEADER_SIZE + data > total)
+        return M6P_ERR_TRUNCATED;
+    if (info->loop_point >= info->count) info->loop_point = 0;
+    return M6P_OK;
+}
+
+// Bytes of frame data following the header (M6P3: the packed payload).
+static inline size_t m6p_data_size(const M6pInfo *info) {
+    return info->packed ? (size_t)info->payload : (size_t)info->count * info->stride;
+}
+
+// CRC-32 of the frame data vs the stored crc32@52.
+static inline int m6p_check_crc(const M6pInfo *info, const uint8_t *frames) {
+    return m6p_crc32_update(0, frames, m6p_data_size(info)) == info->crc32 ? M6P_OK : M6P_ERR_CRC;
+}
+
+// Serialize `info` into a 64-byte header (reserved bytes zeroed). The caller
+// fills info->crc32 (m6p_crc32_update over the frames / M6P3 payload) first.
+static inline void m6p_write_header(const M6pInfo *info, uint8_t h[M6P_HEADER_SIZE]) {
+    memset(h, 0, M6P_HEADER_SIZE);
+    memcpy(h, info->packed ? "M6P3" : info->kind == M6P_KIND_RAW ? "M6P2" : "M6P1", 4);
+    m6p_wr16(h + 4, info->version ? info->version : 1);
+    m6p_wr16(h + 6, info->rate);
+    m6p_wr32(h + 8, info->count);
+    m6p_wr32(h + 12, info->loop_point);
+    size_t n = strlen(info->name);
+    memcpy(h + 16, info->name, n < M6P_NAME_LEN ? n : M6P_NAME_LEN);
+    if (info->packed) {
+        h[48] = info->kind;
+        h[49] = info->block_log2;
+        m6p_wr16(h + 50, info->bits);
+        m6p_wr32(h + 56, info->payload);
+    } else if (info->kind == M6P_KIND_RAW) {
+        h[48] = 1;
+        h[49] = 6;
+    } else {
+        m6p_wr16(h + 48, info->bits);
+    }
+    m6p_wr32(h + M6P_CRC_OFFSET, info->crc32);
+}
+
+// ── Sequence library directory (raw `seq` partition, subtype 0x40) ───
+// Sector 0 holds the directory, files follow as whole .m6p images (header +
+// frames) at 4 KB-aligned offsets:
+//   dir header (16B): magic "M6PL"@0, u16 version@4 (=1), u16 slots@6, rsvd[8]
+//   entry (80B) × slots: u32 state@0, u32 offset@4 (from partition start),
+//                        u32 length@8 (file bytes), rsvd@12, m6p header[64]@16
+// Erased NOR flash reads 0xFF and programming only clears bits, so an entry is
+// appended by programming an EMPTY slot (state word written last = commit) and
+// deleted by clearing its state to 0 — no erase until the library is rebuilt.
+#define M6PL_SECTOR        4096
+#define M6PL_DIR_HDR_SIZE  16
+#define M6PL_ENTRY_SIZE    80
+#define M6PL_MAX_ENTRIES   ((M6PL_SECTOR - M6PL_DIR_HDR_SIZE) / M6PL_ENTRY_SIZE)   // 51
+#define M6PL_DATA_OFFSET   M6PL_SECTOR          // first file
+#define M6PL_STATE_EMPTY   0xFFFFFFFFu
+#define M6PL_STATE_VALID   0x00005A5Au
+#define M6PL_STATE_DELETED 0x00000000u
+
+typedef struct {
+    uint32_t state;
+    uint32_t offset;
+    uint32_t length;
+    uint8_t  header[M6P_HEADER_SIZE];   // copy of the file's .m6p header
+} M6plEntry;
+
+static inline uint32_t m6pl_align(uint32_t v) {
+    return (v + M6PL_SECTOR - 1) & ~(uint32_t)(M6PL_SECTOR - 1);
+}
+
+// Returns the slot count, or 0 when `h` is not an M6PL directory (blank flash).
+static inline int m6pl_parse_dir(const uint8_t *h) {
+    if (memcmp(h, "M6PL", 4) != 0 || m6p_rd16(h + 4) != 1) return 0;
+    uint16_t slots = m6p_rd16(h + 6);
+    return slots > M6PL_MAX_ENTRIES ? M6PL_MAX_ENTRIES : slots;
+}
+
+static inline void m6pl_write_dir(uint8_t h[M6PL_DIR_HDR_SIZE]) {
+    memset(h, 0xFF, M6PL_DIR_HDR_SIZE);
+    memcpy(h, "M6PL", 4);
+    m6p_wr16(h + 4, 1);
+    m6p_wr16(h + 6, M6PL_MAX_ENTRIES);
+}
+
+static inline void m6pl_read_entry(const uint8_t *e, M6plEntry *out) {
+    out->state  = m6p_rd32(e);
+    out->offset = m6p_rd32(e + 4);
+    out->length = m6p_rd32(e + 8);
+    memcpy(out->header, e + 16, M6P_HEADER_SIZE);
+}
+
+// Serialize with the reserved word left erased (0xFF) so it stays programmable.
+static inline void m6pl_write_entry(const M6plEntry *in, uint8_t e[M6PL_ENTRY_SIZE]) {
+    memset(e, 0xFF, M6PL_ENTRY_SIZE);
+    m6p_wr32(e, in->state);
+    m6p_wr32(e + 4, in->offset);
+    m6p_wr32(e + 8, in->length);
+    memcpy(e + 16, in->header, M6P_HEADER_SIZE);
+}
+
+// ── Upload protocol (COBS channel 0x08, SeqUpload.h) ─────────────────
+// Host -> device, first byte = op:
+//   BEGIN 0x01: u32 length@1 (file bytes), header[64]@5
+//   CHUNK 0x02: u32 offset@1 (file offset), u32 crc32@5 (of data), data@9 (1..2048 B)
+//   END   0x03: finish — device CRCs the whole file vs crc32@52, then commits it
+//   ABORT 0x04: stop; the last checkpoint stays resumable
+// Device -> host ack (10 B): u8 op|0x80, u8 status, u32 value@2, u32 credit@6
+//   BEGIN: value = resume offset (0 = fresh);  CHUNK: value = next expected
+//   offset; END: value = library index of the new entry.  credit = bytes the
+//   device can buffer beyond `value` — the host keeps at most that much in
+//   flight. Chunks must arrive in order; anything else is NAKed with the
+//   expected offset (go-back-N). Unsolicited CHUNK acks carry credit updates.
+#define M6PU_OP_BEGIN     0x01
+#define M6PU_OP_CHUNK     0x02
+#define M6PU_OP_END       0x03
+#define M6PU_OP_ABORT     0x04
+#define M6PU_ACK          0x80
+#define M6PU_BEGIN_SIZE   (5 + M6P_HEADER_SIZE)
+#define M6PU_CHUNK_HDR    9
+#define M6PU_CHUNK_MAX    2048
+#define M6PU_ACK_SIZE     10
+
+typedef enum {
+    M6PU_OK           = 0,
+    M6PU_ERR_CRC      = 1,   // chunk CRC mismatch — resend from `value`
+    M6PU_ERR_OFFSET   = 2,   // not the expected offset (or END before all bytes)
+    M6PU_ERR_BUSY     = 3,   // chunk exceeds the credit / BEGIN while REC:* records
+    M6PU_ERR_STATE    = 4,   // no session / previous one still draining
+    M6PU_ERR_HEADER   = 5,   // BEGIN header or length invalid
+    M6PU_ERR_SPACE    = 6,   // partition or directory full
+    M6PU_ERR_FLASH    = 7,   // erase/write/read failed — ABORT and retry
+    M6PU_ERR_FILE_CRC = 8,   // whole-file check failed; nothing committed
+} M6puStatus;
+
+static inline const char* m6pu_strerror(int st) {
+    switch (st) {
+        case M6PU_OK:           return "ok";
+        case M6PU_ERR_CRC:      return "chunk crc";
+        case M6PU_ERR_OFFSET:   return "offset";
+        case M6PU_ERR_BUSY:     return "busy";
+        case M6PU_ERR_STATE:    return "state";
+        case M6PU_ERR_HEADER:   return "bad header";
+        case M6PU_ERR_SPACE:    return "no space";
+        case M6PU_ERR_FLASH:    return "flash error";
+        case M6PU_ERR_FILE_CRC: return "file crc";
+        default:                return "?";
+    }
+}
+
+static inline void m6pu_write_ack(uint8_t a[M6PU_ACK_SIZE], uint8_t op, uint8_t status,
+                                  uint32_t value, uint32_t credit) {
+    a[0] = (uint8_t)(op | M6PU_ACK);
+    a[1] = status;
+    m6p_wr32(a + 2, value);
+    m6p_wr32(a + 6, credit);
+}
+
+#endif // M6P_H
@@ -0,0 +1,167 @@
+// m6p3.h — M6P3 packed motion sequences: streaming block decoder
+// Header-only, zero-dependency, works on ESP32 and desktop
+//
+// Each channel is coded as the residual of a linear prediction from the two
+// previous samples (x̂ = 2·x[n-1] − x[n-2]), zigzag-mapped to unsigned and
+// Rice-coded with a per-block, per-channel parameter k. Smooth motion leaves
+// residuals of a few counts, so a 16-bit sample costs ~3–5 bits.
+//
+// Payload (after the 64-byte header, m6p.h; crc32@52 covers all of it):
+//   float32 scale[6]          raw: value = q × scale[ch]; baked: 1.0
+//   u32 block_off[nblocks]    payload offset of each block  -> O(1) seek
+//   blocks                    nblocks = ceil(count / 2^block_log2)
+// Block: u16 x0[6] (first frame; raw = int16 q), u8 k[6], then an MSB-first
+// bitstream of frames 1..B-1, channel-interleaved per frame, byte-aligned at
+// the end. A sample is either  q ones, a zero, k bits  (q = zz >> k < 15), or
+// the escape  15 ones + 20 raw bits of zz  — at most 35 bits per sample, 210
+// per frame, so the per-frame decode cost is bounded whatever the data.
+//
+//   M6p3Decoder d;  m6p3_init(&d, file, &info);   // file = header + payload
+//   m6p3_seek(&d, idx);                            // any frame, ≤ 1 block of work
+//   m6p3_next(&d, frame);                          // streaming, bounded per frame
+//
+// The encoder lives in host/m6p3enc.h (`m6ptool compress`, replay goldens).
+#ifndef M6P3_H
+#define M6P3_H
+
+#include "m6p.h"
+
+#define M6P3_AXES         6
+#define M6P3_SCALES_SIZE  (M6P3_AXES * 4)
+#define M6P3_BLOCK_HDR    (M6P3_AXES * 3)   // u16 x0[6] + u8 k[6]
+#define M6P3_RICE_ESC     15                // unary prefix that escapes to raw bits
+#define M6P3_RAW_BITS     20                // |residual| < 2^18 for 16-bit samples
+#define M6P3_K_MAX        15
+
+static inline uint32_t m6p3_nblocks(const M6pInfo *info) {
+    return (info->count + (1u << info->block_log2) - 1) >> info->block_log2;
+}
+
+static inline uint32_t m6p3_zigzag(int32_t v)   { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+static inline int32_t  m6p3_unzigzag(uint32_t u) { return (int32_t)(u >> 1) ^ -(int32_t)(u & 1u); }
+
+// Bits the Rice code with parameter k spends on `zz` (encoder's k search).
+static inline uint32_t m6p3_rice_bits(uint32_t zz, int k) {
+    uint32_t q = zz >> k;
+    return q < M6P3_RICE_ESC ? q + 1 + (uint32_t)k : M6P3_RICE_ESC + M6P3_RAW_BITS;
+}
+
+typedef struct {
+    const uint8_t *payload;    // first byte after the header
+    const uint8_t *end;        // one past the payload
+    uint32_t count;
+    uint32_t nblocks;
+    uint8_t  log2;
+    uint8_t  raw;              // 1 = M6P2 semantics (q × scale), 0 = counts
+    float    scale[M6P3_AXES];
+    uint32_t pos;              // frame m6p3_next() returns next
+    const uint8_t *p;          // next byte to shift into the accumulator
+    uint64_t acc;              // MSB-aligned bit accumulator
+    int      nbits;
+    int32_t  x1[M6P3_AXES], x2[M6P3_AXES];   // last two samples
+    uint8_t  k[M6P3_AXES];
+} M6p3Decoder;
+
+static inline void m6p3_refill(M6p3Decoder *d) {
+    while (d->nbits <= 56) {
+        uint64_t b = d->p < d->end ? *d->p : 0;   // past the end reads zeros
+        d->acc |= b << (56 - d->nbits);
+        d->p++;
+        d->nbits += 8;
+    }
+}
+
+static inline uint32_t m6p3_bits(M6p3Decoder *d, int n) {
+    if (n == 0) return 0;
+    uint32_t v = (uint32_t)(d->acc >> (64 - n));
+    d->acc <<= n;
+    d->nbits -= n;
+    return v;
+}
+
+static inline uint32_t m6p3_rice(M6p3Decoder *d, int k) {
+    m6p3_refill(d);                                          // ≥ 57 bits: a whole sample
+    uint32_t top = (uint32_t)(d->acc >> 48) << 16;           // next 16 bits, MSB-aligned
+    int q = __builtin_clz(~top | 0x1u);                      // leading ones
+    if (q >= M6P3_RICE_ESC) {
+        m6p3_bits(d, M6P3_RICE_ESC);
+        return m6p3_bits(d, M6P3_RAW_BITS);
+    }
+    m6p3_bits(d, q + 1);
+    return ((uint32_t)q << k) | m6p3_bits(d, k);
+}
+
+// Position at the start of block `b`: read its first frame into x1/x2.
+static inline void m6p3_block(M6p3Decoder *d, uint32_t b) {
+    const uint8_t *idx = d->payload + M6P3_SCALES_SIZE;
+    uint32_t off = m6p_rd32(idx + 4 * (size_t)b);
+    const uint8_t *h = d->payload + off;
+    if (off > (uint32_t)(d->end - d->payload) - M6P3_BLOCK_HDR) h = d->end - M6P3_BLOCK_HDR;   // corrupt: stay in bounds
+    for (int c = 0; c < M6P3_AXES; c++) {
+        uint16_t v = m6p_rd16(h + 2 * c);
+        d->x1[c] = d->x2[c] = d->raw ? (int32_t)(int16_t)v : (int32_t)v;
+        uint8_t k = h[2 * M6P3_AXES + c];
+        d->k[c] = k > M6P3_K_MAX ? M6P3_K_MAX : k;
+    }
+    d->p = h + M6P3_BLOCK_HDR;
+    d->acc = 0;
+    d->nbits = 0;
+}
+
+static inline void m6p3_emit(const M6p3Decoder *d, float out[M6P3_AXES]) {
+    for (int c = 0; c < M6P3_AXES; c++)
+        out[c] = d->raw ? (float)d->x1[c] * d->scale[c] : (float)d->x1[c];
+}
+
+// Next frame in file order. Returns the last frame again at the end.
+static inline void m6p3_next(M6p3Decoder *d, float out[M6P3_AXES]) {
+    if (d->pos >= d->count) { m6p3_emit(d, out); return; }
+    if ((d->pos & ((1u << d->log2) - 1)) == 0) {
+        m6p3_block(d, d->pos >> d->log2);
+    } else {
+        for (int c = 0; c < M6P3_AXES; c++) {
+            int32_t x = 2 * d->x1[c] - d->x2[c] + m6p3_unzigzag(m6p3_rice(d, d->k[c]));
+            d->x2[c] = d->x1[c];
+            d->x1[c] = x;
+        }
+    }
+    d->pos++;
+    m6p3_emit(d, out);
+}
+
+// Make frame `idx` the next one m6p3_next() returns: jump to its block via
+// the offset table, then decode up to 2^block_log2 − 1 frames into it. Runs
+// inside a CueTask tick (loop wrap, lead, PLAY:SEEK), so the block size is
+// capped at M6P3_LOG2_MAX: ≤ 255 bounded frame decodes (PLAY:BENCH seek<=).
+static inline void m6p3_seek(M6p3Decoder *d, uint32_t idx) {
+    if (idx >= d->count) idx = d->count - 1;
+    uint32_t b = idx >> d->log2;
+    d->pos = b << d->log2;
+    float tmp[M6P3_AXES];
+    while (d->pos < idx) m6p3_next(d, tmp);
+}
+
+// Frame `idx` — one step when sequential, a seek otherwise.
+static inline void m6p3_read(M6p3Decoder *d, uint32_t idx, float out[M6P3_AXES]) {
+    if (idx != d->pos) m6p3_seek(d, idx);
+    m6p3_next(d, out);
+}
+
+// `file` = 64-byte header + payload, `info` parsed from it (packed = 1).
+static inline int m6p3_init(M6p3Decoder *d, const uint8_t *file, const M6pInfo *info) {
+    memset(d, 0, sizeof(*d));
+    if (!info->packed) return M6P_ERR_FORMAT;
+    d->count   = info->count;
+    d->log2    = info->block_log2;
+    d->raw     = info->kind == M6P_KIND_RAW;
+    d->nblocks = m6p3_nblocks(info);
+    if ((size_t)info->payload < M6P3_SCALES_SIZE + 4 * (size_t)d->nblocks + M6P3_BLOCK_HDR)
+        return M6P_ERR_TRUNCATED;
+    d->payload = file + M6P_HEADER_SIZE;
+    d->end     = d->payload + info->payload;
+    memcpy(d->scale, d->payload, sizeof(d->scale));
+    m6p3_seek(d, 0);
+    return M6P_OK;
+}
+
+#endif // M6P3_H
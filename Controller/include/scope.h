@@ -0,0 +1,200 @@
+// scope.h — Oscilloscope-style capture of the cue loop (every CueTask tick)
+// Header-only, zero-dependency, works on ESP32 and desktop
+//
+// CueTask pushes one ScopeSample per tick into a ring while the scope is
+// armed. Once `pre` samples are in, each push evaluates the trigger; after it
+// fires, depth − pre more samples are taken and the ring freezes (DONE) until
+// it is read out (SCOPE:DUMP over COBS_CH_SCOPE) and re-armed. Only CueTask
+// writes; readers touch the ring only in DONE, so no locking is needed.
+//
+//   Scope s;  scope_init(&s);  s.trig.type = SCOPE_TRIG_CLIP;
+//   scope_arm(&s, 64);                      // command side
+//   scope_push(&s, &sample);                // CueTask, every tick
+//   if (s.state == SCOPE_DONE) for (i..scope_count(&s)) scope_get(&s, i);
+//
+// The sample layout is also the wire format (little-endian, no padding) —
+// host/m6ptool.cpp `scope` decodes it with this header. SCOPE:DUMP sends,
+// on COBS_CH_SCOPE:
+//   HDR   u8 op=1, u8 ver=1, u16 sample_size, u16 count, u16 trig_index,
+//         u16 rate_hz, u8 trig type, u8 field, u8 axis, u8 edge, f32 level
+//   DATA  u8 op=2, u16 first, ScopeSample[≤ SCOPE_DUMP_BATCH]
+//   END   u8 op=3, u16 count, u32 crc32 (IEEE, over all sample bytes in order)
+#ifndef SCOPE_H
+#define SCOPE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef SCOPE_DEPTH
+#define SCOPE_DEPTH  256          // samples (~1 s at 250 Hz, 35 KB)
+#endif
+
+#define SCOPE_OP_HDR      1
+#define SCOPE_OP_DATA     2
+#define SCOPE_OP_END      3
+#define SCOPE_HDR_SIZE    18
+#define SCOPE_DUMP_BATCH  3       // samples per DATA frame (fits the 512 B TX frame)
+
+// Per-sample flags (set by CueTask / driveServos).
+#define SCOPE_F_SLEW     0x0001   // slew limiter clipped at least one axis
+#define SCOPE_F_CLIP     0x0002   // IK angle NaN or beyond SERVO_MAX_ANGLE_RAD
+#define SCOPE_F_OVERRUN  0x0004   // tick started > 1.5 periods after the last
+#define SCOPE_F_STALE    0x0008   // target older than CUE_LOST_DECAY_MS (decay)
+#define SCOPE_F_WDT      0x0010   // activity watchdog tripped
+#define SCOPE_F_OFF      0x0020   // SOURCE:OFF (gated home)
+#define SCOPE_F_TRIG     0x8000   // the trigger sample
+
+// Naturally aligned, no padding (checked below) — also the wire layout.
+typedef struct {
+    uint32_t tick;        // CueTask tick counter
+    uint16_t flags;       // SCOPE_F_*
+    uint8_t  fmt;         // TargetFmt of the input
+    uint8_t  src;         // Source (OFF / DEMO / LIVE)
+    float    in[6];       // target as read (counts / percent / mm,rad)
+    float    filt[6];     // after the input filter (RAW) — = in otherwise
+    float    cued[6];     // count domain after MCA + output stage
+    float    pose[6];     // after the slew limiter (mm / rad)
+    float    angle[6];    // IK output, clamped (rad)
+    uint16_t pulse[6];    // servo pulse (µs)
+} ScopeSample;
+typedef char scope_sample_layout_check[sizeof(ScopeSample) == 140 ? 1 : -1];
+
+typedef enum {
+    SCOPE_FIELD_IN = 0, SCOPE_FIELD_FILT, SCOPE_FIELD_CUED,
+    SCOPE_FIELD_POSE, SCOPE_FIELD_ANGLE, SCOPE_FIELD_PULSE,
+    SCOPE_FIELD_COUNT
+} ScopeField;
+
+typedef enum {
+    SCOPE_TRIG_NOW = 0,   // as soon as the pre-trigger part is full
+    SCOPE_TRIG_CLIP,      // SCOPE_F_CLIP
+    SCOPE_TRIG_SLEW,      // SCOPE_F_SLEW
+    SCOPE_TRIG_OVERRUN,   // SCOPE_F_OVERRUN
+    SCOPE_TRIG_WDT,       // SCOPE_F_STALE or SCOPE_F_WDT
+    SCOPE_TRIG_THR,       // field[axis] crosses level (edge)
+    SCOPE_TRIG_COUNT
+} ScopeTrigType;
+
+typedef enum { SCOPE_EDGE_RISE = 1, SCOPE_EDGE_FALL = 2, SCOPE_EDGE_BOTH = 3 } ScopeEdge;
+
+typedef enum { SCOPE_IDLE = 0, SCOPE_ARMED, SCOPE_TRIGGERED, SCOPE_DONE } ScopeState;
+
+typedef struct {
+    uint8_t type;         // ScopeTrigType
+    uint8_t field;        // ScopeField (THR)
+    uint8_t axis;         // 0..5 (THR)
+    uint8_t edge;         // ScopeEdge (THR)
+    float   level;        // THR
+} ScopeTrigger;
+
+typedef struct {
+    ScopeSample  ring[SCOPE_DEPTH];
+    ScopeTrigger trig;
+    volatile int state;   // ScopeState
+    volatile bool force;  // SCOPE:FORCE — trigger on the next push
+    uint32_t n;           // samples pushed since arm
+    uint32_t pre;         // samples kept before the trigger
+    uint32_t post;        // still to take after the trigger
+    uint32_t trigN;       // n of the trigger sample
+    float    last;        // previous THR value
+    bool     primed;      // `last` valid (no edge on the first sample)
+} Scope;
+
+static inline void scope_init(Scope *s) {
+    memset(s, 0, sizeof(*s));
+    s->trig.edge = SCOPE_EDGE_RISE;
+}
+
+static inline const char *scope_field_name(int f) {
+    static const char *const names[SCOPE_FIELD_COUNT] = { "in", "filt", "cued", "pose", "angle", "pulse" };
+    return (f >= 0 && f < SCOPE_FIELD_COUNT) ? names[f] : "?";
+}
+
+static inline const char *scope_trig_name(int t) {
+    static const char *const names[SCOPE_TRIG_COUNT] = { "NOW", "CLIP", "SLEW", "OVERRUN", "WDT", "THR" };
+    return (t >= 0 && t < SCOPE_TRIG_COUNT) ? names[t] : "?";
+}
+
+static inline float scope_value(const ScopeSample *x, int field, int axis) {
+    switch (field) {
+        case SCOPE_FIELD_IN:    return x->in[axis];
+        case SCOPE_FIELD_FILT:  return x->filt[axis];
+        case SCOPE_FIELD_CUED:  return x->cued[axis];
+        case SCOPE_FIELD_POSE:  return x->pose[axis];
+        case SCOPE_FIELD_ANGLE: return x->angle[axis];
+        default:                return (float)x->pulse[axis];
+    }
+}
+
+// Command side. `pre` is clamped to depth − 1 (at least one post sample).
+static inline void scope_arm(Scope *s, uint32_t pre) {
+    s->state = SCOPE_IDLE;               // CueTask stops pushing first
+    s->pre   = pre < SCOPE_DEPTH ? pre : SCOPE_DEPTH - 1;
+    s->n     = 0;
+    s->post  = 0;
+    s->trigN = 0;
+    s->force = false;
+    s->primed = false;
+    s->state = SCOPE_ARMED;
+}
+
+static inline bool scope_fires(Scope *s, const ScopeSample *x) {
+    const ScopeTrigger *t = &s->trig;
+    switch (t->type) {
+        case SCOPE_TRIG_NOW:     return true;
+        case SCOPE_TRIG_CLIP:    return (x->flags & SCOPE_F_CLIP) != 0;
+        case SCOPE_TRIG_SLEW:    return (x->flags & SCOPE_F_SLEW) != 0;
+        case SCOPE_TRIG_OVERRUN: return (x->flags & SCOPE_F_OVERRUN) != 0;
+        case SCOPE_TRIG_WDT:     return (x->flags & (SCOPE_F_STALE | SCOPE_F_WDT)) != 0;
+        case SCOPE_TRIG_THR: {
+            float v = scope_value(x, t->field, t->axis);
+            bool rise = s->primed && s->last < t->level && v >= t->level;
+            bool fall = s->primed && s->last > t->level && v <= t->level;
+            s->last = v;
+            s->primed = true;
+            return ((t->edge & SCOPE_EDGE_RISE) && rise) || ((t->edge & SCOPE_EDGE_FALL) && fall);
+        }
+        default: return false;
+    }
+}
+
+// CueTask, every tick. A few dozen cycles + one 140-byte copy when armed.
+static inline void scope_push(Scope *s, const ScopeSample *x) {
+    int st = s->state;
+    if (st != SCOPE_ARMED && st != SCOPE_TRIGGERED) return;
+    ScopeSample *slot = &s->ring[s->n % SCOPE_DEPTH];
+    *slot = *x;
+    s->n++;
+    if (st == SCOPE_ARMED) {
+        bool hit = scope_fires(s, x);    // keeps the THR history current
+        if (s->n <= s->pre) return;      // pre-trigger part still filling
+        if (!hit && !s->force) return;
+        slot->flags |= SCOPE_F_TRIG;
+        s->trigN = s->n - 1;
+        s->post  = SCOPE_DEPTH - s->pre - 1;
+        s->state = SCOPE_TRIGGERED;
+        if (s->post == 0) s->state = SCOPE_DONE;
+        return;
+    }
+    if (--s->post == 0) s->state = SCOPE_DONE;
+}
+
+// CueTask: is a sample wanted this tick? (skip filling it otherwise)
+static inline bool scope_active(const Scope *s) {
+    return s->state == SCOPE_ARMED || s->state == SCOPE_TRIGGERED;
+}
+
+// Command side: back to idle (drops a capture in progress).
+static inline void scope_stop(Scope *s) { s->state = SCOPE_IDLE; }
+
+// Samples held (≤ depth) and the index of the trigger sample among them.
+static inline uint32_t scope_count(const Scope *s) { return s->n < SCOPE_DEPTH ? s->n : SCOPE_DEPTH; }
+static inline uint32_t scope_trigger_index(const Scope *s) { return s->trigN - (s->n - scope_count(s)); }
+
+// i-th held sample, oldest first (valid in SCOPE_DONE).
+static inline const ScopeSample *scope_get(const Scope *s, uint32_t i) {
+    return &s->ring[(s->n - scope_count(s) + i) % SCOPE_DEPTH];
+}
+
+#endif // SCOPE_H
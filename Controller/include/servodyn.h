@@ -0,0 +1,79 @@
+// servodyn.h — Hobby-servo dynamics model + feed-forward lag compensation
+// Header-only, zero-dependency, works on ESP32 and desktop
+//
+// Model (per servo): the arm angle θ chases the commanded angle u as a
+// first-order lag with time constant τ, capped at vmax:
+//   θ̇ = clamp((u − θ) / τ, −vmax, +vmax)
+// Compensator (driveServos, every CueTask tick): phase lead from the inverse
+// of that lag, u = θd + lead · τ · θ̇d. The lead term is limited so u never
+// runs further than vmax · τ ahead of the modeled arm — past that point the
+// servo is already at full speed and extra lead would only overshoot. lead = 0
+// passes θd through unchanged; the model still tracks the arm.
+//
+//   ServoDynState s = {};  float u = servo_dyn_compensate(&p, &s, angle, dt);
+//
+// host/m6ptool.cpp `servosim` runs the same functions against the embedded
+// lap to compare tracking error with and without compensation.
+#ifndef SERVODYN_H
+#define SERVODYN_H
+
+#include <math.h>
+#include <stdbool.h>
+
+#define SERVO_DYN_LEAD_MAX  1.5f
+
+typedef struct {
+    float tau_s;     // first-order time constant, s (0 = no lag)
+    float vmax;      // speed cap, rad/s
+    float lead;      // compensation gain, 0 (off) .. SERVO_DYN_LEAD_MAX; 1 = full model inverse
+} ServoDynParams;
+
+typedef struct {
+    float est;       // modeled arm angle, rad
+    float prev;      // previous target (θ̇d by backward difference)
+    bool  init;
+} ServoDynState;
+
+// Analog hobby servo at the 50 Hz carrier: ~0.1 s/60° no-load, ~30 ms lag.
+static inline void servo_dyn_defaults(ServoDynParams *p) {
+    p->tau_s = 0.030f;
+    p->vmax  = 10.0f;
+    p->lead  = 0.0f;
+}
+
+// Advance the model by dt under command u.
+static inline void servo_dyn_step(const ServoDynParams *p, float *theta, float u, float dt) {
+    float d = u - *theta;
+    if (p->tau_s > 0.0f) d *= 1.0f - expf(-dt / p->tau_s);
+    const float cap = p->vmax * dt;
+    if (p->vmax > 0.0f) {
+        if (d > cap) d = cap;
+        else if (d < -cap) d = -cap;
+    }
+    *theta += d;
+}
+
+// Command for this tick given the intended angle `target`.
+static inline float servo_dyn_compensate(const ServoDynParams *p, ServoDynState *s, float target, float dt) {
+    if (!s->init) {
+        s->est  = target;
+        s->prev = target;
+        s->init = true;
+    }
+    const float vel = dt > 0.0f ? (target - s->prev) / dt : 0.0f;
+    s->prev = target;
+
+    float u = target + p->lead * p->tau_s * vel;
+    if (p->vmax > 0.0f && p->tau_s > 0.0f) {
+        // Lead never pulls the command beyond est ± vmax·τ (nor short of target).
+        const float span = p->vmax * p->tau_s;
+        const float hi = fmaxf(target, s->est + span);
+        const float lo = fminf(target, s->est - span);
+        if (u > hi) u = hi;
+        if (u < lo) u = lo;
+    }
+    servo_dyn_step(p, &s->est, u, dt);
+    return u;
+}
+
+#endif // SERVODYN_H
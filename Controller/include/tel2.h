@@ -0,0 +1,223 @@
+// tel2.h — TEL2 compact telemetry sample (CueTask-synchronous, field-selectable)
+// Header-only, zero-dependency, works on ESP32 and desktop
+//
+// CueTask encodes one sample every N ticks from the same per-tick record the
+// scope captures (ScopeSample), so every field in a sample belongs to one
+// tick. The host picks field groups with a bitmask (TEL2:<mask>[,<div>]);
+// values travel as scaled int16 (~half the bytes of the float32 TEL frame).
+//
+// Layout (little-endian), on COBS_CH_TEL2 one sample per frame; on the BLE
+// status characteristic (0xFF02) samples are concatenated back to back —
+// split them with tel2_sizeof(first byte).
+//   u8  mask        TEL2_F_* groups present, in bit order below
+//   u8  fmt | src<<4
+//   u16 flags       SCOPE_F_* of the tick
+//   u32 tick        CueTask tick counter
+//   u32 t_us        esp_timer time of the tick start (wraps every ~71 min)
+//   [IN]     6 × v  target as read — fmt BAKED: u16 counts; RAW/RAW_ZP:
+//                   i16 percent × 100; PHYS: pose scaling; IMU: i16 × 100
+//                   (m/s², rad/s)
+//   [CUE]    6 × v  count domain after MCA + output stage — u16 counts
+//                   (PHYS / IMU: pose scaling)
+//   [POSE]   6 × i16  after the slew limiter: xyz mm × 100, rpy rad × 10000
+//   [ANGLE]  6 × i16  IK servo angle, rad × 10000
+//   [PULSE]  6 × u16  servo pulse, µs
+//   [TIMING] 3 × u16  µs: cue chain, IK + PWM write, whole tick
+//   [AGE]    1 × u16  input age, 0.1 ms (saturates at 6.5 s)
+#ifndef TEL2_H
+#define TEL2_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "scope.h"
+
+#define TEL2_F_IN      0x01
+#define TEL2_F_CUE     0x02
+#define TEL2_F_POSE    0x04
+#define TEL2_F_ANGLE   0x08
+#define TEL2_F_PULSE   0x10
+#define TEL2_F_TIMING  0x20
+#define TEL2_F_AGE     0x40
+#define TEL2_F_ALL     0x7F
+
+#define TEL2_HDR_SIZE  12
+#define TEL2_MAX_SIZE  (TEL2_HDR_SIZE + 5 * 12 + 6 + 2)
+
+// TargetFmt values as sent in the header (main.cpp)
+#define TEL2_FMT_BAKED   0
+#define TEL2_FMT_RAW     1
+#define TEL2_FMT_PHYS    2
+#define TEL2_FMT_RAW_ZP  3
+#define TEL2_FMT_IMU     4
+
+// Formats whose IN group is i16 × 100 / whose CUE group is a pose.
+static inline bool tel2_in_x100(int fmt) { return fmt == TEL2_FMT_RAW || fmt == TEL2_FMT_RAW_ZP || fmt == TEL2_FMT_IMU; }
+static inline bool tel2_is_pose(int fmt) { return fmt == TEL2_FMT_PHYS || fmt == TEL2_FMT_IMU; }
+
+typedef struct {
+    uint16_t cue_us;      // target read .. mapped position
+    uint16_t drive_us;    // slew + IK + PWM write
+    uint16_t tick_us;     // whole tick up to the servo write
+    uint32_t age_us;      // input age
+} Tel2Extra;
+
+// Bytes of each group, in bit order.
+static const uint8_t TEL2_GROUP_SIZE[7] = { 12, 12, 12, 12, 12, 6, 2 };
+
+static inline uint16_t tel2_sizeof(uint8_t mask) {
+    uint16_t n = TEL2_HDR_SIZE;
+    for (int b = 0; b < 7; b++)
+        if (mask & (1u << b)) n += TEL2_GROUP_SIZE[b];
+    return n;
+}
+
+// Cut an encoded sample down to the groups of `mask` (a subset of its own
+// mask) — one encode in CueTask, a per-subscriber selection downstream.
+static inline int tel2_select(uint8_t *out, const uint8_t *in, uint8_t mask) {
+    const uint8_t have = in[0];
+    mask &= have;
+    memcpy(out, in, TEL2_HDR_SIZE);
+    out[0] = mask;
+    const uint8_t *src = in + TEL2_HDR_SIZE;
+    uint8_t *dst = out + TEL2_HDR_SIZE;
+    for (int b = 0; b < 7; b++) {
+        if (!(have & (1u << b))) continue;
+        if (mask & (1u << b)) {
+            memcpy(dst, src, TEL2_GROUP_SIZE[b]);
+            dst += TEL2_GROUP_SIZE[b];
+        }
+        src += TEL2_GROUP_SIZE[b];
+    }
+    return (int)(dst - out);
+}
+
+static inline int16_t tel2_sat16(float v) {
+    if (v <= -32768.0f) return -32768;
+    if (v >= 32767.0f) return 32767;
+    return (int16_t)(v >= 0 ? v + 0.5f : v - 0.5f);
+}
+
+static inline uint16_t tel2_satu16(float v) {
+    if (v <= 0.0f) return 0;
+    if (v >= 65535.0f) return 65535;
+    return (uint16_t)(v + 0.5f);
+}
+
+static inline uint8_t *tel2_put16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static inline uint8_t *tel2_put_pose(uint8_t *p, const float v[6]) {
+    for (int i = 0; i < 3; i++) p = tel2_put16(p, (uint16_t)tel2_sat16(v[i] * 100.0f));
+    for (int i = 3; i < 6; i++) p = tel2_put16(p, (uint16_t)tel2_sat16(v[i] * 10000.0f));
+    return p;
+}
+
+static inline uint8_t *tel2_put_counts(uint8_t *p, const float v[6], int fmt) {
+    if (tel2_is_pose(fmt)) return tel2_put_pose(p, v);
+    for (int i = 0; i < 6; i++) p = tel2_put16(p, tel2_satu16(v[i]));
+    return p;
+}
+
+// Encode `mask` groups of one tick into out[TEL2_MAX_SIZE]; returns bytes.
+static inline int tel2_encode(uint8_t *out, uint8_t mask, uint32_t t_us,
+                              const ScopeSample *s, const Tel2Extra *x) {
+    mask &= TEL2_F_ALL;
+    uint8_t *p = out;
+    *p++ = mask;
+    *p++ = (uint8_t)((s->fmt & 0x0F) | (s->src << 4));
+    p = tel2_put16(p, s->flags);
+    p = tel2_put16(p, (uint16_t)s->tick);
+    p = tel2_put16(p, (uint16_t)(s->tick >> 16));
+    p = tel2_put16(p, (uint16_t)t_us);
+    p = tel2_put16(p, (uint16_t)(t_us >> 16));
+    if (mask & TEL2_F_IN) {
+        if (tel2_in_x100(s->fmt))
+            for (int i = 0; i < 6; i++) p = tel2_put16(p, (uint16_t)tel2_sat16(s->in[i] * 100.0f));
+        else
+            p = tel2_put_counts(p, s->in, s->fmt);
+    }
+    if (mask & TEL2_F_CUE)    p = tel2_put_counts(p, s->cued, s->fmt);
+    if (mask & TEL2_F_POSE)   p = tel2_put_pose(p, s->pose);
+    if (mask & TEL2_F_ANGLE)
+        for (int i = 0; i < 6; i++) p = tel2_put16(p, (uint16_t)tel2_sat16(s->angle[i] * 10000.0f));
+    if (mask & TEL2_F_PULSE)
+        for (int i = 0; i < 6; i++) p = tel2_put16(p, s->pulse[i]);
+    if (mask & TEL2_F_TIMING) {
+        p = tel2_put16(p, x->cue_us);
+        p = tel2_put16(p, x->drive_us);
+        p = tel2_put16(p, x->tick_us);
+    }
+    if (mask & TEL2_F_AGE) {
+        uint32_t a = x->age_us / 100;
+        p = tel2_put16(p, (uint16_t)(a > 65535 ? 65535 : a));
+    }
+    return (int)(p - out);
+}
+
+// ── Host side ────────────────────────────────────────────────────────
+// Decoded sample; groups missing from `mask` are left zero.
+typedef struct {
+    uint8_t  mask, fmt, src;
+    uint16_t flags;
+    uint32_t tick, t_us;
+    float    in[6], cued[6], pose[6], angle[6];
+    uint16_t pulse[6];
+    uint16_t cue_us, drive_us, tick_us;
+    float    age_ms;
+} Tel2Sample;
+
+static inline uint16_t tel2_get16(const uint8_t **p) {
+    uint16_t v = (uint16_t)((*p)[0] | ((*p)[1] << 8));
+    *p += 2;
+    return v;
+}
+
+static inline void tel2_get_pose(const uint8_t **p, float v[6]) {
+    for (int i = 0; i < 3; i++) v[i] = (int16_t)tel2_get16(p) / 100.0f;
+    for (int i = 3; i < 6; i++) v[i] = (int16_t)tel2_get16(p) / 10000.0f;
+}
+
+static inline void tel2_get_counts(const uint8_t **p, float v[6], int fmt) {
+    if (tel2_is_pose(fmt)) { tel2_get_pose(p, v); return; }
+    for (int i = 0; i < 6; i++) v[i] = (float)tel2_get16(p);
+}
+
+// Returns false on a short or inconsistent frame.
+static inline bool tel2_decode(const uint8_t *buf, int len, Tel2Sample *s) {
+    if (len < TEL2_HDR_SIZE) return false;
+    memset(s, 0, sizeof(*s));
+    const uint8_t *p = buf;
+    s->mask = *p++;
+    if (len != tel2_sizeof(s->mask)) return false;
+    s->fmt  = *p & 0x0F;
+    s->src  = *p++ >> 4;
+    s->flags = tel2_get16(&p);
+    s->tick  = tel2_get16(&p);
+    s->tick |= (uint32_t)tel2_get16(&p) << 16;
+    s->t_us  = tel2_get16(&p);
+    s->t_us |= (uint32_t)tel2_get16(&p) << 16;
+    if (s->mask & TEL2_F_IN) {
+        if (tel2_in_x100(s->fmt))
+            for (int i = 0; i < 6; i++) s->in[i] = (int16_t)tel2_get16(&p) / 100.0f;
+        else
+            tel2_get_counts(&p, s->in, s->fmt);
+    }
+    if (s->mask & TEL2_F_CUE)   tel2_get_counts(&p, s->cued, s->fmt);
+    if (s->mask & TEL2_F_POSE)  tel2_get_pose(&p, s->pose);
+    if (s->mask & TEL2_F_ANGLE)
+        for (int i = 0; i < 6; i++) s->angle[i] = (int16_t)tel2_get16(&p) / 10000.0f;
+    if (s->mask & TEL2_F_PULSE)
+        for (int i = 0; i < 6; i++) s->pulse[i] = tel2_get16(&p);
+    if (s->mask & TEL2_F_TIMING) {
+        s->cue_us   = tel2_get16(&p);
+        s->drive_us = tel2_get16(&p);
+        s->tick_us  = tel2_get16(&p);
+    }
+    if (s->mask & TEL2_F_AGE) s->age_ms = tel2_get16(&p) / 10.0f;
+    return true;
+}
+
+#endif // TEL2_H
@@ -0,0 +1,51 @@
+// tribuf.h — Lock-free triple buffer: one writer publishes, one reader adopts
+// Header-only, zero-dependency, works on ESP32 and desktop
+//
+// Manages slot INDICES only; the caller owns `T slots[3]`. The writer fills
+// slots[tribuf_write_index()] and publishes with a single atomic exchange; the
+// reader swaps in the newest published slot at a point of its choosing (e.g.
+// the top of a control tick) and then reads it without any lock. Neither side
+// ever blocks or sees a half-written slot:
+//
+//   writer:  fill(&slot[tribuf_write_index(&tb)]);  tribuf_publish(&tb);
+//   reader:  tribuf_acquire(&tb);  use(&slot[tribuf_read_index(&tb)]);
+//
+// Exactly one writer and one reader at a time — serialize multiple writers
+// outside (a mutex is fine there, it is not the reader's hot path).
+#ifndef TRIBUF_H
+#define TRIBUF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TRIBUF_DIRTY  0x4u   // middle slot holds an unread publication
+
+typedef struct {
+    uint32_t write;    // writer-owned
+    uint32_t middle;   // shared: index | TRIBUF_DIRTY, only touched atomically
+    uint32_t read;     // reader-owned
+} TriBuf;
+
+static inline void tribuf_init(TriBuf *tb) {
+    tb->write  = 0;
+    tb->middle = 1;
+    tb->read   = 2;
+}
+
+static inline uint32_t tribuf_write_index(const TriBuf *tb) { return tb->write; }
+static inline uint32_t tribuf_read_index(const TriBuf *tb)  { return tb->read; }
+
+// Hand the filled write slot to the reader; take back whichever slot was in
+// the middle (the reader's old one, or an unread older publication).
+static inline void tribuf_publish(TriBuf *tb) {
+    tb->write = __atomic_exchange_n(&tb->middle, tb->write | TRIBUF_DIRTY, __ATOMIC_ACQ_REL) & 0x3u;
+}
+
+// Adopt the newest publication, if any. Returns true when the read slot changed.
+static inline bool tribuf_acquire(TriBuf *tb) {
+    if (!(__atomic_load_n(&tb->middle, __ATOMIC_ACQUIRE) & TRIBUF_DIRTY)) return false;
+    tb->read = __atomic_exchange_n(&tb->middle, tb->read, __ATOMIC_ACQ_REL) & 0x3u;
+    return true;
+}
+
+#endif // TRIBUF_H
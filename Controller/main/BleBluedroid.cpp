@@ -0,0 +1,314 @@
+// BleBluedroid.cpp — Bluedroid backend of the BLE transport (BleHost.h)
+// Default host stack (sdkconfig.defaults). The GATT table is built one
+// attribute at a time through the GATTS event chain; connection and link
+// events are forwarded to the transport core.
+#include "BleHost.h"
+
+#if defined(ENABLE_BLE) && defined(CONFIG_BT_BLUEDROID_ENABLED)
+
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_bt.h"
+#include "esp_bt_main.h"
+#include "esp_gap_ble_api.h"
+#include "esp_gatts_api.h"
+#include "esp_bt_defs.h"
+#include "esp_gatt_common_api.h"
+
+static const char *TAG = "ble_bluedroid";
+
+// GATT handles
+static uint16_t s_gatts_if = ESP_GATT_IF_NONE;
+static uint16_t s_service_handle = 0;
+static uint16_t s_char_motion_handle = 0;   // writable: receives motion packets
+static uint16_t s_char_status_handle = 0;   // notify: sends status/telemetry
+static uint16_t s_status_cccd_handle = 0;   // its Client Characteristic Configuration
+static uint16_t s_char_accel_handle = 0;    // writable: receives accel packets
+static int s_char_add_phase = 0;            // tracks which char we're adding
+
+static uint16_t s_dle_pending = 0xFFFF;     // DLE completion carries no address
+
+static uint8_t s_service_uuid[16];
+
+// Advertising data
+static esp_ble_adv_data_t s_adv_data = {
+    .set_scan_rsp = false,
+    .include_name = true,
+    .include_txpower = false,
+    .min_interval = 0x0006,  // 7.5ms
+    .max_interval = 0x0010,  // 20ms
+    .appearance = 0x00,
+    .manufacturer_len = 0,
+    .p_manufacturer_data = NULL,
+    .service_data_len = 0,
+    .p_service_data = NULL,
+    .service_uuid_len = sizeof(s_service_uuid),
+    .p_service_uuid = s_service_uuid,
+    .flag = (ESP_BLE_ADV_FLAG_GEN_DISC | ESP_BLE_ADV_FLAG_BREDR_NOT_SPT),
+};
+
+static esp_ble_adv_params_t s_adv_params = {
+    .adv_int_min = 0x20,     // 20ms
+    .adv_int_max = 0x40,     // 40ms
+    .adv_type = ADV_TYPE_IND,
+    .own_addr_type = BLE_ADDR_TYPE_PUBLIC,
+    .peer_addr = {0},
+    .peer_addr_type = BLE_ADDR_TYPE_PUBLIC,
+    .channel_map = ADV_CHNL_ALL,
+    .adv_filter_policy = ADV_FILTER_ALLOW_SCAN_ANY_CON_ANY,
+};
+
+#define GATTS_APP_ID 0
+#define GATTS_NUM_HANDLE 12
+
+// ── GAP event handler ────────────────────────────────────────────────
+
+static void gap_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param)
+{
+    uint16_t conn_id;
+    switch (event) {
+        case ESP_GAP_BLE_ADV_DATA_SET_COMPLETE_EVT:
+            esp_ble_gap_start_advertising(&s_adv_params);
+            break;
+        case ESP_GAP_BLE_ADV_START_COMPLETE_EVT:
+            if (param->adv_start_cmpl.status == ESP_BT_STATUS_SUCCESS) {
+                ble_core_adv_started();
+                ESP_LOGI(TAG, "BLE advertising started");
+            }
+            break;
+        case ESP_GAP_BLE_SET_PKT_LENGTH_COMPLETE_EVT:
+            if (s_dle_pending != 0xFFFF && param->pkt_data_length_cmpl.status == ESP_BT_STATUS_SUCCESS)
+                ble_core_set_data_len(s_dle_pending, param->pkt_data_length_cmpl.params.tx_len,
+                                      param->pkt_data_length_cmpl.params.rx_len);
+            s_dle_pending = 0xFFFF;
+            break;
+        case ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT:
+            if (param->update_conn_params.status == ESP_BT_STATUS_SUCCESS &&
+                ble_core_find_addr(param->update_conn_params.bda, &conn_id))
+                ble_core_set_interval(conn_id, param->update_conn_params.conn_int);
+            break;
+#if CONFIG_BT_BLE_50_FEATURES_SUPPORTED
+        case ESP_GAP_BLE_PHY_UPDATE_COMPLETE_EVT:
+            if (param->phy_update.status == ESP_BT_STATUS_SUCCESS &&
+                ble_core_find_addr(param->phy_update.bda, &conn_id))
+                ble_core_set_phy(conn_id, param->phy_update.tx_phy, param->phy_update.rx_phy);
+            break;
+#endif
+        default:
+            break;
+    }
+}
+
+// ── GATTS event handler ──────────────────────────────────────────────
+
+static void gatts_event_handler(esp_gatts_cb_event_t event, esp_gatt_if_t gatts_if,
+                                esp_ble_gatts_cb_param_t *param)
+{
+    switch (event) {
+        case ESP_GATTS_REG_EVT: {
+            s_gatts_if = gatts_if;
+            esp_ble_gap_set_device_name(BLE_DEVICE_NAME);
+            esp_ble_gap_config_adv_data(&s_adv_data);
+
+            // Create service
+            esp_gatt_srvc_id_t service_id = {};
+            service_id.is_primary = true;
+            service_id.id.inst_id = 0;
+            service_id.id.uuid.len = ESP_UUID_LEN_128;
+            memcpy(service_id.id.uuid.uuid.uuid128, s_service_uuid, 16);
+            esp_ble_gatts_create_service(gatts_if, &service_id, GATTS_NUM_HANDLE);
+            break;
+        }
+
+        case ESP_GATTS_CREATE_EVT: {
+            s_service_handle = param->create.service_handle;
+            esp_ble_gatts_start_service(s_service_handle);
+            s_char_add_phase = 0;
+
+            // Motion RX characteristic (writable — receives binary motion packets)
+            esp_bt_uuid_t motion_uuid = {
+                .len = ESP_UUID_LEN_16,
+                .uuid = { .uuid16 = 0xFF01 },
+            };
+            esp_gatt_perm_t motion_perm = ESP_GATT_PERM_WRITE;
+            esp_gatt_char_prop_t motion_prop = ESP_GATT_CHAR_PROP_BIT_WRITE | ESP_GATT_CHAR_PROP_BIT_WRITE_NR;
+            esp_ble_gatts_add_char(s_service_handle, &motion_uuid, motion_perm, motion_prop, NULL, NULL);
+            break;
+        }
+
+        case ESP_GATTS_ADD_CHAR_EVT: {
+            if (s_char_add_phase == 0) {
+                // Phase 0: Motion RX char just added
+                s_char_motion_handle = param->add_char.attr_handle;
+                ESP_LOGI(TAG, "Motion RX char handle: %d", s_char_motion_handle);
+                s_char_add_phase = 1;
+
+                // Add Status TX characteristic (notify — sends telemetry/status)
+                esp_bt_uuid_t status_uuid = {
+                    .len = ESP_UUID_LEN_16,
+                    .uuid = { .uuid16 = 0xFF02 },
+                };
+                esp_gatt_perm_t status_perm = (esp_gatt_perm_t)(ESP_GATT_PERM_READ | ESP_GATT_PERM_WRITE);
+                esp_gatt_char_prop_t status_prop = ESP_GATT_CHAR_PROP_BIT_NOTIFY | ESP_GATT_CHAR_PROP_BIT_READ |
+                                                   ESP_GATT_CHAR_PROP_BIT_WRITE;
+                esp_ble_gatts_add_char(s_service_handle, &status_uuid, status_perm, status_prop, NULL, NULL);
+            } else if (s_char_add_phase == 1) {
+                // Phase 1: Status TX char just added
+                s_char_status_handle = param->add_char.attr_handle;
+                ESP_LOGI(TAG, "Status TX char handle: %d", s_char_status_handle);
+                s_char_add_phase = 2;
+
+                // Its CCCD (0x2902): each observer enables notifications here
+                esp_bt_uuid_t cccd_uuid = {
+                    .len = ESP_UUID_LEN_16,
+                    .uuid = { .uuid16 = ESP_GATT_UUID_CHAR_CLIENT_CONFIG },
+                };
+                esp_ble_gatts_add_char_descr(s_service_handle, &cccd_uuid,
+                    (esp_gatt_perm_t)(ESP_GATT_PERM_READ | ESP_GATT_PERM_WRITE), NULL, NULL);
+            } else {
+                // Phase 2: Accel RX char just added
+                s_char_accel_handle = param->add_char.attr_handle;
+                ESP_LOGI(TAG, "Accel RX char handle: %d", s_char_accel_handle);
+            }
+            break;
+        }
+
+        case ESP_GATTS_ADD_CHAR_DESCR_EVT: {
+            // Status CCCD added -> Accel RX characteristic (writable — 24-byte accel packets)
+            s_status_cccd_handle = param->add_char_descr.attr_handle;
+            esp_bt_uuid_t accel_uuid = {
+                .len = ESP_UUID_LEN_16,
+                .uuid = { .uuid16 = 0xFF03 },
+            };
+            esp_gatt_perm_t accel_perm = ESP_GATT_PERM_WRITE;
+            esp_gatt_char_prop_t accel_prop = ESP_GATT_CHAR_PROP_BIT_WRITE | ESP_GATT_CHAR_PROP_BIT_WRITE_NR;
+            esp_ble_gatts_add_char(s_service_handle, &accel_uuid, accel_perm, accel_prop, NULL, NULL);
+            break;
+        }
+
+        case ESP_GATTS_MTU_EVT:
+            ble_core_set_mtu(param->mtu.conn_id, param->mtu.mtu);
+            break;
+
+        case ESP_GATTS_CONGEST_EVT:
+            ble_core_set_congested(param->congest.conn_id, param->congest.congested);
+            break;
+
+        case ESP_GATTS_CONNECT_EVT: {
+            const int n = ble_core_connect(param->connect.conn_id, param->connect.remote_bda);
+            if (n < 0) break;
+            s_dle_pending = param->connect.conn_id;
+
+            // Request higher connection priority for low latency
+            esp_ble_conn_update_params_t conn_params = {};
+            memcpy(conn_params.bda, param->connect.remote_bda, sizeof(esp_bd_addr_t));
+            conn_params.latency = 0;
+            conn_params.max_int = 0x0006;  // 7.5ms
+            conn_params.min_int = 0x0006;  // 7.5ms
+            conn_params.timeout = 400;     // 4s
+            esp_ble_gap_update_conn_params(&conn_params);
+
+            // Request preferred connection params for higher throughput
+            esp_ble_gap_set_prefer_conn_params(param->connect.remote_bda, 6, 6, 0, 400);
+
+            // Data length extension: 251-byte link-layer PDUs, so a batched
+            // write up to the MTU goes out in one packet per connection event.
+            esp_ble_gap_set_pkt_data_len(param->connect.remote_bda, BLE_DLE_OCTETS);
+#if CONFIG_BT_BLE_50_FEATURES_SUPPORTED
+            // 2M PHY where both controllers support it (BLE 5 targets only).
+            esp_ble_gap_set_preferred_phy(param->connect.remote_bda, 0,
+                ESP_BLE_GAP_PHY_2M_PREF_MASK, ESP_BLE_GAP_PHY_2M_PREF_MASK, ESP_BLE_GAP_PHY_OPTIONS_NO_PREF);
+#endif
+
+            // Advertising stops on connect; keep it up while observer slots are free.
+            if (n < BLE_MAX_CONN) esp_ble_gap_start_advertising(&s_adv_params);
+            break;
+        }
+
+        case ESP_GATTS_DISCONNECT_EVT:
+            ble_core_disconnect(param->disconnect.conn_id);
+            esp_ble_gap_start_advertising(&s_adv_params);
+            break;
+
+        case ESP_GATTS_WRITE_EVT: {
+            const uint16_t h = param->write.handle;
+            if (h == s_char_motion_handle) {
+                ble_core_rx(param->write.conn_id, BLE_CHR_MOTION, param->write.value, param->write.len);
+            } else if (h == s_char_accel_handle) {
+                ble_core_rx(param->write.conn_id, BLE_CHR_ACCEL, param->write.value, param->write.len);
+            } else if (h == s_char_status_handle) {
+                ble_core_rx(param->write.conn_id, BLE_CHR_STATUS, param->write.value, param->write.len);
+            } else if (h == s_status_cccd_handle && param->write.len == 2) {
+                // CCCD write: this observer's notifications on/off
+                uint16_t descr_value = param->write.value[1] << 8 | param->write.value[0];
+                ble_core_set_notify(param->write.conn_id, (descr_value & 0x0001) != 0);
+            }
+            if (param->write.need_rsp) {
+                esp_ble_gatts_send_response(gatts_if, param->write.conn_id,
+                    param->write.trans_id, ESP_GATT_OK, NULL);
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// ── BleHost.h ────────────────────────────────────────────────────────
+
+bool ble_host_start(void)
+{
+    memcpy(s_service_uuid, BLE_SERVICE_UUID128, sizeof(s_service_uuid));
+
+    // Release classic BT memory (we only need BLE)
+    ESP_ERROR_CHECK(esp_bt_controller_mem_release(ESP_BT_MODE_CLASSIC_BT));
+
+    esp_bt_controller_config_t bt_cfg = BT_CONTROLLER_INIT_CONFIG_DEFAULT();
+    esp_err_t ret = esp_bt_controller_init(&bt_cfg);
+    if (ret) {
+        ESP_LOGE(TAG, "BT controller init failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+
+    ret = esp_bt_controller_enable(ESP_BT_MODE_BLE);
+    if (ret) {
+        ESP_LOGE(TAG, "BT controller enable failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+
+    ret = esp_bluedroid_init();
+    if (ret) {
+        ESP_LOGE(TAG, "Bluedroid init failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+
+    ret = esp_bluedroid_enable();
+    if (ret) {
+        ESP_LOGE(TAG, "Bluedroid enable failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+
+    esp_ble_gatts_register_callback(gatts_event_handler);
+    esp_ble_gap_register_callback(gap_event_handler);
+    esp_ble_gatts_app_register(GATTS_APP_ID);
+
+    // MTU for batched telemetry notifications (each client negotiates its own)
+    esp_ble_gatt_set_local_mtu(BLE_LOCAL_MTU);
+    return true;
+}
+
+bool ble_host_notify(uint16_t conn_id, const uint8_t *data, uint16_t len)
+{
+    if (s_char_status_handle == 0) return false;
+    return esp_ble_gatts_send_indicate(s_gatts_if, conn_id, s_char_status_handle, len,
+                                       (uint8_t *)data, false) == ESP_OK;
+}
+
+const char *ble_host_name(void)
+{
+    return "Bluedroid";
+}
+
+#endif // ENABLE_BLE && CONFIG_BT_BLUEDROID_ENABLED
@@ -0,0 +1,267 @@
+// BleNimble.cpp — NimBLE backend of the BLE transport (BleHost.h)
+// Selected with the sdkconfig.nimble overlay (CONFIG_BT_NIMBLE_ENABLED). Same
+// service, characteristics and advertising as the Bluedroid backend at a
+// fraction of its RAM and flash: the GATT table is static and registered in
+// one call, the host runs in a single task (nimble_port_freertos_init) and
+// every GAP event arrives in gap_event(). NimBLE has no congestion event —
+// a notification that finds no mbuf fails, and the core counts it dropped.
+#include "BleHost.h"
+
+#if defined(ENABLE_BLE) && defined(CONFIG_BT_NIMBLE_ENABLED)
+
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_bt.h"
+#include "nimble/nimble_port.h"
+#include "nimble/nimble_port_freertos.h"
+#include "host/ble_hs.h"
+#include "host/util/util.h"
+#include "services/gap/ble_svc_gap.h"
+#include "services/gatt/ble_svc_gatt.h"
+
+static const char *TAG = "ble_nimble";
+
+static uint8_t  s_own_addr_type = 0;
+static uint16_t s_char_motion_handle = 0;
+static uint16_t s_char_status_handle = 0;
+static uint16_t s_char_accel_handle = 0;
+static volatile bool s_synced = false;
+
+static ble_uuid128_t s_service_uuid;        // filled from BLE_SERVICE_UUID128
+static const ble_uuid16_t s_motion_uuid = BLE_UUID16_INIT(0xFF01);
+static const ble_uuid16_t s_status_uuid = BLE_UUID16_INIT(0xFF02);
+static const ble_uuid16_t s_accel_uuid  = BLE_UUID16_INIT(0xFF03);
+
+static int gap_event(struct ble_gap_event *event, void *arg);
+
+// ── GATT table ───────────────────────────────────────────────────────
+// The status characteristic's CCCD (0x2902) is added by NimBLE for the
+// NOTIFY flag; subscriptions arrive as BLE_GAP_EVENT_SUBSCRIBE.
+
+static int gatt_access(uint16_t conn_handle, uint16_t attr_handle,
+                       struct ble_gatt_access_ctxt *ctxt, void *arg)
+{
+    (void)attr_handle;
+    if (ctxt->op == BLE_GATT_ACCESS_OP_READ_CHR) return 0;   // status reads back empty
+    if (ctxt->op != BLE_GATT_ACCESS_OP_WRITE_CHR) return BLE_ATT_ERR_UNLIKELY;
+
+    uint8_t buf[BLE_LOCAL_MTU];
+    uint16_t len = 0;
+    if (ble_hs_mbuf_to_flat(ctxt->om, buf, sizeof(buf), &len) != 0) return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+    ble_core_rx(conn_handle, (BleChr)(intptr_t)arg, buf, len);
+    return 0;
+}
+
+static const struct ble_gatt_chr_def s_chars[] = {
+    {
+        .uuid       = &s_motion_uuid.u,
+        .access_cb  = gatt_access,
+        .arg        = (void *)(intptr_t)BLE_CHR_MOTION,
+        .flags      = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_WRITE_NO_RSP,
+        .val_handle = &s_char_motion_handle,
+    },
+    {
+        .uuid       = &s_status_uuid.u,
+        .access_cb  = gatt_access,
+        .arg        = (void *)(intptr_t)BLE_CHR_STATUS,
+        .flags      = BLE_GATT_CHR_F_NOTIFY | BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_WRITE,
+        .val_handle = &s_char_status_handle,
+    },
+    {
+        .uuid       = &s_accel_uuid.u,
+        .access_cb  = gatt_access,
+        .arg        = (void *)(intptr_t)BLE_CHR_ACCEL,
+        .flags      = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_WRITE_NO_RSP,
+        .val_handle = &s_char_accel_handle,
+    },
+    { 0 },
+};
+
+static const struct ble_gatt_svc_def s_services[] = {
+    {
+        .type            = BLE_GATT_SVC_TYPE_PRIMARY,
+        .uuid            = &s_service_uuid.u,
+        .characteristics = s_chars,
+    },
+    { 0 },
+};
+
+// ── Advertising ──────────────────────────────────────────────────────
+// Flags + complete name + 128-bit service UUID = the full 31-byte payload,
+// as with Bluedroid.
+
+static void advertise(void)
+{
+    if (!s_synced || ble_gap_adv_active()) return;
+
+    struct ble_hs_adv_fields fields = {};
+    fields.flags = BLE_HS_ADV_F_DISC_GEN | BLE_HS_ADV_F_BREDR_UNSUP;
+    fields.name = (const uint8_t *)BLE_DEVICE_NAME;
+    fields.name_len = strlen(BLE_DEVICE_NAME);
+    fields.name_is_complete = 1;
+    fields.uuids128 = &s_service_uuid;
+    fields.num_uuids128 = 1;
+    fields.uuids128_is_complete = 1;
+    int rc = ble_gap_adv_set_fields(&fields);
+    if (rc != 0) {
+        ESP_LOGE(TAG, "adv fields failed: %d", rc);
+        return;
+    }
+
+    struct ble_gap_adv_params adv = {};
+    adv.conn_mode = BLE_GAP_CONN_MODE_UND;
+    adv.disc_mode = BLE_GAP_DISC_MODE_GEN;
+    adv.itvl_min  = 0x20;    // 20ms
+    adv.itvl_max  = 0x40;    // 40ms
+    rc = ble_gap_adv_start(s_own_addr_type, NULL, BLE_HS_FOREVER, &adv, gap_event, NULL);
+    if (rc == 0) {
+        ble_core_adv_started();
+        ESP_LOGI(TAG, "BLE advertising started");
+    } else {
+        ESP_LOGE(TAG, "adv start failed: %d", rc);
+    }
+}
+
+// ── GAP events ───────────────────────────────────────────────────────
+
+static int gap_event(struct ble_gap_event *event, void *arg)
+{
+    (void)arg;
+    struct ble_gap_conn_desc desc;
+    switch (event->type) {
+        case BLE_GAP_EVENT_CONNECT: {
+            if (event->connect.status != 0) { advertise(); break; }
+            const uint16_t h = event->connect.conn_handle;
+            if (ble_gap_conn_find(h, &desc) != 0) break;
+            const int n = ble_core_connect(h, desc.peer_id_addr.val);
+            if (n < 0) { ble_gap_terminate(h, BLE_ERR_CONN_LIMIT); break; }
+            ble_core_set_interval(h, desc.conn_itvl);
+
+            // 7.5 ms interval, no latency, 4 s supervision timeout
+            struct ble_gap_upd_params p = {};
+            p.itvl_min = 0x0006;
+            p.itvl_max = 0x0006;
+            p.latency = 0;
+            p.supervision_timeout = 400;
+            ble_gap_update_params(h, &p);
+
+            // Data length extension (see the Bluedroid backend)
+            ble_gap_set_data_len(h, BLE_DLE_OCTETS, BLE_DLE_TIME_US);
+#if CONFIG_BT_NIMBLE_50_FEATURE_SUPPORT
+            ble_gap_set_prefered_le_phy(h, BLE_GAP_LE_PHY_2M_MASK, BLE_GAP_LE_PHY_2M_MASK, BLE_GAP_LE_PHY_CODED_ANY);
+#endif
+            // Advertising stops on connect; keep it up while observer slots are free.
+            if (n < BLE_MAX_CONN) advertise();
+            break;
+        }
+        case BLE_GAP_EVENT_DISCONNECT:
+            ble_core_disconnect(event->disconnect.conn.conn_handle);
+            advertise();
+            break;
+        case BLE_GAP_EVENT_ADV_COMPLETE:
+            advertise();
+            break;
+        case BLE_GAP_EVENT_CONN_UPDATE:
+            if (event->conn_update.status == 0 && ble_gap_conn_find(event->conn_update.conn_handle, &desc) == 0)
+                ble_core_set_interval(event->conn_update.conn_handle, desc.conn_itvl);
+            break;
+        case BLE_GAP_EVENT_MTU:
+            ble_core_set_mtu(event->mtu.conn_handle, event->mtu.value);
+            break;
+        case BLE_GAP_EVENT_SUBSCRIBE:
+            if (event->subscribe.attr_handle == s_char_status_handle)
+                ble_core_set_notify(event->subscribe.conn_handle, event->subscribe.cur_notify);
+            break;
+#if CONFIG_BT_NIMBLE_50_FEATURE_SUPPORT
+        case BLE_GAP_EVENT_PHY_UPDATE_COMPLETE:
+            if (event->phy_updated.status == 0)
+                ble_core_set_phy(event->phy_updated.conn_handle, event->phy_updated.tx_phy,
+                                 event->phy_updated.rx_phy);
+            break;
+#endif
+#ifdef BLE_GAP_EVENT_DATA_LEN_CHG
+        case BLE_GAP_EVENT_DATA_LEN_CHG:
+            ble_core_set_data_len(event->data_len_chg.conn_handle, event->data_len_chg.max_tx_octets,
+                                  event->data_len_chg.max_rx_octets);
+            break;
+#endif
+        default:
+            break;
+    }
+    return 0;
+}
+
+// ── Host task ────────────────────────────────────────────────────────
+
+static void on_sync(void)
+{
+    ble_hs_util_ensure_addr(0);
+    ble_hs_id_infer_auto(0, &s_own_addr_type);
+    s_synced = true;
+    advertise();
+}
+
+static void on_reset(int reason)
+{
+    s_synced = false;
+    ESP_LOGW(TAG, "NimBLE host reset: %d", reason);
+}
+
+static void host_task(void *pv)
+{
+    (void)pv;
+    nimble_port_run();              // returns only on nimble_port_stop()
+    nimble_port_freertos_deinit();
+}
+
+// ── BleHost.h ────────────────────────────────────────────────────────
+
+bool ble_host_start(void)
+{
+    s_service_uuid.u.type = BLE_UUID_TYPE_128;
+    memcpy(s_service_uuid.value, BLE_SERVICE_UUID128, 16);
+
+    // Release classic BT memory (we only need BLE)
+    esp_bt_controller_mem_release(ESP_BT_MODE_CLASSIC_BT);
+
+    esp_err_t ret = nimble_port_init();     // controller + host
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "NimBLE init failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+
+    ble_hs_cfg.sync_cb  = on_sync;
+    ble_hs_cfg.reset_cb = on_reset;
+
+    ble_svc_gap_init();
+    ble_svc_gatt_init();
+    int rc = ble_gatts_count_cfg(s_services);
+    if (rc == 0) rc = ble_gatts_add_svcs(s_services);
+    if (rc != 0) {
+        ESP_LOGE(TAG, "GATT table failed: %d", rc);
+        return false;
+    }
+    ble_svc_gap_device_name_set(BLE_DEVICE_NAME);
+
+    // MTU for batched telemetry notifications (each client negotiates its own)
+    ble_att_set_preferred_mtu(BLE_LOCAL_MTU);
+
+    nimble_port_freertos_init(host_task);
+    return true;
+}
+
+bool ble_host_notify(uint16_t conn_id, const uint8_t *data, uint16_t len)
+{
+    if (!s_synced || s_char_status_handle == 0) return false;
+    struct os_mbuf *om = ble_hs_mbuf_from_flat(data, len);
+    if (!om) return false;                  // out of mbufs: the link is backed up
+    return ble_gatts_notify_custom(conn_id, s_char_status_handle, om) == 0;
+}
+
+const char *ble_host_name(void)
+{
+    return "NimBLE";
+}
+
+#endif // ENABLE_BLE && CONFIG_BT_NIMBLE_ENABLED
@@ -1,9 +1,11 @@
 #ifdef ENABLE_BLE
 
 #include "BleTransport.h"
+#include "BleHost.h"
 #include "CobsTransport.h"
 #include "helpers.h"
 #include "debug_uart.h"
+#include "tel2.h"
 
 #include <string.h>
 #include <stdio.h>
@@ -11,14 +13,11 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
+#include "freertos/queue.h"
 
 #include "esp_log.h"
-#include "esp_bt.h"
-#include "esp_bt_main.h"
-#include "esp_gap_ble_api.h"
-#include "esp_gatts_api.h"
-#include "esp_bt_defs.h"
-#include "esp_gatt_common_api.h"
+#include "esp_timer.h"
+#include "esp_system.h"
 
 static const char *TAG = "ble_transport";
 
@@ -37,65 +36,126 @@ typedef enum {
 static volatile ble_state_t s_ble_state = BLE_STATE_IDLE;
 static void (*s_packet_callback)(const uint8_t *payload) = NULL;
 static void (*s_accel_callback)(const float *data) = NULL;
-
-// GATT handles
-static uint16_t s_gatts_if = ESP_GATT_IF_NONE;
-static uint16_t s_conn_id = 0;
-static uint16_t s_service_handle = 0;
-static uint16_t s_char_motion_handle = 0;   // writable: receives motion packets
-static uint16_t s_char_status_handle = 0;   // notify: sends status/telemetry
-static uint16_t s_char_accel_handle = 0;    // writable: receives accel packets
-static bool s_notify_enabled = false;
-static int s_char_add_phase = 0;            // tracks which char we're adding
-
-// Service UUID: 42100001-0001-1000-8000-00805f9b34fb
-static uint8_t s_service_uuid[16] = {
+static ble_motion_at_cb_t s_packet_at_callback = NULL;   // batched writes
+static ble_accel_at_cb_t  s_accel_at_callback  = NULL;
+
+// ── Connections (BLE_MAX_CONN observers) ──────────────────────────────
+// Config fields are written from the host stack's callbacks and read by
+// BleTelTask under s_conn_mux; the batch buffer belongs to BleTelTask alone.
+#define BLE_TEL_QUEUE       32       // TEL2 samples between CueTask and BleTelTask
+#define BLE_TEL_FLUSH_US    20000    // max time a sample waits in a part-filled batch
+#define BLE_TEL_DEF_MASK    (TEL2_F_POSE | TEL2_F_ANGLE)
+#define BLE_TEL_DEF_HZ      50
+
+typedef struct {
+    bool     used;
+    uint8_t  gen;           // bumped per connect: BleTelTask restarts the slot
+    bool     notify;        // CCCD notifications on
+    bool     congested;     // host reports congestion: hold notifications
+    uint16_t connId;
+    uint16_t mtu;           // negotiated ATT MTU (23 until exchanged)
+    uint8_t  mask;          // TEL2 groups this observer gets
+    uint16_t rateHz;        // samples per second this observer gets
+    // BleTelTask only
+    uint8_t  seenGen;
+    uint32_t nextUs;        // decimation schedule (sample t_us)
+    uint8_t  batch[BLE_LOCAL_MTU - 3];
+    uint16_t batchLen;
+    uint8_t  batchN;
+    int64_t  batchStartUs;
+    // counters
+    uint32_t samples, notifies, dropped;
+    // link (host callbacks)
+    uint8_t  addr[6];
+    uint8_t  txPhy, rxPhy;  // 1 = 1M, 2 = 2M, 3 = coded
+    uint16_t txOctets, rxOctets;   // data length (27 until DLE)
+    uint16_t intervalX125;  // connection interval, 1.25 ms units
+    uint32_t rxWrites, rxSamples, rxBytes, rxBad;
+    int64_t  rxSinceUs;     // window start for BLE:LINK? rates
+} BleConn;
+
+static BleConn        s_conns[BLE_MAX_CONN];
+static portMUX_TYPE   s_conn_mux = portMUX_INITIALIZER_UNLOCKED;
+static volatile uint8_t s_tel_mask = 0;     // union of subscribed masks (CueTask reads)
+static QueueHandle_t  s_tel_queue = NULL;
+
+typedef struct {
+    uint8_t len;
+    uint8_t data[TEL2_MAX_SIZE];
+} BleTelItem;
+
+static uint32_t       s_heap_used = 0;      // free-heap drop across ble_host_start()
+static int64_t        s_adv_ready_us = 0;   // first advertising start (boot time base)
+
+const uint8_t BLE_SERVICE_UUID128[16] = {
     0xfb, 0x34, 0x9b, 0x5f, 0x80, 0x00, 0x00, 0x80,
     0x00, 0x10, 0x01, 0x00, 0x01, 0x00, 0x10, 0x42
 };
 
-// Advertising data
-static esp_ble_adv_data_t s_adv_data = {
-    .set_scan_rsp = false,
-    .include_name = true,
-    .include_txpower = false,
-    .min_interval = 0x0006,  // 7.5ms
-    .max_interval = 0x0010,  // 20ms
-    .appearance = 0x00,
-    .manufacturer_len = 0,
-    .p_manufacturer_data = NULL,
-    .service_data_len = 0,
-    .p_service_data = NULL,
-    .service_uuid_len = sizeof(s_service_uuid),
-    .p_service_uuid = s_service_uuid,
-    .flag = (ESP_BLE_ADV_FLAG_GEN_DISC | ESP_BLE_ADV_FLAG_BREDR_NOT_SPT),
-};
+// Caller holds s_conn_mux.
+static BleConn *conn_find(uint16_t conn_id)
+{
+    for (int i = 0; i < BLE_MAX_CONN; i++)
+        if (s_conns[i].used && s_conns[i].connId == conn_id) return &s_conns[i];
+    return NULL;
+}
 
-static esp_ble_adv_params_t s_adv_params = {
-    .adv_int_min = 0x20,     // 20ms
-    .adv_int_max = 0x40,     // 40ms
-    .adv_type = ADV_TYPE_IND,
-    .own_addr_type = BLE_ADDR_TYPE_PUBLIC,
-    .peer_addr = {0},
-    .peer_addr_type = BLE_ADDR_TYPE_PUBLIC,
-    .channel_map = ADV_CHNL_ALL,
-    .adv_filter_policy = ADV_FILTER_ALLOW_SCAN_ANY_CON_ANY,
-};
+// Caller holds s_conn_mux.
+static void tel_mask_update(void)
+{
+    uint8_t m = 0;
+    for (int i = 0; i < BLE_MAX_CONN; i++)
+        if (s_conns[i].used && s_conns[i].notify) m |= s_conns[i].mask;
+    s_tel_mask = m;
+}
 
-#define DEVICE_NAME "Mini6DOF"
-#define GATTS_APP_ID 0
-#define GATTS_NUM_HANDLE 12
+static int conn_count(void)
+{
+    int n = 0;
+    for (int i = 0; i < BLE_MAX_CONN; i++) n += s_conns[i].used;
+    return n;
+}
 
 // ── Process received BLE data ────────────────────────────────────────
+// Single writes go straight to the callback. Batched writes (BLE_BATCH_MAGIC,
+// BleTransport.h) carry N samples with sender-side offsets; each is handed
+// on with its due time = arrival + (offset − first offset), so the batch
+// plays back over its own span at the spacing it was captured with.
+// Returns the number of samples delivered (0 = malformed).
+
+static int unpack_batch(const uint8_t *data, uint16_t len, int payload, bool accel)
+{
+    if (len < BLE_BATCH_HDR) return 0;
+    const int n = data[1];
+    const int stride = 2 + payload;
+    if (n < 1 || len != BLE_BATCH_HDR + n * stride) return 0;
+    const int64_t arrival = esp_timer_get_time();
+    const uint8_t *p = data + BLE_BATCH_HDR;
+    const uint16_t off0 = (uint16_t)(p[0] | (p[1] << 8));
+    for (int k = 0; k < n; k++, p += stride) {
+        const uint16_t off = (uint16_t)(p[0] | (p[1] << 8));
+        const int64_t due = arrival + (int64_t)(uint16_t)(off - off0) * BLE_BATCH_TICK_US;
+        if (accel) {
+            float values[6];
+            memcpy(values, p + 2, 24);
+            if (s_accel_at_callback) s_accel_at_callback(values, due);
+            else if (k == n - 1 && s_accel_callback) s_accel_callback(values);
+        } else {
+            if (s_packet_at_callback) s_packet_at_callback(p + 2, due);
+            else if (k == n - 1 && s_packet_callback) s_packet_callback(p + 2);
+        }
+    }
+    return n;
+}
 
-static void process_ble_write(const uint8_t *data, uint16_t len)
+static int process_ble_write(const uint8_t *data, uint16_t len)
 {
-    if (s_packet_callback == NULL) return;
+    if (s_packet_callback == NULL) return 0;
 
     // Accept 12-byte raw payload
     if (len == BIN_PAYLOAD_SIZE) {
         s_packet_callback(data);
-        return;
+        return 1;
     }
 
     // Accept 15-byte framed packet (sync + payload + checksum)
@@ -106,184 +166,255 @@ static void process_ble_write(const uint8_t *data, uint16_t len)
             xor_check ^= data[2 + i];
         if (xor_check == data[14]) {
             s_packet_callback(&data[2]);
-        } else {
-            DEBUG_PRINTLN("BLE checksum fail");
+            return 1;
         }
-        return;
+        DEBUG_PRINTLN("BLE checksum fail");
+        return 0;
+    }
+
+    if (len > 0 && data[0] == BLE_BATCH_MAGIC) {
+        int n = unpack_batch(data, len, BIN_PAYLOAD_SIZE, false);
+        if (n) return n;
     }
 
     DEBUG_PRINTLN("BLE: unexpected %d bytes", len);
+    return 0;
 }
 
 // ── Process received BLE accel data ──────────────────────────────────
 
-static void process_ble_accel_write(const uint8_t *data, uint16_t len)
+static int process_ble_accel_write(const uint8_t *data, uint16_t len)
 {
-    if (s_accel_callback == NULL) return;
+    if (s_accel_callback == NULL) return 0;
 
     // Accept 24-byte raw payload: 6 x float32 LE
     if (len == 24) {
         float values[6];
         memcpy(values, data, 24);
         s_accel_callback(values);
-        return;
+        return 1;
+    }
+
+    if (len > 0 && data[0] == BLE_BATCH_MAGIC) {
+        int n = unpack_batch(data, len, 24, true);
+        if (n) return n;
     }
 
     DEBUG_PRINTLN("BLE accel: unexpected %d bytes", len);
+    return 0;
 }
 
-// ── GAP event handler ────────────────────────────────────────────────
+// ── Host stack events (BleHost.h) ────────────────────────────────────
 
-static void gap_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param)
+void ble_core_adv_started(void)
 {
-    switch (event) {
-        case ESP_GAP_BLE_ADV_DATA_SET_COMPLETE_EVT:
-            esp_ble_gap_start_advertising(&s_adv_params);
-            break;
-        case ESP_GAP_BLE_ADV_START_COMPLETE_EVT:
-            if (param->adv_start_cmpl.status == ESP_BT_STATUS_SUCCESS) {
-                s_ble_state = BLE_STATE_ADVERTISING;
-                ESP_LOGI(TAG, "BLE advertising started");
-            }
-            break;
-        case ESP_GAP_BLE_SET_PKT_LENGTH_COMPLETE_EVT:
-            ESP_LOGI(TAG, "BLE packet length updated");
-            break;
-        default:
-            break;
+    if (!s_adv_ready_us) s_adv_ready_us = esp_timer_get_time();
+    if (s_ble_state == BLE_STATE_IDLE) s_ble_state = BLE_STATE_ADVERTISING;
+}
+
+int ble_core_connect(uint16_t conn_id, const uint8_t addr[6])
+{
+    portENTER_CRITICAL(&s_conn_mux);
+    BleConn *c = NULL;
+    for (int i = 0; i < BLE_MAX_CONN && !c; i++)
+        if (!s_conns[i].used) c = &s_conns[i];
+    if (c) {
+        c->used      = true;
+        c->gen++;
+        c->notify    = false;
+        c->congested = false;
+        c->connId    = conn_id;
+        c->mtu       = 23;
+        c->mask      = BLE_TEL_DEF_MASK;
+        c->rateHz    = BLE_TEL_DEF_HZ;
+        memcpy(c->addr, addr, 6);
+        c->txPhy = c->rxPhy = 1;
+        c->txOctets = c->rxOctets = 27;
+        c->intervalX125 = 0;
+        c->rxWrites = c->rxSamples = c->rxBytes = c->rxBad = 0;
+        c->rxSinceUs = esp_timer_get_time();
     }
+    const int n = conn_count();
+    portEXIT_CRITICAL(&s_conn_mux);
+    if (!c) return -1;
+    s_ble_state = BLE_STATE_CONNECTED;
+    ESP_LOGI(TAG, "BLE client connected (conn_id=%d, %d/%d)", conn_id, n, BLE_MAX_CONN);
+    cobs_send_fmt(COBS_CH_LOG, "BLE:CONNECTED %d (%d/%d)", conn_id, n, BLE_MAX_CONN);
+    return n;
 }
 
-// ── GATTS event handler ──────────────────────────────────────────────
+int ble_core_disconnect(uint16_t conn_id)
+{
+    portENTER_CRITICAL(&s_conn_mux);
+    BleConn *c = conn_find(conn_id);
+    if (c) c->used = false;
+    tel_mask_update();
+    const int n = conn_count();
+    portEXIT_CRITICAL(&s_conn_mux);
+    s_ble_state = n ? BLE_STATE_CONNECTED : BLE_STATE_ADVERTISING;
+    ESP_LOGI(TAG, "BLE client %d disconnected, restarting advertising", conn_id);
+    cobs_send_fmt(COBS_CH_LOG, "BLE:DISCONNECTED %d (%d/%d)", conn_id, n, BLE_MAX_CONN);
+    return n;
+}
 
-static void gatts_event_handler(esp_gatts_cb_event_t event, esp_gatt_if_t gatts_if,
-                                esp_ble_gatts_cb_param_t *param)
+bool ble_core_find_addr(const uint8_t addr[6], uint16_t *conn_id)
 {
-    switch (event) {
-        case ESP_GATTS_REG_EVT: {
-            s_gatts_if = gatts_if;
-            esp_ble_gap_set_device_name(DEVICE_NAME);
-            esp_ble_gap_config_adv_data(&s_adv_data);
-
-            // Create service
-            esp_gatt_srvc_id_t service_id = {};
-            service_id.is_primary = true;
-            service_id.id.inst_id = 0;
-            service_id.id.uuid.len = ESP_UUID_LEN_128;
-            memcpy(service_id.id.uuid.uuid.uuid128, s_service_uuid, 16);
-            esp_ble_gatts_create_service(gatts_if, &service_id, GATTS_NUM_HANDLE);
-            break;
+    bool hit = false;
+    portENTER_CRITICAL(&s_conn_mux);
+    for (int i = 0; i < BLE_MAX_CONN && !hit; i++)
+        if (s_conns[i].used && memcmp(s_conns[i].addr, addr, 6) == 0) {
+            *conn_id = s_conns[i].connId;
+            hit = true;
         }
+    portEXIT_CRITICAL(&s_conn_mux);
+    return hit;
+}
 
-        case ESP_GATTS_CREATE_EVT: {
-            s_service_handle = param->create.service_handle;
-            esp_ble_gatts_start_service(s_service_handle);
-            s_char_add_phase = 0;
-
-            // Motion RX characteristic (writable — receives binary motion packets)
-            esp_bt_uuid_t motion_uuid = {
-                .len = ESP_UUID_LEN_16,
-                .uuid = { .uuid16 = 0xFF01 },
-            };
-            esp_gatt_perm_t motion_perm = ESP_GATT_PERM_WRITE;
-            esp_gatt_char_prop_t motion_prop = ESP_GATT_CHAR_PROP_BIT_WRITE | ESP_GATT_CHAR_PROP_BIT_WRITE_NR;
-            esp_ble_gatts_add_char(s_service_handle, &motion_uuid, motion_perm, motion_prop, NULL, NULL);
-            break;
-        }
+void ble_core_set_mtu(uint16_t conn_id, uint16_t mtu)
+{
+    portENTER_CRITICAL(&s_conn_mux);
+    BleConn *c = conn_find(conn_id);
+    if (c) c->mtu = mtu;
+    portEXIT_CRITICAL(&s_conn_mux);
+    ESP_LOGI(TAG, "conn %d MTU %d", conn_id, mtu);
+}
 
-        case ESP_GATTS_ADD_CHAR_EVT: {
-            if (s_char_add_phase == 0) {
-                // Phase 0: Motion RX char just added
-                s_char_motion_handle = param->add_char.attr_handle;
-                ESP_LOGI(TAG, "Motion RX char handle: %d", s_char_motion_handle);
-                s_char_add_phase = 1;
-
-                // Add Status TX characteristic (notify — sends telemetry/status)
-                esp_bt_uuid_t status_uuid = {
-                    .len = ESP_UUID_LEN_16,
-                    .uuid = { .uuid16 = 0xFF02 },
-                };
-                esp_gatt_perm_t status_perm = ESP_GATT_PERM_READ;
-                esp_gatt_char_prop_t status_prop = ESP_GATT_CHAR_PROP_BIT_NOTIFY | ESP_GATT_CHAR_PROP_BIT_READ;
-                esp_ble_gatts_add_char(s_service_handle, &status_uuid, status_perm, status_prop, NULL, NULL);
-            } else if (s_char_add_phase == 1) {
-                // Phase 1: Status TX char just added
-                s_char_status_handle = param->add_char.attr_handle;
-                ESP_LOGI(TAG, "Status TX char handle: %d", s_char_status_handle);
-                s_char_add_phase = 2;
-
-                // Add Accel RX characteristic (writable — receives 24-byte accel packets)
-                esp_bt_uuid_t accel_uuid = {
-                    .len = ESP_UUID_LEN_16,
-                    .uuid = { .uuid16 = 0xFF03 },
-                };
-                esp_gatt_perm_t accel_perm = ESP_GATT_PERM_WRITE;
-                esp_gatt_char_prop_t accel_prop = ESP_GATT_CHAR_PROP_BIT_WRITE | ESP_GATT_CHAR_PROP_BIT_WRITE_NR;
-                esp_ble_gatts_add_char(s_service_handle, &accel_uuid, accel_perm, accel_prop, NULL, NULL);
-            } else {
-                // Phase 2: Accel RX char just added
-                s_char_accel_handle = param->add_char.attr_handle;
-                ESP_LOGI(TAG, "Accel RX char handle: %d", s_char_accel_handle);
-            }
-            break;
-        }
+void ble_core_set_congested(uint16_t conn_id, bool congested)
+{
+    portENTER_CRITICAL(&s_conn_mux);
+    BleConn *c = conn_find(conn_id);
+    if (c) c->congested = congested;
+    portEXIT_CRITICAL(&s_conn_mux);
+}
 
-        case ESP_GATTS_CONNECT_EVT: {
-            s_conn_id = param->connect.conn_id;
-            s_ble_state = BLE_STATE_CONNECTED;
-
-            // Request higher connection priority for low latency
-            esp_ble_conn_update_params_t conn_params = {};
-            memcpy(conn_params.bda, param->connect.remote_bda, sizeof(esp_bd_addr_t));
-            conn_params.latency = 0;
-            conn_params.max_int = 0x0006;  // 7.5ms
-            conn_params.min_int = 0x0006;  // 7.5ms
-            conn_params.timeout = 400;     // 4s
-            esp_ble_gap_update_conn_params(&conn_params);
-
-            // Request preferred connection params for higher throughput
-            esp_ble_gap_set_prefer_conn_params(param->connect.remote_bda, 6, 6, 0, 400);
-
-            ESP_LOGI(TAG, "BLE client connected (conn_id=%d)", s_conn_id);
-            cobs_send_fmt(COBS_CH_LOG, "BLE:CONNECTED");
-            break;
-        }
+void ble_core_set_notify(uint16_t conn_id, bool on)
+{
+    portENTER_CRITICAL(&s_conn_mux);
+    BleConn *c = conn_find(conn_id);
+    if (c) c->notify = on;
+    tel_mask_update();
+    portEXIT_CRITICAL(&s_conn_mux);
+    ESP_LOGI(TAG, "conn %d notifications %s", conn_id, on ? "enabled" : "disabled");
+}
 
-        case ESP_GATTS_DISCONNECT_EVT: {
-            s_ble_state = BLE_STATE_ADVERTISING;
-            s_notify_enabled = false;
-            ESP_LOGI(TAG, "BLE client disconnected, restarting advertising");
-            cobs_send_fmt(COBS_CH_LOG, "BLE:DISCONNECTED");
-            esp_ble_gap_start_advertising(&s_adv_params);
-            break;
-        }
+void ble_core_set_phy(uint16_t conn_id, uint8_t tx_phy, uint8_t rx_phy)
+{
+    portENTER_CRITICAL(&s_conn_mux);
+    BleConn *c = conn_find(conn_id);
+    if (c) { c->txPhy = tx_phy; c->rxPhy = rx_phy; }
+    portEXIT_CRITICAL(&s_conn_mux);
+    ESP_LOGI(TAG, "conn %d PHY tx=%d rx=%d", conn_id, tx_phy, rx_phy);
+}
 
-        case ESP_GATTS_WRITE_EVT: {
-            if (param->write.handle == s_char_motion_handle) {
-                process_ble_write(param->write.value, param->write.len);
-            }
-            if (param->write.handle == s_char_accel_handle) {
-                process_ble_accel_write(param->write.value, param->write.len);
+void ble_core_set_data_len(uint16_t conn_id, uint16_t tx_octets, uint16_t rx_octets)
+{
+    portENTER_CRITICAL(&s_conn_mux);
+    BleConn *c = conn_find(conn_id);
+    if (c) { c->txOctets = tx_octets; c->rxOctets = rx_octets; }
+    portEXIT_CRITICAL(&s_conn_mux);
+    ESP_LOGI(TAG, "conn %d data length tx=%d rx=%d", conn_id, tx_octets, rx_octets);
+}
+
+void ble_core_set_interval(uint16_t conn_id, uint16_t itvl_x125)
+{
+    portENTER_CRITICAL(&s_conn_mux);
+    BleConn *c = conn_find(conn_id);
+    if (c) c->intervalX125 = itvl_x125;
+    portEXIT_CRITICAL(&s_conn_mux);
+}
+
+void ble_core_rx(uint16_t conn_id, BleChr chr, const uint8_t *data, uint16_t len)
+{
+    if (chr == BLE_CHR_STATUS) {
+        // [mask, rate_hz u16 LE]: this observer's TEL2 subscription
+        if (len == 3) ble_transport_tel_config(conn_id, data[0], (uint16_t)(data[1] | (data[2] << 8)));
+        return;
+    }
+    const int samples = chr == BLE_CHR_MOTION ? process_ble_write(data, len)
+                                              : process_ble_accel_write(data, len);
+    portENTER_CRITICAL(&s_conn_mux);
+    BleConn *c = conn_find(conn_id);
+    if (c) {
+        c->rxWrites++;
+        c->rxSamples += samples;
+        c->rxBytes   += len;
+        if (!samples) c->rxBad++;
+    }
+    portEXIT_CRITICAL(&s_conn_mux);
+}
+
+// ── Telemetry fan-out (BleTelTask) ─────────────────────────────────
+// CueTask queues one TEL2 sample per tick carrying the union of the
+// observers' groups. Per observer: decimate to its rate, cut the sample to
+// its groups (tel2_select), append to its batch, and notify when the next
+// sample would not fit the negotiated MTU or the oldest one has waited
+// BLE_TEL_FLUSH_US. A congested link keeps its batch; once it is full the
+// batch is dropped (counted) — nothing upstream ever waits on the radio.
+
+static void conn_flush(BleConn *c, uint16_t conn_id, bool congested)
+{
+    if (!c->batchN) return;
+    if (congested) return;
+    if (ble_host_notify(conn_id, c->batch, c->batchLen)) c->notifies++;
+    else               c->dropped += c->batchN;
+    c->batchLen = 0;
+    c->batchN   = 0;
+}
+
+static void BleTelTask(void *pv)
+{
+    (void)pv;
+    BleTelItem it;
+    uint8_t sel[TEL2_MAX_SIZE];
+    for (;;) {
+        const bool got = xQueueReceive(s_tel_queue, &it, pdMS_TO_TICKS(BLE_TEL_FLUSH_US / 2000)) == pdTRUE;
+        const int64_t now = esp_timer_get_time();
+        uint32_t t_us = 0;
+        if (got) t_us = (uint32_t)(it.data[8] | (it.data[9] << 8) | (it.data[10] << 16) | ((uint32_t)it.data[11] << 24));
+
+        for (int i = 0; i < BLE_MAX_CONN; i++) {
+            BleConn *c = &s_conns[i];
+            portENTER_CRITICAL(&s_conn_mux);
+            const bool     live = c->used && c->notify;
+            const uint16_t id   = c->connId;
+            const uint8_t  mask = c->mask;
+            const uint16_t rate = c->rateHz;
+            const uint16_t cap  = c->mtu - 3 < (int)sizeof(c->batch) ? c->mtu - 3 : sizeof(c->batch);
+            const bool     cong = c->congested;
+            const uint8_t  gen  = c->gen;
+            portEXIT_CRITICAL(&s_conn_mux);
+            if (gen != c->seenGen) {               // new client in this slot
+                c->seenGen  = gen;
+                c->nextUs   = t_us;
+                c->samples  = c->notifies = c->dropped = 0;
+                c->batchLen = 0;
+                c->batchN   = 0;
             }
-            // Handle CCCD write for notifications
-            if (param->write.len == 2) {
-                uint16_t descr_value = param->write.value[1] << 8 | param->write.value[0];
-                if (descr_value == 0x0001) {
-                    s_notify_enabled = true;
-                    ESP_LOGI(TAG, "Notifications enabled");
-                } else {
-                    s_notify_enabled = false;
+            if (!live) { c->batchLen = 0; c->batchN = 0; continue; }
+
+            if (got && rate) {
+                const uint32_t period = 1000000u / rate;
+                if ((int32_t)(t_us - c->nextUs) >= 0) {
+                    // On schedule, or resync after a gap / rate change.
+                    c->nextUs = (int32_t)(t_us - c->nextUs) > (int32_t)period ? t_us + period : c->nextUs + period;
+                    const int n = tel2_select(sel, it.data, mask);
+                    if (n <= cap) {
+                        if (c->batchLen + n > cap) {
+                            if (cong) { c->dropped += c->batchN; c->batchLen = 0; c->batchN = 0; }
+                            else      conn_flush(c, id, false);
+                        }
+                        if (!c->batchN) c->batchStartUs = now;
+                        memcpy(c->batch + c->batchLen, sel, n);
+                        c->batchLen += n;
+                        c->batchN++;
+                        c->samples++;
+                    } else {
+                        c->dropped++;          // MTU not exchanged yet and mask too wide
+                    }
                 }
             }
-            if (param->write.need_rsp) {
-                esp_ble_gatts_send_response(gatts_if, param->write.conn_id,
-                    param->write.trans_id, ESP_GATT_OK, NULL);
-            }
-            break;
+            if (c->batchN && now - c->batchStartUs >= BLE_TEL_FLUSH_US) conn_flush(c, id, cong);
         }
-
-        default:
-            break;
     }
 }
 
@@ -293,42 +424,17 @@ bool ble_transport_init(void (*process_packet)(const uint8_t *payload))
 {
     s_packet_callback = process_packet;
 
-    // Release classic BT memory (we only need BLE)
-    ESP_ERROR_CHECK(esp_bt_controller_mem_release(ESP_BT_MODE_CLASSIC_BT));
-
-    esp_bt_controller_config_t bt_cfg = BT_CONTROLLER_INIT_CONFIG_DEFAULT();
-    esp_err_t ret = esp_bt_controller_init(&bt_cfg);
-    if (ret) {
-        ESP_LOGE(TAG, "BT controller init failed: %s", esp_err_to_name(ret));
-        return false;
-    }
-
-    ret = esp_bt_controller_enable(ESP_BT_MODE_BLE);
-    if (ret) {
-        ESP_LOGE(TAG, "BT controller enable failed: %s", esp_err_to_name(ret));
-        return false;
-    }
-
-    ret = esp_bluedroid_init();
-    if (ret) {
-        ESP_LOGE(TAG, "Bluedroid init failed: %s", esp_err_to_name(ret));
-        return false;
-    }
-
-    ret = esp_bluedroid_enable();
-    if (ret) {
-        ESP_LOGE(TAG, "Bluedroid enable failed: %s", esp_err_to_name(ret));
-        return false;
-    }
-
-    esp_ble_gatts_register_callback(gatts_event_handler);
-    esp_ble_gap_register_callback(gap_event_handler);
-    esp_ble_gatts_app_register(GATTS_APP_ID);
+    const uint32_t heap0 = esp_get_free_heap_size();
+    if (!ble_host_start()) return false;
+    const uint32_t heap1 = esp_get_free_heap_size();
+    s_heap_used = heap0 > heap1 ? heap0 - heap1 : 0;
 
-    // Set MTU high enough for 24-byte accel packets + ATT overhead
-    esp_ble_gatt_set_local_mtu(128);
+    s_tel_queue = xQueueCreate(BLE_TEL_QUEUE, sizeof(BleTelItem));
+    // Core 0, below TelStream (3): radio telemetry is the first thing to yield.
+    xTaskCreatePinnedToCore(BleTelTask, "BleTel", 3072, NULL, 2, NULL, 0);
 
-    ESP_LOGI(TAG, "BLE transport initialized, device name: %s (MTU=128)", DEVICE_NAME);
+    ESP_LOGI(TAG, "BLE transport initialized (%s), device name: %s (MTU=%d, %d observers, %lu B heap)",
+             ble_host_name(), BLE_DEVICE_NAME, BLE_LOCAL_MTU, BLE_MAX_CONN, (unsigned long)s_heap_used);
     return true;
 }
 
@@ -354,12 +460,115 @@ const char* ble_transport_state_str(void)
 
 int ble_transport_notify(const uint8_t *data, uint16_t len)
 {
-    if (s_ble_state != BLE_STATE_CONNECTED || !s_notify_enabled) return -1;
-    if (s_char_status_handle == 0) return -1;
+    if (s_ble_state != BLE_STATE_CONNECTED) return -1;
+
+    uint16_t ids[BLE_MAX_CONN];
+    int n = 0;
+    portENTER_CRITICAL(&s_conn_mux);
+    for (int i = 0; i < BLE_MAX_CONN; i++)
+        if (s_conns[i].used && s_conns[i].notify && !s_conns[i].congested && len <= s_conns[i].mtu - 3)
+            ids[n++] = s_conns[i].connId;
+    portEXIT_CRITICAL(&s_conn_mux);
+
+    int sent = 0;
+    for (int i = 0; i < n; i++)
+        if (ble_host_notify(ids[i], data, len)) sent++;
+    return sent ? 0 : -1;
+}
+
+void ble_transport_host_info(BleHostInfo *out)
+{
+    out->host         = ble_host_name();
+    out->heap_used    = s_heap_used;
+    out->adv_ready_us = (uint32_t)s_adv_ready_us;
+}
+
+void ble_transport_set_timed_callbacks(ble_motion_at_cb_t motion, ble_accel_at_cb_t accel)
+{
+    s_packet_at_callback = motion;
+    s_accel_at_callback  = accel;
+}
+
+int ble_transport_link_status(BleLinkStatus *out, int max)
+{
+    const int64_t now = esp_timer_get_time();
+    int n = 0;
+    portENTER_CRITICAL(&s_conn_mux);
+    for (int i = 0; i < BLE_MAX_CONN && n < max; i++) {
+        BleConn *c = &s_conns[i];
+        if (!c->used) continue;
+        BleLinkStatus *o = &out[n++];
+        o->conn_id     = c->connId;
+        o->mtu         = c->mtu;
+        o->tx_phy      = c->txPhy;
+        o->rx_phy      = c->rxPhy;
+        o->tx_octets   = c->txOctets;
+        o->rx_octets   = c->rxOctets;
+        o->interval_us = (uint32_t)c->intervalX125 * 1250;
+        o->writes      = c->rxWrites;
+        o->samples     = c->rxSamples;
+        o->bytes       = c->rxBytes;
+        o->bad         = c->rxBad;
+        o->window_us   = (uint32_t)(now - c->rxSinceUs);
+        // next query reports the next window
+        c->rxWrites = c->rxSamples = c->rxBytes = c->rxBad = 0;
+        c->rxSinceUs = now;
+    }
+    portEXIT_CRITICAL(&s_conn_mux);
+    return n;
+}
 
-    esp_err_t ret = esp_ble_gatts_send_indicate(
-        s_gatts_if, s_conn_id, s_char_status_handle, len, (uint8_t*)data, false);
-    return (ret == ESP_OK) ? 0 : -1;
+uint8_t ble_transport_tel_mask(void)
+{
+    return s_tel_mask;
+}
+
+bool ble_transport_tel_push(const uint8_t *sample, int len)
+{
+    if (!s_tel_queue || len <= 0 || len > TEL2_MAX_SIZE) return false;
+    BleTelItem it;
+    it.len = (uint8_t)len;
+    memcpy(it.data, sample, len);
+    return xQueueSend(s_tel_queue, &it, 0) == pdTRUE;
+}
+
+bool ble_transport_tel_config(int conn_id, uint8_t mask, uint16_t rate_hz)
+{
+    if (rate_hz > BLE_TEL_MAX_HZ) rate_hz = BLE_TEL_MAX_HZ;
+    bool hit = false;
+    portENTER_CRITICAL(&s_conn_mux);
+    for (int i = 0; i < BLE_MAX_CONN; i++) {
+        BleConn *c = &s_conns[i];
+        if (!c->used || (conn_id >= 0 && c->connId != conn_id)) continue;
+        c->mask   = mask & TEL2_F_ALL;
+        c->rateHz = rate_hz;
+        hit = true;
+    }
+    tel_mask_update();
+    portEXIT_CRITICAL(&s_conn_mux);
+    return hit;
+}
+
+int ble_transport_tel_status(BleTelStatus *out, int max)
+{
+    int n = 0;
+    portENTER_CRITICAL(&s_conn_mux);
+    for (int i = 0; i < BLE_MAX_CONN && n < max; i++) {
+        const BleConn *c = &s_conns[i];
+        if (!c->used) continue;
+        out[n].conn_id   = c->connId;
+        out[n].mtu       = c->mtu;
+        out[n].notify    = c->notify;
+        out[n].congested = c->congested;
+        out[n].mask      = c->mask;
+        out[n].rate_hz   = c->rateHz;
+        out[n].samples   = c->samples;
+        out[n].notifies  = c->notifies;
+        out[n].dropped   = c->dropped;
+        n++;
+    }
+    portEXIT_CRITICAL(&s_conn_mux);
+    return n;
 }
 
 #endif // ENABLE_BLE
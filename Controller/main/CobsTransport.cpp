@@ -1,6 +1,10 @@
 // CobsTransport.cpp — COBS-framed multiplexed serial transport for ESP32
-// Uses VFS stdin/stdout (the proven working path) for I/O.
-// No uart_driver_install — avoids conflicts with ESP-IDF console subsystem.
+// UART0 runs under the IDF UART driver with a large RX ring: its ISR lives in
+// IRAM (CONFIG_UART_ISR_IN_IRAM), so bytes keep landing in the ring while a
+// flash erase/write has the cache disabled — the bare 128-byte FIFO would
+// overflow in ~1.4 ms at 921600 baud. Frames are read/written with
+// uart_read_bytes / uart_write_bytes directly; VFS stdio is routed through the
+// same driver so the console subsystem stays consistent.
 
 #include "CobsTransport.h"
 #include "cobs.h"
@@ -8,8 +12,6 @@
 #include <cstring>
 #include <cstdarg>
 #include <cstdio>
-#include <fcntl.h>
-#include <unistd.h>
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
@@ -18,17 +20,20 @@
 #include "driver/uart.h"
 #include "driver/uart_vfs.h"
 
-#define COBS_MAX_FRAME  512
+#define COBS_MAX_FRAME  512          // TX (responses, telemetry, logs)
+#define COBS_RX_RING    (16 * 1024)  // ~175 ms of line rate — covers a 64 KB block erase
 
 static SemaphoreHandle_t s_tx_mutex = NULL;
 static cobs_data_cb_t s_data_handler     = NULL;
 static cobs_data_cb_t s_data_raw_handler = NULL;
+static cobs_data_cb_t s_upload_handler   = NULL;
 static cobs_cmd_cb_t  s_cmd_handler      = NULL;
-static int s_stdin_fd = -1;
 
-// Decoder accumulation buffer
-static uint8_t s_rx_acc[COBS_MAX_FRAME];
+// Decoder accumulation + output buffers (RX task only; too big for its stack)
+static uint8_t s_rx_acc[COBS_MAX_ENC_SIZE(COBS_MAX_RX_FRAME)];
+static uint8_t s_rx_dec[COBS_MAX_ENC_SIZE(COBS_MAX_RX_FRAME)];
 static int     s_rx_pos = 0;
+static bool    s_rx_overflow = false;   // discard until the next delimiter
 
 // ── Init ─────────────────────────────────────────────────────────────
 
@@ -45,6 +50,8 @@ void cobs_transport_init(int baud_rate) {
     cfg.flow_ctrl  = UART_HW_FLOWCTRL_DISABLE;
     cfg.source_clk = UART_SCLK_DEFAULT;
     uart_param_config(UART_NUM_0, &cfg);
+    uart_driver_install(UART_NUM_0, COBS_RX_RING, 0, 0, NULL, 0);
+    uart_vfs_dev_use_driver(UART_NUM_0);
 
     // CRITICAL: Disable VFS line-ending conversion on UART0.
     // Default: TX converts \n→\r\n, RX converts \r\n→\n.
@@ -56,27 +63,19 @@ void cobs_transport_init(int baud_rate) {
     // TX mutex for thread-safe frame writes
     s_tx_mutex = xSemaphoreCreateMutex();
 
-    // Set stdin to non-blocking (same as original InterfaceMonitorTask)
-    s_stdin_fd = fileno(stdin);
-    int flags = fcntl(s_stdin_fd, F_GETFL, 0);
-    fcntl(s_stdin_fd, F_SETFL, flags | O_NONBLOCK);
-
-    // Make stdout unbuffered — we use direct write() for COBS frames
+    // Make stdout unbuffered — stray stdio must not sit in a buffer and
+    // land in the middle of a frame later
     setvbuf(stdout, NULL, _IONBF, 0);
 
-    // Cache stdout fd for direct write() calls
-    static int s_stdout_fd = -1;
-    s_stdout_fd = fileno(stdout);
-
     // Sync delimiters so receiver can resynchronize after boot garbage
     uint8_t sync[8] = {0};
-    write(s_stdout_fd, sync, sizeof(sync));
+    uart_write_bytes(UART_NUM_0, sync, sizeof(sync));
 
     // Send init message as a proper COBS LOG frame
     cobs_send_fmt(COBS_CH_LOG, "COBS transport initialized");
 }
 
-// ── Send (via VFS stdout — proven working path) ─────────────────────
+// ── Send ─────────────────────────────────────────────────────────────
 
 void cobs_send(uint8_t channel, const uint8_t *payload, int payload_len) {
     if (payload_len < 0 || payload_len > COBS_MAX_FRAME - 1) return;
@@ -94,12 +93,9 @@ void cobs_send(uint8_t channel, const uint8_t *payload, int payload_len) {
     enc[enc_len] = 0x00;  // frame delimiter
     enc_len++;
 
-    // Direct write() bypasses newlib stdio buffering — single VFS call
-    static int s_out_fd = -1;
-    if (s_out_fd < 0) s_out_fd = fileno(stdout);
-
+    // One driver call per frame — bypasses newlib stdio entirely
     xSemaphoreTake(s_tx_mutex, portMAX_DELAY);
-    write(s_out_fd, enc, enc_len);
+    uart_write_bytes(UART_NUM_0, enc, enc_len);
     xSemaphoreGive(s_tx_mutex);
 }
 
@@ -127,9 +123,9 @@ void cobs_send_telemetry(const float angles[6], const float positions[6]) {
     cobs_send(COBS_CH_TEL, buf, 48);
 }
 
-// ── Receive & Dispatch (via VFS stdin — proven working path) ────────
+// ── Receive & Dispatch ───────────────────────────────────────────────
 
-static void dispatch_frame(const uint8_t *data, int len) {
+void cobs_dispatch_frame(const uint8_t *data, int len) {
     if (len < 1) return;
     uint8_t ch = data[0];
     const uint8_t *payload = data + 1;
@@ -153,31 +149,33 @@ static void dispatch_frame(const uint8_t *data, int len) {
                 s_cmd_handler(cmd);
             }
             break;
+        case COBS_CH_UPLOAD:
+            if (s_upload_handler && plen > 0)
+                s_upload_handler(payload, plen);
+            break;
         default:
             break;
     }
 }
 
 int cobs_read_process(int timeout_ms) {
-    (void)timeout_ms;
-    uint8_t buf[128];
-    int len = read(s_stdin_fd, buf, sizeof(buf));
+    uint8_t buf[256];
+    int len = uart_read_bytes(UART_NUM_0, buf, sizeof(buf), pdMS_TO_TICKS(timeout_ms));
     if (len <= 0) return 0;
 
     for (int i = 0; i < len; i++) {
         if (buf[i] == 0x00) {
-            if (s_rx_pos > 0) {
-                uint8_t decoded[COBS_MAX_FRAME];
-                int dec_len = cobs_decode(s_rx_acc, s_rx_pos, decoded);
+            if (s_rx_pos > 0 && !s_rx_overflow) {
+                int dec_len = cobs_decode(s_rx_acc, s_rx_pos, s_rx_dec);
                 if (dec_len > 0)
-                    dispatch_frame(decoded, dec_len);
+                    cobs_dispatch_frame(s_rx_dec, dec_len);
             }
             s_rx_pos = 0;
+            s_rx_overflow = false;
+        } else if (s_rx_pos < COBS_MAX_ENC_SIZE(COBS_MAX_RX_FRAME)) {
+            s_rx_acc[s_rx_pos++] = buf[i];
         } else {
-            if (s_rx_pos < COBS_MAX_FRAME)
-                s_rx_acc[s_rx_pos++] = buf[i];
-            else
-                s_rx_pos = 0;
+            s_rx_overflow = true;   // oversized frame: drop it whole, not its tail
         }
     }
     return len;
@@ -186,3 +184,4 @@ int cobs_read_process(int timeout_ms) {
 void cobs_set_data_handler(cobs_data_cb_t handler)     { s_data_handler     = handler; }
 void cobs_set_data_raw_handler(cobs_data_cb_t handler) { s_data_raw_handler = handler; }
 void cobs_set_cmd_handler(cobs_cmd_cb_t handler)       { s_cmd_handler      = handler; }
+void cobs_set_upload_handler(cobs_data_cb_t handler)   { s_upload_handler   = handler; }
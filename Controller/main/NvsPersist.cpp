@@ -0,0 +1,209 @@
+// NvsPersist.cpp — Staged key slots -> NvsSave task -> one nvs_commit per burst
+// Slots are claimed by key on first use and never freed (the key set is
+// fixed at compile time). The lock only covers memcpy in/out of a slot;
+// NvsSave copies a dirty slot out, clears its bit and writes the copy, so a
+// value staged during the write is simply dirty again for the next round. A
+// failed set or commit re-marks the slots it took and retries later.
+
+#include "NvsPersist.h"
+
+#include <cstring>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "nvs.h"
+
+static const char *TAG = "nvspersist";
+
+enum { SLOT_BLOB = 0, SLOT_U8, SLOT_U16, SLOT_CALL };
+
+typedef struct {
+    char     key[16];
+    uint8_t  type;
+    bool     dirty;
+    uint16_t len;
+    uint8_t  data[NVS_PERSIST_MAX_BLOB];
+} Slot;
+
+static Slot              s_slots[NVS_PERSIST_SLOTS];
+static int               s_nslots  = 0;
+static SemaphoreHandle_t s_lock    = NULL;
+static TaskHandle_t      s_task    = NULL;
+static const char       *s_ns      = NULL;
+static volatile bool     s_flushReq = false;
+static nvs_persist_done_cb_t s_flushDone = NULL;
+
+static volatile uint32_t s_commits = 0, s_writes = 0, s_staged = 0, s_coalesced = 0;
+static volatile uint32_t s_errors = 0, s_lastUs = 0, s_lastKeys = 0;
+
+static bool stage(const char *key, uint8_t type, const void *data, size_t len) {
+    if (!s_lock || len > NVS_PERSIST_MAX_BLOB || strlen(key) >= sizeof(s_slots[0].key)) return false;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    Slot *s = NULL;
+    for (int i = 0; i < s_nslots && !s; i++)
+        if (strcmp(s_slots[i].key, key) == 0) s = &s_slots[i];
+    bool fresh = false;
+    if (!s) {
+        if (s_nslots == NVS_PERSIST_SLOTS) {
+            xSemaphoreGive(s_lock);
+            ESP_LOGE(TAG, "no slot for '%s'", key);
+            return false;
+        }
+        s = &s_slots[s_nslots++];
+        strcpy(s->key, key);
+        fresh = true;
+    }
+    const bool changed = fresh || type == SLOT_CALL || s->type != type || s->len != len ||
+                         memcmp(s->data, data, len) != 0;
+    if (changed) {
+        s->type = type;
+        s->len  = (uint16_t)len;
+        memcpy(s->data, data, len);
+        s_staged = s_staged + 1;
+        if (s->dirty) s_coalesced = s_coalesced + 1;
+        s->dirty = true;
+    }
+    xSemaphoreGive(s_lock);
+    if (changed && s_task) xTaskNotifyGive(s_task);
+    return true;
+}
+
+bool nvs_persist_blob(const char *key, const void *data, size_t len) {
+    return stage(key, SLOT_BLOB, data, len);
+}
+
+bool nvs_persist_u8(const char *key, uint8_t v) {
+    return stage(key, SLOT_U8, &v, sizeof(v));
+}
+
+bool nvs_persist_u16(const char *key, uint16_t v) {
+    return stage(key, SLOT_U16, &v, sizeof(v));
+}
+
+bool nvs_persist_call(const char *key, nvs_persist_write_fn fn) {
+    return stage(key, SLOT_CALL, &fn, sizeof(fn));
+}
+
+void nvs_persist_flush(nvs_persist_done_cb_t done) {
+    s_flushDone = done;
+    s_flushReq  = true;
+    if (s_task) xTaskNotifyGive(s_task);
+}
+
+void nvs_persist_stats(NvsPersistStats *st) {
+    uint32_t pending = 0;
+    if (s_lock) {
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        for (int i = 0; i < s_nslots; i++) pending += s_slots[i].dirty;
+        xSemaphoreGive(s_lock);
+    }
+    st->commits   = s_commits;
+    st->writes    = s_writes;
+    st->staged    = s_staged;
+    st->coalesced = s_coalesced;
+    st->errors    = s_errors;
+    st->pending   = pending;
+    st->lastUs    = s_lastUs;
+    st->lastKeys  = s_lastKeys;
+}
+
+// ── NvsSave task ─────────────────────────────────────────────────────
+
+// Put the slots in `taken` back to dirty after a failed set / commit. A slot
+// re-staged meanwhile is dirty already and holds the newer value.
+static void remark(uint32_t taken) {
+    if (!taken) return;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    for (int i = 0; i < s_nslots; i++)
+        if (taken & (1u << i)) s_slots[i].dirty = true;
+    xSemaphoreGive(s_lock);
+}
+
+// Write every dirty slot, then commit once. Returns keys written, -1 on error
+// (the failed keys are dirty again).
+static int write_dirty(void) {
+    static Slot out;                      // one slot copy, only NvsSave uses it
+    const int64_t t0 = esp_timer_get_time();
+    nvs_handle_t h;
+    if (nvs_open(s_ns, NVS_READWRITE, &h) != ESP_OK) {
+        s_errors = s_errors + 1;
+        return -1;
+    }
+    int keys = 0;
+    bool ok = true;
+    uint32_t taken = 0, failed = 0;
+    for (int i = 0; i < NVS_PERSIST_SLOTS; i++) {
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        const bool take = i < s_nslots && s_slots[i].dirty;
+        if (take) {
+            memcpy(&out, &s_slots[i], sizeof(out));
+            s_slots[i].dirty = false;
+        }
+        xSemaphoreGive(s_lock);
+        if (!take) continue;
+        taken |= 1u << i;
+
+        esp_err_t err;
+        if (out.type == SLOT_U8)       err = nvs_set_u8(h, out.key, out.data[0]);
+        else if (out.type == SLOT_U16) { uint16_t v; memcpy(&v, out.data, 2); err = nvs_set_u16(h, out.key, v); }
+        else if (out.type == SLOT_CALL) {                   // writes + commits on its own
+            nvs_persist_write_fn fn;
+            memcpy(&fn, out.data, sizeof(fn));
+            err = fn() == 0 ? ESP_OK : ESP_FAIL;
+        } else                         err = nvs_set_blob(h, out.key, out.data, out.len);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "set '%s': %s", out.key, esp_err_to_name(err));
+            s_errors = s_errors + 1;
+            ok = false;
+            failed |= 1u << i;
+            continue;
+        }
+        keys++;
+    }
+    if (keys) {
+        if (nvs_commit(h) == ESP_OK) s_commits = s_commits + 1;
+        else { s_errors = s_errors + 1; ok = false; failed = taken; }   // none of them is durable
+    }
+    nvs_close(h);
+    remark(failed);
+    s_writes   = s_writes + keys;
+    s_lastKeys = keys;
+    s_lastUs   = (uint32_t)(esp_timer_get_time() - t0);
+    return ok ? keys : -1;
+}
+
+static void NvsSaveTask(void *pv) {
+    (void)pv;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        // Debounce: every new change restarts the quiet window, up to the cap.
+        const int64_t deadline = esp_timer_get_time() + (int64_t)NVS_PERSIST_MAX_DEFER_MS * 1000;
+        while (!s_flushReq) {
+            int64_t waitMs = (deadline - esp_timer_get_time()) / 1000;
+            if (waitMs <= 0) break;
+            if (waitMs > NVS_PERSIST_DEBOUNCE_MS) waitMs = NVS_PERSIST_DEBOUNCE_MS;
+            if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs)) == 0) break;   // quiet
+        }
+        const bool flush = s_flushReq;
+        nvs_persist_done_cb_t done = s_flushDone;
+        s_flushReq  = false;
+        s_flushDone = NULL;
+        const int keys = write_dirty();
+        if (flush && done) done(keys < 0 ? 0 : keys, keys >= 0);
+        if (keys < 0) {                      // keys still dirty: back off, then retry
+            vTaskDelay(pdMS_TO_TICKS(NVS_PERSIST_RETRY_MS));
+            xTaskNotifyGive(s_task);
+        }
+    }
+}
+
+void nvs_persist_init(const char *ns) {
+    s_ns   = ns;
+    s_lock = xSemaphoreCreateMutex();
+    // Core 0, below TelStream (3): a commit is a few ms of flash work and
+    // nothing waits on it.
+    xTaskCreatePinnedToCore(NvsSaveTask, "NvsSave", 3072, NULL, 2, &s_task, 0);
+}
@@ -0,0 +1,213 @@
+// SeqLibrary.cpp — .m6p sequence library on the raw `seq` flash partition
+// Reads the M6PL directory (m6p.h) with esp_partition_read, validates each
+// entry (header + CRC-32 over the mmapped frames) and maps the selected one
+// for zero-copy playback.
+
+#include "SeqLibrary.h"
+
+#include <cstring>
+
+#include "esp_partition.h"
+#include "esp_log.h"
+
+static const char *TAG = "seqlib";
+
+#define SEQ_PARTITION_SUBTYPE  ((esp_partition_subtype_t)0x40)
+#define SEQ_PARTITION_LABEL    "seq"
+
+static const esp_partition_t *s_part = NULL;
+static const uint8_t *s_embedded     = NULL;
+static size_t         s_embedded_len = 0;
+
+static SeqEntry s_entries[SEQ_LIBRARY_MAX];
+static int      s_count    = 0;
+static uint32_t s_free_off = M6PL_DATA_OFFSET;
+static int      s_free_slot = 0;       // first EMPTY directory slot, -1 = full
+static bool     s_has_dir   = false;   // sector 0 holds an M6PL directory
+static bool     s_writer    = false;   // an uploader / recorder owns the free space
+
+static esp_partition_mmap_handle_t s_map_handle = 0;
+static bool                        s_mapped     = false;
+
+static void unmap_current(void) {
+    if (s_mapped) {
+        esp_partition_munmap(s_map_handle);
+        s_mapped = false;
+    }
+}
+
+static const uint8_t *map_range(uint32_t offset, uint32_t length) {
+    const void *ptr = NULL;
+    esp_err_t err = esp_partition_mmap(s_part, offset, length, ESP_PARTITION_MMAP_DATA,
+                                       &ptr, &s_map_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "mmap 0x%lx+%lu failed: %s", (unsigned long)offset,
+                 (unsigned long)length, esp_err_to_name(err));
+        return NULL;
+    }
+    s_mapped = true;
+    return (const uint8_t *)ptr;
+}
+
+// Header + CRC of a whole in-memory .m6p image.
+static int check_image(const uint8_t *img, size_t len, M6pInfo *info) {
+    int st = m6p_parse_header(img, len, info);
+    if (st == M6P_OK) st = m6p_check_crc(info, img + M6P_HEADER_SIZE);
+    return st;
+}
+
+static void add_embedded(void) {
+    if (!s_embedded || s_embedded_len < M6P_HEADER_SIZE) return;
+    SeqEntry *e = &s_entries[s_count++];
+    memset(e, 0, sizeof(*e));
+    e->embedded = true;
+    e->length   = (uint32_t)s_embedded_len;
+    e->status   = check_image(s_embedded, s_embedded_len, &e->info);
+}
+
+static bool is_blank(const uint8_t *p, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        if (p[i] != 0xFF) return false;
+    return true;
+}
+
+static void scan_partition(void) {
+    if (!s_part) return;
+    uint8_t hdr[M6PL_DIR_HDR_SIZE];
+    if (esp_partition_read(s_part, 0, hdr, sizeof(hdr)) != ESP_OK) return;
+    int slots = m6pl_parse_dir(hdr);
+    s_has_dir   = (slots > 0);
+    s_free_slot = s_has_dir ? -1 : 0;
+    for (int i = 0; i < slots; i++) {
+        uint8_t raw[M6PL_ENTRY_SIZE];
+        if (esp_partition_read(s_part, M6PL_DIR_HDR_SIZE + (size_t)i * M6PL_ENTRY_SIZE,
+                               raw, sizeof(raw)) != ESP_OK) break;
+        M6plEntry ent;
+        m6pl_read_entry(raw, &ent);
+        if (ent.state == M6PL_STATE_EMPTY) {
+            if (is_blank(raw, sizeof(raw))) {            // append-only: first blank slot ends the list
+                s_free_slot = i;
+                break;
+            }
+            continue;                                    // torn commit: body without state, never reused
+        }
+        if (ent.state != M6PL_STATE_VALID) continue;     // deleted
+
+        SeqEntry *e = &s_entries[s_count++];
+        memset(e, 0, sizeof(*e));
+        e->offset = ent.offset;
+        e->length = ent.length;
+        if (ent.offset < M6PL_DATA_OFFSET || (ent.offset % M6PL_SECTOR) != 0 ||
+            ent.length < M6P_HEADER_SIZE || ent.offset + ent.length > s_part->size) {
+            e->status = M6P_ERR_TRUNCATED;
+            continue;
+        }
+        uint32_t end = m6pl_align(ent.offset + ent.length);
+        if (end > s_free_off) s_free_off = end;
+
+        // Directory copy of the header must match the file; then CRC the frames.
+        const uint8_t *img = map_range(ent.offset, ent.length);
+        if (!img) { e->status = M6P_ERR_SHORT; continue; }
+        if (memcmp(img, ent.header, M6P_HEADER_SIZE) != 0) {
+            m6p_parse_header(ent.header, 0, &e->info);
+            e->status = M6P_ERR_MAGIC;
+        } else {
+            e->status = check_image(img, ent.length, &e->info);
+        }
+        unmap_current();
+        if (e->status != M6P_OK)
+            ESP_LOGW(TAG, "entry %d @0x%lx: %s", s_count - 1, (unsigned long)ent.offset,
+                     m6p_strerror(e->status));
+    }
+}
+
+int seq_library_rescan(void) {
+    unmap_current();
+    s_count    = 0;
+    s_free_off = M6PL_DATA_OFFSET;
+    s_free_slot = -1;
+    s_has_dir   = false;
+    add_embedded();
+    scan_partition();
+    return s_count;
+}
+
+int seq_library_init(const uint8_t *embedded, size_t embedded_len) {
+    s_embedded     = embedded;
+    s_embedded_len = embedded_len;
+    s_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, SEQ_PARTITION_SUBTYPE,
+                                      SEQ_PARTITION_LABEL);
+    if (!s_part) ESP_LOGW(TAG, "no '%s' partition", SEQ_PARTITION_LABEL);
+    return seq_library_rescan();
+}
+
+int seq_library_count(void) { return s_count; }
+
+const SeqEntry *seq_library_entry(int n) {
+    return (n >= 0 && n < s_count) ? &s_entries[n] : NULL;
+}
+
+const uint8_t *seq_library_map(int n) {
+    const SeqEntry *e = seq_library_entry(n);
+    if (!e || e->status != M6P_OK) return NULL;
+    unmap_current();
+    if (e->embedded) return s_embedded;
+    return map_range(e->offset, e->length);
+}
+
+uint32_t seq_library_capacity(void)    { return s_part ? s_part->size : 0; }
+uint32_t seq_library_free_offset(void) { return s_free_off; }
+
+int seq_library_free_slot(void) { return s_part ? s_free_slot : -1; }
+
+const esp_partition_t *seq_library_partition(void) { return s_part; }
+
+bool seq_library_claim_writer(void) {
+    return !__atomic_exchange_n(&s_writer, true, __ATOMIC_ACQ_REL);
+}
+
+void seq_library_release_writer(void) {
+    __atomic_store_n(&s_writer, false, __ATOMIC_RELEASE);
+}
+
+int seq_library_commit(uint32_t offset, uint32_t length, const uint8_t header[M6P_HEADER_SIZE]) {
+    if (!s_part || s_free_slot < 0) return -1;
+    if (!s_has_dir) {
+        // Blank or foreign sector 0: nothing to lose, start a fresh directory.
+        uint8_t dir[M6PL_DIR_HDR_SIZE];
+        m6pl_write_dir(dir);
+        if (esp_partition_erase_range(s_part, 0, M6PL_SECTOR) != ESP_OK ||
+            esp_partition_write(s_part, 0, dir, sizeof(dir)) != ESP_OK) return -1;
+        s_has_dir = true;
+    }
+    // Body first with the state word still erased, then the state word: a
+    // power cut in between leaves a slot with a body but no state. Its bits
+    // can't be programmed again, so any slot that isn't all 0xFF is marked
+    // DELETED and skipped before the write.
+    for (;;) {
+        uint8_t cur[M6PL_ENTRY_SIZE];
+        size_t at = M6PL_DIR_HDR_SIZE + (size_t)s_free_slot * M6PL_ENTRY_SIZE;
+        if (esp_partition_read(s_part, at, cur, sizeof(cur)) != ESP_OK) return -1;
+        if (is_blank(cur, sizeof(cur))) break;
+        uint8_t dead[4];
+        m6p_wr32(dead, M6PL_STATE_DELETED);
+        if (esp_partition_write(s_part, at, dead, sizeof(dead)) != ESP_OK) return -1;
+        ESP_LOGW(TAG, "directory slot %d not blank (torn commit) -> deleted", s_free_slot);
+        if (++s_free_slot >= M6PL_MAX_ENTRIES) { s_free_slot = -1; return -1; }
+    }
+    M6plEntry ent;
+    ent.state  = M6PL_STATE_EMPTY;
+    ent.offset = offset;
+    ent.length = length;
+    memcpy(ent.header, header, M6P_HEADER_SIZE);
+    uint8_t raw[M6PL_ENTRY_SIZE];
+    m6pl_write_entry(&ent, raw);
+    size_t at = M6PL_DIR_HDR_SIZE + (size_t)s_free_slot * M6PL_ENTRY_SIZE;
+    if (esp_partition_write(s_part, at + 4, raw + 4, sizeof(raw) - 4) != ESP_OK) return -1;
+    uint8_t state[4];
+    m6p_wr32(state, M6PL_STATE_VALID);
+    if (esp_partition_write(s_part, at, state, sizeof(state)) != ESP_OK) return -1;
+    int slot = s_free_slot;
+    s_free_slot = (slot + 1 < M6PL_MAX_ENTRIES) ? slot + 1 : -1;
+    return slot;
+}
@@ -0,0 +1,294 @@
+// SeqRecord.cpp — Record live motion into the `seq` partition as a new .m6p
+// CueTask side: lock-free single-producer ring push + a wake-up per tick.
+// RecordTask side: up-front erase of the reservation (rig parked), ring -> page staging
+// (encode + running CRC-32), one page program per wake, header + directory
+// commit at the end. The two sides share only the ring indexes and state.
+
+#include "SeqRecord.h"
+#include "SeqLibrary.h"
+#include "m6p.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_partition.h"
+#include "esp_log.h"
+
+static const char *TAG = "seqrec";
+
+#define REC_RING     512                  // frames (12 KB): 2 s at 250 Hz
+#define REC_PAGE     256                  // flash page: one program ≈ 0.5–1 ms
+#define REC_BLOCK    (64 * 1024)          // block erase when aligned
+#define REC_KICK     ((REC_PAGE + M6P_STRIDE_BAKED - 1) / M6P_STRIDE_BAKED)   // frames that fill a page
+
+static seq_record_done_cb_t   s_on_done = NULL;
+static seq_record_parked_cb_t s_parked  = NULL;
+static TaskHandle_t          s_task    = NULL;
+static const esp_partition_t *s_part   = NULL;
+
+// Ring: CueTask advances s_head, RecordTask advances s_tail (free-running).
+static float             s_ring[REC_RING][6];
+static volatile uint32_t s_head = 0;
+static volatile uint32_t s_tail = 0;
+
+// Shared state
+static volatile int      s_state    = SEQ_REC_IDLE;
+static volatile bool     s_stopReq  = false;
+static volatile uint8_t  s_kind     = 0;     // set by the first pushed sample
+static volatile uint32_t s_frames   = 0;
+static volatile uint32_t s_dropped  = 0;
+static volatile uint32_t s_rejected = 0;
+static volatile uint32_t s_ringPeak = 0;
+
+// Take — written by seq_record_start(), then RecordTask-owned.
+static uint32_t s_base      = 0;     // partition offset of the file
+static uint32_t s_region    = 0;     // erased reservation, bytes
+static uint32_t s_armOff    = 0;     // partition offset: [s_base, s_armOff) is erased
+static uint32_t s_maxFrames = 0;
+static uint16_t s_rate      = 0;
+static uint16_t s_bits      = 12;
+static char     s_name[M6P_NAME_LEN + 1];
+
+// RecordTask-owned
+static uint8_t           s_stage[2 * REC_PAGE];
+static uint32_t          s_stageLen = 0;
+static volatile uint32_t s_written  = 0;     // file bytes programmed (header slot included)
+static uint32_t          s_crc      = 0;
+static int               s_lastStatus = SEQ_REC_OK;
+static int               s_lastIndex  = -1;
+
+static uint32_t stride(void) { return s_kind == M6P_KIND_RAW ? M6P_STRIDE_RAW : M6P_STRIDE_BAKED; }
+
+// ── RecordTask ───────────────────────────────────────────────────────
+
+static void end_take(int status, int index) {
+    s_lastStatus = status;
+    s_lastIndex  = index;
+    s_state      = SEQ_REC_IDLE;
+    seq_library_release_writer();
+}
+
+// Erase the whole reservation before any sample is taken — one unit at a
+// time, and only while the rig is parked: an erase stalls both cores, so it
+// never runs under live motion. Picks up at s_armOff on the next wake.
+static void arm(void) {
+    const uint32_t end = s_base + s_region;
+    while (s_armOff < end) {
+        if (s_stopReq) { end_take(SEQ_REC_ERR_EMPTY, -1); return; }
+        if (s_parked && !s_parked()) return;
+        uint32_t unit = M6PL_SECTOR;
+        if (((s_part->address + s_armOff) % REC_BLOCK) == 0 && s_armOff + REC_BLOCK <= end) unit = REC_BLOCK;
+        esp_err_t err = esp_partition_erase_range(s_part, s_armOff, unit);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "erase 0x%lx: %s", (unsigned long)s_armOff, esp_err_to_name(err));
+            end_take(SEQ_REC_ERR_FLASH, -1);
+            return;
+        }
+        s_armOff += unit;
+    }
+    s_written  = M6P_HEADER_SIZE;   // header bytes stay erased until the commit
+    s_stageLen = 0;
+    s_crc      = 0;
+    s_state    = SEQ_REC_CAPTURE;
+}
+
+// Ring -> staging, encoded as M6P1 (uint16 counts) or M6P2 (float32).
+static void drain(void) {
+    uint32_t tail = s_tail;
+    uint32_t head = __atomic_load_n(&s_head, __ATOMIC_ACQUIRE);
+    uint32_t n = stride();
+    while (tail != head && s_stageLen + n <= sizeof(s_stage)) {
+        const float *f = s_ring[tail % REC_RING];
+        uint8_t *p = s_stage + s_stageLen;
+        if (s_kind == M6P_KIND_RAW) {
+            memcpy(p, f, M6P_STRIDE_RAW);
+        } else {
+            for (int i = 0; i < 6; i++) {
+                float c = roundf(f[i]);
+                if (c < 0.0f) c = 0.0f;
+                if (c > 65535.0f) c = 65535.0f;
+                m6p_wr16(p + 2 * i, (uint16_t)c);
+            }
+        }
+        s_crc = m6p_crc32_update(s_crc, p, n);
+        s_stageLen += n;
+        tail++;
+    }
+    __atomic_store_n(&s_tail, tail, __ATOMIC_RELEASE);
+}
+
+// Program up to the next page boundary — once a full page is staged, or
+// whatever is left when `flush`.
+static bool program(bool flush) {
+    uint32_t n = REC_PAGE - (s_written % REC_PAGE);   // file base is sector-aligned
+    if (s_stageLen < n && !flush) return true;
+    if (n > s_stageLen) n = s_stageLen;
+    if (n == 0) return true;
+    if (esp_partition_write(s_part, s_base + s_written, s_stage, n) != ESP_OK) return false;
+    memmove(s_stage, s_stage + n, s_stageLen - n);
+    s_stageLen -= n;
+    s_written  += n;
+    return true;
+}
+
+static void commit(void) {
+    uint32_t count = (s_written - M6P_HEADER_SIZE) / stride();
+    if (count == 0) { end_take(SEQ_REC_ERR_EMPTY, -1); return; }
+    M6pInfo info;
+    memset(&info, 0, sizeof(info));
+    info.kind  = s_kind;
+    info.rate  = s_rate;
+    info.count = count;
+    info.bits  = s_bits;
+    info.crc32 = s_crc;
+    memcpy(info.name, s_name, sizeof(info.name));
+    uint8_t hdr[M6P_HEADER_SIZE];
+    m6p_write_header(&info, hdr);
+    int slot = -1;
+    if (esp_partition_write(s_part, s_base, hdr, sizeof(hdr)) == ESP_OK)
+        slot = seq_library_commit(s_base, s_written, hdr);
+    if (slot < 0) { end_take(SEQ_REC_ERR_FLASH, -1); return; }
+    // Rescan before releasing: the next writer must see the new free offset.
+    int index = s_on_done ? s_on_done(slot) : slot;
+    end_take(SEQ_REC_OK, index);
+}
+
+static void RecordTask(void *pv) {
+    (void)pv;
+    for (;;) {
+        uint32_t kicked = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+        int st = s_state;
+        if (st == SEQ_REC_ARMING) { arm(); continue; }
+        // Flash programs only on a CueTask kick: right after its servo write.
+        if (!kicked || (st != SEQ_REC_CAPTURE && st != SEQ_REC_FINISHING)) continue;
+        if (st == SEQ_REC_CAPTURE && (s_stopReq || s_frames >= s_maxFrames))
+            s_state = st = SEQ_REC_FINISHING;
+
+        drain();
+        bool done = (st == SEQ_REC_FINISHING) &&
+                    __atomic_load_n(&s_head, __ATOMIC_ACQUIRE) == s_tail;
+        if (!program(done)) {
+            ESP_LOGE(TAG, "write 0x%lx failed", (unsigned long)(s_base + s_written));
+            end_take(SEQ_REC_ERR_FLASH, -1);
+            continue;
+        }
+        if (done && s_stageLen == 0) commit();
+    }
+}
+
+// ── CueTask side ─────────────────────────────────────────────────────
+
+bool seq_record_push(const float ch[6], uint8_t kind) {
+    if (s_state != SEQ_REC_CAPTURE || s_frames >= s_maxFrames) return false;
+    if (s_kind == 0) s_kind = kind;              // the first sample picks the format
+    else if (kind != s_kind) { s_rejected++; return false; }
+    uint32_t head = s_head;
+    uint32_t used = head - __atomic_load_n(&s_tail, __ATOMIC_ACQUIRE);
+    if (used >= REC_RING) { s_dropped++; return false; }
+    memcpy(s_ring[head % REC_RING], ch, sizeof(s_ring[0]));
+    __atomic_store_n(&s_head, head + 1, __ATOMIC_RELEASE);
+    s_frames++;
+    if (used + 1 > s_ringPeak) s_ringPeak = used + 1;
+    return true;
+}
+
+void seq_record_tick(void) {
+    int st = s_state;
+    if (st == SEQ_REC_IDLE || st == SEQ_REC_ARMING) return;
+    if (st == SEQ_REC_FINISHING || s_stopReq || s_frames >= s_maxFrames ||
+        s_head - s_tail >= REC_KICK)
+        xTaskNotifyGive(s_task);
+}
+
+// ── Command side ─────────────────────────────────────────────────────
+
+int seq_record_start(uint16_t rate, uint32_t max_seconds, uint16_t bits, const char *name) {
+    if (s_state != SEQ_REC_IDLE) return SEQ_REC_ERR_BUSY;
+    if (rate < SEQ_REC_RATE_MIN || rate > SEQ_REC_RATE_MAX ||
+        max_seconds == 0 || max_seconds > SEQ_REC_SECONDS_MAX)
+        return SEQ_REC_ERR_ARG;
+    if (!s_part) return SEQ_REC_ERR_SPACE;
+    if (!seq_library_claim_writer()) return SEQ_REC_ERR_BUSY;   // upload running
+
+    // Reserve for the widest format (the first sample decides); shrink the
+    // take to the free space, but insist on a second of it.
+    uint32_t base  = seq_library_free_offset();
+    uint32_t cap   = seq_library_capacity();
+    uint32_t avail = base < cap ? cap - base : 0;
+    uint32_t maxFrames = rate * max_seconds;
+    uint32_t fit = avail > M6P_HEADER_SIZE ? (avail - M6P_HEADER_SIZE) / M6P_STRIDE_RAW : 0;
+    if (maxFrames > fit) maxFrames = fit;
+    if (seq_library_free_slot() < 0 || maxFrames < rate) {
+        seq_library_release_writer();
+        return SEQ_REC_ERR_SPACE;
+    }
+
+    s_base      = base;
+    s_maxFrames = maxFrames;
+    s_region    = m6pl_align(M6P_HEADER_SIZE + maxFrames * M6P_STRIDE_RAW);
+    if (s_base + s_region > cap) s_region = cap - s_base;
+    s_armOff    = base;
+    s_rate      = rate;
+    s_bits      = bits;
+    memset(s_name, 0, sizeof(s_name));
+    if (name) strncpy(s_name, name, M6P_NAME_LEN);
+    s_head = s_tail = 0;
+    s_kind     = 0;
+    s_frames   = 0;
+    s_dropped  = 0;
+    s_rejected = 0;
+    s_ringPeak = 0;
+    s_written  = 0;
+    s_stopReq  = false;
+    s_state    = SEQ_REC_ARMING;
+    xTaskNotifyGive(s_task);
+    return SEQ_REC_OK;
+}
+
+int seq_record_stop(void) {
+    int st = s_state;
+    if (st != SEQ_REC_ARMING && st != SEQ_REC_CAPTURE) return SEQ_REC_ERR_IDLE;
+    s_stopReq = true;
+    xTaskNotifyGive(s_task);
+    return SEQ_REC_OK;
+}
+
+bool seq_record_capturing(void) { return s_state == SEQ_REC_CAPTURE; }
+
+void seq_record_status(SeqRecordStatus *st) {
+    st->state      = s_state;
+    st->kind       = s_kind;
+    st->rate       = s_rate;
+    st->frames     = s_frames;
+    st->maxFrames  = s_maxFrames;
+    st->written    = s_written;
+    st->dropped    = s_dropped;
+    st->rejected   = s_rejected;
+    st->ringPeak   = s_ringPeak;
+    st->ringSize   = REC_RING;
+    st->lastStatus = s_lastStatus;
+    st->lastIndex  = s_lastIndex;
+}
+
+const char *seq_record_strerror(int st) {
+    switch (st) {
+        case SEQ_REC_OK:        return "ok";
+        case SEQ_REC_ERR_BUSY:  return "busy";
+        case SEQ_REC_ERR_SPACE: return "no space";
+        case SEQ_REC_ERR_EMPTY: return "empty";
+        case SEQ_REC_ERR_FLASH: return "flash error";
+        case SEQ_REC_ERR_ARG:   return "bad argument";
+        case SEQ_REC_ERR_IDLE:  return "not recording";
+        default:                return "?";
+    }
+}
+
+void seq_record_init(seq_record_done_cb_t on_done, seq_record_parked_cb_t parked) {
+    s_on_done = on_done;
+    s_parked  = parked;
+    s_part    = seq_library_partition();
+    // Same core / priority as UploadTask, below the RX task (5).
+    xTaskCreatePinnedToCore(RecordTask, "SeqRecord", 4096, NULL, 4, &s_task, 0);
+}
@@ -0,0 +1,384 @@
+// SeqUpload.cpp — Pipelined .m6p upload into the `seq` partition over COBS
+// RX task (InterfaceMonitorTask) side: protocol, per-chunk CRC, copy into the
+// double buffer, credit-based flow control. UploadTask side: erase-ahead,
+// sector programming, NVS checkpoints, whole-file verify + directory commit.
+// The two sides share only the buffer-free mask and a job queue.
+
+#include "SeqUpload.h"
+#include "SeqLibrary.h"
+#include "CobsTransport.h"
+#include "m6p.h"
+
+#include <cstring>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_partition.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "nvs_flash.h"
+
+static const char *TAG = "sequpl";
+
+#define UPL_NVS_NAMESPACE  "mini6dof"      // shared with main.cpp
+#define UPL_NVS_KEY        "seq_upl"
+#define UPL_BUF_SIZE       M6PL_SECTOR     // one flash sector per buffer
+#define UPL_NBUF           2
+#define UPL_BLOCK          (64 * 1024)     // block erase when aligned (~4x faster per byte)
+#define UPL_ERASE_AHEAD    (64 * 1024)     // erased-but-unwritten lead over the write point
+#define UPL_CHECKPOINT     (64 * 1024)     // resume granularity (multiple of the sector)
+
+enum { JOB_START, JOB_WRITE, JOB_FINISH, JOB_ABORT };
+
+typedef struct {
+    uint8_t  kind;
+    uint8_t  buf;
+    uint32_t off;    // file offset (JOB_WRITE) / resume offset (JOB_START)
+    uint32_t len;
+} UplJob;
+
+// Resume checkpoint (NVS blob): the same file into the same free space.
+typedef struct {
+    uint32_t base;        // partition offset of the file
+    uint32_t length;
+    uint32_t hdrCrc;      // CRC-32 of the 64-byte header (identifies the file)
+    uint32_t committed;   // bytes programmed, multiple of UPL_CHECKPOINT
+} UplResume;
+
+static seq_upload_begin_cb_t s_on_begin = NULL;
+static seq_upload_done_cb_t  s_on_done  = NULL;
+
+static uint8_t           s_buf[UPL_NBUF][UPL_BUF_SIZE];
+static volatile uint32_t s_freeMask = (1u << UPL_NBUF) - 1;   // RX clears, UploadTask sets
+static QueueHandle_t     s_jobs = NULL;
+
+// Session — written by the RX task at BEGIN, read-only for UploadTask after
+// the JOB_START handoff.
+static const esp_partition_t *s_part = NULL;
+static UplResume s_sess;
+static uint8_t   s_header[M6P_HEADER_SIZE];
+static int64_t   s_t0Us = 0;
+
+// RX-owned
+static volatile bool     s_active   = false;
+static volatile uint32_t s_expected = 0;
+static int               s_cur      = -1;    // buffer being filled
+static uint32_t          s_curOff   = 0;     // its file offset
+static uint32_t          s_curFill  = 0;
+
+// UploadTask-owned (read by status/credit)
+static volatile bool     s_busy    = false;
+static volatile bool     s_failed  = false;
+static volatile uint32_t s_written = 0;
+static uint32_t          s_erased  = 0;      // partition offset: [base, erased) is erased
+static uint32_t          s_lastRate   = 0;
+static int               s_lastStatus = M6PU_OK;
+
+// ── Helpers ──────────────────────────────────────────────────────────
+
+static void send_ack(uint8_t op, int status, uint32_t value, uint32_t credit) {
+    uint8_t a[M6PU_ACK_SIZE];
+    m6pu_write_ack(a, op, (uint8_t)status, value, credit);
+    cobs_send(COBS_CH_UPLOAD, a, sizeof(a));
+}
+
+// Bytes the RX side can take beyond s_expected without waiting for flash.
+// Exact on the RX task; a snapshot when UploadTask sends a credit update.
+static uint32_t credit(void) {
+    uint32_t c = (s_cur >= 0) ? UPL_BUF_SIZE - s_curFill : 0;
+    uint32_t m = __atomic_load_n(&s_freeMask, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < UPL_NBUF; i++)
+        if (m & (1u << i)) c += UPL_BUF_SIZE;
+    return c;
+}
+
+static bool load_resume(UplResume *r) {
+    nvs_handle_t h;
+    bool ok = false;
+    if (nvs_open(UPL_NVS_NAMESPACE, NVS_READONLY, &h) == ESP_OK) {
+        size_t sz = sizeof(*r);
+        ok = (nvs_get_blob(h, UPL_NVS_KEY, r, &sz) == ESP_OK && sz == sizeof(*r));
+        nvs_close(h);
+    }
+    return ok;
+}
+
+static void save_resume(const UplResume *r) {
+    nvs_handle_t h;
+    if (nvs_open(UPL_NVS_NAMESPACE, NVS_READWRITE, &h) == ESP_OK) {
+        if (r) nvs_set_blob(h, UPL_NVS_KEY, r, sizeof(*r));
+        else   nvs_erase_key(h, UPL_NVS_KEY);
+        nvs_commit(h);
+        nvs_close(h);
+    }
+}
+
+// ── UploadTask: erase-ahead, programming, verify + commit ────────────
+
+static uint32_t region_end(void) { return s_sess.base + m6pl_align(s_sess.length); }
+
+static bool erase_wanted(void) {
+    return s_busy && !s_failed && s_erased < region_end() &&
+           s_erased < s_sess.base + s_written + UPL_ERASE_AHEAD;
+}
+
+// Erase the next unit past s_erased: a 64 KB block when the absolute flash
+// address is block-aligned and the region covers it, else one sector.
+static bool erase_next(void) {
+    uint32_t unit = M6PL_SECTOR;
+    if (((s_part->address + s_erased) % UPL_BLOCK) == 0 && s_erased + UPL_BLOCK <= region_end())
+        unit = UPL_BLOCK;
+    esp_err_t err = esp_partition_erase_range(s_part, s_erased, unit);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "erase 0x%lx: %s", (unsigned long)s_erased, esp_err_to_name(err));
+        return false;
+    }
+    s_erased += unit;
+    return true;
+}
+
+static void fail(uint8_t op, int status) {
+    s_failed = true;
+    s_lastStatus = status;
+    send_ack(op, status, s_written, 0);
+}
+
+static void do_write(const UplJob *job) {
+    uint32_t end = s_sess.base + job->off + job->len;
+    bool ok = !s_failed;
+    while (ok && s_erased < end) ok = erase_next();   // erase-ahead fell behind
+    if (ok && esp_partition_write(s_part, s_sess.base + job->off, s_buf[job->buf], job->len) != ESP_OK)
+        ok = false;
+    __atomic_fetch_or(&s_freeMask, 1u << job->buf, __ATOMIC_RELEASE);
+    if (!ok) {
+        if (!s_failed) fail(M6PU_OP_CHUNK, M6PU_ERR_FLASH);
+        return;
+    }
+    uint32_t prev = s_written;
+    s_written = job->off + job->len;
+    if (s_written / UPL_CHECKPOINT != prev / UPL_CHECKPOINT && s_written < s_sess.length) {
+        UplResume r = s_sess;
+        r.committed = s_written - (s_written % UPL_CHECKPOINT);
+        save_resume(&r);
+    }
+    // Credit update: a buffer just came back.
+    send_ack(M6PU_OP_CHUNK, M6PU_OK, s_expected, credit());
+}
+
+// Read the file back from flash (not the RX buffers) and CRC it; commit the
+// directory entry only if it matches crc32@52 of the BEGIN header.
+static int verify_and_commit(int *slot) {
+    if (s_failed) return M6PU_ERR_FLASH;
+    uint8_t *blk = s_buf[0];   // all writes are done: both buffers are ours
+    uint32_t crc = 0;
+    for (uint32_t off = 0; off < s_sess.length; off += UPL_BUF_SIZE) {
+        uint32_t n = s_sess.length - off;
+        if (n > UPL_BUF_SIZE) n = UPL_BUF_SIZE;
+        if (esp_partition_read(s_part, s_sess.base + off, blk, n) != ESP_OK) return M6PU_ERR_FLASH;
+        if (off == 0) {
+            if (memcmp(blk, s_header, M6P_HEADER_SIZE) != 0) return M6PU_ERR_FILE_CRC;
+            crc = m6p_crc32_update(crc, blk + M6P_HEADER_SIZE, n - M6P_HEADER_SIZE);
+        } else {
+            crc = m6p_crc32_update(crc, blk, n);
+        }
+    }
+    if (crc != m6p_rd32(s_header + M6P_CRC_OFFSET)) return M6PU_ERR_FILE_CRC;
+    *slot = seq_library_commit(s_sess.base, s_sess.length, s_header);
+    return *slot < 0 ? M6PU_ERR_FLASH : M6PU_OK;
+}
+
+static void UploadTask(void *pv) {
+    (void)pv;
+    for (;;) {
+        UplJob job;
+        if (xQueueReceive(s_jobs, &job, erase_wanted() ? 0 : portMAX_DELAY) != pdTRUE) {
+            if (!erase_next()) fail(M6PU_OP_CHUNK, M6PU_ERR_FLASH);
+            continue;
+        }
+        switch (job.kind) {
+            case JOB_START:
+                s_erased = s_sess.base + job.off;   // beyond the checkpoint may be half-programmed
+                break;
+            case JOB_WRITE:
+                do_write(&job);
+                break;
+            case JOB_FINISH: {
+                int slot = -1;
+                int st = verify_and_commit(&slot);
+                int64_t us = esp_timer_get_time() - s_t0Us;
+                uint32_t bytes = s_sess.length - s_sess.committed;
+                s_lastRate   = us > 0 ? (uint32_t)((uint64_t)bytes * 1000000ULL / (uint64_t)us) : 0;
+                s_lastStatus = st;
+                // Rate + status first: on_done reports them (seq_upload_status).
+                uint32_t index = 0;
+                if (st == M6PU_OK) index = s_on_done ? (uint32_t)s_on_done(slot) : (uint32_t)slot;
+                save_resume(NULL);    // committed, or the file itself is bad: start over
+                seq_library_release_writer();
+                s_busy = false;
+                send_ack(M6PU_OP_END, st, index, 0);
+                break;
+            }
+            case JOB_ABORT:
+                s_lastStatus = s_failed ? M6PU_ERR_FLASH : M6PU_OK;
+                seq_library_release_writer();
+                s_busy = false;
+                send_ack(M6PU_OP_ABORT, M6PU_OK, s_written - (s_written % UPL_CHECKPOINT), 0);
+                break;
+        }
+    }
+}
+
+// ── RX side (InterfaceMonitorTask) ───────────────────────────────────
+
+static void submit_current(void) {
+    UplJob job = { JOB_WRITE, (uint8_t)s_cur, s_curOff, s_curFill };
+    xQueueSend(s_jobs, &job, portMAX_DELAY);   // depth > buffers: never blocks
+    s_cur = -1;
+}
+
+static void on_begin(const uint8_t *p, int len) {
+    if (s_active || s_busy) { send_ack(M6PU_OP_BEGIN, M6PU_ERR_STATE, 0, 0); return; }
+    if (!s_part || len < M6PU_BEGIN_SIZE) { send_ack(M6PU_OP_BEGIN, M6PU_ERR_HEADER, 0, 0); return; }
+
+    uint32_t length = m6p_rd32(p + 1);
+    const uint8_t *hdr = p + 5;
+    M6pInfo info;
+    if (m6p_parse_header(hdr, 0, &info) != M6P_OK ||
+        length != M6P_HEADER_SIZE + m6p_data_size(&info)) {
+        send_ack(M6PU_OP_BEGIN, M6PU_ERR_HEADER, 0, 0);
+        return;
+    }
+    if (!seq_library_claim_writer()) {   // REC:* is writing the free space
+        send_ack(M6PU_OP_BEGIN, M6PU_ERR_BUSY, 0, 0);
+        return;
+    }
+    uint32_t base = seq_library_free_offset();
+    if (seq_library_free_slot() < 0 || base + m6pl_align(length) > seq_library_capacity()) {
+        seq_library_release_writer();
+        send_ack(M6PU_OP_BEGIN, M6PU_ERR_SPACE, 0, 0);
+        return;
+    }
+
+    UplResume r;
+    uint32_t hdrCrc = m6p_crc32_update(0, hdr, M6P_HEADER_SIZE);
+    uint32_t resume = 0;
+    if (load_resume(&r) && r.base == base && r.length == length && r.hdrCrc == hdrCrc &&
+        r.committed < length && (r.committed % UPL_CHECKPOINT) == 0)
+        resume = r.committed;
+
+    s_sess.base      = base;
+    s_sess.length    = length;
+    s_sess.hdrCrc    = hdrCrc;
+    s_sess.committed = resume;
+    memcpy(s_header, hdr, M6P_HEADER_SIZE);
+    s_t0Us     = esp_timer_get_time();
+    s_expected = resume;
+    s_cur      = -1;
+    s_written  = resume;     // UploadTask is idle until JOB_START
+    s_failed   = false;
+    s_busy     = true;
+    s_active   = true;
+    UplJob job = { JOB_START, 0, resume, 0 };
+    xQueueSend(s_jobs, &job, portMAX_DELAY);
+
+    if (s_on_begin) s_on_begin();
+    send_ack(M6PU_OP_BEGIN, M6PU_OK, resume, credit());
+}
+
+static void on_chunk(const uint8_t *p, int len) {
+    if (!s_active) { send_ack(M6PU_OP_CHUNK, M6PU_ERR_STATE, 0, 0); return; }
+    if (s_failed)  { send_ack(M6PU_OP_CHUNK, M6PU_ERR_FLASH, s_expected, 0); return; }
+    int n = len - M6PU_CHUNK_HDR;
+    uint32_t off = m6p_rd32(p + 1);
+    const uint8_t *data = p + M6PU_CHUNK_HDR;
+    if (n <= 0 || n > M6PU_CHUNK_MAX || off != s_expected || off + (uint32_t)n > s_sess.length) {
+        send_ack(M6PU_OP_CHUNK, M6PU_ERR_OFFSET, s_expected, credit());
+        return;
+    }
+    if (m6p_crc32_update(0, data, (size_t)n) != m6p_rd32(p + 5)) {
+        send_ack(M6PU_OP_CHUNK, M6PU_ERR_CRC, s_expected, credit());
+        return;
+    }
+    if ((uint32_t)n > credit()) {
+        send_ack(M6PU_OP_CHUNK, M6PU_ERR_BUSY, s_expected, credit());
+        return;
+    }
+
+    while (n > 0) {
+        if (s_cur < 0) {
+            uint32_t m = __atomic_load_n(&s_freeMask, __ATOMIC_ACQUIRE);
+            s_cur = (m & 1u) ? 0 : 1;   // credit() guaranteed one is free
+            __atomic_fetch_and(&s_freeMask, ~(1u << s_cur), __ATOMIC_ACQ_REL);
+            s_curOff  = off;
+            s_curFill = 0;
+        }
+        uint32_t k = UPL_BUF_SIZE - s_curFill;
+        if (k > (uint32_t)n) k = (uint32_t)n;
+        memcpy(s_buf[s_cur] + s_curFill, data, k);
+        s_curFill += k;
+        data += k;
+        off  += k;
+        n    -= (int)k;
+        if (s_curFill == UPL_BUF_SIZE) submit_current();
+    }
+    s_expected = off;
+    send_ack(M6PU_OP_CHUNK, M6PU_OK, s_expected, credit());
+}
+
+static void on_end(void) {
+    if (!s_active) { send_ack(M6PU_OP_END, M6PU_ERR_STATE, 0, 0); return; }
+    if (s_expected != s_sess.length) {
+        send_ack(M6PU_OP_END, M6PU_ERR_OFFSET, s_expected, credit());
+        return;
+    }
+    if (s_cur >= 0) submit_current();   // tail sector (rest stays erased 0xFF)
+    s_active = false;
+    UplJob job = { JOB_FINISH, 0, 0, 0 };
+    xQueueSend(s_jobs, &job, portMAX_DELAY);   // UploadTask acks after the verify
+}
+
+static void on_abort(void) {
+    if (!s_active) {
+        send_ack(M6PU_OP_ABORT, s_busy ? M6PU_ERR_STATE : M6PU_OK, 0, 0);
+        return;
+    }
+    if (s_cur >= 0) {   // partial buffer is dropped; resume restarts at a checkpoint
+        __atomic_fetch_or(&s_freeMask, 1u << s_cur, __ATOMIC_RELEASE);
+        s_cur = -1;
+    }
+    s_active = false;
+    UplJob job = { JOB_ABORT, 0, 0, 0 };
+    xQueueSend(s_jobs, &job, portMAX_DELAY);
+}
+
+void seq_upload_handle_frame(const uint8_t *payload, int len) {
+    if (len < 1) return;
+    switch (payload[0]) {
+        case M6PU_OP_BEGIN: on_begin(payload, len); break;
+        case M6PU_OP_CHUNK: on_chunk(payload, len); break;
+        case M6PU_OP_END:   on_end();               break;
+        case M6PU_OP_ABORT: on_abort();             break;
+        default: break;
+    }
+}
+
+void seq_upload_status(SeqUploadStatus *st) {
+    st->active      = s_active;
+    st->busy        = s_busy;
+    st->length      = s_sess.length;
+    st->received    = s_expected;
+    st->written     = s_written;
+    st->resumed     = s_sess.committed;
+    st->bytesPerSec = s_lastRate;
+    st->lastStatus  = s_lastStatus;
+}
+
+void seq_upload_init(seq_upload_begin_cb_t on_begin_cb, seq_upload_done_cb_t on_done_cb) {
+    s_on_begin = on_begin_cb;
+    s_on_done  = on_done_cb;
+    s_part     = seq_library_partition();
+    s_jobs     = xQueueCreate(UPL_NBUF + 3, sizeof(UplJob));
+    // Below the RX task (5) on the same core: flash work fills the gaps.
+    xTaskCreatePinnedToCore(UploadTask, "SeqUpload", 4096, NULL, 4, NULL, 0);
+}
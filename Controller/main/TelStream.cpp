@@ -0,0 +1,66 @@
+// TelStream.cpp — TEL2 sample queue (CueTask) -> TelTask -> COBS_CH_TEL2
+// Fixed-size queue items: one xQueueSend copy per sample on the CueTask
+// side, no allocation, no locks held across the UART write.
+
+#include "TelStream.h"
+#include "CobsTransport.h"
+#include "cobs.h"
+#include "tel2.h"
+
+#include <cstring>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+typedef struct {
+    uint8_t len;
+    uint8_t data[TEL2_MAX_SIZE];
+} TelItem;
+
+static QueueHandle_t     s_queue   = NULL;
+static volatile uint32_t s_sent    = 0;
+static volatile uint32_t s_dropped = 0;
+static volatile uint32_t s_peak    = 0;
+
+static void TelTask(void *pv) {
+    (void)pv;
+    TelItem it;
+    for (;;) {
+        if (xQueueReceive(s_queue, &it, portMAX_DELAY) != pdTRUE) continue;
+        cobs_send(COBS_CH_TEL2, it.data, it.len);
+        s_sent = s_sent + 1;
+    }
+}
+
+bool tel_stream_push(const uint8_t *buf, int len) {
+    if (!s_queue || len <= 0 || len > TEL2_MAX_SIZE) return false;
+    TelItem it;
+    it.len = (uint8_t)len;
+    memcpy(it.data, buf, len);
+    if (xQueueSend(s_queue, &it, 0) != pdTRUE) {
+        s_dropped = s_dropped + 1;
+        return false;
+    }
+    uint32_t waiting = (uint32_t)uxQueueMessagesWaiting(s_queue);
+    if (waiting > s_peak) s_peak = waiting;
+    return true;
+}
+
+void tel_stream_stats(TelStreamStats *st) {
+    st->sent    = s_sent;
+    st->dropped = s_dropped;
+    st->peak    = s_peak;
+}
+
+void tel_stream_reset_stats(void) {
+    s_sent = 0;
+    s_dropped = 0;
+    s_peak = 0;
+}
+
+void tel_stream_init(void) {
+    s_queue = xQueueCreate(TEL_STREAM_DEPTH, sizeof(TelItem));
+    // Core 0, below SeqUpload / SeqRecord (4): telemetry yields to flash work.
+    xTaskCreatePinnedToCore(TelTask, "TelStream", 3072, NULL, 3, NULL, 0);
+}
@@ -25,6 +25,7 @@
 #include "esp_mac.h"
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "esp_cpu.h"
 #include "driver/ledc.h"
 #include "driver/gpio.h"
 #include <fcntl.h>
@@ -38,9 +39,28 @@
 #include "InverseKinematics.h"
 #include "AxisScaling.h"
 #include "MotionCueing.h"
+#include "MiniPlatform.h"
+#include "m6p.h"
+#include "m6p3.h"
 #include "version.h"
+#include "biquad6.h"
+#include "tribuf.h"
+#include "lookahead6.h"
+#include "scope.h"
+#include "tel2.h"
+#include "imufusion.h"
+#include "servodyn.h"
+#include "clocksync.h"
 #include "BleTransport.h"
 #include "CobsTransport.h"
+#include "SeqLibrary.h"
+#include "SeqUpload.h"
+#include "SeqRecord.h"
+#include "TelStream.h"
+#include "NvsPersist.h"
+#ifdef MINI6DOF_HARNESS
+#include "fw_harness.h"
+#endif
 
 static const char* TAG __attribute__((unused)) = "mini6dof";
 
@@ -53,6 +73,8 @@ bool debugEnabled = false;
 #define serial_printf(fmt, ...) cobs_send_fmt(COBS_CH_RESP, fmt, ##__VA_ARGS__)
 
 // ── Platform Configuration ───────────────────────────────────────────
+// Staging copies, edited by the command setters; CueTask reads the published
+// CueConfig snapshot instead (see "Config snapshots" below).
 static StewartConfig stewartConfig;
 static AxisScaleConfig axisScales;
 
@@ -76,7 +98,7 @@ static volatile uint16_t servoRateHz    = SERVO_RATE_ANALOG_HZ;   // default = a
 static volatile float    servoPeriodUs  = 1000000.0f / SERVO_RATE_ANALOG_HZ;
 
 // ── On-device cue engine: shared latest-sample target (hold-only) ─────
-// Ingest paths (CH_DATA, CH_DATA_RAW, PlaybackTask, BLE) STOP driving IK/servo
+// Ingest paths (CH_DATA, CH_DATA_RAW, BLE) STOP driving IK/servo
 // and just write the freshest sample here + an esp_timer receive-stamp. The
 // fixed-rate CueTask is the SOLE servo writer: it reads this, runs the cue
 // chain (for RAW), maps to position, per-time slews, IK, and writes servos.
@@ -85,6 +107,8 @@ typedef enum {
     TGT_BAKED = 0,   // raw uint16 counts, cue already baked -> mapRawToPosition only
     TGT_RAW   = 1,   // pre-cue telemetry -> inputFilter -> MCA -> outputStage -> mapRawToPosition
     TGT_PHYS  = 2,   // already physical mm/rad (BLE accel) -> straight to slew/IK
+    TGT_RAW_ZP = 3,  // pre-cue, zero-phase filtered upstream (DEMO lookahead) -> MCA -> outputStage
+    TGT_IMU   = 4,   // raw phone IMU (ACCEL:MODE=RAW) -> fusion -> accel map/gain -> slew/IK
 } TargetFmt;
 static portMUX_TYPE g_targetMux = portMUX_INITIALIZER_UNLOCKED;
 static float   g_targetCh[6]  = {0, 0, 0, 0, 0, 0};
@@ -96,25 +120,6 @@ static int     g_targetFmt    = TGT_BAKED;
 // sample; the washout HP naturally returns RAW motion toward center.
 #define CUE_LOST_DECAY_MS  300
 
-// Mini-6DOF specific defaults (geometry in mm, converted from inches)
-static void initMiniDefaults(StewartConfig* cfg) {
-    cfg->theta_r = 10.0f;
-    cfg->theta_s[0] = 150.0f; cfg->theta_s[1] = -90.0f; cfg->theta_s[2] = 30.0f;
-    cfg->theta_s[3] = 150.0f; cfg->theta_s[4] = -90.0f; cfg->theta_s[5] = 30.0f;
-    cfg->theta_p = 30.0f;
-    cfg->RD = 15.75f;               // base radius (mm — original Mini uses mm directly)
-    cfg->PD = 16.0f;                // platform radius (mm)
-    cfg->ServoArmLengthL1 = 7.25f;  // servo horn length (mm)
-    cfg->ConnectingArmLengthL2 = 28.5f; // connecting rod length (mm)
-    cfg->platformHeight = 25.517f;   // neutral height (mm)
-
-    // Drive train not used for PWM servos — kept for API compat
-    cfg->virtual_gear = 1.0f;
-    cfg->planetary_ratio = 1.0f;
-    cfg->encoder_ppr = 1;
-    cfg->steps_per_degree = 1.0f;
-}
-
 // ── Input Scaling ────────────────────────────────────────────────────
 static uint8_t inputBitRange = 12;
 static float maxRawInput = 4095.0f;
@@ -127,6 +132,8 @@ static SemaphoreHandle_t xMutex = NULL;
 // ── Telemetry Rate ──────────────────────────────────────────────────
 static volatile int telemetryDelayMs = 20;  // default 50Hz (was 100ms = 10Hz)
 static volatile bool telemetryEnabled = false;  // silent until app sends TELRATE:N after handshake
+static volatile uint8_t  tel2Mask = 0;      // TEL2:<mask> field groups (tel2.h), 0 = off
+static volatile uint16_t tel2Div  = 1;      // one TEL2 sample every N cue ticks
 
 // ── Activity Watchdog ────────────────────────────────────────────────
 static volatile int64_t lastPacketTimeUs = 0;            // esp_timer_get_time() of last motion packet
@@ -149,18 +156,45 @@ static volatile InputMode inputMode = INPUT_SERIAL;
 // NVS (generalizes the old play_on_boot). Default boot source = DEMO.
 typedef enum {
     SRC_OFF  = 0,   // motion off: home + ignore incoming motion (safe idle)
-    SRC_DEMO = 1,   // on-device embedded playback (PlaybackTask)
+    SRC_DEMO = 1,   // on-device embedded playback (sampled in CueTask)
     SRC_LIVE = 2,   // accept streamed motion (CH_DATA / CH_DATA_RAW)
 } Source;
 static volatile Source g_source = SRC_DEMO;
 
+// ── Boot timeline (BOOT?) ────────────────────────────────────────────
+// esp_timer_get_time() at each phase of app_main, first write wins. The timer
+// starts during IDF startup, so ROM + 2nd-stage bootloader time (~0.3 s with
+// the default log level) comes on top. MOTION is CueTask's first tick that
+// drives a DEMO sample; BLE is filled by the BleInit task once the stack is up.
+typedef enum {
+    BOOT_APP = 0,   // app_main entry
+    BOOT_CONFIG,    // NVS + config loaded and published
+    BOOT_HOME,      // LEDC up, servos at center (settle starts)
+    BOOT_SEQ,       // MCA + sequence library ready (runs inside the settle)
+    BOOT_POWER,     // servo power on
+    BOOT_CUE,       // CueTask started
+    BOOT_MOTION,    // first DEMO sample driven
+    BOOT_BLE,       // ble_transport_init() returned (deferred)
+    BOOT_PHASES
+} BootPhase;
+static const char* const BOOT_PHASE_NAMES[BOOT_PHASES] = {
+    "app", "config", "home", "seq", "power", "cue", "motion", "ble"
+};
+static volatile int64_t g_bootUs[BOOT_PHASES] = {0};
+#define BOOT_SETTLE_MAX_MS  2000
+static uint16_t bootSettleMs = 500;   // home -> servo power (BOOT:SETTLE=, NVS)
+
+static inline void bootMark(BootPhase p) {
+    if (!g_bootUs[p]) g_bootUs[p] = esp_timer_get_time();
+}
+
 // ── BLE Accel Input ──────────────────────────────────────────────────
 // Raw sensor data from phone: [accel_x, accel_y, accel_z, gyro_x, gyro_y, gyro_z]
 // Accel in m/s² (Android TYPE_ACCELEROMETER, includes gravity)
 // Gyro in rad/s  (Android TYPE_GYROSCOPE)
-static volatile float accelRaw[6] = {0};
-static volatile bool accelFresh = false;
 static volatile uint32_t accelPacketCount = 0;
+static volatile uint32_t accelLatAvgUs = 0;   // BLE write -> servo write (EMA, CueTask)
+static volatile uint32_t accelLatMaxUs = 0;   // worst since the last ACCEL?
 
 // Per-axis gain: maps sensor units to platform physical units
 // Translation axes: mm per G   (e.g. 5.0 = 1G → 5mm displacement)
@@ -174,35 +208,38 @@ static float accelGain[6] = {
     1.0f,   // yaw   (1.0 = 1:1 phone-to-platform degrees)
 };
 
-// Axis mapping: which phone sensor index maps to each platform axis
-// Phone flat, screen up, top edge forward:
-//   phone X = right, Y = forward, Z = up (matches TYPE_ACCELEROMETER)
+// Axis mapping: which packet index feeds each platform axis
+// The app sends [roll°, pitch°, yaw°, surge, sway, heave] (m/s²).
 // Positive value = same polarity, negative = inverted
 // abs(value)-1 = source index (1-based to allow sign encoding, 0 = disabled)
+// Platform axes 0-2 are translation (mm per m/s²), 3-5 rotation (degrees in).
 static int8_t accelAxisMap[6] = {
-     2,  // surge  ← phone Y (forward)
-     1,  // sway   ← phone X (right)
-     3,  // heave  ← phone Z (up)
-     4,  // roll   ← gyro X
-     5,  // pitch  ← gyro Y
-     6,  // yaw    ← gyro Z
+     4,  // surge  ← packet[3]
+     5,  // sway   ← packet[4]
+     6,  // heave  ← packet[5]
+     1,  // roll   ← packet[0]
+     2,  // pitch  ← packet[1]
+     3,  // yaw    ← packet[2]
 };
 
+// ACCEL:MODE — what 0xFF03 carries.
+//   FUSED: the app's own fusion, [roll°, pitch°, yaw°, surge, sway, heave]
+//          (gravity already removed) — mapped in the BLE callback.
+//   RAW:   [ax, ay, az (m/s², with gravity), gx, gy, gz (rad/s)] as the
+//          sensors deliver them. CueTask fuses the freshest sample every tick
+//          (imufusion.h) into the FUSED layout, so map and gain apply as-is.
+typedef enum { ACCEL_FUSED = 0, ACCEL_RAW = 1 } AccelMode;
+static volatile int      accelMode = ACCEL_FUSED;
+static ImuFusionConfig   imuConfig;          // defaults set in app_main
+static ImuFusion         g_imu;              // CueTask-owned; ACCEL? peeks
+static volatile uint32_t imuGen = 0;         // bumped by ACCEL:MODE: CueTask restarts the fusion
+
 #define GRAVITY_MS2 9.80665f
 
-// ── Slew-Rate Limiter (per-TIME, rate-independent) ───────────────────
-// FIX TRAP B (MCU_HIFI_CUEING.md §2): the old limit was per-CALL (5 units/
-// cycle) which silently assumed 50 Hz. At 250 Hz that would be ~5x harsher.
-// Express it as units/SECOND and multiply by dt so it's identical in feel at
-// any cueLoopHz. 250 units/s == the old 5 units × 50 Hz.
-#define SLEW_RATE_MAX_PER_S   250.0f                     // mm (or rad) per SECOND
+// ── Slew-Rate Limiter state (limit: SLEW_RATE_MAX_PER_S, MiniPlatform.h) ─
 static float smoothedPosition[6] = {0};                  // current smoothed output
 static bool smoothingInitialized = false;
 
-// ── IK Angle Limits ──────────────────────────────────────────────────
-// Max servo arm deflection in radians (±45° is typical hobby servo range)
-#define SERVO_MAX_ANGLE_RAD  (IK_PI / 4.0f)
-
 // ── Servo PWM ────────────────────────────────────────────────────────
 static const int servoPins[6] = {
     SERVO_PIN_0, SERVO_PIN_1, SERVO_PIN_2,
@@ -218,21 +255,152 @@ static float servoPulsePerRad = 800.0f / (float)(IK_PI / 4.0);
 // Inverted servos (mounted mirrored)
 static const bool servoInverted[6] = {true, false, true, false, true, false};
 
+// Servo dynamics model + lead compensation (servodyn.h), per servo. Set by
+// SERVO:DYN=, stored in NVS; defaults to the analog model with lead 0 (off).
+static ServoDynParams servoDyn[6];
+static ServoDynState  servoDynState[6];   // driveServos only
+
+// ── Config snapshots (setters -> CueTask, RCU-style) ─────────────────
+// The globals above (stewartConfig, axisScales, servoCenter, mcaConfig, ...)
+// are the WRITER-side staging copies: command setters edit them, do any heavy
+// recompute there (workspace probe, biquad retune) and then publishConfig()
+// copies everything into a fresh immutable CueConfig and hands it over with
+// one atomic exchange (tribuf.h). CueTask adopts the newest snapshot at the
+// top of a tick and reads only that — no locks on the hot path, no tick ever
+// sees half-updated geometry or biquad coefficients.
+//
+// Filter STATE is CueTask's own (cueMca / cueInputFilter). The staging
+// mcaConfig / inputFilter are never ticked, so their state is always fresh;
+// a snapshot with a new filterGen is adopted by copying them over, which
+// retunes and resets the chain in one step (same as a source transition).
+// Parameter tweaks (MCA:INTENSITY, GAIN, ...) must not reset the washout
+// while the rig moves: they go through the MCA edit log below instead and
+// CueTask replays the same setter on its own cueMca, state kept.
+typedef struct {
+    StewartConfig      geom;
+    AxisScaleConfig    scales;
+    int                servoCenter[6];
+    float              servoPulsePerRad;
+    float              maxRawInput;
+    uint16_t           rateHz;            // cueLoopHz == LEDC carrier
+    float              periodUs;
+    uint32_t           filterGen;         // bumped when the cue filters change/reset
+    uint32_t           mcaEditSeq;        // MCA edits logged up to here (g_mcaEdits)
+    MotionCueingConfig mca;
+    InputFilterConfig  inputFilter;
+    ServoDynParams     dyn[6];
+} CueConfig;
+
+static CueConfig         g_cfgSlot[3];
+static TriBuf            g_cfgBuf;
+static SemaphoreHandle_t g_cfgWriteLock = NULL;   // serializes writers only
+static uint32_t          g_filterGen    = 0;
+
+// MCA parameter edits, in order. The setter runs on the staging mcaConfig
+// and is logged; CueTask applies logged edits it hasn't seen to cueMca, the
+// way the setters used to edit the live struct in place. A CueTask more than
+// half the ring behind (a burst within one tick) re-adopts the whole
+// snapshot instead, which resets.
+enum { MCA_EDIT_INTENSITY, MCA_EDIT_GAIN, MCA_EDIT_INVERT, MCA_EDIT_CHGAIN,
+       MCA_EDIT_HPFC, MCA_EDIT_LPFC, MCA_EDIT_TILT };
+typedef struct {
+    uint8_t op;
+    int8_t  axis;
+    float   a, b;
+} McaEdit;
+#define MCA_EDIT_RING  16
+static McaEdit           g_mcaEdits[MCA_EDIT_RING];
+static volatile uint32_t g_mcaEditSeq   = 0;      // writers, under g_cfgWriteLock
+
+static void mcaApplyEdit(MotionCueingConfig* c, const McaEdit* e) {
+    switch (e->op) {
+        case MCA_EDIT_INTENSITY: mcaSetIntensity(c, e->a);                      break;
+        case MCA_EDIT_GAIN:      mcaSetAxisGain(c, e->axis, e->a);              break;
+        case MCA_EDIT_INVERT:    mcaSetAxisInvert(c, e->axis, (int)e->a);       break;
+        case MCA_EDIT_CHGAIN:    mcaSetChannelGain(c, e->axis, e->a);           break;
+        case MCA_EDIT_HPFC:      mcaSetChannelHpFc(c, e->axis, e->a);           break;
+        case MCA_EDIT_LPFC:      mcaSetChannelLpFc(c, e->axis, e->a);           break;
+        case MCA_EDIT_TILT:      mcaSetTiltSurgeGain(c, e->a);
+                                 mcaSetTiltSwayGain(c, e->b);                   break;
+    }
+}
+
+// Publish the staging config. `filters` = the MCA / input-filter config changed
+// (or must be reset): CueTask re-adopts them from this snapshot.
+static void publishConfig(bool filters) {
+    if (g_cfgWriteLock) xSemaphoreTake(g_cfgWriteLock, portMAX_DELAY);
+    if (filters) g_filterGen++;
+    CueConfig* c = &g_cfgSlot[tribuf_write_index(&g_cfgBuf)];
+    c->geom             = stewartConfig;
+    c->scales           = axisScales;
+    memcpy(c->servoCenter, servoCenter, sizeof(c->servoCenter));
+    c->servoPulsePerRad = servoPulsePerRad;
+    c->maxRawInput      = maxRawInput;
+    c->rateHz           = servoRateHz;
+    c->periodUs         = servoPeriodUs;
+    c->filterGen        = g_filterGen;
+    c->mcaEditSeq       = g_mcaEditSeq;
+    c->mca              = mcaConfig;       // always copied: any slot may carry the newest gen
+    c->inputFilter      = inputFilter;
+    memcpy(c->dyn, servoDyn, sizeof(c->dyn));
+    tribuf_publish(&g_cfgBuf);
+    if (g_cfgWriteLock) xSemaphoreGive(g_cfgWriteLock);
+}
+
+// Setter side of the MCA edit log: staging copy, log entry, publish.
+static void mcaEdit(uint8_t op, int axis, float a, float b = 0.0f) {
+    McaEdit e = { op, (int8_t)axis, a, b };
+    if (g_cfgWriteLock) xSemaphoreTake(g_cfgWriteLock, portMAX_DELAY);
+    mcaApplyEdit(&mcaConfig, &e);
+    g_mcaEdits[g_mcaEditSeq % MCA_EDIT_RING] = e;
+    g_mcaEditSeq = g_mcaEditSeq + 1;
+    if (g_cfgWriteLock) xSemaphoreGive(g_cfgWriteLock);
+    publishConfig(false);
+}
+
+// Reader side: CueTask (or app_main before CueTask starts — one reader at a time).
+static const CueConfig* acquireConfig() {
+    tribuf_acquire(&g_cfgBuf);
+    return &g_cfgSlot[tribuf_read_index(&g_cfgBuf)];
+}
+
 // ── NVS Persistence ─────────────────────────────────────────────────
+// Writes go through NvsPersist: the command path only stages values, the
+// NvsSave task commits the changed keys once a burst of commands settles
+// (SAVE:FLUSH forces it). Reads stay direct — they only happen at boot.
 static const char* NVS_NAMESPACE = "mini6dof";
+static_assert(sizeof(StewartConfig) <= NVS_PERSIST_MAX_BLOB, "geometry blob exceeds NvsPersist slot");
+static_assert(sizeof(ServoDynParams) * 6 <= NVS_PERSIST_MAX_BLOB, "servo_dyn blob exceeds NvsPersist slot");
 
+// Stages every config key; NvsPersist drops the unchanged ones.
 static void saveConfigToNVS() {
-    nvs_handle_t h;
-    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &h) == ESP_OK) {
-        nvs_set_blob(h, "servo_center", servoCenter, sizeof(servoCenter));
-        nvs_set_blob(h, "pulse_per_rad", &servoPulsePerRad, sizeof(servoPulsePerRad));
-        nvs_set_blob(h, "geometry", &stewartConfig, sizeof(stewartConfig));
-        nvs_set_u8(h, "bit_depth", inputBitRange);
-        uint16_t sr = servoRateHz;
-        nvs_set_blob(h, "servo_rate", &sr, sizeof(sr));
-        nvs_commit(h);
-        nvs_close(h);
-    }
+    nvs_persist_blob("servo_center", servoCenter, sizeof(servoCenter));
+    nvs_persist_blob("pulse_per_rad", &servoPulsePerRad, sizeof(servoPulsePerRad));
+    nvs_persist_blob("geometry", &stewartConfig, sizeof(stewartConfig));
+    nvs_persist_u8("bit_depth", inputBitRange);
+    uint16_t sr = servoRateHz;
+    nvs_persist_blob("servo_rate", &sr, sizeof(sr));
+    nvs_persist_blob("servo_dyn", servoDyn, sizeof(servoDyn));
+    nvs_persist_u16("boot_settle", bootSettleMs);
+}
+
+// MCA:SAVE — stewart-core owns the MCA key and blob layout (mcaSaveToNVS),
+// so NvsSave calls it on a snapshot taken when the command ran.
+static MotionCueingConfig g_mcaSaved;      // under g_cfgWriteLock
+
+static int writeMcaSnapshot() {
+    static MotionCueingConfig snap;        // NvsSave only
+    xSemaphoreTake(g_cfgWriteLock, portMAX_DELAY);
+    snap = g_mcaSaved;
+    xSemaphoreGive(g_cfgWriteLock);
+    return mcaSaveToNVS(&snap);
+}
+
+static void saveMcaToNVS() {
+    xSemaphoreTake(g_cfgWriteLock, portMAX_DELAY);
+    g_mcaSaved = mcaConfig;
+    xSemaphoreGive(g_cfgWriteLock);
+    nvs_persist_call("mca", writeMcaSnapshot);
 }
 
 static void loadConfigFromNVS() {
@@ -258,6 +426,17 @@ static void loadConfigFromNVS() {
             servoRateHz   = sr;
             servoPeriodUs = 1000000.0f / (float)sr;
         }
+        ServoDynParams dyn[6]; sz = sizeof(dyn);
+        if (nvs_get_blob(h, "servo_dyn", dyn, &sz) == ESP_OK && sz == sizeof(dyn)) {
+            bool ok = true;
+            for (int i = 0; i < 6; i++)
+                ok = ok && dyn[i].tau_s >= 0.0f && dyn[i].tau_s <= 0.5f && dyn[i].vmax >= 0.0f &&
+                     dyn[i].lead >= 0.0f && dyn[i].lead <= SERVO_DYN_LEAD_MAX;
+            if (ok) memcpy(servoDyn, dyn, sizeof(servoDyn));
+        }
+        uint16_t settle = 0;
+        if (nvs_get_u16(h, "boot_settle", &settle) == ESP_OK && settle <= BOOT_SETTLE_MAX_MS)
+            bootSettleMs = settle;
         nvs_close(h);
     }
 }
@@ -268,6 +447,8 @@ static void loadConfigFromNVS() {
 // plays the lap" (DECISIONS r3). SOURCE:BOOT=OFF|DEMO|LIVE sets it; PLAY:BOOT=0
 // (OFF) / PLAY:BOOT=1 (DEMO) stay as aliases. Reads the legacy play_on_boot key
 // as a fallback so an already-flashed device keeps its setting.
+static Source g_bootSource = SRC_DEMO;   // last loaded / set (the NVS write may be pending)
+
 static Source loadBootSource() {
     nvs_handle_t h;
     Source src = SRC_DEMO;   // default
@@ -280,16 +461,13 @@ static Source loadBootSource() {
         }
         nvs_close(h);
     }
+    g_bootSource = src;
     return src;
 }
 
 static void saveBootSource(Source src) {
-    nvs_handle_t h;
-    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &h) == ESP_OK) {
-        nvs_set_u8(h, "boot_source", (uint8_t)src);
-        nvs_commit(h);
-        nvs_close(h);
-    }
+    g_bootSource = src;
+    nvs_persist_u8("boot_source", (uint8_t)src);
 }
 
 static const char* sourceName(Source s) {
@@ -332,15 +510,15 @@ static void setupServoPWM() {
 // Convert microseconds to LEDC duty value.
 // duty = (us / period_us) * max_duty, where period_us tracks the servo rate
 // (20000us @ 50Hz, 4000us @ 250Hz) so pulse widths stay absolute microseconds.
-static uint32_t usToDuty(int us) {
-    return (uint32_t)((float)us / servoPeriodUs * (float)LEDC_TIMER_MAX);
+static uint32_t usToDuty(int us, float periodUs) {
+    return (uint32_t)((float)us / periodUs * (float)LEDC_TIMER_MAX);
 }
 
 // Set servo pulse width in microseconds
 static void setServoPulse(int channel, int us) {
     if (us < SERVO_MIN_US) us = SERVO_MIN_US;
     if (us > SERVO_MAX_US) us = SERVO_MAX_US;
-    ledc_set_duty(LEDC_LOW_SPEED_MODE, (ledc_channel_t)channel, usToDuty(us));
+    ledc_set_duty(LEDC_LOW_SPEED_MODE, (ledc_channel_t)channel, usToDuty(us, servoPeriodUs));
     ledc_update_duty(LEDC_LOW_SPEED_MODE, (ledc_channel_t)channel);
 }
 
@@ -368,46 +546,72 @@ static void slewRateLimit(const float target[6], float out[6], float dt) {
 // writer) once tasks are running, plus directly at boot before CueTask starts.
 //   1. Per-time slew-rate limiting prevents servo jerk from large steps
 //   2. IK output validated (NaN / out-of-range clamped)
-//   3. Atomic servo update: all 6 duties set first, then all 6 updated
+//   3. Servo lag compensation (SERVO:DYN, no-op at lead 0)
+//   4. Atomic servo update: all 6 duties set first, then all 6 updated
 // `dt` is the loop period in seconds (1/cueLoopHz) for the per-time slew.
+// Geometry and servo calibration come from the caller's config snapshot.
 
-static void driveServos(float position[6], float dt) {
+static void driveServos(const CueConfig* cfg, float position[6], float dt, ScopeSample* sc) {
     // Slew-rate limit the input position (rate-independent)
     float limited[6];
     slewRateLimit(position, limited, dt);
+    uint16_t flags = 0;
+    for (int i = 0; i < 6; i++)
+        if (limited[i] != position[i]) flags |= SCOPE_F_SLEW;
 
     // Run inverse kinematics
     float angles[6];
-    calculateAllServoAngles(limited, &stewartConfig, angles);
+    calculateAllServoAngles(limited, &cfg->geom, angles);
 
     // Validate IK output — clamp NaN and out-of-range angles
     for (int i = 0; i < 6; i++) {
         if (isnan(angles[i]) || isinf(angles[i])) {
             angles[i] = 0.0f;  // safe fallback
+            flags |= SCOPE_F_CLIP;
         } else if (angles[i] > SERVO_MAX_ANGLE_RAD) {
             angles[i] = SERVO_MAX_ANGLE_RAD;
+            flags |= SCOPE_F_CLIP;
         } else if (angles[i] < -SERVO_MAX_ANGLE_RAD) {
             angles[i] = -SERVO_MAX_ANGLE_RAD;
+            flags |= SCOPE_F_CLIP;
         }
     }
 
     memcpy((void*)lastServoAngles, angles, sizeof(lastServoAngles));
 
+    // Feed-forward lag compensation (servodyn.h): lead on the commanded angle
+    // so the arm, not the pulse, follows the intended trajectory.
+    float cmd[6];
+    for (int i = 0; i < 6; i++) {
+        cmd[i] = servo_dyn_compensate(&cfg->dyn[i], &servoDynState[i], angles[i], dt);
+        if (cmd[i] > SERVO_MAX_ANGLE_RAD) cmd[i] = SERVO_MAX_ANGLE_RAD;
+        if (cmd[i] < -SERVO_MAX_ANGLE_RAD) cmd[i] = -SERVO_MAX_ANGLE_RAD;
+    }
+
     // Pre-compute all 6 pulse widths
     int pulse[6];
     for (int i = 0; i < 6; i++) {
         if (servoInverted[i]) {
-            pulse[i] = servoCenter[i] + (int)(angles[i] * servoPulsePerRad);
+            pulse[i] = cfg->servoCenter[i] + (int)(cmd[i] * cfg->servoPulsePerRad);
         } else {
-            pulse[i] = servoCenter[i] - (int)(angles[i] * servoPulsePerRad);
+            pulse[i] = cfg->servoCenter[i] - (int)(cmd[i] * cfg->servoPulsePerRad);
         }
         if (pulse[i] < SERVO_MIN_US) pulse[i] = SERVO_MIN_US;
         if (pulse[i] > SERVO_MAX_US) pulse[i] = SERVO_MAX_US;
     }
 
+    if (sc) {   // SCOPE:* capture
+        sc->flags |= flags;
+        for (int i = 0; i < 6; i++) {
+            sc->pose[i]  = limited[i];
+            sc->angle[i] = angles[i];
+            sc->pulse[i] = (uint16_t)pulse[i];
+        }
+    }
+
     // Atomic batch update: set all duties first, then trigger all updates
     for (int i = 0; i < 6; i++) {
-        ledc_set_duty(LEDC_LOW_SPEED_MODE, (ledc_channel_t)i, usToDuty(pulse[i]));
+        ledc_set_duty(LEDC_LOW_SPEED_MODE, (ledc_channel_t)i, usToDuty(pulse[i], cfg->periodUs));
     }
     for (int i = 0; i < 6; i++) {
         ledc_update_duty(LEDC_LOW_SPEED_MODE, (ledc_channel_t)i);
@@ -421,8 +625,8 @@ static void writeTarget(const float ch[6], int fmt) {
     int64_t t = esp_timer_get_time();
     taskENTER_CRITICAL(&g_targetMux);
     for (int i = 0; i < 6; i++) g_targetCh[i] = ch[i];
-    g_targetTsUs = t;
-    g_targetFmt  = fmt;
+    g_targetTsUs   = t;
+    g_targetFmt    = fmt;
     taskEXIT_CRITICAL(&g_targetMux);
     lastPacketTimeUs = t;
     watchdogTripped  = false;
@@ -435,10 +639,166 @@ static void readTarget(float ch[6], int64_t* ts, int* fmt) {
     taskEXIT_CRITICAL(&g_targetMux);
 }
 
+// ── Timed targets (batched BLE writes) ───────────────────────────────
+// A batched write carries several samples, each with its own due time
+// (BleTransport.h). The BLE callback queues them here; CueTask releases every
+// entry that is due at the start of its tick and hands the newest one to
+// writeTarget, so samples play back at their capture spacing instead of
+// collapsing onto one tick. One producer (the BT task), one consumer.
+#define TIMED_RING 64
+typedef struct {
+    int64_t due;
+    float   ch[6];
+    int     fmt;
+} TimedTarget;
+static TimedTarget       g_timed[TIMED_RING];
+static uint32_t          g_timedHead = 0, g_timedTail = 0;   // under g_targetMux
+static volatile uint32_t timedDropped = 0;                   // ring full (batch > 64 samples ahead)
+
+static void queueTarget(const float ch[6], int fmt, int64_t due) {
+    bool ok = false;
+    taskENTER_CRITICAL(&g_targetMux);
+    if (g_timedHead - g_timedTail < TIMED_RING) {
+        TimedTarget* t = &g_timed[g_timedHead % TIMED_RING];
+        t->due = due;
+        for (int i = 0; i < 6; i++) t->ch[i] = ch[i];
+        t->fmt = fmt;
+        g_timedHead++;
+        ok = true;
+    }
+    taskEXIT_CRITICAL(&g_targetMux);
+    if (!ok) timedDropped++;
+    lastPacketTimeUs = esp_timer_get_time();   // the link is alive even if the sample is queued
+    watchdogTripped  = false;
+}
+
+// CueTask: publish the newest entry due by `now` (older due ones are skipped —
+// they were meant for ticks already past).
+static void releaseTimedTargets(int64_t now) {
+    float ch[6]; int fmt = -1;
+    taskENTER_CRITICAL(&g_targetMux);
+    while (g_timedTail != g_timedHead) {
+        const TimedTarget* t = &g_timed[g_timedTail % TIMED_RING];
+        if (t->due > now) break;
+        for (int i = 0; i < 6; i++) ch[i] = t->ch[i];
+        fmt = t->fmt;
+        g_timedTail++;
+    }
+    taskEXIT_CRITICAL(&g_targetMux);
+    if (fmt >= 0) writeTarget(ch, fmt);
+}
+
+// ── Multi-rig sync (SYNC:*) ──────────────────────────────────────────
+// Rigs side by side follow one host clock. The host runs timestamp exchanges
+// with each rig (SYNC:T, clocksync.h), so every device tracks its offset and
+// drift from the host, and motion frames / SOURCE:DEMO / PLAY:SEEK can carry
+// a host-time apply stamp. Stamped frames go through the timed-target ring
+// above. With SYNC:ON, CueTask also slews its tick phase onto the host's
+// period grid (one FreeRTOS tick at a time) and trims the DEMO playhead rate
+// so the sample it plays is the one due at the tick's host time: rigs drive
+// the same sample on the same tick within SYNC_TOL_US.
+#define SYNC_TOL_US        1000      // stated lockstep tolerance: one FreeRTOS tick
+#define SYNC_TICK_BAND_US  600       // tick phase error before a one-tick slew
+#define SYNC_SLEW_MAX      0.005f    // playhead rate trim, ±0.5 %
+#define SYNC_SLEW_TAU_S    1.0f      // playhead error time constant
+#define SYNC_STEP_MS       250       // playhead error beyond this steps instead
+#define SYNC_STAMP_SIZE    8         // int64 LE host µs after a CH_DATA / CH_DATA_RAW payload
+
+static ClockSync          g_clk;                  // command task only
+static ClockSyncModel     g_syncModel;            // published copy (g_syncMux)
+static portMUX_TYPE       g_syncMux = portMUX_INITIALIZER_UNLOCKED;
+static volatile bool      syncOn = false;
+static int64_t            syncPendT1 = -1, syncPendT2 = 0, syncPendT3 = 0;   // exchange awaiting t4
+// Playhead anchor, command task -> CueTask: frame syncReqIdx at host syncReqHost.
+#define SYNC_ANCHOR_SET    1
+#define SYNC_ANCHOR_CLEAR  2
+static uint8_t            syncAnchorCmd = 0;      // g_syncMux
+static int64_t            syncReqHost   = 0;
+static uint32_t           syncReqIdx    = 0;
+static bool               syncReqHold   = false;  // SOURCE:DEMO@: hold the frame until due
+// CueTask -> SYNC?
+static volatile uint8_t   syncAnchorState = 0;    // 0 none, 1 pending, 2 tracking
+static volatile float     syncTickErrUs = 0.0f, syncTickRmsUs = 0.0f;   // tick start vs host grid
+static volatile float     syncPlayErrUs = 0.0f, syncPlayRmsUs = 0.0f;   // playhead vs host time
+static volatile uint32_t  syncTickSlews = 0, syncSteps = 0;
+static volatile uint32_t  syncTimed = 0, syncLate = 0, syncUntimed = 0;
+
+static bool syncModel(ClockSyncModel* m) {
+    taskENTER_CRITICAL(&g_syncMux);
+    *m = g_syncModel;
+    taskEXIT_CRITICAL(&g_syncMux);
+    return m->valid;
+}
+
+static void syncPublish() {
+    taskENTER_CRITICAL(&g_syncMux);
+    g_syncModel = g_clk.m;
+    taskEXIT_CRITICAL(&g_syncMux);
+}
+
+// Device time a host-stamped frame is due; now (untimed) unless SYNC:ON and locked.
+static int64_t syncDue(const uint8_t* stamp) {
+    int64_t host;
+    memcpy(&host, stamp, sizeof(host));
+    ClockSyncModel m;
+    const int64_t now = esp_timer_get_time();
+    if (!syncOn || !syncModel(&m)) { syncUntimed++; return now; }
+    const int64_t due = clocksync_to_device(&m, host);
+    syncTimed++;
+    if (due < now) syncLate++;
+    return due;
+}
+
+// Split a "<cmd>@<host µs>" apply stamp off `data`; false when unstamped.
+static bool syncSplitStamp(char* data, int64_t* host) {
+    char* at = strchr(data, '@');
+    if (!at) return false;
+    *at = '\0';
+    *host = strtoll(at + 1, NULL, 10);
+    return true;
+}
+
+static void syncAnchor(uint32_t idx, int64_t host, bool hold) {
+    taskENTER_CRITICAL(&g_syncMux);
+    syncReqIdx    = idx;
+    syncReqHost   = host;
+    syncReqHold   = hold;
+    syncAnchorCmd = SYNC_ANCHOR_SET;
+    taskEXIT_CRITICAL(&g_syncMux);
+}
+
+static void syncAnchorClear() {
+    taskENTER_CRITICAL(&g_syncMux);
+    syncAnchorCmd = SYNC_ANCHOR_CLEAR;
+    taskEXIT_CRITICAL(&g_syncMux);
+}
+
+// SYNC:ON — tick start vs the host grid (host time ≡ 0 mod the period).
+// Returns FreeRTOS ticks to add to the next delay: ±1 moves the phase by one
+// tick, so the error is slewed, never jumped. The decision uses a smoothed
+// error so wakeup jitter alone does not slew back and forth.
+static float syncTickFilt = 0.0f;
+static int syncTickSlew(TickType_t period, int64_t startUs) {
+    ClockSyncModel m;
+    if (!syncModel(&m)) return 0;
+    const int64_t pUs = (int64_t)period * portTICK_PERIOD_MS * 1000;
+    int64_t ph = clocksync_to_host(&m, startUs) % pUs;
+    if (ph < 0) ph += pUs;
+    if (ph > pUs / 2) ph -= pUs;             // > 0: this tick started after its grid point
+    syncTickErrUs = (float)ph;
+    syncTickRmsUs = sqrtf(0.95f * syncTickRmsUs * syncTickRmsUs + 0.05f * (float)ph * (float)ph);
+    syncTickFilt += 0.2f * ((float)ph - syncTickFilt);
+    const float tickUs = portTICK_PERIOD_MS * 1000.0f;
+    if (syncTickFilt > SYNC_TICK_BAND_US && period > 1) { syncTickFilt -= tickUs; syncTickSlews++; return -1; }
+    if (syncTickFilt < -SYNC_TICK_BAND_US)              { syncTickFilt += tickUs; syncTickSlews++; return 1; }
+    return 0;
+}
+
 // ── Servo-rate profile applier ───────────────────────────────────────
 // Sets BOTH the LEDC carrier and the CueTask loop rate (cueLoopHz) together,
 // and retunes the biquads (FIX TRAP A) so filters match the new loop rate.
-// Safe to call at runtime; CueTask picks up the new period on its next tick.
+// Safe to call at runtime; CueTask picks up the new period and the retuned
+// filters together from the published snapshot on its next tick.
 static void applyServoRate(uint16_t hz) {
     if (hz < SERVO_RATE_MIN_HZ) hz = SERVO_RATE_MIN_HZ;
     if (hz > SERVO_RATE_MAX_HZ) hz = SERVO_RATE_MAX_HZ;
@@ -458,19 +818,58 @@ static void applyServoRate(uint16_t hz) {
     // loop rate (== servoRateHz), NOT the telemetry/seq rate.
     mcaUpdateSampleRate(&mcaConfig, (float)hz);
     inputFilterUpdateSampleRate(&inputFilter, (float)hz);
+    publishConfig(true);
 }
 
 // ── BLE Accel Callback ───────────────────────────────────────────────
 // Called from BLE transport when 24-byte accel packet arrives on 0xFF03.
-// Stores raw data and sets fresh flag for main loop processing.
+// The whole 6-axis pipeline runs right here, in the BLE stack's callback:
+// axis map -> gain -> units -> TGT_PHYS target, so CueTask's next tick
+// already drives it (no app_main polling hop; every packet lands).
+//   translation: m/s² × gain -> mm      rotation: degrees × DEG_TO_RAD × gain -> rad
+
+static void accelToPhys(const float* data, float position[6]) {
+    for (int i = 0; i < 6; i++) {
+        int m = accelAxisMap[i];
+        int src = (m < 0 ? -m : m) - 1;
+        float v = (src >= 0 && src < 6) ? data[src] : 0.0f;
+        if (m < 0) v = -v;
+        if (i >= 3) v *= DEG_TO_RAD;
+        position[i] = v * accelGain[i];
+    }
+}
 
 void process_accel_packet(const float* data) {
-    for (int i = 0; i < 6; i++) accelRaw[i] = data[i];
-    accelFresh = true;
     accelPacketCount++;
-    lastPacketTimeUs = esp_timer_get_time();
-    watchdogTripped = false;
     inputMode = INPUT_BLE_ACCEL;
+
+    float position[6];   // [surge, sway, heave, roll, pitch, yaw] — already physical
+    if (accelMode == ACCEL_RAW && g_source != SRC_OFF) {
+        writeTarget(data, TGT_IMU);        // fused in CueTask
+    } else if (g_source != SRC_OFF) {
+        accelToPhys(data, position);
+        writeTarget(position, TGT_PHYS);   // stamps the target + feeds the watchdog
+    } else {
+        lastPacketTimeUs = esp_timer_get_time();
+        watchdogTripped = false;
+    }
+}
+
+// One sample of a batched accel write, due at `due_us`.
+void process_accel_packet_at(const float* data, int64_t due_us) {
+    accelPacketCount++;
+    inputMode = INPUT_BLE_ACCEL;
+
+    float position[6];
+    if (accelMode == ACCEL_RAW && g_source != SRC_OFF) {
+        queueTarget(data, TGT_IMU, due_us);
+    } else if (g_source != SRC_OFF) {
+        accelToPhys(data, position);
+        queueTarget(position, TGT_PHYS, due_us);
+    } else {
+        lastPacketTimeUs = esp_timer_get_time();
+        watchdogTripped = false;
+    }
 }
 
 // ── Forward Declarations ─────────────────────────────────────────────
@@ -495,6 +894,16 @@ void process_binary_packet(const uint8_t* payload) {
     writeTarget(raw, TGT_BAKED);
 }
 
+// One baked sample due at `due_us` (batched BLE write, SYNC-stamped CH_DATA).
+void process_binary_packet_at(const uint8_t* payload, int64_t due_us) {
+    float raw[6];
+    for (int i = 0; i < 6; i++) {
+        uint16_t val = (uint16_t)payload[i * 2] | ((uint16_t)payload[i * 2 + 1] << 8);
+        raw[i] = (float)val;
+    }
+    queueTarget(raw, TGT_BAKED, due_us);
+}
+
 // RAW pre-cue frame: 6×float32 LE = 24 bytes (CH_DATA_RAW / M6P2 playback).
 // Producer only: CueTask runs the full cue chain (inputFilter -> MCA ->
 // outputStage -> mapRawToPosition) at cueLoopHz.
@@ -504,6 +913,13 @@ void process_raw_packet(const uint8_t* payload) {
     writeTarget(raw, TGT_RAW);
 }
 
+// RAW frame due at `due_us` (SYNC-stamped CH_DATA_RAW).
+void process_raw_packet_at(const uint8_t* payload, int64_t due_us) {
+    float raw[6];
+    memcpy(raw, payload, 6 * sizeof(float));
+    queueTarget(raw, TGT_RAW, due_us);
+}
+
 // ── Embedded Sequence Playback ───────────────────────────────────────
 // A motion-cued lap baked offline by the desktop app's export_sequence (see
 // cobra-6dof-mount). File .m6p: 64-byte header {"M6P1", u16 ver, u16 rate,
@@ -513,60 +929,41 @@ void process_raw_packet(const uint8_t* payload) {
 // payload at `rate`, so it reuses the whole decode→IK→servo path and, because
 // process_binary_packet() feeds the activity watchdog, playback keeps the rig
 // live with no extra plumbing.
+// Sequences now come from the library on the `seq` partition (SeqLibrary.h,
+// mmapped, zero copy); the embedded file is entry 0 and the fallback.
+#if MINI6DOF_EMBED_SEQ
 extern const uint8_t _seq_start[] asm("_binary_laps123_moderate_m6p_start");
 extern const uint8_t _seq_end[]   asm("_binary_laps123_moderate_m6p_end");
+#endif
 
-static const uint8_t* seqSamples   = nullptr;  // -> first sample
+static const uint8_t* seqSamples   = nullptr;  // -> first sample (mmapped / embedded)
 static uint32_t        seqCount     = 0;
 static uint32_t        seqLoopPoint = 0;
 static uint16_t        seqRateHz    = 50;
 static uint16_t        seqBits      = 12;
 static uint16_t        seqStride    = 12;      // bytes/frame: 12 (M6P1) or 24 (M6P2)
 static bool            g_framesRaw  = false;   // true = M6P2 float32 pre-cue frames
+static bool            g_seqPacked  = false;   // true = M6P3, frames come from seqDec
+static M6p3Decoder     seqDec;                  // streaming M6P3 decoder (CueTask)
 static volatile bool     playbackActive = false;
 static volatile bool     playbackLoop   = true;
 static volatile uint32_t playbackIdx    = 0;
+static int               seqSelected    = -1;     // library entry being played
+static SemaphoreHandle_t g_seqMutex     = NULL;   // CueTask frame reads vs PLAY:SELECT remap
 
-// .m6p header (64 bytes), branch on magic (app Phase-2 contract, PR #29):
-//   common: magic[4]@0, u16 ver@4, u16 rate@6, u32 count@8, u32 loop@12,
-//           name[32]@16..47, u32 crc32@52.
-//   M6P1 (baked): u16 bits@48; frames = 6×uint16 LE (12B, post-cue, wire order
-//                 = device order, surge/sway already swapped). g_framesRaw=false.
-//   M6P2 (raw):   u8 format@48 (1=float32), u8 channels@49 (=6), [50..51] rsvd,
-//                 [56..63] rsvd; frames = 6×float32 LE (24B), PRE-cueing, app
-//                 axis order (surge=0, sway=1), NO surge/sway swap on the wire
-//                 (CueTask swaps after cueing). g_framesRaw=true.
-static bool parseSequence() {
-    const uint8_t* h = _seq_start;
-    size_t total = (size_t)(_seq_end - _seq_start);
-    if (total < 64) return false;
-
-    bool isM6P1 = (memcmp(h, "M6P1", 4) == 0);
-    bool isM6P2 = (memcmp(h, "M6P2", 4) == 0);
-    if (!isM6P1 && !isM6P2) return false;
-
-    memcpy(&seqRateHz,    h + 6,  2);
-    memcpy(&seqCount,     h + 8,  4);
-    memcpy(&seqLoopPoint, h + 12, 4);
-
-    if (isM6P2) {
-        uint8_t format   = h[48];         // 1 = float32
-        uint8_t channels = h[49];         // must be 6
-        if (format != 1 || channels != 6) return false;
-        g_framesRaw = true;
-        seqStride   = 24;                 // 6 × float32
-        seqBits     = 16;                 // raw float32 has no bit depth (placeholder)
-    } else {
-        memcpy(&seqBits, h + 48, 2);      // M6P1: u16 bit depth @48
-        g_framesRaw = false;
-        seqStride   = 12;                 // 6 × uint16 (baked)
+// Selected sequence (NVS) — library index, 0 = embedded / first entry.
+static int loadSeqSelection() {
+    nvs_handle_t h;
+    uint8_t v = 0;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &h) == ESP_OK) {
+        nvs_get_u8(h, "seq_sel", &v);
+        nvs_close(h);
     }
+    return v;
+}
 
-    if (seqRateHz == 0 || seqCount == 0) return false;
-    if ((size_t)64 + (size_t)seqCount * seqStride > total) return false;   // truncated
-    if (seqLoopPoint >= seqCount) seqLoopPoint = 0;
-    seqSamples = h + 64;
-    return true;
+static void saveSeqSelection(int n) {
+    nvs_persist_u8("seq_sel", (uint8_t)n);
 }
 
 // Decode one embedded frame (M6P1 uint16 or M6P2 float32) into raw[6].
@@ -581,107 +978,605 @@ static inline void decodeSeqFrame(const uint8_t* p, float raw[6]) {
     }
 }
 
-// PlaybackTask is now a PRODUCER: it paces to the file rate and pushes each
-// sample into the shared target (raw M6P2 -> TGT_RAW so CueTask cues it;
-// baked M6P1 -> TGT_BAKED). CueTask does the IK/servo at cueLoopHz.
-static void PlaybackTask(void* pv) {
-    (void)pv;
-    uint16_t rate = (seqRateHz ? seqRateHz : 50);
-    TickType_t period = pdMS_TO_TICKS(1000 / rate);
-    if (period < 1) period = 1;
-    TickType_t last = xTaskGetTickCount();
-    for (;;) {
-        if (playbackActive && seqSamples && seqCount) {
-            float raw[6];
-            decodeSeqFrame(seqSamples + (size_t)playbackIdx * seqStride, raw);
-            writeTarget(raw, g_framesRaw ? TGT_RAW : TGT_BAKED);
-            uint32_t nxt = playbackIdx + 1;
-            if (nxt >= seqCount) {
-                if (playbackLoop) {
+// Frame `idx` of the selected sequence. M6P3 decodes in stream order — one
+// frame of Rice codes, bounded — and seeks through the block index on a jump
+// (loop wrap, lead, restart), so flash reads stay ~1 byte/sample.
+static inline void readSeqFrame(uint32_t idx, float raw[6]) {
+    if (g_seqPacked) m6p3_read(&seqDec, idx, raw);
+    else             decodeSeqFrame(seqSamples + (size_t)idx * seqStride, raw);
+}
+
+// ── Lookahead (zero-phase) cueing + lag compensation for DEMO ─────────
+// The sequence is known in advance, so instead of the causal input biquad
+// (which lags motion by its group delay) M6P2 frames get a symmetric FIR over
+// a fixed ±H frame window (lookahead6.h) read H frames AHEAD of the playhead:
+// zero phase, no added latency (the window is primed straight from flash).
+// CueTask then runs only MCA + output stage (TGT_RAW_ZP) and interpolates to
+// the next filtered frame, which is known too. PLAY:LEAD shifts the whole
+// read position forward so demo motion leads the recorded telemetry by the
+// residual lag of the washout/tilt stage and the servos. Baked M6P1 frames
+// are already cued: they skip the FIR (H = 0) but still honor the lead.
+// Off by default: PLAY:ZP=fc opts in, and is refused when the ±16-frame
+// window cannot reach fc at the sequence rate (PLAY:ZP? reports the cutoff
+// actually achieved and the FIR group delay that is read ahead).
+#define ZP_FC_DEFAULT_HZ   0.0f
+#define ZP_FC_TOL          0.10f                       // achieved fc within ±10 % of the request
+#define PLAY_LEAD_MAX_MS   500
+static volatile float    zpFcHz       = ZP_FC_DEFAULT_HZ;   // 0 = off (causal input filter)
+static volatile int      playLeadMs   = 0;
+static volatile bool     zpReprime    = true;    // redesign + refill the window
+static Lookahead6        zpWin;                   // CueTask-owned
+static volatile uint32_t zpCycAvg     = 0;        // FIR cycles per frame (EMA)
+static volatile uint32_t zpCycMax     = 0;
+
+// Next frame index in play order (wraps to the loop point, else holds the end).
+static inline uint32_t seqNext(uint32_t idx) {
+    if (idx + 1 < seqCount) return idx + 1;
+    return playbackLoop ? seqLoopPoint : seqCount - 1;
+}
+
+// `k` frames on in play order, in one step (SYNC:* playhead jumps).
+static inline uint32_t seqAdvance(uint32_t idx, uint32_t k) {
+    if ((uint64_t)idx + k < seqCount) return idx + k;
+    if (!playbackLoop || seqLoopPoint >= seqCount) return seqCount - 1;
+    const uint32_t r = k - (seqCount - idx);             // steps left once at the loop point
+    return seqLoopPoint + r % (seqCount - seqLoopPoint);
+}
+
+static inline bool zpActive() { return g_framesRaw && zpFcHz > 0.0f; }
+
+// ── DEMO playback sampler (runs inside CueTask) ───────────────────────
+// No producer task: CueTask samples the sequence itself every tick with an
+// integer phase accumulator — phase += rate × speed (Q8) × the tick's real
+// period in ms, one file frame per PLAY_PHASE_ONE (1000 << 8) — so playback
+// follows wall time at any SERVO:RATE, including rates the 1 kHz FreeRTOS
+// tick can't hit exactly (60 Hz runs a 16 ms period): every frame is
+// consumed once, none dropped or repeated, and the output is interpolated
+// between the two frames around the playhead.
+// PLAY:SEEK re-primes the window at the new index: direct for M6P1/M6P2, via
+// the block index for M6P3 (≤ one block of decode). Lead is in wall time, so
+// its frame count follows the speed at (re)prime.
+#define PLAY_SPEED_Q       8                 // playSpeedQ8: 256 = 1×
+#define PLAY_SPEED_MIN     0.25f
+#define PLAY_SPEED_MAX     4.0f
+#define PLAY_PHASE_ONE     (1000u << PLAY_SPEED_Q)   // one file frame: ms × Q8
+static volatile uint16_t playSpeedQ8    = 1u << PLAY_SPEED_Q;
+static volatile bool     playbackPaused = false;
+static volatile bool     playbackDone   = false;  // CueTask -> main loop: print PLAY:DONE
+static volatile float    playFrac       = 0.0f;   // playhead past playbackIdx, [0,1)
+// CueTask-owned sampler state.
+static uint32_t playPhase  = 0;        // fraction of a frame, in 1/PLAY_PHASE_ONE
+static uint16_t playRate   = 50;
+static uint32_t playReadIdx = 0;       // next file frame to push into the window
+static float    playCur[6], playNxt[6], playOut[6];
+static int      playFmt    = TGT_BAKED;
+// SYNC:* playhead anchor: frame syncAnchorIdx plays at host syncAnchorHost.
+static uint32_t syncAnchorIdx  = 0;
+static int64_t  syncAnchorHost = 0;
+static bool     syncAnchorHold = false;
+static uint32_t syncHave       = 0;    // whole frames played since the anchor
+static int32_t  syncTrim       = 0;    // phase increment trim, 1/PLAY_PHASE_ONE per tick
+static bool     syncCueReset   = false;  // -> cueTick: reset cueMca / cueInputFilter
+
+static inline void lerp6(const float a[6], const float b[6], float u, float out[6]) {
+    for (int i = 0; i < 6; i++) out[i] = a[i] + (b[i] - a[i]) * u;
+}
+
+static inline float playSpeed() { return (float)playSpeedQ8 / (1u << PLAY_SPEED_Q); }
+
+// Slide the window one file frame: cur <- nxt, nxt <- next filtered frame.
+static void slideWindow() {
+    float frame[6];
+    memcpy(playCur, playNxt, sizeof(playCur));
+    uint32_t c0 = esp_cpu_get_cycle_count();
+    readSeqFrame(playReadIdx, frame);
+    lookahead6_push(&zpWin, frame);
+    lookahead6_output(&zpWin, playNxt);
+    uint32_t cyc = esp_cpu_get_cycle_count() - c0;
+    playReadIdx = seqNext(playReadIdx);
+    zpCycAvg = zpCycAvg - (zpCycAvg >> 4) + (cyc >> 4);
+    if (cyc > zpCycMax) zpCycMax = cyc;
+}
+
+// (Re)started, seeked or new sequence: center the window on playhead + lead
+// — hold the first frame for the past half and read H frames ahead of it.
+static void primeWindow() {
+    float frame[6];
+    playRate = seqRateHz ? seqRateHz : 50;
+    lookahead6_design(&zpWin, zpActive() ? zpFcHz : 0.0f, (float)playRate);
+    uint32_t lead = (uint32_t)((float)playLeadMs * playRate * playSpeed() / 1000.0f);
+    uint32_t base = playbackIdx;
+    for (uint32_t k = 0; k < lead; k++) base = seqNext(base);
+    readSeqFrame(base, frame);
+    lookahead6_fill(&zpWin, frame);
+    playReadIdx = seqNext(base);
+    for (int k = 0; k < lookahead6_delay(&zpWin); k++) {
+        readSeqFrame(playReadIdx, frame);
+        lookahead6_push(&zpWin, frame);
+        playReadIdx = seqNext(playReadIdx);
+    }
+    lookahead6_output(&zpWin, playNxt);
+    slideWindow();                           // cur = playhead, nxt = +1
+    playPhase = 0;
+}
+
+// Put the playhead `want` frames past the anchor (anchor due, or a step).
+static void syncJump(double want) {
+    const uint32_t k = (uint32_t)want;
+    playbackIdx = seqAdvance(syncAnchorIdx, k);
+    primeWindow();
+    playPhase  = (uint32_t)((want - k) * (double)PLAY_PHASE_ONE);
+    syncHave   = k;
+    syncCueReset = true;                   // a jump, like PLAY:SEEK: reset the washout
+}
+
+// SYNC:ON playhead, once per tick before the sample: take a new anchor from
+// the command task, start it when due, then keep the playhead on host time —
+// a rate trim within ±SYNC_SLEW_MAX, or a jump past SYNC_STEP_MS. Returns
+// true to hold the current frame (SOURCE:DEMO@ before its start time).
+static bool syncPlayhead(uint32_t tickMs) {
+    syncTrim = 0;
+    if (!syncAnchorCmd && !syncAnchorState) return false;   // SYNC off: no lock taken
+    taskENTER_CRITICAL(&g_syncMux);
+    const uint8_t cmd = syncAnchorCmd;
+    syncAnchorCmd = 0;
+    if (cmd == SYNC_ANCHOR_SET) {
+        syncAnchorIdx  = syncReqIdx;
+        syncAnchorHost = syncReqHost;
+        syncAnchorHold = syncReqHold;
+    }
+    taskEXIT_CRITICAL(&g_syncMux);
+    if (cmd) syncAnchorState = cmd == SYNC_ANCHOR_SET ? 1 : 0;
+    if (!syncAnchorState) return false;
+
+    ClockSyncModel m;
+    if (!syncOn || playbackPaused || !syncModel(&m)) { syncAnchorState = 0; return false; }
+    const double fps  = (double)playRate * playSpeed();
+    const double want = (double)(clocksync_to_host(&m, esp_timer_get_time()) - syncAnchorHost) * 1e-6 * fps;
+    if (syncAnchorState == 1) {
+        if (want < 0.0) return syncAnchorHold;
+        syncJump(want);
+        syncAnchorState = 2;
+        syncPlayErrUs   = 0.0f;
+        return false;
+    }
+    const uint32_t den = PLAY_PHASE_ONE;
+    double err = want - ((double)syncHave + (double)playPhase / den);   // frames, > 0: behind
+    if (fabs(err) * 1000.0 > SYNC_STEP_MS * fps) {
+        syncJump(want);
+        syncSteps++;
+        err = 0.0;
+    }
+    const float errUs = (float)(err * 1e6 / fps);
+    syncPlayErrUs = errUs;
+    syncPlayRmsUs = sqrtf(0.95f * syncPlayRmsUs * syncPlayRmsUs + 0.05f * errUs * errUs);
+    const double lim = (double)playRate * playSpeedQ8 * tickMs * SYNC_SLEW_MAX;
+    double trim = err * den * tickMs / (SYNC_SLEW_TAU_S * 1000.0);
+    if (trim >  lim) trim =  lim;
+    if (trim < -lim) trim = -lim;
+    syncTrim = (int32_t)trim;
+    return false;
+}
+
+// Sample the playhead for one CueTask tick of `tickMs` (raw M6P2 ->
+// TGT_RAW_ZP via the lookahead FIR, or TGT_RAW so CueTask cues it causally;
+// baked M6P1 -> TGT_BAKED). Never blocks: while PLAY:SELECT / an upload
+// rescan / PLAY:BENCH holds g_seqMutex it repeats the last sample. Returns
+// false when nothing is playing, so CueTask falls back to the shared target.
+static bool playbackSample(uint32_t tickMs, float out[6], int* fmt) {
+    if (!playbackActive) return false;
+    if (xSemaphoreTake(g_seqMutex, 0) != pdTRUE) {
+        memcpy(out, playOut, sizeof(playOut));
+        *fmt = playFmt;
+        return true;
+    }
+    bool ok = playbackActive && seqSamples && seqCount;
+    if (ok) {
+        if (zpReprime) {
+            zpReprime = false;
+            primeWindow();
+        }
+        const bool hold = syncPlayhead(tickMs);
+        const uint32_t den = PLAY_PHASE_ONE;
+        lerp6(playCur, playNxt, (float)playPhase / (float)den, playOut);
+        playFmt = zpActive() ? TGT_RAW_ZP : (g_framesRaw ? TGT_RAW : TGT_BAKED);
+        if (!playbackPaused && !hold) {
+            playPhase += (uint32_t)((int32_t)(playRate * playSpeedQ8 * tickMs) + syncTrim);
+            while (playPhase >= den) {
+                playPhase -= den;
+                uint32_t nxt = playbackIdx + 1;
+                if (nxt >= seqCount) {
+                    if (!playbackLoop) {
+                        playbackActive = false;
+                        zpReprime    = true;
+                        playbackIdx  = 0;
+                        playPhase    = 0;
+                        playbackDone = true;
+                        syncAnchorState = 0;
+                        break;
+                    }
                     nxt = seqLoopPoint;
-                } else {
-                    playbackActive = false;
-                    nxt = 0;
-                    serial_printf("PLAY:DONE\r\n");
                 }
+                playbackIdx = nxt;
+                syncHave++;
+                slideWindow();
             }
-            playbackIdx = nxt;
         }
-        vTaskDelayUntil(&last, period);
+        playFrac = (float)playPhase / (float)den;
+    }
+    xSemaphoreGive(g_seqMutex);
+    if (!ok) return false;
+    memcpy(out, playOut, sizeof(playOut));
+    *fmt = playFmt;
+    lastPacketTimeUs = esp_timer_get_time();   // playback counts as input (watchdog)
+    watchdogTripped  = false;
+    return true;
+}
+
+// Switch playback to library entry `n` (header + CRC were checked at boot).
+// Stops playback; the caller restarts it (setSource(SRC_DEMO)) if wanted.
+static bool selectSequence(int n) {
+    const SeqEntry* e = seq_library_entry(n);
+    if (!e || e->status != M6P_OK) return false;
+    xSemaphoreTake(g_seqMutex, portMAX_DELAY);
+    playbackActive = false;
+    const uint8_t* h = seq_library_map(n);
+    if (h) {
+        // .m6p header (64 bytes) — layout + parser in m6p.h. M6P1 = baked
+        // 6×uint16 (g_framesRaw=false); M6P2 = raw pre-cue 6×float32, app axis
+        // order, CueTask swaps after cueing (g_framesRaw=true). M6P3 packs
+        // either one; seqDec decodes it in place from the mapping (m6p3.h).
+        seqRateHz    = e->info.rate;
+        seqCount     = e->info.count;
+        seqLoopPoint = e->info.loop_point;
+        seqBits      = e->info.bits;
+        seqStride    = e->info.stride;
+        g_framesRaw  = (e->info.kind == M6P_KIND_RAW);
+        g_seqPacked  = e->info.packed;
+        seqSamples   = h + M6P_HEADER_SIZE;
+        seqSelected  = n;
+        if (g_seqPacked && m6p3_init(&seqDec, h, &e->info) != M6P_OK) {
+            seqSamples  = nullptr;
+            seqCount    = 0;
+            seqSelected = -1;
+            h = nullptr;
+        }
+    } else {
+        seqSamples  = nullptr;
+        seqCount    = 0;
+        seqSelected = -1;
+    }
+    playbackIdx = 0;
+    zpReprime   = true;
+    xSemaphoreGive(g_seqMutex);
+    return h != nullptr;
+}
+
+// ── Sequence upload hooks (SeqUpload.h, COBS_CH_UPLOAD) ──────────────
+// Erases/writes turn the flash cache off on both cores, stalling CueTask for
+// tens of ms at a time — park the rig for the duration of an upload.
+static void onUploadBegin() {
+    if (g_source != SRC_OFF) {
+        setSource(SRC_OFF);
+        serial_printf("PLAY:UPLOAD begin -> SOURCE:OFF\r\n");
+    }
+}
+
+// A file was committed to the directory (upload / recording). The rescan
+// unmaps the current entry, so it runs with playback detached under
+// g_seqMutex; existing indexes don't move (append-only), so the previous
+// selection is simply mapped again and DEMO restarted on it, as
+// PLAY:SELECT does. Returns the library entry count.
+static int reloadLibrary() {
+    int prev = seqSelected;
+    xSemaphoreTake(g_seqMutex, portMAX_DELAY);
+    playbackActive = false;
+    seqSamples = nullptr;
+    seqCount   = 0;
+    int n = seq_library_rescan();
+    xSemaphoreGive(g_seqMutex);
+    if (!selectSequence(prev)) selectSequence(n - 1);
+    if (g_source == SRC_DEMO) setSource(SRC_DEMO);
+    return n;
+}
+
+// UploadTask: a verified file was committed to directory slot `slot`.
+// Returns the new entry's library index.
+static int onUploadDone(int slot) {
+    int n = reloadLibrary();
+    SeqUploadStatus st;
+    seq_upload_status(&st);
+    const SeqEntry* e = seq_library_entry(n - 1);
+    serial_printf("PLAY:UPLOAD done #%d slot=%d \"%s\" %lu bytes %s (%lu B/s)\r\n",
+        n - 1, slot, e ? e->info.name : "?", (unsigned long)st.length,
+        e ? m6p_strerror(e->status) : "?", (unsigned long)st.bytesPerSec);
+    return n - 1;
+}
+
+// ── Recording (SeqRecord.h, REC:*) ───────────────────────────────────
+// CueTask samples the LIVE target at recRateHz with the same kind of phase
+// accumulator playback uses and pushes it into SeqRecord's ring; only
+// CH_DATA (TGT_BAKED -> M6P1) and CH_DATA_RAW (TGT_RAW -> M6P2) frames that
+// are fresh are taken, so idle gaps aren't recorded.
+static volatile uint16_t recRateHz = 50;
+
+// RecordTask, before each erase unit of REC:START's reservation: like an
+// upload, erases only run with the rig parked, never under live motion.
+static bool recParked() { return g_source == SRC_OFF; }
+
+static bool recArming() {
+    SeqRecordStatus rs;
+    seq_record_status(&rs);
+    return rs.state == SEQ_REC_ARMING;
+}
+
+// RecordTask: the take was committed to directory slot `slot`.
+static int onRecordDone(int slot) {
+    int n = reloadLibrary();
+    const SeqEntry* e = seq_library_entry(n - 1);
+    SeqRecordStatus st;
+    seq_record_status(&st);
+    serial_printf("REC:DONE #%d slot=%d \"%s\" %s %lu frames @ %uHz (%.1fs) dropped=%lu %s\r\n",
+        n - 1, slot, e ? e->info.name : "?", st.kind == M6P_KIND_RAW ? "M6P2" : "M6P1",
+        (unsigned long)(e ? e->info.count : 0), (unsigned)st.rate,
+        e ? (double)e->info.count / st.rate : 0.0, (unsigned long)st.dropped,
+        e ? m6p_strerror(e->status) : "?");
+    return n - 1;
+}
+
+static Scope g_scope;       // SCOPE:* capture ring (only CueTask writes it)
+
+// SCOPE:DUMP — stream the frozen capture on COBS_CH_SCOPE (layout in
+// scope.h). Runs on the command task; CueTask leaves the ring alone in DONE.
+static void scopeDump() {
+    const uint32_t count = scope_count(&g_scope);
+    const ScopeTrigger* t = &g_scope.trig;
+    uint8_t hdr[SCOPE_HDR_SIZE];
+    hdr[0] = SCOPE_OP_HDR;
+    hdr[1] = 1;
+    m6p_wr16(hdr + 2, (uint16_t)sizeof(ScopeSample));
+    m6p_wr16(hdr + 4, (uint16_t)count);
+    m6p_wr16(hdr + 6, (uint16_t)scope_trigger_index(&g_scope));
+    m6p_wr16(hdr + 8, (uint16_t)servoRateHz);
+    hdr[10] = t->type; hdr[11] = t->field; hdr[12] = t->axis; hdr[13] = t->edge;
+    memcpy(hdr + 14, &t->level, 4);
+    cobs_send(COBS_CH_SCOPE, hdr, sizeof(hdr));
+
+    uint8_t frame[3 + SCOPE_DUMP_BATCH * sizeof(ScopeSample)];
+    uint32_t crc = 0;
+    for (uint32_t i = 0; i < count; i += SCOPE_DUMP_BATCH) {
+        uint32_t k = count - i < SCOPE_DUMP_BATCH ? count - i : SCOPE_DUMP_BATCH;
+        frame[0] = SCOPE_OP_DATA;
+        m6p_wr16(frame + 1, (uint16_t)i);
+        for (uint32_t j = 0; j < k; j++)
+            memcpy(frame + 3 + j * sizeof(ScopeSample), scope_get(&g_scope, i + j), sizeof(ScopeSample));
+        crc = m6p_crc32_update(crc, frame + 3, k * sizeof(ScopeSample));
+        cobs_send(COBS_CH_SCOPE, frame, 3 + (int)(k * sizeof(ScopeSample)));
     }
+
+    uint8_t end[7] = { SCOPE_OP_END };
+    m6p_wr16(end + 1, (uint16_t)count);
+    m6p_wr32(end + 3, crc);
+    cobs_send(COBS_CH_SCOPE, end, sizeof(end));
 }
 
 // ── CueTask — fixed-rate consumer (SOLE servo writer) ────────────────
 // MCU_HIFI_CUEING.md "DECISIONS APPLIED" hold-only variant: reads the freshest
-// sample (zero-order hold), runs the cue chain for RAW frames, maps to
-// position, per-time slews, IK, writes servos — all at cueLoopHz (== servoRateHz).
-static void CueTask(void* pv) {
-    (void)pv;
-    // Retune biquads to the loop rate up front (FIX TRAP A).
-    applyServoRate(servoRateHz);
-    uint16_t curRate = servoRateHz;
-    TickType_t period = pdMS_TO_TICKS(1000 / curRate);
-    if (period < 1) period = 1;
-    TickType_t last = xTaskGetTickCount();
+// sample (zero-order hold) — or, in DEMO, samples the sequence itself
+// (playbackSample) — runs the cue chain for RAW frames, maps to position,
+// per-time slews, IK, writes servos — all at cueLoopHz (== servoRateHz).
+// Config comes from the newest published CueConfig, adopted once per tick.
+static MotionCueingConfig cueMca;           // CueTask-owned working filters
+static InputFilterConfig  cueInputFilter;   // (state lives here, not in staging)
+
+// Loop state carried from one tick to the next.
+typedef struct {
+    const CueConfig* cfg;
+    uint32_t   filterGen;
+    uint32_t   mcaEditSeq;    // MCA edits applied to cueMca
+    uint16_t   curRate;
+    uint32_t   recPhase;      // REC:* sampler, rate × ms (1000 = one frame)
+    uint32_t   tick;
+    uint16_t   telCount;      // TEL2 divider
+    int64_t    lastPhysTs;    // BLE accel latency: first tick per packet
+    uint32_t   seenImuGen;    // ACCEL:MODE=RAW fusion restart
+    int64_t    lastStartUs;
+    TickType_t period;
+    int8_t     slew;          // SYNC:ON: ticks added to the next delay (±1)
+} CueLoop;
+
+static void cueLoopInit(CueLoop* L) {
+    // app_main already ran applyServoRate() (FIX TRAP A) and published.
+    L->cfg         = acquireConfig();
+    L->filterGen   = L->cfg->filterGen - 1;   // force adoption on the first tick
+    L->mcaEditSeq  = L->cfg->mcaEditSeq;
+    L->curRate     = 0;
+    L->recPhase    = 0;
+    L->tick        = 0;
+    L->telCount    = 0;
+    L->lastPhysTs  = 0;
+    L->seenImuGen  = imuGen - 1;
+    L->lastStartUs = 0;
+    L->period      = 1;
+    L->slew        = 0;
+}
 
-    for (;;) {
-        // Pick up a runtime servo-rate change (SERVO:RATE / SERVO:MODE).
-        if (servoRateHz != curRate) {
-            curRate = servoRateHz;
-            period  = pdMS_TO_TICKS(1000 / curRate);
-            if (period < 1) period = 1;
+// One tick: everything CueTask does between two vTaskDelayUntil() calls.
+static void cueTick(CueLoop* L) {
+    // Adopt the newest snapshot (one atomic exchange, never blocks).
+    L->cfg = acquireConfig();
+    if (L->cfg->filterGen != L->filterGen ||
+        L->cfg->mcaEditSeq - L->mcaEditSeq > MCA_EDIT_RING / 2) {
+        L->filterGen   = L->cfg->filterGen;
+        L->mcaEditSeq  = L->cfg->mcaEditSeq;    // the snapshot has them all
+        cueMca         = L->cfg->mca;           // retuned + reset in one step
+        cueInputFilter = L->cfg->inputFilter;
+    }
+    while (L->mcaEditSeq != L->cfg->mcaEditSeq)  // parameter edits, filter state kept
+        mcaApplyEdit(&cueMca, &g_mcaEdits[L->mcaEditSeq++ % MCA_EDIT_RING]);
+    // Pick up a runtime servo-rate change (SERVO:RATE / SERVO:MODE).
+    if (L->cfg->rateHz != L->curRate) {
+        L->curRate = L->cfg->rateHz;
+        L->period  = pdMS_TO_TICKS(1000 / L->curRate);
+        if (L->period < 1) L->period = 1;
+    }
+    const float dt = 1.0f / (float)L->curRate;
+    const int64_t startUs = esp_timer_get_time();
+    const bool overrun = L->lastStartUs &&
+        (startUs - L->lastStartUs) * 2 > (int64_t)L->period * portTICK_PERIOD_MS * 1000 * 3;
+    L->lastStartUs = startUs;
+    L->slew = syncOn ? (int8_t)syncTickSlew(L->period, startUs) : 0;
+
+    // DEMO samples the sequence right here (phase accumulator); every
+    // other source reads the freshest producer sample.
+    float ch[6]; int64_t ts; int fmt;
+    const bool demo = g_source == SRC_DEMO &&
+                      playbackSample((uint32_t)L->period * portTICK_PERIOD_MS, ch, &fmt);
+    if (demo) {
+        ts = esp_timer_get_time();
+        if (syncCueReset) {                   // SYNC:* playhead jump
+            syncCueReset   = false;
+            cueMca         = L->cfg->mca;
+            cueInputFilter = L->cfg->inputFilter;
         }
-        const float dt = 1.0f / (float)curRate;
-
-        float ch[6]; int64_t ts; int fmt;
+    } else {
+        releaseTimedTargets(startUs);
         readTarget(ch, &ts, &fmt);
-        int64_t age = esp_timer_get_time() - ts;
-
-        float pos[6];
-        if (g_source == SRC_OFF) {
-            // Gated: home and ignore incoming motion (one-tap kill).
-            for (int i = 0; i < 6; i++) pos[i] = 0.0f;
-        } else if (age > (int64_t)CUE_LOST_DECAY_MS * 1000) {
-            // Lost: decay toward home so we never park at a stale tilt.
-            for (int i = 0; i < 6; i++) pos[i] = 0.0f;
-        } else if (fmt == TGT_RAW) {
-            // RAW = pre-cue telemetry in APP axis order (surge=0, sway=1), no
-            // wire swap. Run the cue chain in app order (the washout/tilt engine
-            // is defined in app order), THEN swap surge<->sway into device order
-            // before scaling/IK — the swap the baked wire already carried.
-            float f[6], m[6], o[6];
-            processInputFilter(&inputFilter, ch, f);
-            processMotionCueing(&mcaConfig, f, m);
-            mcaApplyOutputStage(&mcaConfig, m, o);
-            float tmp = o[0]; o[0] = o[1]; o[1] = tmp;   // surge<->sway (app->device)
-            // RAW = signed PERCENT (pre-cue telemetry). mapRawToPosition expects the
-            // COUNT domain [0..max_raw] centered at home, so convert first per the
-            // pinned contract: counts = home*(1 + pct/100)  =>  ±100% spans 0..max_raw
-            // and the mapping yields position = scale*(pct/100). Feeding raw percent
-            // straight in (the previous code) sits ~0 counts << home and rails the
-            // output — decoupled from input. Bug found on the first live stream.
-            float home = (float)((int)maxRawInput / 2);
-            float counts[6];
-            for (int i = 0; i < 6; i++) counts[i] = home * (1.0f + o[i] * 0.01f);
-            mapRawToPosition(counts, &axisScales, maxRawInput, pos);
-        } else if (fmt == TGT_PHYS) {
-            for (int i = 0; i < 6; i++) pos[i] = ch[i];
-        } else { // TGT_BAKED
-            mapRawToPosition(ch, &axisScales, maxRawInput, pos);
+    }
+    int64_t age = esp_timer_get_time() - ts;
+
+    // One tick record (ScopeSample) feeds both the scope and TEL2, so a
+    // telemetry sample is always a single consistent tick.
+    const bool scoping = scope_active(&g_scope);
+    const uint8_t telMask = tel2Mask;
+    const bool telDue = telMask && ++L->telCount >= tel2Div;
+    if (telDue) L->telCount = 0;
+#ifdef ENABLE_BLE
+    const uint8_t bleMask = ble_transport_tel_mask();   // BleTelTask decimates per client
+#else
+    const uint8_t bleMask = 0;
+#endif
+    const bool timed   = telDue || bleMask;
+    const bool capture = scoping || timed;
+
+    // filt / counts are kept for the record (the same math cueRawFrame
+    // does, split at the input filter).
+    float pos[6], filt[6], counts[6];
+    memcpy(filt, ch, sizeof(filt));
+    memcpy(counts, ch, sizeof(counts));
+    bool stale = false;
+    if (g_source == SRC_OFF) {
+        // Gated: home and ignore incoming motion (one-tap kill).
+        for (int i = 0; i < 6; i++) pos[i] = 0.0f;
+    } else if (age > (int64_t)CUE_LOST_DECAY_MS * 1000) {
+        // Lost: decay toward home so we never park at a stale tilt.
+        for (int i = 0; i < 6; i++) pos[i] = 0.0f;
+        stale = true;
+        if (fmt == TGT_IMU) imu_fusion_reset(&g_imu);   // re-seed when the stream resumes
+    } else if (fmt == TGT_RAW) {
+        // RAW = pre-cue percent, app axis order: cue chain -> surge/sway swap
+        // -> count domain (cueRawFrame, MiniPlatform.h) -> position.
+        processInputFilter(&cueInputFilter, ch, filt);
+        cueFilteredFrame(&cueMca, filt, L->cfg->maxRawInput, counts);
+        mapRawToPosition(counts, &L->cfg->scales, L->cfg->maxRawInput, pos);
+    } else if (fmt == TGT_RAW_ZP) {
+        // Input filter already applied (zero-phase, playback lookahead).
+        cueFilteredFrame(&cueMca, ch, L->cfg->maxRawInput, counts);
+        mapRawToPosition(counts, &L->cfg->scales, L->cfg->maxRawInput, pos);
+    } else if (fmt == TGT_PHYS) {
+        for (int i = 0; i < 6; i++) pos[i] = ch[i];
+    } else if (fmt == TGT_IMU) {
+        // Raw IMU: one fusion step per tick on the freshest sample (ZOH
+        // between packets), then the FUSED-mode map/gain. filt = fused
+        // [roll°, pitch°, yaw°, lin ax, ay, az].
+        if (imuGen != L->seenImuGen) {
+            L->seenImuGen = imuGen;
+            imu_fusion_reset(&g_imu);
         }
+        imu_fusion_update(&g_imu, &imuConfig, &ch[0], &ch[3], dt);
+        imu_fusion_euler_deg(&g_imu, &filt[0]);
+        imu_fusion_linear(&g_imu, &ch[0], &filt[3]);
+        accelToPhys(filt, pos);
+        memcpy(counts, pos, sizeof(counts));
+    } else { // TGT_BAKED
+        mapRawToPosition(ch, &L->cfg->scales, L->cfg->maxRawInput, pos);
+    }
+
+    const int64_t cueEndUs = timed ? esp_timer_get_time() : 0;
+
+    // SCOPE:* (every tick while armed) / TEL2 (every tel2Div ticks).
+    ScopeSample sc;
+    if (capture) {
+        sc.tick  = L->tick;
+        sc.flags = (overrun ? SCOPE_F_OVERRUN : 0) | (stale ? SCOPE_F_STALE : 0) |
+                   (watchdogTripped ? SCOPE_F_WDT : 0) | (g_source == SRC_OFF ? SCOPE_F_OFF : 0);
+        sc.fmt   = (uint8_t)fmt;
+        sc.src   = (uint8_t)g_source;
+        memcpy(sc.in, ch, sizeof(sc.in));
+        memcpy(sc.filt, filt, sizeof(sc.filt));
+        memcpy(sc.cued, counts, sizeof(sc.cued));
+    }
 
-        for (int i = 0; i < 6; i++) arr[i] = pos[i];   // telemetry snapshot
-        driveServos(pos, dt);
-        vTaskDelayUntil(&last, period);
+    for (int i = 0; i < 6; i++) arr[i] = pos[i];   // telemetry snapshot
+    driveServos(L->cfg, pos, dt, capture ? &sc : NULL);
+    if (demo && !g_bootUs[BOOT_MOTION]) bootMark(BOOT_MOTION);
+    if (scoping) scope_push(&g_scope, &sc);
+    if ((fmt == TGT_PHYS || fmt == TGT_IMU) && ts != L->lastPhysTs && inputMode == INPUT_BLE_ACCEL) {
+        // BLE accel packet -> first servo write that carries it.
+        L->lastPhysTs = ts;
+        uint32_t lat = (uint32_t)(esp_timer_get_time() - ts);
+        accelLatAvgUs = accelLatAvgUs ? accelLatAvgUs - (accelLatAvgUs >> 4) + (lat >> 4) : lat;
+        if (lat > accelLatMaxUs) accelLatMaxUs = lat;
+    }
+    if (timed) {
+        const int64_t endUs = esp_timer_get_time();
+        Tel2Extra x;
+        x.cue_us   = (uint16_t)(cueEndUs - startUs);
+        x.drive_us = (uint16_t)(endUs - cueEndUs);
+        x.tick_us  = (uint16_t)(endUs - startUs);
+        x.age_us   = age > 0 ? (age > 0xFFFFFFFFLL ? 0xFFFFFFFFu : (uint32_t)age) : 0;
+        uint8_t buf[TEL2_MAX_SIZE];
+        if (telDue) tel_stream_push(buf, tel2_encode(buf, telMask, (uint32_t)startUs, &sc, &x));
+#ifdef ENABLE_BLE
+        if (bleMask) ble_transport_tel_push(buf, tel2_encode(buf, bleMask, (uint32_t)startUs, &sc, &x));
+#endif
+    }
+    L->tick++;
+
+    // REC:* — after the servo write, so RecordTask's page program (kicked
+    // here) overlaps this task's sleep, not its tick.
+    if (seq_record_capturing()) {
+        L->recPhase += recRateHz * ((uint32_t)L->period * portTICK_PERIOD_MS);   // real period
+        while (L->recPhase >= 1000) {
+            L->recPhase -= 1000;
+            if (g_source == SRC_LIVE && age <= (int64_t)CUE_LOST_DECAY_MS * 1000 &&
+                (fmt == TGT_BAKED || fmt == TGT_RAW))
+                seq_record_push(ch, fmt == TGT_RAW ? M6P_KIND_RAW : M6P_KIND_BAKED);
+        }
+    }
+    seq_record_tick();
+}
+
+static void CueTask(void* pv) {
+    (void)pv;
+    CueLoop L;
+    cueLoopInit(&L);
+    TickType_t last = xTaskGetTickCount();
+    for (;;) {
+        cueTick(&L);
+        vTaskDelayUntil(&last, L.period + L.slew);
     }
 }
 
 // ── Source transitions ───────────────────────────────────────────────
 // Reset filter state on EVERY transition (DECISIONS r4 / task requirement) so
-// stale washout doesn't bleed across a mode change.
+// stale washout doesn't bleed across a mode change. The reset reaches CueTask
+// as a new filterGen in the published snapshot.
 static void setSource(Source s) {
     resetMotionCueing(&mcaConfig);
     resetInputFilter(&inputFilter);
+    playbackPaused = false;
+    syncAnchorClear();
 
     switch (s) {
         case SRC_OFF: {
@@ -698,6 +1593,7 @@ static void setSource(Source s) {
                     maxRawInput   = (float)((1 << seqBits) - 1);
                 }
                 playbackIdx    = 0;
+                zpReprime      = true;
                 playbackActive = true;
                 inputMode      = INPUT_PLAYBACK;
             }
@@ -709,6 +1605,7 @@ static void setSource(Source s) {
             break;
         }
     }
+    publishConfig(true);
     g_source = s;
 }
 
@@ -789,6 +1686,7 @@ void process_data(char* data) {
         if (bits >= 8 && bits <= 16) {
             inputBitRange = (uint8_t)bits;
             maxRawInput = (float)((1 << bits) - 1);
+            publishConfig(false);
             serial_printf("BITS:%d,max_raw=%.0f\r\n", inputBitRange, maxRawInput);
             saveConfigToNVS();
         } else {
@@ -814,7 +1712,8 @@ void process_data(char* data) {
             else if (strcmp(param, "theta_p") == 0) stewartConfig.theta_p = val;
             else { changed = false; serial_printf("CONFIG:ERR unknown key '%s'\r\n", param); }
             if (changed) {
-                computeAxisScalesFromGeometry(&axisScales, &stewartConfig, 0.90f);
+                computeAxisScalesFromGeometry(&axisScales, &stewartConfig, AXIS_SCALE_MARGIN);
+                publishConfig(false);   // geometry + scales land in CueTask together
                 serial_printf("CONFIG:OK %s=%.4f (scales recomputed)\r\n", param, val);
                 saveConfigToNVS();
             }
@@ -833,6 +1732,7 @@ void process_data(char* data) {
                     servoCenter[i] = vals[i];
                 }
             }
+            publishConfig(false);
             serial_printf("SERVO:CENTER=%d,%d,%d,%d,%d,%d\r\n",
                 servoCenter[0], servoCenter[1], servoCenter[2],
                 servoCenter[3], servoCenter[4], servoCenter[5]);
@@ -848,6 +1748,7 @@ void process_data(char* data) {
         float val = atof(data + 12);
         if (val > 0.0f && val < 10000.0f) {
             servoPulsePerRad = val;
+            publishConfig(false);
             serial_printf("SERVO:PULSE=%.1f\r\n", servoPulsePerRad);
             saveConfigToNVS();
         } else {
@@ -856,6 +1757,37 @@ void process_data(char* data) {
         return;
     }
 
+    // ── SERVO:DYN — servo dynamics model + lead compensation (servodyn.h) ─
+    // SERVO:DYN=<tau ms>,<vmax deg/s>,<lead 0-1.5>[,<servo 0-5>] (all if omitted)
+    // SERVO:DYN?   Persists in NVS. lead 0 = compensation off.
+    if (strcmp(data, "SERVO:DYN?") == 0) {
+        for (int i = 0; i < 6; i++)
+            serial_printf("SERVO:DYN servo=%d tau=%.1fms vmax=%.0fdeg/s lead=%.2f\r\n", i,
+                servoDyn[i].tau_s * 1000.0f, servoDyn[i].vmax * RAD_TO_DEG, servoDyn[i].lead);
+        return;
+    }
+    if (strncmp(data, "SERVO:DYN=", 10) == 0) {
+        float tauMs = 0, vmaxDps = 0, lead = 0; int servo = -1;
+        int n = sscanf(data + 10, "%f,%f,%f,%d", &tauMs, &vmaxDps, &lead, &servo);
+        if (n < 3 || tauMs < 0.0f || tauMs > 500.0f || vmaxDps <= 0.0f || vmaxDps > 5000.0f ||
+            lead < 0.0f || lead > SERVO_DYN_LEAD_MAX || (n == 4 && (servo < 0 || servo > 5))) {
+            serial_printf("ERR:SERVO:DYN=<tau 0-500ms>,<vmax deg/s>,<lead 0-%.1f>[,servo 0-5]\r\n",
+                          SERVO_DYN_LEAD_MAX);
+            return;
+        }
+        for (int i = 0; i < 6; i++) {
+            if (n == 4 && i != servo) continue;
+            servoDyn[i].tau_s = tauMs / 1000.0f;
+            servoDyn[i].vmax  = vmaxDps * DEG_TO_RAD;
+            servoDyn[i].lead  = lead;
+        }
+        publishConfig(false);
+        saveConfigToNVS();
+        if (n == 4) serial_printf("SERVO:DYN=%.1f,%.0f,%.2f servo=%d\r\n", tauMs, vmaxDps, lead, servo);
+        else        serial_printf("SERVO:DYN=%.1f,%.0f,%.2f servo=all\r\n", tauMs, vmaxDps, lead);
+        return;
+    }
+
     // ── TELRATE? — Query telemetry rate ────────────────────────────────
     if (strcmp(data, "TELRATE?") == 0) {
         serial_printf("TELRATE:%d\r\n", (int)(1000 / telemetryDelayMs));
@@ -876,6 +1808,99 @@ void process_data(char* data) {
         return;
     }
 
+    // ── TEL2:<mask>[,<div>] — CueTask-synchronous compact telemetry ───
+    // mask = TEL2_F_* groups (tel2.h): 1 in, 2 cue, 4 pose, 8 angle,
+    // 16 pulse, 32 timing, 64 age; 0 = off. One sample every <div> cue ticks
+    // on COBS_CH_TEL2. TEL2? — settings, bytes/sample, sent / dropped.
+    if (strcmp(data, "TEL2?") == 0) {
+        TelStreamStats ts;
+        tel_stream_stats(&ts);
+        const uint8_t m = tel2Mask;
+        const float hz = m ? (float)servoRateHz / tel2Div : 0.0f;
+        serial_printf("TEL2:mask=0x%02X div=%u rate=%.1fHz bytes=%u (%.1f KB/s) sent=%lu dropped=%lu "
+                      "queue=%lu/%d\r\n", m, (unsigned)tel2Div, hz, (unsigned)tel2_sizeof(m),
+                      hz * (tel2_sizeof(m) + 3) / 1024.0f, (unsigned long)ts.sent,
+                      (unsigned long)ts.dropped, (unsigned long)ts.peak, TEL_STREAM_DEPTH);
+        return;
+    }
+    if (strncmp(data, "TEL2:", 5) == 0) {
+        char* end;
+        long mask = strtol(data + 5, &end, 0);
+        long div  = *end == ',' ? strtol(end + 1, NULL, 10) : tel2Div;
+        if (mask < 0 || mask > TEL2_F_ALL || div < 1 || div > 250) {
+            serial_printf("ERR:TEL2 mask 0-0x%02X, div 1-250\r\n", TEL2_F_ALL);
+            return;
+        }
+        tel2Div  = (uint16_t)div;
+        tel_stream_reset_stats();
+        tel2Mask = (uint8_t)mask;
+        serial_printf("TEL2:mask=0x%02X div=%ld (%.1f Hz, %u B/sample)\r\n", (unsigned)mask, div,
+                      mask ? (double)servoRateHz / div : 0.0, (unsigned)tel2_sizeof((uint8_t)mask));
+        return;
+    }
+
+#ifdef ENABLE_BLE
+    // ── BLE:LINK? — PHY / data length / receive throughput per client ──
+    // Rates cover the window since the previous BLE:LINK? (each query resets).
+    // samples/event = samples per second × connection interval: > 1 only
+    // with batched writes.
+    if (strcmp(data, "BLE:LINK?") == 0) {
+        BleLinkStatus st[8];
+        int n = ble_transport_link_status(st, 8);
+        BleHostInfo hi;
+        ble_transport_host_info(&hi);
+        serial_printf("BLE:LINK %d client(s), %s, host=%s heap=%luB adv@%lums, timed drops=%lu\r\n", n,
+                      ble_transport_state_str(), hi.host, (unsigned long)hi.heap_used,
+                      (unsigned long)(hi.adv_ready_us / 1000), (unsigned long)timedDropped);
+        for (int i = 0; i < n; i++) {
+            const BleLinkStatus* l = &st[i];
+            double secs = l->window_us ? l->window_us / 1e6 : 1.0;
+            double sps  = l->samples / secs;
+            serial_printf("BLE:LINK conn=%u phy=%u/%u dle=%u/%u mtu=%u interval=%.2fms "
+                          "rx=%.2fKB/s writes=%.1f/s samples=%.1f/s per_event=%.2f bad=%lu\r\n",
+                          (unsigned)l->conn_id, (unsigned)l->tx_phy, (unsigned)l->rx_phy,
+                          (unsigned)l->tx_octets, (unsigned)l->rx_octets, (unsigned)l->mtu,
+                          l->interval_us / 1000.0, l->bytes / secs / 1024.0, l->writes / secs, sps,
+                          sps * l->interval_us / 1e6, (unsigned long)l->bad);
+        }
+        return;
+    }
+
+    // ── BLE:TEL — Batched TEL2 notifications per BLE client ──────────
+    // BLE:TEL=<mask>,<hz>[,<conn>] (all clients if no conn) | BLE:TEL?
+    // Clients can set their own by writing [mask, hz u16 LE] to 0xFF02.
+    if (strcmp(data, "BLE:TEL?") == 0) {
+        BleTelStatus st[8];
+        int n = ble_transport_tel_status(st, 8);
+        serial_printf("BLE:TEL %d client(s), %s\r\n", n, ble_transport_state_str());
+        for (int i = 0; i < n; i++) {
+            serial_printf("BLE:TEL conn=%u mtu=%u notify=%d%s mask=0x%02X rate=%uHz samples=%lu "
+                          "notifies=%lu (%.1f/notify) dropped=%lu\r\n",
+                          st[i].conn_id, st[i].mtu, st[i].notify, st[i].congested ? " congested" : "",
+                          st[i].mask, st[i].rate_hz, (unsigned long)st[i].samples,
+                          (unsigned long)st[i].notifies,
+                          st[i].notifies ? (double)st[i].samples / st[i].notifies : 0.0,
+                          (unsigned long)st[i].dropped);
+        }
+        return;
+    }
+    if (strncmp(data, "BLE:TEL=", 8) == 0) {
+        char* end;
+        long mask = strtol(data + 8, &end, 0);
+        long hz   = *end == ',' ? strtol(end + 1, &end, 10) : -1;   // conn -1 = all
+        long conn = *end == ',' ? strtol(end + 1, NULL, 10) : -1;
+        if (mask < 0 || mask > TEL2_F_ALL || hz < 0 || hz > BLE_TEL_MAX_HZ) {
+            serial_printf("ERR:BLE:TEL=<mask 0-0x%02X>,<hz 0-%d>[,conn]\r\n", TEL2_F_ALL, BLE_TEL_MAX_HZ);
+            return;
+        }
+        if (ble_transport_tel_config((int)conn, (uint8_t)mask, (uint16_t)hz))
+            serial_printf("BLE:TEL mask=0x%02X rate=%ldHz conn=%ld\r\n", (unsigned)mask, hz, conn);
+        else
+            serial_printf("ERR:BLE:TEL no such client\r\n");
+        return;
+    }
+#endif
+
     // ── MCA? — Query motion cueing config ──────────────────────────────
     if (strcmp(data, "MCA?") == 0) {
         serial_printf("MCA:preset=%s,enabled=%d,sr=%.0f\r\n",
@@ -891,33 +1916,83 @@ void process_data(char* data) {
     }
 
     // ── MCA:preset_name / granular cue-param setters ────────────────
+#define MCA_BENCH_MAX    20000     // MCA:BENCH ticks (~0.1 s of RX blocked at 240 MHz)
+#define MCA_BENCH_TRACE  512       // trace frames, cycled
     // Granular setters map to the shared stewart-core API + the new output
     // stage (intensity / per-axis gain / invert). Persist with MCA:SAVE
-    // (mcaSaveToNVS writes the whole shared struct blob).
+    // (staged; NvsSave runs mcaSaveToNVS, the whole shared struct blob).
     if (strncmp(data, "MCA:", 4) == 0) {
         const char* name = data + 4;
         if (strcmp(name, "SAVE") == 0) {
-            mcaSaveToNVS(&mcaConfig);
+            saveMcaToNVS();
             serial_printf("MCA:SAVED\r\n");
             return;
         }
         if (strcmp(name, "RESET") == 0) {
             resetMotionCueing(&mcaConfig);
             resetInputFilter(&inputFilter);
+            publishConfig(true);
             serial_printf("MCA:RESET\r\n");
             return;
         }
+        // ── MCA:BENCH[=N] — cycles/tick, live cue chain vs biquad6 SoA ──
+        // Runs N ticks of a synthetic trace through scratch COPIES of the
+        // live filters (CueTask state untouched), then through a biquad6
+        // cascade of 4 sections/axis (input LP + 2-section washout HP + tilt
+        // LP) at the same loop rate. biquad6 is not in the live chain; this
+        // only sizes what a port would save. The trace is generated before
+        // either timed loop; N is capped so the command task (RX dispatch)
+        // blocks for well under a second.
+        if (strncmp(name, "BENCH", 5) == 0) {
+            int n = (name[5] == '=') ? atoi(name + 6) : 1000;
+            if (n < 1) n = 1;
+            if (n > MCA_BENCH_MAX) n = MCA_BENCH_MAX;
+            static MotionCueingConfig benchMca;
+            static InputFilterConfig  benchIf;
+            static Biquad6            benchBq;
+            static float              trace[MCA_BENCH_TRACE][6];
+            benchMca = mcaConfig;
+            benchIf  = inputFilter;
+            const float fs = (float)servoRateHz;
+            biquad6_init(&benchBq, 4);
+            for (int a = 0; a < BIQUAD6_AXES; a++) {
+                biquad6_set_lowpass (&benchBq, 0, a, 8.0f, fs, 0.7071f);
+                biquad6_set_highpass(&benchBq, 1, a, 0.5f, fs, 0.5412f);
+                biquad6_set_highpass(&benchBq, 2, a, 0.5f, fs, 1.3066f);
+                biquad6_set_lowpass (&benchBq, 3, a, 3.0f, fs, 0.7071f);
+            }
+            for (int k = 0; k < MCA_BENCH_TRACE; k++)
+                for (int a = 0; a < 6; a++) trace[k][a] = 50.0f * sinf(0.01f * (float)k * (float)(a + 1));
+            float f[6], m[6], o[6];
+            float sink = 0.0f;
+            uint32_t c0 = esp_cpu_get_cycle_count();
+            for (int k = 0; k < n; k++) {
+                processInputFilter(&benchIf, trace[k % MCA_BENCH_TRACE], f);
+                processMotionCueing(&benchMca, f, m);
+                mcaApplyOutputStage(&benchMca, m, o);
+                sink += o[0];
+            }
+            uint32_t c1 = esp_cpu_get_cycle_count();
+            for (int k = 0; k < n; k++) {
+                biquad6_tick(&benchBq, trace[k % MCA_BENCH_TRACE], o);
+                sink += o[0];
+            }
+            uint32_t c2 = esp_cpu_get_cycle_count();
+            serial_printf("MCA:BENCH ticks=%d chain=%lu cyc/tick soa=%lu cyc/tick (chk=%.1f)\r\n",
+                n, (unsigned long)((c1 - c0) / (uint32_t)n), (unsigned long)((c2 - c1) / (uint32_t)n), sink);
+            return;
+        }
         // ── Output stage (v6) ──
         if (strncmp(name, "INTENSITY=", 10) == 0) {
             float v = atof(name + 10);
-            mcaSetIntensity(&mcaConfig, v);
+            mcaEdit(MCA_EDIT_INTENSITY, 0, v);
             serial_printf("MCA:INTENSITY=%.3f\r\n", mcaGetIntensity(&mcaConfig));
             return;
         }
         if (strncmp(name, "GAIN=", 5) == 0) {          // output-stage per-axis gain
             int ax; float v;
             if (sscanf(name + 5, "%d,%f", &ax, &v) == 2) {
-                mcaSetAxisGain(&mcaConfig, ax, v);
+                mcaEdit(MCA_EDIT_GAIN, ax, v);
                 serial_printf("MCA:GAIN[%d]=%.3f\r\n", ax, mcaGetAxisGain(&mcaConfig, ax));
             } else serial_printf("MCA:ERR GAIN=<axis>,<val>\r\n");
             return;
@@ -925,7 +2000,7 @@ void process_data(char* data) {
         if (strncmp(name, "INVERT=", 7) == 0) {
             int ax, v;
             if (sscanf(name + 7, "%d,%d", &ax, &v) == 2) {
-                mcaSetAxisInvert(&mcaConfig, ax, v);
+                mcaEdit(MCA_EDIT_INVERT, ax, (float)v);
                 serial_printf("MCA:INVERT[%d]=%d\r\n", ax, mcaGetAxisInvert(&mcaConfig, ax));
             } else serial_printf("MCA:ERR INVERT=<axis>,<0|1>\r\n");
             return;
@@ -934,7 +2009,7 @@ void process_data(char* data) {
         if (strncmp(name, "CHGAIN=", 7) == 0) {
             int ax; float v;
             if (sscanf(name + 7, "%d,%f", &ax, &v) == 2) {
-                mcaSetChannelGain(&mcaConfig, ax, v);
+                mcaEdit(MCA_EDIT_CHGAIN, ax, v);
                 serial_printf("MCA:CHGAIN[%d]=%.3f\r\n", ax, v);
             } else serial_printf("MCA:ERR CHGAIN=<axis>,<val>\r\n");
             return;
@@ -942,7 +2017,7 @@ void process_data(char* data) {
         if (strncmp(name, "HPFC=", 5) == 0) {
             int ax; float v;
             if (sscanf(name + 5, "%d,%f", &ax, &v) == 2) {
-                mcaSetChannelHpFc(&mcaConfig, ax, v);
+                mcaEdit(MCA_EDIT_HPFC, ax, v);
                 serial_printf("MCA:HPFC[%d]=%.3f\r\n", ax, v);
             } else serial_printf("MCA:ERR HPFC=<axis>,<fc>\r\n");
             return;
@@ -950,7 +2025,7 @@ void process_data(char* data) {
         if (strncmp(name, "LPFC=", 5) == 0) {
             int ax; float v;
             if (sscanf(name + 5, "%d,%f", &ax, &v) == 2) {
-                mcaSetChannelLpFc(&mcaConfig, ax, v);
+                mcaEdit(MCA_EDIT_LPFC, ax, v);
                 serial_printf("MCA:LPFC[%d]=%.3f\r\n", ax, v);
             } else serial_printf("MCA:ERR LPFC=<axis>,<fc>\r\n");
             return;
@@ -959,8 +2034,7 @@ void process_data(char* data) {
         if (strncmp(name, "TILT=", 5) == 0) {
             float sg, wg;
             if (sscanf(name + 5, "%f,%f", &sg, &wg) == 2) {
-                mcaSetTiltSurgeGain(&mcaConfig, sg);
-                mcaSetTiltSwayGain(&mcaConfig, wg);
+                mcaEdit(MCA_EDIT_TILT, 0, sg, wg);
                 serial_printf("MCA:TILT surge=%.3f sway=%.3f\r\n", sg, wg);
             } else serial_printf("MCA:ERR TILT=<surge>,<sway>\r\n");
             return;
@@ -971,6 +2045,7 @@ void process_data(char* data) {
         }
         if (found >= 0) {
             setMotionCueingPreset(&mcaConfig, found);
+            publishConfig(true);
             serial_printf("MCA:OK preset=%s enabled=%d\r\n", mcaPresetName(found), mcaConfig.enabled);
         } else {
             serial_printf("MCA:ERR unknown preset '%s' (off/gentle/moderate/aggressive/race_pro)\r\n", name);
@@ -986,8 +2061,47 @@ void process_data(char* data) {
         serial_printf("ACCEL:map=%d,%d,%d,%d,%d,%d\r\n",
             accelAxisMap[0], accelAxisMap[1], accelAxisMap[2],
             accelAxisMap[3], accelAxisMap[4], accelAxisMap[5]);
+#ifdef ENABLE_BLE
+        const char* bleState = ble_transport_state_str();
+#else
+        const char* bleState = "off";
+#endif
         serial_printf("ACCEL:mode=%d,packets=%lu,ble=%s\r\n",
-            (int)inputMode, accelPacketCount, ble_transport_state_str());
+            (int)inputMode, (unsigned long)accelPacketCount, bleState);
+        serial_printf("ACCEL:lat avg=%luus max=%luus (BLE write -> servo write)\r\n",
+            (unsigned long)accelLatAvgUs, (unsigned long)accelLatMaxUs);
+        accelLatMaxUs = 0;
+        if (accelMode == ACCEL_RAW) {
+            float rpy[3];
+            imu_fusion_euler_deg(&g_imu, rpy);
+            serial_printf("ACCEL:fusion=RAW beta=%.3f rpy=%.1f,%.1f,%.1f bias=%.4f,%.4f,%.4f still=%.1fs\r\n",
+                imuConfig.beta, rpy[0], rpy[1], rpy[2],
+                g_imu.bias[0], g_imu.bias[1], g_imu.bias[2], g_imu.still_s);
+        } else {
+            serial_printf("ACCEL:fusion=FUSED (phone)\r\n");
+        }
+        return;
+    }
+
+    // ── ACCEL:MODE=FUSED|RAW[,beta] — 0xFF03 payload / on-device fusion ──
+    // RAW restarts the fusion (attitude re-seeds from gravity, yaw = 0;
+    // the gyro bias estimate is kept).
+    if (strncmp(data, "ACCEL:MODE=", 11) == 0) {
+        const char* arg = data + 11;
+        const char* comma = strchr(arg, ',');
+        const size_t n = comma ? (size_t)(comma - arg) : strlen(arg);
+        int mode = -1;
+        if (n == 5 && strncmp(arg, "FUSED", 5) == 0) mode = ACCEL_FUSED;
+        if (n == 3 && strncmp(arg, "RAW", 3) == 0)   mode = ACCEL_RAW;
+        float beta = comma ? (float)atof(comma + 1) : imuConfig.beta;
+        if (mode < 0 || beta <= 0.0f || beta > 2.0f) {
+            serial_printf("ERR:ACCEL:MODE=FUSED|RAW[,beta 0-2]\r\n");
+            return;
+        }
+        imuConfig.beta = beta;
+        accelMode = mode;
+        imuGen++;
+        serial_printf("ACCEL:MODE=%s beta=%.3f\r\n", mode == ACCEL_RAW ? "RAW" : "FUSED", imuConfig.beta);
         return;
     }
 
@@ -1040,19 +2154,97 @@ void process_data(char* data) {
         return;
     }
 
+    // ── SYNC:* — Multi-rig sync to a host clock ──────────────────────
+    // SYNC:T=<t1>[,<t1'>,<t4'>] -> SYNC:T=<t1>,<t2>,<t3> (the previous
+    // exchange's t1 / t4 complete it)  |  SYNC:ON|OFF|RESET  |  SYNC?
+    if (strncmp(data, "SYNC:T=", 7) == 0) {
+        const int64_t t2 = esp_timer_get_time();
+        char* p = data + 7;
+        const int64_t t1 = strtoll(p, &p, 10);
+        if (*p == ',') {
+            const int64_t t1p = strtoll(p + 1, &p, 10);
+            const int64_t t4p = *p == ',' ? strtoll(p + 1, NULL, 10) : 0;
+            if (t1p == syncPendT1 && t4p) {
+                clocksync_add(&g_clk, syncPendT1, syncPendT2, syncPendT3, t4p);
+                syncPublish();
+            }
+        }
+        syncPendT1 = t1;
+        syncPendT2 = t2;
+        syncPendT3 = esp_timer_get_time();
+        serial_printf("SYNC:T=%lld,%lld,%lld\r\n", (long long)t1, (long long)t2, (long long)syncPendT3);
+        return;
+    }
+    if (strcmp(data, "SYNC?") == 0) {
+        ClockSyncModel m;
+        const bool lock = syncModel(&m);
+        const bool ok = lock && syncTickRmsUs < SYNC_TOL_US &&
+                        (syncAnchorState != 2 || syncPlayRmsUs < SYNC_TOL_US);
+        serial_printf("SYNC:on=%d lock=%d offset=%lld drift=%.2fppm delay=%ld resid=%ld n=%lu rej=%lu "
+                      "tick=%.0f/%.0f slews=%lu play=%.0f/%.0f steps=%lu anchor=%d "
+                      "timed=%lu late=%lu untimed=%lu tol=%d %s\r\n",
+                      syncOn ? 1 : 0, lock ? 1 : 0, (long long)m.offset, m.drift * 1e6,
+                      (long)g_clk.minDelay, (long)g_clk.resid, (unsigned long)g_clk.n,
+                      (unsigned long)g_clk.rejected, syncTickErrUs, syncTickRmsUs,
+                      (unsigned long)syncTickSlews, syncPlayErrUs, syncPlayRmsUs,
+                      (unsigned long)syncSteps, (int)syncAnchorState, (unsigned long)syncTimed,
+                      (unsigned long)syncLate, (unsigned long)syncUntimed, SYNC_TOL_US,
+                      ok ? "OK" : "--");
+        return;
+    }
+    if (strncmp(data, "SYNC:", 5) == 0) {
+        const char* arg = data + 5;
+        if (strcmp(arg, "ON") == 0) {
+            syncOn = true;
+        } else if (strcmp(arg, "OFF") == 0) {
+            syncOn = false;
+            syncAnchorClear();
+        } else if (strcmp(arg, "RESET") == 0) {
+            syncAnchorClear();
+            clocksync_init(&g_clk);
+            syncPublish();
+            syncPendT1 = -1;
+            syncTickErrUs = syncTickRmsUs = syncPlayErrUs = syncPlayRmsUs = syncTickFilt = 0.0f;
+            syncTickSlews = syncSteps = syncTimed = syncLate = syncUntimed = 0;
+        } else {
+            serial_printf("SYNC:ERR unknown '%s' (T=|ON|OFF|RESET)\r\n", arg);
+            return;
+        }
+        serial_printf("SYNC:%s\r\n", arg);
+        return;
+    }
+
     // ── SOURCE:* — Motion source selector (OFF / DEMO / LIVE) ─────────
     // SOURCE:OFF|DEMO|LIVE  |  SOURCE:BOOT=OFF|DEMO|LIVE  |  SOURCE?
+    // SOURCE:DEMO@<host µs> (SYNC:ON, locked): frame 0 plays at that host time.
     if (strcmp(data, "SOURCE?") == 0) {
-        serial_printf("SOURCE:%s boot=%s\r\n", sourceName(g_source), sourceName(loadBootSource()));
+        serial_printf("SOURCE:%s boot=%s\r\n", sourceName(g_source), sourceName(g_bootSource));
         return;
     }
     if (strncmp(data, "SOURCE:", 7) == 0) {
         const char* arg = data + 7;
+        int64_t at;
+        if (syncSplitStamp(data, &at)) {
+            ClockSyncModel m;
+            if (strcmp(arg, "DEMO") != 0) { serial_printf("SOURCE:ERR only DEMO takes @<host us>\r\n"); return; }
+            if (recArming()) { serial_printf("SOURCE:ERR REC arming (flash erase, rig parked)\r\n"); return; }
+            if (!syncOn || !syncModel(&m)) { serial_printf("SOURCE:ERR @ needs SYNC:ON and lock\r\n"); return; }
+            if (!seqSamples || !seqCount) { serial_printf("SOURCE:ERR no sequence\r\n"); return; }
+            setSource(SRC_DEMO);
+            syncAnchor(0, at, true);
+            serial_printf("SOURCE:DEMO@%lld in=%lldus\r\n", (long long)at,
+                          (long long)(clocksync_to_device(&m, at) - esp_timer_get_time()));
+            return;
+        }
         Source parsed; bool ok = true;
         if      (strcmp(arg, "OFF")  == 0) parsed = SRC_OFF;
         else if (strcmp(arg, "DEMO") == 0) parsed = SRC_DEMO;
         else if (strcmp(arg, "LIVE") == 0) parsed = SRC_LIVE;
         else ok = false;
+        if (ok && parsed != SRC_OFF && recArming()) {
+            serial_printf("SOURCE:ERR REC arming (flash erase, rig parked)\r\n");
+            return;
+        }
         if (ok) {
             setSource(parsed);
             serial_printf("SOURCE:%s\r\n", sourceName(g_source));
@@ -1073,6 +2265,59 @@ void process_data(char* data) {
         return;
     }
 
+    // ── SAVE:FLUSH / SAVE? — NvsPersist write-behind ─────────────────
+    // Setters stage their keys; NvsSave commits once the commands stop for
+    // NVS_PERSIST_DEBOUNCE_MS. SAVE:FLUSH commits now and answers from NvsSave.
+    if (strcmp(data, "SAVE:FLUSH") == 0) {
+        nvs_persist_flush([](int keys, bool ok) {
+            if (ok) serial_printf("SAVE:OK keys=%d\r\n", keys);
+            else    serial_printf("ERR:SAVE write failed (%d keys written)\r\n", keys);
+        });
+        return;
+    }
+    if (strcmp(data, "SAVE?") == 0) {
+        NvsPersistStats st;
+        nvs_persist_stats(&st);
+        serial_printf("SAVE: pending=%lu staged=%lu coalesced=%lu commits=%lu writes=%lu errors=%lu "
+                      "last=%lukeys/%.1fms debounce=%dms\r\n",
+            (unsigned long)st.pending, (unsigned long)st.staged, (unsigned long)st.coalesced,
+            (unsigned long)st.commits, (unsigned long)st.writes, (unsigned long)st.errors,
+            (unsigned long)st.lastKeys, st.lastUs / 1000.0, NVS_PERSIST_DEBOUNCE_MS);
+        return;
+    }
+
+    // ── BOOT? / BOOT:SETTLE — boot timeline + home-to-power settle ─────
+    // BOOT?  one line per phase: ms since timer start (+ms since the previous)
+    // BOOT:SETTLE=<ms>  0-2000, persists; takes effect on the next boot
+    if (strcmp(data, "BOOT?") == 0) {
+        int64_t prev = 0;
+        for (int i = 0; i < BOOT_PHASES; i++) {
+            const int64_t t = g_bootUs[i];
+            if (!t) { serial_printf("BOOT:%-6s --\r\n", BOOT_PHASE_NAMES[i]); continue; }
+            serial_printf("BOOT:%-6s %7.1fms (+%.1f)\r\n", BOOT_PHASE_NAMES[i], t / 1000.0,
+                          prev ? (t - prev) / 1000.0 : t / 1000.0);
+            prev = t;
+        }
+#ifdef ENABLE_BLE
+        BleHostInfo hi;
+        ble_transport_host_info(&hi);
+        if (hi.adv_ready_us) serial_printf("BOOT:adv    %7.1fms\r\n", hi.adv_ready_us / 1000.0);
+#endif
+        serial_printf("BOOT:settle=%ums\r\n", (unsigned)bootSettleMs);
+        return;
+    }
+    if (strncmp(data, "BOOT:SETTLE=", 12) == 0) {
+        int ms = atoi(data + 12);
+        if (ms < 0 || ms > BOOT_SETTLE_MAX_MS) {
+            serial_printf("ERR:BOOT:SETTLE=<0-%d ms>\r\n", BOOT_SETTLE_MAX_MS);
+            return;
+        }
+        bootSettleMs = (uint16_t)ms;
+        saveConfigToNVS();
+        serial_printf("BOOT:SETTLE=%u (next boot)\r\n", (unsigned)bootSettleMs);
+        return;
+    }
+
     // ── SERVO:RATE / SERVO:MODE — servo-rate profile (analog/digital) ─
     // SERVO:RATE=50|250 (Hz)  |  SERVO:MODE=ANALOG|DIGITAL  |  SERVO:RATE?
     // Sets BOTH the LEDC carrier and the CueTask loop rate; persists in NVS.
@@ -1106,12 +2351,151 @@ void process_data(char* data) {
         return;
     }
 
+    // ── SCOPE:* — Capture the cue loop around an event ───────────────
+    // SCOPE:TRIG=NOW|CLIP|SLEW|OVERRUN|WDT (flag set on a tick) or
+    // SCOPE:TRIG=THR,<in|filt|cued|pose|angle|pulse>,<axis 0-5>,<level>[,RISE|FALL|BOTH]
+    // SCOPE:ARM[=pre] (default depth/4) | SCOPE:FORCE | SCOPE:STOP | SCOPE:STATUS
+    // SCOPE:DUMP (binary, COBS_CH_SCOPE — `m6ptool scope` writes the CSV)
+    if (strncmp(data, "SCOPE:", 6) == 0) {
+        static const char* const kStates[] = { "idle", "armed", "triggered", "done" };
+        const char* arg = data + 6;
+        if (strncmp(arg, "TRIG=", 5) == 0) {
+            if (scope_active(&g_scope)) { serial_printf("SCOPE:ERR armed (SCOPE:STOP first)\r\n"); return; }
+            char buf[64];
+            snprintf(buf, sizeof(buf), "%s", arg + 5);
+            char* save;
+            char* tok = strtok_r(buf, ",", &save);
+            int type = -1;
+            for (int t = 0; tok && t < SCOPE_TRIG_COUNT; t++)
+                if (strcasecmp(tok, scope_trig_name(t)) == 0) type = t;
+            if (type < 0) { serial_printf("SCOPE:ERR TRIG expects NOW|CLIP|SLEW|OVERRUN|WDT|THR\r\n"); return; }
+            ScopeTrigger trig = g_scope.trig;
+            trig.type = (uint8_t)type;
+            if (type == SCOPE_TRIG_THR) {
+                const char* f = strtok_r(NULL, ",", &save);
+                const char* a = strtok_r(NULL, ",", &save);
+                const char* l = strtok_r(NULL, ",", &save);
+                const char* e = strtok_r(NULL, ",", &save);
+                int field = -1;
+                for (int i = 0; f && i < SCOPE_FIELD_COUNT; i++)
+                    if (strcasecmp(f, scope_field_name(i)) == 0) field = i;
+                int axis = a ? atoi(a) : -1;
+                if (field < 0 || axis < 0 || axis > 5 || !l) {
+                    serial_printf("SCOPE:ERR THR,<field>,<axis 0-5>,<level>[,RISE|FALL|BOTH]\r\n");
+                    return;
+                }
+                trig.field = (uint8_t)field;
+                trig.axis  = (uint8_t)axis;
+                trig.level = strtof(l, NULL);
+                trig.edge  = !e || strcasecmp(e, "RISE") == 0 ? SCOPE_EDGE_RISE
+                           : strcasecmp(e, "FALL") == 0       ? SCOPE_EDGE_FALL : SCOPE_EDGE_BOTH;
+            }
+            g_scope.trig = trig;
+            serial_printf("SCOPE:TRIG %s\r\n", scope_trig_name(type));
+        } else if (strncmp(arg, "ARM", 3) == 0 && (arg[3] == '\0' || arg[3] == '=')) {
+            long pre = arg[3] == '=' ? strtol(arg + 4, NULL, 10) : SCOPE_DEPTH / 4;
+            scope_arm(&g_scope, pre > 0 ? (uint32_t)pre : 0);
+            serial_printf("SCOPE:ARM trig=%s pre=%lu depth=%d (%.2fs @ %uHz)\r\n",
+                          scope_trig_name(g_scope.trig.type), (unsigned long)g_scope.pre, SCOPE_DEPTH,
+                          (double)SCOPE_DEPTH / servoRateHz, (unsigned)servoRateHz);
+        } else if (strcmp(arg, "FORCE") == 0) {
+            g_scope.force = true;
+            serial_printf("SCOPE:FORCE\r\n");
+        } else if (strcmp(arg, "STOP") == 0) {
+            scope_stop(&g_scope);
+            serial_printf("SCOPE:STOP\r\n");
+        } else if (strcmp(arg, "STATUS") == 0) {
+            serial_printf("SCOPE:STATUS %s trig=%s pre=%lu held=%lu/%d trigIdx=%ld sample=%uB\r\n",
+                          kStates[g_scope.state & 3], scope_trig_name(g_scope.trig.type),
+                          (unsigned long)g_scope.pre, (unsigned long)scope_count(&g_scope), SCOPE_DEPTH,
+                          g_scope.state == SCOPE_DONE ? (long)scope_trigger_index(&g_scope) : -1L,
+                          (unsigned)sizeof(ScopeSample));
+        } else if (strcmp(arg, "DUMP") == 0) {
+            if (g_scope.state != SCOPE_DONE) {
+                serial_printf("SCOPE:ERR DUMP needs a finished capture (state=%s)\r\n",
+                              kStates[g_scope.state & 3]);
+                return;
+            }
+            scopeDump();
+        } else {
+            serial_printf("SCOPE:ERR unknown '%s'\r\n", arg);
+        }
+        return;
+    }
+
+    // ── REC:* — Record LIVE motion into the sequence library ─────────
+    // REC:START[=rate[,seconds[,name]]] (defaults 50 Hz, 120 s, "recN") |
+    // REC:STOP | REC:STATUS. The reservation is erased before capture starts,
+    // with the rig parked (SOURCE:OFF) — SOURCE:DEMO/LIVE are refused until
+    // REC:STATUS says capture. The take becomes a normal library entry
+    // (PLAY:LIST / PLAY:SELECT) after REC:STOP.
+    if (strncmp(data, "REC:", 4) == 0) {
+        const char* arg = data + 4;
+        if (strncmp(arg, "START", 5) == 0) {
+            long rate = 50, secs = 120;
+            char name[M6P_NAME_LEN + 1];
+            snprintf(name, sizeof(name), "rec%d", seq_library_count());
+            if (arg[5] == '=') {
+                char* end;
+                rate = strtol(arg + 6, &end, 10);
+                if (*end == ',') {
+                    secs = strtol(end + 1, &end, 10);
+                    if (*end == ',' && end[1]) snprintf(name, sizeof(name), "%s", end + 1);
+                }
+            }
+            if (rate > servoRateHz) {
+                serial_printf("REC:ERR rate %ld above SERVO:RATE %u\r\n", rate, (unsigned)servoRateHz);
+                return;
+            }
+            int st = seq_record_start((uint16_t)(rate > 0 ? rate : 0), secs > 0 ? (uint32_t)secs : 0,
+                                      inputBitRange, name);
+            if (st != SEQ_REC_OK) {
+                serial_printf("REC:ERR START %s (rate %d-%d Hz, 1-%d s)\r\n", seq_record_strerror(st),
+                              SEQ_REC_RATE_MIN, SEQ_REC_RATE_MAX, SEQ_REC_SECONDS_MAX);
+                return;
+            }
+            recRateHz = (uint16_t)rate;
+            bool parked = g_source != SRC_OFF;
+            if (parked) setSource(SRC_OFF);
+            SeqRecordStatus rs;
+            seq_record_status(&rs);
+            serial_printf("REC:START \"%s\" %ldHz max=%lu frames (%.0fs) -> arming%s\r\n", name, rate,
+                          (unsigned long)rs.maxFrames, (double)rs.maxFrames / rate,
+                          parked ? ", SOURCE:OFF" : "");
+        } else if (strcmp(arg, "STOP") == 0) {
+            int st = seq_record_stop();
+            if (st == SEQ_REC_OK) serial_printf("REC:STOP -> finishing\r\n");
+            else                  serial_printf("REC:ERR STOP %s\r\n", seq_record_strerror(st));
+        } else if (strcmp(arg, "STATUS") == 0) {
+            static const char* const kStates[] = { "idle", "arming", "capture", "finishing" };
+            SeqRecordStatus rs;
+            seq_record_status(&rs);
+            serial_printf("REC:STATUS %s kind=%s rate=%u frames=%lu/%lu (%.1fs) written=%lu "
+                          "dropped=%lu rejected=%lu ring=%lu/%lu last=%s #%d\r\n",
+                kStates[rs.state & 3], rs.kind == M6P_KIND_RAW ? "M6P2" : rs.kind ? "M6P1" : "-",
+                (unsigned)rs.rate, (unsigned long)rs.frames, (unsigned long)rs.maxFrames,
+                rs.rate ? (double)rs.frames / rs.rate : 0.0, (unsigned long)rs.written,
+                (unsigned long)rs.dropped, (unsigned long)rs.rejected,
+                (unsigned long)rs.ringPeak, (unsigned long)rs.ringSize,
+                seq_record_strerror(rs.lastStatus), rs.lastIndex);
+        } else {
+            serial_printf("REC:ERR unknown '%s'\r\n", arg);
+        }
+        return;
+    }
+
     // ── PLAY:* — Embedded motion-cued sequence playback ──────────────
+#define PLAY_BENCH_MAX  20000      // PLAY:BENCH frames: g_seqMutex + RX held, like MCA:BENCH
     // PLAY:START | PLAY:STOP | PLAY:LOOP=0/1 | PLAY:STATUS | PLAY:BOOT=0/1
+    // PLAY:ZP=<fc Hz> (0 = causal) | PLAY:LEAD=<ms> | PLAY:ZP?
+    // PLAY:LIST | PLAY:SELECT=n (library entry, persisted) | PLAY:UPLOAD?
+    // PLAY:BENCH[=N] (frame decode cost of the selected sequence)
+    // PLAY:SEEK=<s> | PLAY:SPEED=<0.25-4> | PLAY:PAUSE | PLAY:RESUME
     if (strncmp(data, "PLAY:", 5) == 0) {
         const char* arg = data + 5;
         if (strcmp(arg, "START") == 0) {          // alias for SOURCE:DEMO
             if (!seqSamples) { serial_printf("PLAY:ERR no sequence\r\n"); return; }
+            if (recArming()) { serial_printf("PLAY:ERR REC arming (flash erase, rig parked)\r\n"); return; }
             setSource(SRC_DEMO);
             serial_printf("PLAY:START %u samples @ %uHz (%d-bit, %s)\r\n",
                           (unsigned)seqCount, (unsigned)seqRateHz, seqBits,
@@ -1119,14 +2503,186 @@ void process_data(char* data) {
         } else if (strcmp(arg, "STOP") == 0) {    // alias for SOURCE:OFF
             setSource(SRC_OFF);
             serial_printf("PLAY:STOP\r\n");
+        } else if (strncmp(arg, "SEEK=", 5) == 0) {
+            // Jump the playhead; the window re-primes at the new index on the
+            // next tick. Washout is reset like a source change so the jump
+            // isn't cued as an onset.
+            // PLAY:SEEK=<s>@<host µs> (SYNC:ON, locked): the jump lands at
+            // that host time instead, CueTask resets the washout then.
+            if (!playbackActive) { serial_printf("PLAY:ERR SEEK needs playback (PLAY:START)\r\n"); return; }
+            int64_t at;
+            const bool stamped = syncSplitStamp(data, &at);
+            ClockSyncModel m;
+            if (stamped && (!syncOn || !syncModel(&m))) { serial_printf("PLAY:ERR @ needs SYNC:ON and lock\r\n"); return; }
+            float sec = (float)atof(arg + 5);
+            xSemaphoreTake(g_seqMutex, portMAX_DELAY);
+            uint16_t rate = seqRateHz ? seqRateHz : 50;
+            uint32_t idx = sec > 0.0f ? (uint32_t)(sec * rate) : 0;
+            if (idx >= seqCount) idx = seqCount ? seqCount - 1 : 0;
+            if (stamped) {
+                xSemaphoreGive(g_seqMutex);
+                syncAnchor(idx, at, false);
+                serial_printf("PLAY:SEEK=%.2f@%lld idx=%u/%u in=%lldus\r\n", (float)idx / rate, (long long)at,
+                              (unsigned)idx, (unsigned)seqCount,
+                              (long long)(clocksync_to_device(&m, at) - esp_timer_get_time()));
+                return;
+            }
+            syncAnchorClear();
+            playbackIdx = idx;
+            zpReprime   = true;
+            xSemaphoreGive(g_seqMutex);
+            resetMotionCueing(&mcaConfig);
+            resetInputFilter(&inputFilter);
+            publishConfig(true);
+            serial_printf("PLAY:SEEK=%.2f idx=%u/%u\r\n", (float)idx / rate,
+                          (unsigned)idx, (unsigned)seqCount);
+        } else if (strncmp(arg, "SPEED=", 6) == 0) {
+            float v = (float)atof(arg + 6);
+            if (v >= PLAY_SPEED_MIN && v <= PLAY_SPEED_MAX) {
+                playSpeedQ8 = (uint16_t)(v * (1u << PLAY_SPEED_Q) + 0.5f);
+                syncAnchorClear();                 // the anchor's frame rate changed
+                serial_printf("PLAY:SPEED=%.2f\r\n", v);
+            } else {
+                serial_printf("PLAY:ERR SPEED range %.2f-%.2f\r\n", PLAY_SPEED_MIN, PLAY_SPEED_MAX);
+            }
+        } else if (strcmp(arg, "PAUSE") == 0) {
+            if (!playbackActive) { serial_printf("PLAY:ERR not playing\r\n"); return; }
+            playbackPaused = true;
+            serial_printf("PLAY:PAUSE idx=%u\r\n", (unsigned)playbackIdx);
+        } else if (strcmp(arg, "RESUME") == 0) {
+            if (!playbackActive) { serial_printf("PLAY:ERR not playing\r\n"); return; }
+            playbackPaused = false;
+            serial_printf("PLAY:RESUME idx=%u\r\n", (unsigned)playbackIdx);
         } else if (strncmp(arg, "LOOP=", 5) == 0) {
             playbackLoop = atoi(arg + 5) != 0;
             serial_printf("PLAY:LOOP=%d\r\n", playbackLoop ? 1 : 0);
+        } else if (strcmp(arg, "LIST") == 0) {
+            int n = seq_library_count();
+            for (int i = 0; i < n; i++) {
+                const SeqEntry* e = seq_library_entry(i);
+                serial_printf("PLAY:LIST %d%s name=\"%s\" %s rate=%u frames=%u (%.1fs) size=%lu src=%s %s\r\n",
+                    i, i == seqSelected ? "*" : "", e->info.name,
+                    e->info.packed ? "M6P3" : e->info.kind == M6P_KIND_RAW ? "M6P2" : "M6P1",
+                    (unsigned)e->info.rate, (unsigned)e->info.count,
+                    e->info.rate ? (double)e->info.count / e->info.rate : 0.0,
+                    (unsigned long)e->length, e->embedded ? "embedded" : "flash",
+                    m6p_strerror(e->status));
+            }
+            serial_printf("PLAY:LIST count=%d selected=%d free=%lu/%lu\r\n", n, seqSelected,
+                (unsigned long)(seq_library_capacity() > seq_library_free_offset()
+                                ? seq_library_capacity() - seq_library_free_offset() : 0),
+                (unsigned long)seq_library_capacity());
+        } else if (strncmp(arg, "BENCH", 5) == 0) {
+            // Decodes N frames of the selected sequence the way CueTask
+            // does (scratch decoder, playback position untouched) plus the
+            // worst-case seek (last frame of a block). Diagnostic only —
+            // holds g_seqMutex, so DEMO holds its last sample and RX waits
+            // meanwhile; N is capped to keep that well under a second.
+            int n = (arg[5] == '=') ? atoi(arg + 6) : 1000;
+            if (n < 1) n = 1;
+            if (n > PLAY_BENCH_MAX) n = PLAY_BENCH_MAX;
+            static M6p3Decoder benchDec;
+            xSemaphoreTake(g_seqMutex, portMAX_DELAY);
+            if (!seqSamples || !seqCount) {
+                xSemaphoreGive(g_seqMutex);
+                serial_printf("PLAY:ERR no sequence\r\n");
+                return;
+            }
+            const SeqEntry* e = seq_library_entry(seqSelected);
+            float f[6], sink = 0.0f;
+            uint32_t total = 0, worst = 0, seekWorst = 0;
+            if (g_seqPacked) { benchDec = seqDec; m6p3_seek(&benchDec, 0); }
+            for (int k = 0; k < n; k++) {
+                uint32_t idx = (uint32_t)k % seqCount;
+                uint32_t c0 = esp_cpu_get_cycle_count();
+                if (g_seqPacked) m6p3_read(&benchDec, idx, f);
+                else             decodeSeqFrame(seqSamples + (size_t)idx * seqStride, f);
+                uint32_t c = esp_cpu_get_cycle_count() - c0;
+                total += c;
+                if (c > worst) worst = c;
+                sink += f[0];
+            }
+            if (g_seqPacked) {
+                uint32_t last = ((1u << benchDec.log2) - 1 < seqCount) ? (1u << benchDec.log2) - 1 : seqCount - 1;
+                uint32_t c0 = esp_cpu_get_cycle_count();
+                m6p3_seek(&benchDec, last);
+                seekWorst = esp_cpu_get_cycle_count() - c0;
+            }
+            xSemaphoreGive(g_seqMutex);
+            serial_printf("PLAY:BENCH %s frames=%d avg=%lu max=%lu cyc/frame seek<=%lu cyc flash=%.2f B/frame (chk=%.1f)\r\n",
+                g_seqPacked ? "M6P3" : (g_framesRaw ? "M6P2" : "M6P1"), n,
+                (unsigned long)(total / (uint32_t)n), (unsigned long)worst, (unsigned long)seekWorst,
+                (double)m6p_data_size(&e->info) / seqCount, sink);
+        } else if (strcmp(arg, "UPLOAD?") == 0) {
+            SeqUploadStatus st;
+            seq_upload_status(&st);
+            serial_printf("PLAY:UPLOAD %s recv=%lu written=%lu len=%lu resumed=%lu last=%s rate=%luB/s\r\n",
+                st.active ? "active" : (st.busy ? "verifying" : "idle"),
+                (unsigned long)st.received, (unsigned long)st.written, (unsigned long)st.length,
+                (unsigned long)st.resumed, m6pu_strerror(st.lastStatus),
+                (unsigned long)st.bytesPerSec);
+        } else if (strncmp(arg, "SELECT=", 7) == 0) {
+            int n = atoi(arg + 7);
+            bool demo = (g_source == SRC_DEMO);
+            if (selectSequence(n)) {
+                saveSeqSelection(n);
+                if (demo) setSource(SRC_DEMO);   // restart on the new sequence
+                serial_printf("PLAY:SELECT=%d \"%s\" %u samples @ %uHz\r\n", n,
+                    seq_library_entry(n)->info.name, (unsigned)seqCount, (unsigned)seqRateHz);
+            } else {
+                serial_printf("PLAY:ERR SELECT %d not playable (PLAY:LIST)\r\n", n);
+            }
+        } else if (strncmp(arg, "ZP=", 3) == 0) {
+            float fc = atof(arg + 3);
+            uint16_t rate = seqRateHz ? seqRateHz : 50;
+            Lookahead6 probe;
+            lookahead6_design(&probe, fc, (float)rate);
+            float got = lookahead6_cutoff(&probe, (float)rate);
+            if (fc < 0.0f || fc > 25.0f) {
+                serial_printf("PLAY:ERR ZP range 0-25 Hz\r\n");
+            } else if (fc > 0.0f && fabsf(got - fc) > ZP_FC_TOL * fc) {
+                // Below ~0.1·rate the ±16-frame window clamps H and the
+                // transition widens: the filter would cut well above fc.
+                serial_printf("PLAY:ERR ZP fc=%.2f not reachable at %u Hz (achieves %.2f Hz)\r\n",
+                    fc, (unsigned)rate, got);
+            } else {
+                zpFcHz = fc;
+                zpReprime = true;
+                if (fc > 0.0f)
+                    serial_printf("PLAY:ZP=%.2f (lookahead, achieved %.2f Hz @ %u Hz, delay %dms)\r\n",
+                        fc, got, (unsigned)rate, (int)(lookahead6_delay(&probe) * 1000 / rate));
+                else
+                    serial_printf("PLAY:ZP=0.00 (causal)\r\n");
+            }
+        } else if (strncmp(arg, "LEAD=", 5) == 0) {
+            int ms = atoi(arg + 5);
+            if (ms >= 0 && ms <= PLAY_LEAD_MAX_MS) {
+                playLeadMs = ms;
+                zpReprime = true;
+                serial_printf("PLAY:LEAD=%d\r\n", ms);
+            } else {
+                serial_printf("PLAY:ERR LEAD range 0-%d ms\r\n", PLAY_LEAD_MAX_MS);
+            }
+        } else if (strcmp(arg, "ZP?") == 0) {
+            // Window/lookahead are in file frames. delay is the FIR group
+            // delay (H frames), read ahead of the playhead from flash.
+            uint16_t rate = seqRateHz ? seqRateHz : 50;
+            Lookahead6 probe;
+            lookahead6_design(&probe, zpActive() ? zpFcHz : 0.0f, (float)rate);
+            int h = lookahead6_delay(&probe);
+            serial_printf("PLAY:ZP fc=%.2f achieved=%.2f active=%d taps=%d delay=%dms lookahead=%dms lead=%dms "
+                          "cpu=%lu/%lu cyc/frame (avg/max) ram=%uB\r\n",
+                zpFcHz, zpActive() ? lookahead6_cutoff(&probe, (float)rate) : 0.0f,
+                zpActive() ? 1 : 0, 2 * h + 1, (int)(h * 1000 / rate),
+                (int)((h + 1) * 1000 / rate) + playLeadMs, playLeadMs,
+                (unsigned long)zpCycAvg, (unsigned long)zpCycMax, (unsigned)sizeof(Lookahead6));
         } else if (strcmp(arg, "STATUS") == 0) {
-            serial_printf("PLAY:STATUS active=%d idx=%u/%u rate=%u loop=%d src=%s boot=%s\r\n",
-                playbackActive ? 1 : 0, (unsigned)playbackIdx, (unsigned)seqCount,
+            uint16_t rate = seqRateHz ? seqRateHz : 50;
+            serial_printf("PLAY:STATUS active=%d sel=%d idx=%u/%u pos=%.2fs speed=%.2f paused=%d rate=%u loop=%d src=%s boot=%s\r\n",
+                playbackActive ? 1 : 0, seqSelected, (unsigned)playbackIdx, (unsigned)seqCount,
+                ((float)playbackIdx + playFrac) / rate, playSpeed(), playbackPaused ? 1 : 0,
                 (unsigned)seqRateHz, playbackLoop ? 1 : 0,
-                sourceName(g_source), sourceName(loadBootSource()));
+                sourceName(g_source), sourceName(g_bootSource));
         } else if (strncmp(arg, "BOOT=", 5) == 0) {   // alias: 0=OFF, 1=DEMO
             bool on = atoi(arg + 5) != 0;
             saveBootSource(on ? SRC_DEMO : SRC_OFF);
@@ -1158,18 +2714,43 @@ void process_data(char* data) {
 void InterfaceMonitorTask(void* pvParameters) {
     for (;;) {
         // COBS transport: read bytes, decode frames, dispatch to registered handlers
-        // (data_handler → process_binary_packet, cmd_handler → process_data)
-        int got = cobs_read_process(5);
-
-        // Yield when no data — prevents tight busy-loop from starving core 0
-        if (got == 0)
-            vTaskDelay(1);
+        // (data_handler → process_binary_packet, cmd_handler → process_data,
+        // upload_handler → seq_upload_handle_frame). Blocks up to 5 ms on the
+        // UART RX ring, which is what yields core 0 when the link is idle.
+        cobs_read_process(5);
     }
 }
 
 // ── App Main ─────────────────────────────────────────────────────────
 
-extern "C" void app_main(void) {
+#ifdef ENABLE_BLE
+// ── BleInit: deferred BLE bring-up ───────────────────────────────────
+// Started by app_main once CueTask is driving, on core 0 below the serial
+// monitor. BLE:LINK? / BOOT? report the host's boot-to-advertising time.
+static void BleInitTask(void* pv) {
+    (void)pv;
+    if (ble_transport_init(process_binary_packet)) {
+        ble_transport_set_accel_callback(process_accel_packet);
+        ble_transport_set_timed_callbacks(process_binary_packet_at, process_accel_packet_at);
+        bootMark(BOOT_BLE);
+        BleHostInfo hi;
+        ble_transport_host_info(&hi);
+        serial_printf("BLE initialized (%s, %lu B heap) -- advertising as 'Mini6DOF'\r\n",
+                      hi.host, (unsigned long)hi.heap_used);
+        serial_printf("BLE accel char 0xFF03: 24-byte [ax,ay,az,gx,gy,gz] float32 LE\r\n");
+    } else {
+        serial_printf("BLE init FAILED\r\n");
+    }
+    vTaskDelete(NULL);
+}
+#endif
+
+// ── Boot stages ──────────────────────────────────────────────────────
+// app_main runs these in order with the serial monitor started between the
+// first two; the host harness (host/fw_harness.h) runs them without tasks.
+
+// NVS, transport, config, LEDC, servos homed. Returns when power may go on.
+static int64_t bootHome() {
     // Initialize NVS
     esp_err_t ret = nvs_flash_init();
     if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
@@ -1177,19 +2758,31 @@ extern "C" void app_main(void) {
         nvs_flash_init();
     }
 
+    nvs_persist_init(NVS_NAMESPACE);   // NvsSave task: all config writes
+
     // Create mutexes
     xMutex = xSemaphoreCreateMutex();
+    g_cfgWriteLock = xSemaphoreCreateMutex();
+    g_seqMutex     = xSemaphoreCreateMutex();
+    tribuf_init(&g_cfgBuf);
+    imu_fusion_defaults(&imuConfig);   // ACCEL:MODE=RAW fusion (before BLE / CueTask)
+    imu_fusion_init(&g_imu);
 
     // Initialize COBS transport on UART0 (must be before any serial_printf)
     cobs_transport_init(921600);
+    // A frame with SYNC_STAMP_SIZE more bytes carries its host apply time.
     cobs_set_data_handler([](const uint8_t *payload, int len) {
-        (void)len;
-        if (liveMotionGate())          // SOURCE:OFF gates; DEMO auto-switches to LIVE
-            process_binary_packet(payload);   // baked -> shared target
+        if (!liveMotionGate()) return;         // SOURCE:OFF gates; DEMO auto-switches to LIVE
+        if (len >= 12 + SYNC_STAMP_SIZE)
+            process_binary_packet_at(payload, syncDue(payload + 12));
+        else
+            process_binary_packet(payload);    // baked -> shared target
     });
     cobs_set_data_raw_handler([](const uint8_t *payload, int len) {
-        (void)len;
-        if (liveMotionGate())
+        if (!liveMotionGate()) return;
+        if (len >= 24 + SYNC_STAMP_SIZE)
+            process_raw_packet_at(payload, syncDue(payload + 24));
+        else
             process_raw_packet(payload);       // RAW pre-cue -> shared target (cued by CueTask)
     });
     cobs_set_cmd_handler([](const char *cmd) {
@@ -1197,13 +2790,17 @@ extern "C" void app_main(void) {
         int n = snprintf(buf, sizeof(buf), "%s", cmd);
         if (n > 0) process_data(buf);
     });
+    cobs_set_upload_handler(seq_upload_handle_frame);
 
     // Initialize platform config with Mini-6DOF defaults, then overlay NVS
     initMiniDefaults(&stewartConfig);
+    for (int i = 0; i < 6; i++) servo_dyn_defaults(&servoDyn[i]);
     loadConfigFromNVS();
 
     // Compute axis scales from geometry (may have been loaded from NVS)
-    computeAxisScalesFromGeometry(&axisScales, &stewartConfig, 0.90f);
+    computeAxisScalesFromGeometry(&axisScales, &stewartConfig, AXIS_SCALE_MARGIN);
+    publishConfig(false);   // geometry + servo calibration for the boot homing below
+    bootMark(BOOT_CONFIG);
 
     serial_printf("\r\n");
     serial_printf("+==========================================+\r\n");
@@ -1237,32 +2834,19 @@ extern "C" void app_main(void) {
     // Home all servos to center (direct — CueTask not started yet)
     {
         float home[6] = {0, 0, 0, 0, 0, 0};
-        driveServos(home, 1.0f / (float)servoRateHz);
+        driveServos(acquireConfig(), home, 1.0f / (float)servoRateHz, NULL);
     }
 
-    serial_printf("Servos initialized at center. Enabling power...\r\n");
-
-    // Brief delay then enable servo power
-    vTaskDelay(pdMS_TO_TICKS(500));
-    gpio_set_level((gpio_num_t)SERVO_ENABLE_PIN, 1);
-
-    serial_printf("Servo power ON. Ready for motion data.\r\n");
-
-    // Start serial monitor task on Core 0
-    xTaskCreatePinnedToCore(
-        InterfaceMonitorTask,
-        "SerialMonitor",
-        8192,
-        NULL,
-        5,
-        NULL,
-        0
-    );
-
-    serial_printf("Serial monitor started. Accepting commands.\r\n");
-    serial_printf("Commands: VERSION? FINGERPRINT? CONFIG? SCALE? BITS:N ZERO ESTOP:SOFT\r\n");
-    serial_printf("         MCA? MCA:preset ACCEL? ACCEL:GAIN= ACCEL:MAP=\r\n");
+    // Settle: the servos see center pulses for bootSettleMs before power is
+    // switched on. The MCA / sequence setup below runs inside that window.
+    bootMark(BOOT_HOME);
+    serial_printf("Servos initialized at center. Power in %u ms...\r\n", (unsigned)bootSettleMs);
+    return g_bootUs[BOOT_HOME] + (int64_t)bootSettleMs * 1000;
+}
 
+// Cue engine (MCA + input filter), servo rate and the sequence library.
+// Returns whether a sequence is selected.
+static bool bootCueEngine() {
     // Initialize the shared on-device cue engine (MCA + input filter).
     initMotionCueing(&mcaConfig, MCA_SAMPLE_RATE);
     initInputFilter(&inputFilter, MCA_SAMPLE_RATE);
@@ -1278,33 +2862,35 @@ extern "C" void app_main(void) {
     serial_printf("SERVO:RATE=%u Hz (cueLoopHz; %s)\r\n", (unsigned)servoRateHz,
                   servoRateHz >= 200 ? "digital" : "analog");
 
-    // Initialize BLE transport
-#ifdef ENABLE_BLE
-    if (ble_transport_init(process_binary_packet)) {
-        ble_transport_set_accel_callback(process_accel_packet);
-        serial_printf("BLE initialized -- advertising as 'Mini6DOF'\r\n");
-        serial_printf("BLE accel char 0xFF03: 24-byte [ax,ay,az,gx,gy,gz] float32 LE\r\n");
-    } else {
-        serial_printf("BLE init FAILED\r\n");
-    }
+    // ── Sequence library (played by CueTask) ──────────────────────────
+    // Scan the `seq` partition (CRC-checks every entry), then play the NVS
+    // selection; fall back to the first playable entry (embedded = 0).
+#if MINI6DOF_EMBED_SEQ
+    int nSeq = seq_library_init(_seq_start, (size_t)(_seq_end - _seq_start));
+#else
+    int nSeq = seq_library_init(NULL, 0);
 #endif
-
-    // ── CueTask: the fixed-rate consumer + SOLE servo writer ─────────
-    // High prio, core 1 (APP_CPU), clear of the serial monitor on core 0.
-    xTaskCreatePinnedToCore(CueTask, "Cue", 4096, NULL, 7, NULL, 1);
-
-    // ── Embedded motion-cued sequence playback (producer) ────────────
-    bool haveSeq = parseSequence();
+    int wantSeq = loadSeqSelection();
+    bool haveSeq = selectSequence(wantSeq);
+    for (int i = 0; i < nSeq && !haveSeq; i++) haveSeq = selectSequence(i);
     if (haveSeq) {
-        serial_printf("PLAY: sequence ready -- %u samples @ %uHz, %d-bit, %s, loop@%u (~%.1fs)\r\n",
+        serial_printf("PLAY: %d sequence(s); #%d \"%s\" -- %u samples @ %uHz, %d-bit, %s, loop@%u (~%.1fs)\r\n",
+            nSeq, seqSelected, seq_library_entry(seqSelected)->info.name,
             (unsigned)seqCount, (unsigned)seqRateHz, seqBits, g_framesRaw ? "raw" : "baked",
             (unsigned)seqLoopPoint, (double)seqCount / (seqRateHz ? seqRateHz : 50));
-        xTaskCreatePinnedToCore(PlaybackTask, "Playback", 4096, NULL, 6, NULL, 1);
+        if (seqSelected != wantSeq)
+            serial_printf("PLAY: selection %d unavailable -> fallback #%d\r\n", wantSeq, seqSelected);
     } else {
-        serial_printf("PLAY: no valid embedded sequence\r\n");
+        serial_printf("PLAY: no valid sequence (library empty, no embedded file)\r\n");
     }
+    seq_upload_init(onUploadBegin, onUploadDone);
+    seq_record_init(onRecordDone, recParked);
+    bootMark(BOOT_SEQ);
+    return haveSeq;
+}
 
-    // ── Apply the boot source (OFF / DEMO / LIVE), default = DEMO ─────
+// Apply the boot source (OFF / DEMO / LIVE), default = DEMO.
+static void bootApplySource(bool haveSeq) {
     Source bootSrc = loadBootSource();
     if (bootSrc == SRC_DEMO && !haveSeq) {
         serial_printf("SOURCE: boot=DEMO but no sequence -> OFF\r\n");
@@ -1313,34 +2899,61 @@ extern "C" void app_main(void) {
         setSource(bootSrc);
         serial_printf("SOURCE: boot=%s applied\r\n", sourceName(g_source));
     }
+}
+
+extern "C" void app_main(void) {
+    bootMark(BOOT_APP);
+    const int64_t powerAtUs = bootHome();
+
+    // Start serial monitor task on Core 0
+    xTaskCreatePinnedToCore(
+        InterfaceMonitorTask,
+        "SerialMonitor",
+        8192,
+        NULL,
+        5,
+        NULL,
+        0
+    );
+
+    serial_printf("Serial monitor started. Accepting commands.\r\n");
+    serial_printf("Commands: VERSION? FINGERPRINT? CONFIG? SCALE? BITS:N ZERO ESTOP:SOFT\r\n");
+    serial_printf("         MCA? MCA:preset ACCEL? ACCEL:GAIN= ACCEL:MAP= ACCEL:MODE=\r\n");
+
+    const bool haveSeq = bootCueEngine();
+
+    // End of the settle window -> servo power, then start driving.
+    {
+        const int64_t waitUs = powerAtUs - esp_timer_get_time();
+        if (waitUs > 0) vTaskDelay(pdMS_TO_TICKS((waitUs + 999) / 1000));
+    }
+    gpio_set_level((gpio_num_t)SERVO_ENABLE_PIN, 1);
+    bootMark(BOOT_POWER);
+    serial_printf("Servo power ON. Ready for motion data.\r\n");
+
+    // ── CueTask: the fixed-rate consumer + SOLE servo writer ─────────
+    // High prio, core 1 (APP_CPU), clear of the serial monitor on core 0.
+    scope_init(&g_scope);
+    tel_stream_init();
+    xTaskCreatePinnedToCore(CueTask, "Cue", 4096, NULL, 7, NULL, 1);
+    bootMark(BOOT_CUE);
+
+    bootApplySource(haveSeq);
+
+#ifdef ENABLE_BLE
+    // BLE comes up in the background: controller + host bring-up is the
+    // slowest part of boot and nothing on the motion path needs it.
+    xTaskCreatePinnedToCore(BleInitTask, "BleInit", 4096, NULL, 4, NULL, 0);
+#endif
 
     // Seed watchdog timer so it doesn't trip immediately on boot
     lastPacketTimeUs = esp_timer_get_time();
 
-    // Main loop: 6-axis processing + watchdog + telemetry
+    // Main loop: watchdog + telemetry (BLE accel is converted on arrival)
     for (;;) {
-        // ── BLE 6-Axis Pipeline ──────────────────────────────────────
-        // Phone sends [roll_deg, pitch_deg, yaw_deg, surge_ms2, sway_ms2, heave_ms2]
-        // Rotation: degrees → radians, apply gain
-        // Translation: m/s² → mm, apply gain (gain acts as mm-per-m/s²)
-        if (accelFresh && inputMode == INPUT_BLE_ACCEL) {
-            accelFresh = false;
-
-            // Rotation axes: degrees → radians
-            float roll_rad  = accelRaw[0] * DEG_TO_RAD * accelGain[3];
-            float pitch_rad = accelRaw[1] * DEG_TO_RAD * accelGain[4];
-            float yaw_rad   = accelRaw[2] * DEG_TO_RAD * accelGain[5];
-
-            // Translation axes: m/s² → mm (gain = mm per m/s²)
-            float surge_mm = accelRaw[3] * accelGain[0];
-            float sway_mm  = accelRaw[4] * accelGain[1];
-            float heave_mm = accelRaw[5] * accelGain[2];
-
-            // Position: [surge, sway, heave, roll, pitch, yaw] — already physical.
-            // Producer: hand to CueTask as TGT_PHYS (it does slew + IK + servo).
-            float position[6] = {surge_mm, sway_mm, heave_mm, roll_rad, pitch_rad, yaw_rad};
-            if (g_source != SRC_OFF)
-                writeTarget(position, TGT_PHYS);
+        if (playbackDone) {
+            playbackDone = false;
+            serial_printf("PLAY:DONE\r\n");
         }
 
         // ── Activity watchdog (advisory) ──────────────────────────────
@@ -1369,3 +2982,44 @@ extern "C" void app_main(void) {
         vTaskDelay(pdMS_TO_TICKS(telemetryDelayMs));
     }
 }
+
+#ifdef MINI6DOF_HARNESS
+// ── Host harness (host/fw_harness.h) ─────────────────────────────────
+// Host builds only: the boot stages without the settle wait or any of the
+// firmware's own loops, and CueTask's tick stepped by the caller.
+
+static CueLoop g_harnessLoop;
+
+bool fw_harness_boot(void) {
+    bootMark(BOOT_APP);
+    bootHome();
+    const bool haveSeq = bootCueEngine();
+    gpio_set_level((gpio_num_t)SERVO_ENABLE_PIN, 1);
+    bootMark(BOOT_POWER);
+    scope_init(&g_scope);
+    tel_stream_init();
+    bootApplySource(haveSeq);
+    cueLoopInit(&g_harnessLoop);
+    return haveSeq;
+}
+
+void fw_harness_tick(void) {
+    cueTick(&g_harnessLoop);
+}
+
+bool fw_harness_play(const uint8_t* m6p, size_t len) {
+    if (seq_library_init(m6p, len) < 1 || !selectSequence(0)) return false;
+    setSource(SRC_DEMO);
+    return true;
+}
+
+void fw_harness_command(const char* cmd) {
+    char buf[256];
+    int n = snprintf(buf, sizeof(buf), "%s", cmd);
+    if (n > 0) process_data(buf);
+}
+
+void fw_harness_slew(const float target[6], float out[6], float dt) {
+    slewRateLimit(target, out, dt);
+}
+#endif // MINI6DOF_HARNESS